@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "ImaseLib/CpuProfiler.h"
+
 namespace DX
 {
     // Provides an interface for an application that owns DeviceResources to be notified of the device being lost or created.
@@ -67,15 +69,17 @@ namespace DX
         DXGI_COLOR_SPACE_TYPE   GetColorSpace() const noexcept          { return m_colorSpace; }
         unsigned int            GetDeviceOptions() const noexcept       { return m_options; }
 
-        // Performance events
+        // Performance events (also timed on the CPU by Imase::CpuProfiler)
         void PIXBeginEvent(_In_z_ const wchar_t* name)
         {
+            Imase::CpuProfiler::BeginZone(name);
             m_d3dAnnotation->BeginEvent(name);
         }
 
         void PIXEndEvent()
         {
             m_d3dAnnotation->EndEvent();
+            Imase::CpuProfiler::EndZone();
         }
 
         void PIXSetMarker(_In_z_ const wchar_t* name)
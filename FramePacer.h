@@ -0,0 +1,218 @@
+//
+// FramePacer.h - Frame rate limiter with a hybrid sleep-then-spin wait
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "StepTimer.h"
+
+
+namespace DX
+{
+    // Waits between frames so the main loop does not spin a core when vsync is off
+    // or the window is in the background. Most of the wait is spent sleeping; the
+    // last stretch before the deadline is spent spinning, and the length of that
+    // stretch adapts to how much the OS has been oversleeping. The Background and
+    // Suspended policies only sleep: a late wake-up costs nothing there, and spinning
+    // would keep a core busy while the window is not even visible.
+    template<typename TClock>
+    class BasicFramePacer
+    {
+    public:
+        // Which frame rate applies.
+        enum class Policy
+        {
+            Foreground,     // Active window.
+            Background,     // Window lost focus (Game::OnDeactivated).
+            Suspended,      // Minimized or power-suspended (Game::OnSuspending).
+        };
+
+        explicit BasicFramePacer(const TClock& clock = TClock()) noexcept(false) :
+            m_clock(clock),
+            m_policy(Policy::Foreground),
+            m_framesPerSecond{ 0.0, 20.0, 5.0 },
+            m_frequency(m_clock.GetFrequency()),
+            m_period(0),
+            m_deadline(0),
+            m_hasDeadline(false),
+            m_sleepMargin(0),
+            m_minSleepMargin(0),
+            m_waitCount(0),
+            m_missedDeadlineCount(0)
+        {
+            if (m_frequency == 0)
+            {
+                throw std::exception();
+            }
+
+            // Start by spinning the last 2 ms, never less than 0.5 ms.
+            m_sleepMargin = m_frequency / 500;
+            m_minSleepMargin = m_frequency / 2000;
+
+            UpdatePeriod();
+        }
+
+        TClock& GetClock() noexcept { return m_clock; }
+        const TClock& GetClock() const noexcept { return m_clock; }
+
+        // Set the target frame rate for a policy. 0 means no limit.
+        // Defaults: foreground unlimited (vsync paces), background 20, suspended 5.
+        void SetTargetFramesPerSecond(Policy policy, double framesPerSecond) noexcept
+        {
+            m_framesPerSecond[static_cast<int>(policy)] = std::max(framesPerSecond, 0.0);
+            UpdatePeriod();
+        }
+
+        double GetTargetFramesPerSecond(Policy policy) const noexcept { return m_framesPerSecond[static_cast<int>(policy)]; }
+
+        // Switch the active policy.
+        void SetPolicy(Policy policy) noexcept
+        {
+            if (m_policy != policy)
+            {
+                m_policy = policy;
+                UpdatePeriod();
+            }
+        }
+
+        Policy GetPolicy() const noexcept { return m_policy; }
+
+        // Block until the next frame deadline. Returns immediately when running late
+        // or when the current policy has no limit.
+        void WaitForNextFrame()
+        {
+            if (m_period == 0)
+            {
+                m_hasDeadline = false;
+                return;
+            }
+
+            uint64_t now = m_clock.GetCounter();
+
+            if (!m_hasDeadline)
+            {
+                m_deadline = now;
+                m_hasDeadline = true;
+            }
+
+            if (now < m_deadline)
+            {
+                const uint64_t remaining = m_deadline - now;
+
+                if (m_policy != Policy::Foreground)
+                {
+                    // Sleep for all of it and accept the wake-up latency.
+                    m_clock.SleepFor(remaining);
+                    now = m_clock.GetCounter();
+                }
+                else
+                {
+                    // Sleep for everything but the margin.
+                    if (remaining > m_sleepMargin)
+                    {
+                        const uint64_t request = remaining - m_sleepMargin;
+                        m_clock.SleepFor(request);
+
+                        const uint64_t after = m_clock.GetCounter();
+                        const uint64_t slept = after - now;
+                        AdaptSleepMargin(slept > request ? slept - request : 0);
+                        now = after;
+                    }
+
+                    // Spin the rest.
+                    while (now < m_deadline)
+                    {
+                        m_clock.Spin();
+                        now = m_clock.GetCounter();
+                    }
+                }
+
+                // A timer may fire marginally early; count that as on time.
+                m_wakeJitter.Record(now > m_deadline ? ClockToTicks(now - m_deadline) : 0);
+                m_waitCount++;
+            }
+            else if (now > m_deadline)
+            {
+                m_missedDeadlineCount++;
+            }
+
+            // Schedule the next frame. If we fell more than a whole frame behind,
+            // start over from now instead of rushing frames to catch up.
+            m_deadline += m_period;
+            if (now > m_deadline)
+            {
+                m_deadline = now + m_period;
+            }
+        }
+
+        // How late the waits woke up, in StepTimer ticks (recent window).
+        FrameTimeStatistics GetWakeJitterStatistics() const noexcept { return m_wakeJitter.Compute(0); }
+
+        // Current length of the spin phase of the Foreground policy, in StepTimer ticks.
+        uint64_t GetSleepMarginTicks() const noexcept { return ClockToTicks(m_sleepMargin); }
+
+        uint64_t GetWaitCount() const noexcept { return m_waitCount; }
+        uint64_t GetMissedDeadlineCount() const noexcept { return m_missedDeadlineCount; }
+
+    private:
+        void UpdatePeriod() noexcept
+        {
+            const double framesPerSecond = m_framesPerSecond[static_cast<int>(m_policy)];
+            m_period = framesPerSecond > 0.0
+                ? static_cast<uint64_t>(static_cast<double>(m_frequency) / framesPerSecond)
+                : 0;
+
+            // Re-anchor on the next wait so a rate change takes effect immediately.
+            m_hasDeadline = false;
+        }
+
+        void AdaptSleepMargin(uint64_t overshoot) noexcept
+        {
+            if (overshoot > m_sleepMargin)
+            {
+                // The OS overslept past the margin: widen it right away.
+                m_sleepMargin = overshoot + overshoot / 4;
+            }
+            else
+            {
+                // Slowly shrink back towards the observed overshoot.
+                m_sleepMargin -= (m_sleepMargin - overshoot) / 16;
+            }
+
+            m_sleepMargin = std::max(m_sleepMargin, m_minSleepMargin);
+        }
+
+        uint64_t ClockToTicks(uint64_t clockDelta) const noexcept
+        {
+            return (clockDelta / m_frequency) * StepTimer::TicksPerSecond
+                + (clockDelta % m_frequency) * StepTimer::TicksPerSecond / m_frequency;
+        }
+
+        TClock m_clock;
+
+        Policy m_policy;
+        double m_framesPerSecond[3];
+
+        // Timing in clock units.
+        uint64_t m_frequency;
+        uint64_t m_period;
+        uint64_t m_deadline;
+        bool m_hasDeadline;
+        uint64_t m_sleepMargin;
+        uint64_t m_minSleepMargin;
+
+        // Telemetry.
+        FrameTimeHistory m_wakeJitter;
+        uint64_t m_waitCount;
+        uint64_t m_missedDeadlineCount;
+    };
+
+#ifdef _WIN32
+    using FramePacer = BasicFramePacer<QpcClock>;
+#else
+    using FramePacer = BasicFramePacer<SteadyClock>;
+#endif
+}
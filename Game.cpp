@@ -4,6 +4,7 @@
 
 #include "pch.h"
 #include "Game.h"
+#include "ImaseLib/SdkMeshFile.h"
 #include <algorithm>
 
 extern void ExitGame() noexcept;
@@ -12,29 +13,83 @@ using namespace DirectX;
 
 using Microsoft::WRL::ComPtr;
 
-// lp`̒_f[^
-VertexPositionTexture g_vertexes[4] =
+namespace
 {
-    { SimpleMath::Vector3(-0.5f,  0.5f, 0.0f), SimpleMath::Vector2(0.0f, 0.0f) },    // 0
-    { SimpleMath::Vector3( 0.5f,  0.5f, 0.0f), SimpleMath::Vector2(1.0f, 0.0f) },    // 1
-    { SimpleMath::Vector3( 0.5f, -0.5f, 0.0f), SimpleMath::Vector2(1.0f, 1.0f) },    // 2
-    { SimpleMath::Vector3(-0.5f, -0.5f, 0.0f), SimpleMath::Vector2(0.0f, 1.0f) },    // 3
-};
-
-// lp`̃CfbNXf[^
-uint16_t g_indexes[3 * 2] = 
-{
-    0, 1, 2,
-    2, 3, 0,
-};
+    // ˉes̃jANbvƃt@[Nbv
+    const float NEAR_Z = 0.1f;
+    const float FAR_Z = 100.0f;
+
+    // eNX`̃Xg[~OłPt[ɓ]oCg
+    const size_t TEXTURE_UPLOAD_BUDGET = 256 * 1024;
+
+    // \[X̃pbNt@Ci΃\[X̓pbNǂݍށBTools/ResourcePackerō쐬j
+    const wchar_t* RESOURCE_PACK_FILE = L"Resources.pak";
+
+    // foCX̏畜A鎞̂߂ɎcĂǂݍݍς݂̃t@C̃oCg
+    const size_t ASSET_CACHE_BUDGET = 16 * 1024 * 1024;
+
+    // F9L[Ńg[Xɏo͂t[
+    const uint32_t TRACE_CAPTURE_FRAMES = 300;
+
+    // `惌C[
+    enum RenderLayer : uint32_t
+    {
+        LAYER_WORLD = 0,
+        LAYER_OVERLAY = Imase::RENDER_KEY_MAX_LAYER,
+    };
+
+    // }eAiXe[gƃVF[_[̑gݍ킹j
+    enum RenderMaterial : uint32_t
+    {
+        MATERIAL_GRID_FLOOR,
+        MATERIAL_FLOOR_MODEL,
+        MATERIAL_BILLBOARD,
+        MATERIAL_DEBUG_FONT,
+    };
+
+    // eNX`
+    enum RenderTexture : uint32_t
+    {
+        TEXTURE_NONE,
+        TEXTURE_FLOOR,
+        TEXTURE_BALL,
+        TEXTURE_DEBUG_FONT,
+    };
+
+    // _[L[̃yC[hi`R}hj
+    enum RenderCommand : uint32_t
+    {
+        COMMAND_GRID_FLOOR,
+        COMMAND_FLOOR_MODEL,
+        COMMAND_BILLBOARDS,
+        COMMAND_DEBUG_FONT,
+    };
+
+    // [hẄʒu\[gL[p̐[x߂
+    uint32_t GetRenderDepth(const SimpleMath::Vector3& position, const SimpleMath::Matrix& view)
+    {
+        // r[Ԃł͎-Z
+        float distance = -SimpleMath::Vector3::Transform(position, view).z;
+        return Imase::QuantizeRenderDepth(distance, NEAR_Z, FAR_Z);
+    }
+}
 
 Game::Game() noexcept(false)
+    : m_drawCount(0)
+    , m_assetCache(&m_assetLoader, ASSET_CACHE_BUDGET)
+    , m_loadMilliseconds(0.0)
 {
     m_deviceResources = std::make_unique<DX::DeviceResources>();
     // TODO: Provide parameters for swapchain format, depth/stencil format, and backbuffer count.
     //   Add DX::DeviceResources::c_AllowTearing to opt-in to variable rate displays.
     //   Add DX::DeviceResources::c_EnableHDR for HDR10 display.
     m_deviceResources->RegisterDeviceNotify(this);
+
+    // pbNt@C΁Aʂ̃t@C̑ɃpbNǂݍ
+    if (GetFileAttributesW(RESOURCE_PACK_FILE) != INVALID_FILE_ATTRIBUTES)
+    {
+        m_assetLoader.SetResourcePack(std::make_shared<Imase::ResourcePack>(RESOURCE_PACK_FILE));
+    }
 }
 
 // Initialize the Direct3D resources required to run.
@@ -55,6 +110,10 @@ void Game::Initialize(HWND window, int width, int height)
     m_timer.SetTargetElapsedSeconds(1.0 / 60);
     */
 
+    // CPUvt@ČṽI[o[wbh𑪒肵Ă
+    Imase::CpuProfiler::SetThreadName(L"Main");
+    Imase::CpuProfiler::CalibrateOverhead();
+
     // fobOJ̍쐬
     m_debugCamera = std::make_unique<Imase::DebugCamera>(width, height);
 
@@ -64,17 +123,36 @@ void Game::Initialize(HWND window, int width, int height)
 // Executes the basic game loop.
 void Game::Tick()
 {
+    m_framePacer.WaitForNextFrame();
+
     m_timer.Tick([&]()
         {
             Update(m_timer);
         });
 
     Render();
+
+    // ̃t[CPUvt@C̋L^Wv
+    Imase::CpuProfiler::EndFrame();
+
+    // g[Xɂ̃t[L^
+    if (m_traceCapture.IsCapturing())
+    {
+        const auto& stateStatistics = m_stateCache->GetStatistics();
+        m_traceCapture.SetCounter("FPS", m_timer.GetFramesPerSecond());
+        m_traceCapture.SetCounter("Frame ms", m_timer.GetElapsedSeconds() * 1000.0);
+        m_traceCapture.SetCounter("Draws", static_cast<double>(m_drawCount));
+        m_traceCapture.SetCounter("States bound", stateStatistics.bound);
+        m_traceCapture.SetCounter("States skipped", stateStatistics.skipped);
+        m_traceCapture.EndFrame();
+    }
 }
 
 // Updates the world.
 void Game::Update(DX::StepTimer const& timer)
 {
+    Imase::CpuProfileScope profileScope(L"Update");
+
     float elapsedTime = float(timer.GetElapsedSeconds());
 
     // TODO: Add your game logic here.
@@ -83,6 +161,18 @@ void Game::Update(DX::StepTimer const& timer)
     // fobOJ̍XV
     m_debugCamera->Update();
 
+    // F9L[Ńg[X̏o͂JniÕg[X̏ݒ͊JnȂj
+    m_keyboardTracker.Update(Keyboard::Get().GetState());
+    if (m_keyboardTracker.pressed.F9 && !m_traceCapture.IsCapturing())
+    {
+        m_traceCapture.Start("trace.json", "trace.imtrace", TRACE_CAPTURE_FRAMES);
+    }
+
+    // F8L[ŃfoCXXg𔭐ĕA̎ԂmF
+    if (m_keyboardTracker.pressed.F8)
+    {
+        m_deviceResources->HandleDeviceLost();
+    }
 }
 #pragma endregion
 
@@ -104,27 +194,20 @@ void Game::Render()
     // TODO: Add your rendering code here.
     context;
 
-    // fobOJr[s擾
-    SimpleMath::Matrix view = m_debugCamera->GetCameraMatrix();
+    // _[Xe[g̐ݒ񐔂̏WvJn
+    m_stateCache->BeginFrame();
 
-    // Obh̏v̕`
-//    m_gridFloor->Render(context, view, m_proj);
+    // ǂݍ݂ς񂾃eNX`̃~bv}bv]
+    m_textureStreamer->Update(TEXTURE_UPLOAD_BUDGET);
 
-    ///////////////////////////////////////////////////////////
+    // fobOJr[s擾
+    SimpleMath::Matrix view = m_debugCamera->GetCameraMatrix();
 
     SimpleMath::Matrix world;
 
-    // ̃f̕\
-    m_floorModel->Draw(context, *m_states.get(), world, view, m_proj, false, [&]()
-        {
-            // eNX`Tv[̐ݒ
-            ID3D11SamplerState* samplers[] = { m_states->PointWrap() };
-            context->PSSetSamplers(0, 1, samplers);
-        }
-    );
-
-    // r{[h̕`
+    // r{[h̓o^
     SimpleMath::Vector3 cameraPos = m_debugCamera->GetEyePosition();
+    m_billboardBatch->Begin(view, m_proj, -cameraPos);
     for (int i = 0; i < 3; i++)
     {
         for (int j = 0; j < 3; j++)
@@ -132,8 +215,7 @@ void Game::Render()
             SimpleMath::Vector3 pos(0.0f, 0.5f, 0.0f);
             pos.x = static_cast<float>(i) - 1.0f;
             pos.z = static_cast<float>(j) - 1.0f;
-            world = SimpleMath::Matrix::CreateBillboard(pos, -cameraPos, SimpleMath::Vector3::UnitY);
-            DrawBillboard(world, view);
+            m_billboardBatch->Add(pos);
         }
     }
     for (int i = 0; i < 2; i++)
@@ -143,24 +225,148 @@ void Game::Render()
             SimpleMath::Vector3 pos(0.0f, 1.0f, 0.0f);
             pos.x = static_cast<float>(i) - 0.5f;
             pos.z = static_cast<float>(j) - 0.5f;
-            world = SimpleMath::Matrix::CreateBillboard(pos, -cameraPos, SimpleMath::Vector3::UnitY);
-            DrawBillboard(world, view);
+            m_billboardBatch->Add(pos);
         }
     }
-    SimpleMath::Vector3 pos(0.0f, 1.5f, 0.0f);
-    world = SimpleMath::Matrix::CreateBillboard(pos, -cameraPos, SimpleMath::Vector3::UnitY);
-    DrawBillboard(world, view);
-
-    ///////////////////////////////////////////////////////////
+    m_billboardBatch->Add(SimpleMath::Vector3(0.0f, 1.5f, 0.0f));
 
     // FPS擾
     uint32_t fps = m_timer.GetFramesPerSecond();
 
     // FPS̕\
-    m_debugFont->AddString(0, 0, Colors::White, L"FPS=%d", fps);
+    m_debugFont->AddString(0, 0, Colors::White, L"FPS=%d  Load=%.1fms", fps, m_loadMilliseconds);
+
+    // ߂̃t[Ԃ̓vƁAt[̑҂N̂xꂽԂ̕\
+    // iϒlł͌ȂmFj
+    DX::FrameTimeStatistics frameStatistics = m_timer.GetFrameStatistics();
+    DX::FrameTimeStatistics wakeJitter = m_framePacer.GetWakeJitterStatistics();
+    m_debugFont->AddString(0, static_cast<int>(m_debugFont->GetFontHeight() * 2.0f), Colors::White,
+        L"Frame ms avg=%.2f p95=%.2f p99=%.2f max=%.2f over=%u  Wake jitter ms p50=%.3f p99=%.3f",
+        DX::StepTimer::TicksToSeconds(frameStatistics.averageTicks) * 1000.0,
+        DX::StepTimer::TicksToSeconds(frameStatistics.p95Ticks) * 1000.0,
+        DX::StepTimer::TicksToSeconds(frameStatistics.p99Ticks) * 1000.0,
+        DX::StepTimer::TicksToSeconds(frameStatistics.maxTicks) * 1000.0,
+        frameStatistics.overBudgetCount,
+        DX::StepTimer::TicksToSeconds(wakeJitter.p50Ticks) * 1000.0,
+        DX::StepTimer::TicksToSeconds(wakeJitter.p99Ticks) * 1000.0);
+
+    // Õt[̃_[Xe[g̐ݒ񐔂ƕׂʂ̃LbV̕\
+    const auto& stateStatistics = m_stateCache->GetLastFrameStatistics();
+    const auto& layoutCache = m_debugFont->GetLayoutCache();
+    m_debugFont->AddString(0, static_cast<int>(m_debugFont->GetFontHeight()), Colors::White,
+        L"States bound=%u skipped=%u  Text cache hit=%llu miss=%llu",
+        stateStatistics.bound, stateStatistics.skipped,
+        static_cast<unsigned long long>(layoutCache.GetHitCount()),
+        static_cast<unsigned long long>(layoutCache.GetMissCount()));
+
+    // g[X̏o͒̕\
+    if (m_traceCapture.IsCapturing())
+    {
+        m_debugFont->AddString(static_cast<int>(m_debugFont->GetFontHeight() * 20.0f), 0, Colors::Yellow, L"Capturing trace...");
+    }
+    else if (m_traceCapture.IsWriting())
+    {
+        m_debugFont->AddString(static_cast<int>(m_debugFont->GetFontHeight() * 20.0f), 0, Colors::Yellow, L"Writing trace...");
+    }
+
+    // Õt[CPUvt@C̋Ԃ̕\i͓q̐[j
+    float fontHeight = m_debugFont->GetFontHeight();
+    // ṽI[o[wbhڕW𒴂Ă鎞̓^CX^v̓ǂݏoƈꏏɕ\
+    if (Imase::CpuProfiler::IsOverheadOverBudget())
+    {
+        m_debugFont->AddString(0, static_cast<int>(fontHeight * 3.0f), Colors::Orange,
+            L"CPU zones (overhead %.0fns/zone, timer %.0fns, over the %.0fns budget)",
+            Imase::CpuProfiler::GetOverheadNanoseconds(), Imase::CpuProfiler::GetTimestampOverheadNanoseconds(),
+            Imase::CpuProfiler::OVERHEAD_BUDGET_NANOSECONDS);
+    }
+    else
+    {
+        m_debugFont->AddString(0, static_cast<int>(fontHeight * 3.0f), Colors::White,
+            L"CPU zones (overhead %.0fns/zone)", Imase::CpuProfiler::GetOverheadNanoseconds());
+    }
+    const auto& profileZones = Imase::CpuProfiler::GetFrameZones();
+    for (size_t i = 0; i < profileZones.size(); i++)
+    {
+        const Imase::CpuProfileZone& zone = profileZones[i];
+        m_debugFont->AddString(
+            static_cast<int>(fontHeight * static_cast<float>(zone.depth + 1)),
+            static_cast<int>(fontHeight * static_cast<float>(4 + i)), Colors::White,
+            L"%ls %.3fms self=%.3fms x%u", zone.name,
+            Imase::CpuProfiler::TicksToMilliseconds(zone.inclusiveTicks),
+            Imase::CpuProfiler::TicksToMilliseconds(zone.exclusiveTicks),
+            zone.callCount);
+    }
+
+    ///////////////////////////////////////////////////////////
+
+    // `_[L[ɓo^
+    m_renderQueue.Clear();
+
+    // Obh̏v̕`
+//    m_renderQueue.Submit(Imase::MakeOpaqueRenderKey(LAYER_WORLD, MATERIAL_GRID_FLOOR, TEXTURE_NONE, GetRenderDepth(world.Translation(), view)), COMMAND_GRID_FLOOR);
+
+    // ̃f̕\
+    m_renderQueue.Submit(
+        Imase::MakeOpaqueRenderKey(LAYER_WORLD, MATERIAL_FLOOR_MODEL, TEXTURE_FLOOR, GetRenderDepth(world.Translation(), view)),
+        COMMAND_FLOOR_MODEL);
+
+    // r{[h̕`ir{[hm̏Ԃ̓r{[hob`̒ŕבւj
+    m_renderQueue.Submit(
+        Imase::MakeTransparentRenderKey(LAYER_WORLD, GetRenderDepth(SimpleMath::Vector3(0.0f, 1.0f, 0.0f), view), MATERIAL_BILLBOARD, TEXTURE_BALL),
+        COMMAND_BILLBOARDS);
 
     // fobOtHg̕`
-    m_debugFont->Render(m_states.get());
+    m_renderQueue.Submit(
+        Imase::MakeTransparentRenderKey(LAYER_OVERLAY, 0, MATERIAL_DEBUG_FONT, TEXTURE_DEBUG_FONT),
+        COMMAND_DEBUG_FONT);
+
+    // s͎O牜A͉Ȍɕבւĕ`悷
+    m_renderQueue.Sort();
+
+    // `񐔂̓_[L[̐ł͂ȂAꂼꂪۂɕ`悵񐔂𐔂
+    m_drawCount = 0;
+    for (const Imase::RenderItem& item : m_renderQueue)
+    {
+        switch (item.payload)
+        {
+        case COMMAND_GRID_FLOOR:
+            m_gridFloor->Render(context, view, m_proj, m_stateCache.get());
+            m_drawCount++;
+            break;
+
+        case COMMAND_FLOOR_MODEL:
+            m_floorModel->Draw(context, *m_states.get(), world, view, m_proj, false, [&]()
+                {
+                    // ffoCXReLXgɒڃXe[gݒ肵Ă̂Ŕj
+                    m_stateCache->Invalidate();
+
+                    // eNX`Tv[̐ݒ
+                    ID3D11SamplerState* samplers[] = { m_states->PointWrap() };
+                    m_stateCache->SetPSSamplers(0, 1, samplers);
+                }
+            );
+
+            // f̓bVp[cƂɕ`悷
+            for (const auto& mesh : m_floorModel->meshes)
+            {
+                m_drawCount += mesh->meshParts.size();
+            }
+            break;
+
+        case COMMAND_BILLBOARDS:
+            m_billboardBatch->End(context, m_states.get(), m_textureSink->GetTexture(m_ballTexture), m_stateCache.get());
+            m_drawCount += m_billboardBatch->GetDrawCount();
+            break;
+
+        case COMMAND_DEBUG_FONT:
+            m_debugFont->Render(m_states.get());
+            m_drawCount += m_debugFont->GetDrawCount();
+
+            // XvCgob`foCXReLXgɒڃXe[gݒ肵Ă̂Ŕj
+            m_stateCache->Invalidate();
+            break;
+        }
+    }
 
     m_deviceResources->PIXEndEvent();
 
@@ -195,21 +401,25 @@ void Game::Clear()
 void Game::OnActivated()
 {
     // TODO: Game is becoming active window.
+    m_framePacer.SetPolicy(DX::FramePacer::Policy::Foreground);
 }
 
 void Game::OnDeactivated()
 {
     // TODO: Game is becoming background window.
+    m_framePacer.SetPolicy(DX::FramePacer::Policy::Background);
 }
 
 void Game::OnSuspending()
 {
     // TODO: Game is being power-suspended (or minimized).
+    m_framePacer.SetPolicy(DX::FramePacer::Policy::Suspended);
 }
 
 void Game::OnResuming()
 {
     m_timer.ResetElapsedTime();
+    m_framePacer.SetPolicy(DX::FramePacer::Policy::Foreground);
 
     // TODO: Game is being power-resumed (or returning from minimize).
 }
@@ -254,48 +464,55 @@ void Game::CreateDeviceDependentResources()
     // TODO: Initialize device dependent objects here (independent of window size).
     device;
 
+    // t@C̓ǂݍ݂Ɖ͂̓Xbhv[ŕɍsÅԂɃCXbhő̏
+    // iLbVɎcĂt@C͓ǂݒȂj
+    m_assetLoader.ResetTimings();
+    auto fontFile = m_assetCache.Get<Imase::SpriteFontFile>(L"Resources\\Font\\SegoeUI_18.spritefont");
+    auto ballTexture = m_assetCache.Get<Imase::DdsFile>(L"Resources\\Models\\ball.dds");
+    auto floorMesh = m_assetCache.Get<Imase::SdkMeshFile>(L"Resources\\Models\\Floor.sdkmesh");
+
+    // ̃fƃtHg̃eNX`̓̃t@CXbhv[ō쐬ifoCX̓t[Xbhj
+    std::future<std::unique_ptr<Model>> floorModel = m_assetLoader.GetThreadPool().Submit([device, floorMesh]()
+        {
+            EffectFactory fx(device);
+            fx.SetDirectory(L"Resources\\Models");
+            std::shared_ptr<const Imase::SdkMeshFile> mesh = floorMesh.get();
+            return Model::CreateFromSDKMESH(device, mesh->GetData(), mesh->GetSize(), fx);
+        }
+    );
+    std::future<ComPtr<ID3D11ShaderResourceView>> fontTexture = m_assetLoader.GetThreadPool().Submit([device, fontFile]()
+        {
+            return Imase::DebugFont::CreateTexture(device, *fontFile.get());
+        }
+    );
+
     // ʃXe[g̍쐬
     m_states = std::make_unique<CommonStates>(device);
 
-    // fobOtHg̍쐬
-    m_debugFont = std::make_unique<Imase::DebugFont>(device
-        , context, L"Resources\\Font\\SegoeUI_18.spritefont");
+    // _[Xe[g̃LbV̍쐬
+    m_stateTarget = std::make_unique<Imase::D3DRenderStateTarget>(context);
+    m_stateCache = std::make_unique<Imase::RenderStateCache>(m_stateTarget.get());
 
     // Obh̍쐬
     m_gridFloor = std::make_unique<Imase::GridFloor>(device, context, m_states.get());
 
-    // x[VbNGtFNg̍쐬
-    m_basicEffect = std::make_unique<BasicEffect>(device);
-    // Cg(OFF)
-    m_basicEffect->SetLightingEnabled(false);
-    // _J[(OFF)
-    m_basicEffect->SetVertexColorEnabled(false);
-    // eNX`(ON)
-    m_basicEffect->SetTextureEnabled(true);
-
-    // At@eXgGtFNg̍쐬
-    m_alphaTestEffect = std::make_unique<AlphaTestEffect>(device);
-    m_alphaTestEffect->SetReferenceAlpha(200);
-
-    // ̓CAEg̍쐬
-    DX::ThrowIfFailed(
-        CreateInputLayoutFromEffect<VertexPositionTexture>(
-            device, m_basicEffect.get(), m_inputLayout.ReleaseAndGetAddressOf())
-    );
+    // r{[hob`̍쐬
+    m_billboardBatch = std::make_unique<Imase::BillboardBatch>(device);
 
-    // v~eBuob`̍쐬
-    m_primitiveBatch = std::make_unique<PrimitiveBatch<VertexPositionTexture>>(context);
+    // ȉ͓ǂݍ݂ς񂾃t@CGPŨ\[X쐬
 
-    // DDSeNX`̓ǂݍ
-    DX::ThrowIfFailed(
-        CreateDDSTextureFromFile(
-            device, L"Resources\\Models\\ball.dds", nullptr, m_texture.ReleaseAndGetAddressOf())
-    );
+    // fobOtHg̍쐬iXvCgob`̓foCXReLXgĝŃCXbhō쐬j
+    m_debugFont = std::make_unique<Imase::DebugFont>(context, fontFile.get(), fontTexture.get());
+
+    // DDSeNX`̓o^i~bv}bvɓ]Ac͕`悵Ȃ]j
+    // ]̓foCXReLXgĝŃCXbhōs
+    m_textureStreamer.reset();
+    m_textureSink = std::make_unique<Imase::D3DTextureUploadSink>(device, context);
+    m_textureStreamer = std::make_unique<Imase::TextureStreamer>(m_textureSink.get());
+    m_ballTexture = m_textureStreamer->Add(ballTexture.get());
 
-    // ̃f̓ǂݍ
-    EffectFactory fx(device);
-    fx.SetDirectory(L"Resources\\Models");
-    m_floorModel = Model::CreateFromSDKMESH(device, L"Resources\\Models\\Floor.sdkmesh", fx);
+    // ̃f̍쐬҂i}bvt@C̒ĝ܂ܓnĂj
+    m_floorModel = floorModel.get();
 
     // }eÃfBt[YF𔒂ɕύX
     m_floorModel->UpdateEffects([&](IEffect* effect)
@@ -308,6 +525,23 @@ void Game::CreateDeviceDependentResources()
         }
     );
 
+    // ǂݍ݂Ɏst@ĈāALbV\ZɎ߂igp̃t@C͎cj
+    m_assetCache.Trim();
+
+    // ǂݍݎԂfobOo͂ɕ\
+    m_loadMilliseconds = m_assetLoader.GetElapsedMilliseconds();
+    for (const Imase::AssetTiming& timing : m_assetLoader.GetTimings())
+    {
+        wchar_t text[MAX_PATH + 64];
+        swprintf_s(text, L"Load %ls: %.2fms (%.2f - %.2f)\n", timing.fileName.c_str(),
+            timing.endMilliseconds - timing.startMilliseconds, timing.startMilliseconds, timing.endMilliseconds);
+        OutputDebugStringW(text);
+    }
+    Imase::AssetCache::Statistics cache = m_assetCache.GetStatistics();
+    wchar_t total[128];
+    swprintf_s(total, L"Load total: %.2fms (cache hits=%zu misses=%zu evictions=%zu, %zu bytes)\n", m_loadMilliseconds,
+        cache.hits, cache.misses, cache.evictions, m_assetCache.GetSize());
+    OutputDebugStringW(total);
 }
 
 // Allocate all memory resources that change on a window SizeChanged event.
@@ -322,13 +556,24 @@ void Game::CreateWindowSizeDependentResources()
     m_proj = SimpleMath::Matrix::CreatePerspectiveFieldOfView(
         XMConvertToRadians(45.0f)
         , static_cast<float>(rect.right) / static_cast<float>(rect.bottom)
-        , 0.1f, 100.0f);
+        , NEAR_Z, FAR_Z);
 
 }
 
 void Game::OnDeviceLost()
 {
     // TODO: Add Direct3D resource cleanup here.
+
+    // foCXɈˑ̂jiǂݍ񂾃t@C̓LbVɎcj
+    m_textureStreamer.reset();
+    m_textureSink.reset();
+    m_floorModel.reset();
+    m_billboardBatch.reset();
+    m_gridFloor.reset();
+    m_debugFont.reset();
+    m_stateCache.reset();
+    m_stateTarget.reset();
+    m_states.reset();
 }
 
 void Game::OnDeviceRestored()
@@ -338,49 +583,4 @@ void Game::OnDeviceRestored()
     CreateWindowSizeDependentResources();
 }
 
-// r{[h̕`֐
-void Game::DrawBillboard(const SimpleMath::Matrix& world, const SimpleMath::Matrix& view)
-{
-    auto context = m_deviceResources->GetD3DDeviceContext();
-
-    // [xXeVobt@̐ݒ
-    context->OMSetDepthStencilState(m_states->DepthDefault(), 0);
-
-    // uhXe[g̐ݒ
-    context->OMSetBlendState(m_states->AlphaBlend(), nullptr, 0xffffffff);
-
-    // JO̐ݒ
-    context->RSSetState(m_states->CullNone());
-
-    // eNX`Tv[̐ݒ
-    ID3D11SamplerState* samplers[] = { m_states->LinearClamp() };
-    context->PSSetSamplers(0, 1, samplers);
-
-    // [hs
-    m_alphaTestEffect->SetWorld(world);
-
-    // r[s
-    m_alphaTestEffect->SetView(view);
-
-    // ˉes
-    m_alphaTestEffect->SetProjection(m_proj);
-
-    // eNX`
-    m_alphaTestEffect->SetTexture(m_texture.Get());
-
-    // GtFNgK
-    m_alphaTestEffect->Apply(context);
-
-    // ̓CAEg
-    context->IASetInputLayout(m_inputLayout.Get());
-
-    // v~eBuob`̕`
-    m_primitiveBatch->Begin();
-
-    // lp`̕`
-    m_primitiveBatch->DrawIndexed(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST, g_indexes, 6, g_vertexes, 4);
-
-    m_primitiveBatch->End();
-}
-
 #pragma endregion
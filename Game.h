@@ -6,10 +6,18 @@
 
 #include "DeviceResources.h"
 #include "StepTimer.h"
+#include "FramePacer.h"
 
 #include "ImaseLib/DebugFont.h"
 #include "ImaseLib/GridFloor.h"
 #include "ImaseLib/DebugCamera.h"
+#include "ImaseLib/BillboardBatch.h"
+#include "ImaseLib/D3DTextureUploadSink.h"
+#include "ImaseLib/D3DRenderStateTarget.h"
+#include "ImaseLib/RenderQueue.h"
+#include "ImaseLib/TraceCapture.h"
+#include "ImaseLib/AssetLoader.h"
+#include "ImaseLib/AssetCache.h"
 
 // A basic game implementation that creates a D3D11 device and
 // provides a game loop.
@@ -64,6 +72,9 @@ private:
     // Rendering loop timer.
     DX::StepTimer                           m_timer;
 
+    // Frame limiter for the message loop.
+    DX::FramePacer                          m_framePacer;
+
 private:
 
     // ˉes
@@ -72,6 +83,12 @@ private:
     // ʃXe[g
     std::unique_ptr<DirectX::CommonStates> m_states;
 
+    // _[Xe[g̐ݒ
+    std::unique_ptr<Imase::D3DRenderStateTarget> m_stateTarget;
+
+    // _[Xe[g̍ĐݒȂLbV
+    std::unique_ptr<Imase::RenderStateCache> m_stateCache;
+
     // fobOtHg
     std::unique_ptr<Imase::DebugFont> m_debugFont;
 
@@ -81,25 +98,40 @@ private:
     // fobOJ
     std::unique_ptr<Imase::DebugCamera> m_debugCamera;
 
-    // x[VbNGtFNg
-    std::unique_ptr<DirectX::BasicEffect> m_basicEffect;
+    // eNX`̓]
+    std::unique_ptr<Imase::D3DTextureUploadSink> m_textureSink;
 
-    // At@eXgGtFNg
-    std::unique_ptr<DirectX::AlphaTestEffect> m_alphaTestEffect;
+    // eNX`̃Xg[~Oi]ɔjj
+    std::unique_ptr<Imase::TextureStreamer> m_textureStreamer;
 
-    // ̓CAEg
-    Microsoft::WRL::ComPtr<ID3D11InputLayout> m_inputLayout;
-
-    // v~eBuob`
-    std::unique_ptr<DirectX::PrimitiveBatch<DirectX::VertexPositionTexture>> m_primitiveBatch;
- 
-    // eNX`nh
-    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_texture;
+    // {[̃eNX`
+    Imase::TextureHandle m_ballTexture;
 
     // ̃f
     std::unique_ptr<DirectX::Model> m_floorModel;
 
-    // r{[h̕`֐
-    void DrawBillboard(const DirectX::SimpleMath::Matrix& world, const DirectX::SimpleMath::Matrix& view);
+    // r{[hob`
+    std::unique_ptr<Imase::BillboardBatch> m_billboardBatch;
+
+    // _[L[
+    Imase::RenderQueue m_renderQueue;
+
+    // Ōɕ`悵t[̕`񐔁ifAr{[hAtHgAObh̏j
+    size_t m_drawCount;
+
+    // L[{[h̉̌o
+    DirectX::Keyboard::KeyboardStateTracker m_keyboardTracker;
+
+    // g[X̏óiF9L[ŊJnj
+    Imase::TraceCapture m_traceCapture;
+
+    // AZbg̕ǂݍ
+    Imase::AssetLoader m_assetLoader;
+
+    // ǂݍ񂾃t@C̃LbVifoCXXg̕Ał̓fBXNǂݒȂj
+    Imase::AssetCache m_assetCache;
+
+    // foCXɈˑ郊\[X̍쐬ɂԁi~bj
+    double m_loadMilliseconds;
 
 };
@@ -0,0 +1,100 @@
+﻿//--------------------------------------------------------------------------------------
+// File: AssetCache.cpp
+//
+// 読み込んだアセットをファイル名で覚えておき、再利用するクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "AssetCache.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace Imase;
+
+const size_t AssetCache::NO_BUDGET;
+
+// コンストラクタ
+AssetCache::AssetCache(AssetLoader* loader, size_t budget)
+	: m_loader(loader)
+	, m_budget(budget)
+	, m_useCount(0)
+	, m_statistics{}
+{
+}
+
+// 予算を設定する関数
+void AssetCache::SetBudget(size_t budget)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_budget = budget;
+}
+
+// 他から参照されていないアセットを使われていない順に破棄して予算に収める関数
+void AssetCache::Trim()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	size_t total = 0;
+	std::vector<std::unordered_map<std::wstring, std::unique_ptr<Entry>>::iterator> candidates;
+	for (auto it = m_entries.begin(); it != m_entries.end();)
+	{
+		if (it->second->HasFailed())
+		{
+			it = m_entries.erase(it);
+			continue;
+		}
+
+		total += it->second->GetSize();
+		if (!it->second->IsShared()) candidates.push_back(it);
+		++it;
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+		{
+			return a->second->lastUse < b->second->lastUse;
+		});
+
+	for (auto it : candidates)
+	{
+		if (total <= m_budget) break;
+
+		total -= it->second->GetSize();
+		m_entries.erase(it);
+		m_statistics.evictions++;
+	}
+}
+
+// 全てのアセットを破棄する関数
+void AssetCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_entries.clear();
+}
+
+// 覚えているアセットの数を取得する関数
+size_t AssetCache::GetCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_entries.size();
+}
+
+// 覚えているアセットのバイト数を取得する関数
+size_t AssetCache::GetSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	size_t total = 0;
+	for (const auto& entry : m_entries)
+	{
+		total += entry.second->GetSize();
+	}
+	return total;
+}
+
+// 統計を取得する関数
+AssetCache::Statistics AssetCache::GetStatistics() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_statistics;
+}
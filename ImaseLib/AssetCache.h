@@ -0,0 +1,177 @@
+﻿//--------------------------------------------------------------------------------------
+// File: AssetCache.h
+//
+// 読み込んだアセットをファイル名で覚えておき、再利用するクラス
+//
+// Usage: Get関数で取得すると、初めてのファイルはAssetLoaderで読み込み、２回目からは
+//        覚えている結果（std::shared_future）をそのまま返します。
+//        アセットはデバイスに依存しない（ファイルをマップして解析した）ものなので、
+//        デバイスの消失から復帰する時にディスクから読み直さずに済みます。
+//        予算（バイト数）を指定すると、Trim関数で他から参照されていないアセットを
+//        使われていない順に破棄して予算に収めます。
+//        同じファイルを違う型で取得すると std::runtime_error を投げます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "AssetLoader.h"
+
+namespace Imase
+{
+	class AssetCache
+	{
+	public:
+
+		// 予算の制限なし
+		static const size_t NO_BUDGET = SIZE_MAX;
+
+		// 統計
+		struct Statistics
+		{
+			// 覚えていたアセットを返した回数と、読み込んだ回数
+			uint64_t hits;
+			uint64_t misses;
+
+			// 予算に収めるために破棄した数
+			uint64_t evictions;
+		};
+
+	private:
+
+		// 覚えているアセット（型ごとの実装の基底）
+		class Entry
+		{
+		public:
+
+			virtual ~Entry() = default;
+
+			// 読み込みが済んだか
+			virtual bool IsReady() const = 0;
+
+			// 読み込みに失敗したか
+			virtual bool HasFailed() const = 0;
+
+			// キャッシュ以外から参照されているか（読み込み中も参照されているとみなす）
+			virtual bool IsShared() const = 0;
+
+			// バイト数（読み込み中は0）
+			virtual size_t GetSize() const = 0;
+
+			// 最後に使ったGet関数の番号
+			uint64_t lastUse = 0;
+		};
+
+		// 型ごとのアセット
+		template <class T>
+		class TypedEntry : public Entry
+		{
+		public:
+
+			std::shared_future<std::shared_ptr<const T>> future;
+
+			bool IsReady() const override
+			{
+				return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+			}
+
+			bool HasFailed() const override
+			{
+				if (!IsReady()) return false;
+				try
+				{
+					future.get();
+					return false;
+				}
+				catch (const std::exception&)
+				{
+					return true;
+				}
+			}
+
+			bool IsShared() const override
+			{
+				return !IsReady() || (!HasFailed() && future.get().use_count() > 1);
+			}
+
+			size_t GetSize() const override
+			{
+				return (IsReady() && !HasFailed()) ? future.get()->GetSize() : 0;
+			}
+		};
+
+		// 読み込みに使うローダー
+		AssetLoader* m_loader;
+
+		// ファイル名ごとのアセット（m_mutexで保護）
+		mutable std::mutex m_mutex;
+		std::unordered_map<std::wstring, std::unique_ptr<Entry>> m_entries;
+
+		// 予算
+		size_t m_budget;
+
+		// Get関数を呼んだ回数（使った順の判定用）
+		uint64_t m_useCount;
+
+		// 統計
+		Statistics m_statistics;
+
+	public:
+
+		// コンストラクタ
+		explicit AssetCache(AssetLoader* loader, size_t budget = NO_BUDGET);
+
+		// アセットを取得する関数（覚えていなければ読み込みを開始する）
+		template <class T>
+		std::shared_future<std::shared_ptr<const T>> Get(const wchar_t* fileName)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			std::wstring name(fileName);
+			auto it = m_entries.find(name);
+			if (it != m_entries.end())
+			{
+				TypedEntry<T>* typed = dynamic_cast<TypedEntry<T>*>(it->second.get());
+				if (!typed) throw std::runtime_error("Asset is cached with a different type.");
+
+				m_statistics.hits++;
+				typed->lastUse = ++m_useCount;
+				return typed->future;
+			}
+
+			std::unique_ptr<TypedEntry<T>> typed = std::make_unique<TypedEntry<T>>();
+			typed->future = m_loader->Load<T>(fileName).share();
+			typed->lastUse = ++m_useCount;
+			m_statistics.misses++;
+
+			std::shared_future<std::shared_ptr<const T>> future = typed->future;
+			m_entries.emplace(std::move(name), std::move(typed));
+			return future;
+		}
+
+		// 予算を設定する関数
+		void SetBudget(size_t budget);
+
+		// 他から参照されていないアセットを使われていない順に破棄して予算に収める関数
+		// （読み込みに失敗したものは次に読み直せるように必ず破棄する）
+		void Trim();
+
+		// 全てのアセットを破棄する関数（参照されているアセットは参照が無くなるまで残る）
+		void Clear();
+
+		// 覚えているアセットの数とバイト数を取得する関数
+		size_t GetCount() const;
+		size_t GetSize() const;
+
+		// 統計を取得する関数
+		Statistics GetStatistics() const;
+	};
+}
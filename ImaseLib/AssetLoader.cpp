@@ -0,0 +1,52 @@
+﻿//--------------------------------------------------------------------------------------
+// File: AssetLoader.cpp
+//
+// アセットのファイルをスレッドプールで並列に読み込むクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "AssetLoader.h"
+
+using namespace Imase;
+
+// コンストラクタ
+AssetLoader::AssetLoader(uint32_t threadCount)
+	: m_origin(Clock::now())
+	, m_pool(threadCount)
+{
+}
+
+// 時間の基準を今にして、読み込み時間の記録を消す関数
+void AssetLoader::ResetTimings()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_origin = Clock::now();
+	m_timings.clear();
+}
+
+// 読み込み時間の記録を取得する関数
+std::vector<AssetTiming> AssetLoader::GetTimings() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_timings;
+}
+
+// ResetTimings関数を呼んでからの時間を取得する関数
+double AssetLoader::GetElapsedMilliseconds() const
+{
+	Clock::time_point origin;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		origin = m_origin;
+	}
+	return std::chrono::duration<double, std::milli>(Clock::now() - origin).count();
+}
+
+// 読み込み時間を記録する関数
+void AssetLoader::AddTiming(const std::wstring& fileName, double start, double end)
+{
+	AssetTiming timing = { fileName, start, end };
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_timings.push_back(timing);
+}
@@ -0,0 +1,124 @@
+﻿//--------------------------------------------------------------------------------------
+// File: AssetLoader.h
+//
+// アセットのファイルをスレッドプールで並列に読み込むクラス
+//
+// Usage: Load関数にファイル名を渡すと、ワーカースレッドでファイルをマップして解析し、
+//        結果をstd::futureで返します。Tにはファイル名を受け取るコンストラクタと
+//        GetData、GetSize関数を持つクラス（SpriteFontFile、DdsFile、SdkMeshFile）を指定します。
+//        マップしたファイルのページもワーカースレッドで読み込んでおくので、
+//        受け取った後のGPUのリソースの作成でディスクの読み込みを待ちません。
+//        GPUのリソースの作成はD3Dのデバイスを使うスレッドで、getで受け取った後に行ってください。
+//        読み込みが失敗した時はgetで例外が投げ直されます。
+//        ResetTimings関数を呼んでからのアセットごとの読み込み時間をGetTimings関数で取得できます。
+//        SetResourcePack関数でパックファイルを設定すると、パックに入っているファイルはパックから
+//        読み込みます（圧縮していなければコピーせずにパックの中身を直接参照します）。
+//        Tにはメモリ上の内容を受け取るコンストラクタも必要です。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "MappedFile.h"
+#include "ResourcePack.h"
+#include "ThreadPool.h"
+
+namespace Imase
+{
+	// アセットの読み込み時間
+	struct AssetTiming
+	{
+		// ファイル名
+		std::wstring fileName;
+
+		// 読み込みの開始と終了（ResetTimings関数を呼んでからのミリ秒）
+		double startMilliseconds;
+		double endMilliseconds;
+	};
+
+	class AssetLoader
+	{
+	private:
+
+		// 時間の基準
+		typedef std::chrono::steady_clock Clock;
+		Clock::time_point m_origin;
+
+		// 読み込み時間（m_mutexで保護）
+		mutable std::mutex m_mutex;
+		std::vector<AssetTiming> m_timings;
+
+		// パックファイル（なければnullptr）
+		std::shared_ptr<const ResourcePack> m_pack;
+
+		// スレッドプール（破棄する時に読み込み中の処理を待つので最後に宣言する）
+		ThreadPool m_pool;
+
+	public:
+
+		// コンストラクタ
+		explicit AssetLoader(uint32_t threadCount = ThreadPool::GetDefaultThreadCount());
+
+		// ファイルを読み込む関数
+		template <class T>
+		std::future<std::shared_ptr<const T>> Load(const wchar_t* fileName)
+		{
+			std::wstring name(fileName);
+			std::shared_ptr<const ResourcePack> pack = m_pack;
+			return m_pool.Submit([this, name, pack]()
+				{
+					double start = GetElapsedMilliseconds();
+					std::shared_ptr<const T> asset = Open<T>(pack, name.c_str());
+					TouchPages(asset->GetData(), asset->GetSize());
+					AddTiming(name, start, GetElapsedMilliseconds());
+					return asset;
+				});
+		}
+
+		// パックファイルを設定する関数（この後のLoad関数から使う。nullptrで個別のファイルに戻す）
+		void SetResourcePack(std::shared_ptr<const ResourcePack> pack) { m_pack = std::move(pack); }
+
+		// スレッドプールを取得する関数（デバイスだけを使うGPUのリソースの作成などを並列に行う）
+		ThreadPool& GetThreadPool() { return m_pool; }
+
+		// 時間の基準を今にして、読み込み時間の記録を消す関数
+		void ResetTimings();
+
+		// 読み込み時間の記録を取得する関数（読み込みが終わった順）
+		std::vector<AssetTiming> GetTimings() const;
+
+		// ResetTimings関数を呼んでからの時間を取得する関数
+		double GetElapsedMilliseconds() const;
+
+	private:
+
+		// パックにあればパックから、なければファイルから開く関数
+		template <class T>
+		static std::shared_ptr<const T> Open(const std::shared_ptr<const ResourcePack>& pack, const wchar_t* fileName)
+		{
+			const ResourcePackEntry* entry = pack ? pack->Find(fileName) : nullptr;
+			if (!entry) return std::make_shared<T>(fileName);
+
+			// 中身を参照している間はパックか展開先のバッファを残しておく
+			if (!ResourcePack::IsCompressed(*entry))
+			{
+				return std::shared_ptr<const T>(
+					new T(pack->GetStoredData(*entry), static_cast<size_t>(entry->size)),
+					[pack](const T* asset) { delete asset; });
+			}
+
+			auto buffer = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(entry->size));
+			pack->Decompress(*entry, buffer->data());
+			return std::shared_ptr<const T>(
+				new T(buffer->data(), buffer->size()),
+				[buffer](const T* asset) { delete asset; });
+		}
+
+		// 読み込み時間を記録する関数
+		void AddTiming(const std::wstring& fileName, double start, double end);
+	};
+}
@@ -0,0 +1,300 @@
+﻿//--------------------------------------------------------------------------------------
+// File: BillboardBatch.cpp
+//
+// ビルボードをまとめて描画するクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "pch.h"
+#include "BillboardBatch.h"
+#include "D3DRenderStateTarget.h"
+
+using namespace DirectX;
+using namespace Imase;
+
+namespace
+{
+	// 作業用の配列で一度に頂点を作成するビルボードの数
+	const size_t BUILD_CHUNK_SIZE = 1024;
+
+	// 並べ替えた順に配列の要素を入れ替える
+	template <class T>
+	void Reorder(std::vector<T>& values, std::vector<T>& temp, const std::vector<RenderItem>& order)
+	{
+		temp.resize(values.size());
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			temp[i] = values[order[i].payload];
+		}
+		values.swap(temp);
+	}
+}
+
+static_assert(sizeof(BillboardVertex) == sizeof(VertexPositionColorTexture), "BillboardVertex layout mismatch.");
+
+// コンストラクタ
+BillboardBatch::BillboardBatch(ID3D11Device* device, int referenceAlpha, size_t maxBillboardsPerDraw)
+	: m_maxBillboardsPerDraw(std::min(std::max(maxBillboardsPerDraw, size_t(1)), size_t(MAX_BILLBOARDS_PER_DRAW)))
+	, m_camera{}
+	, m_drawCount(0)
+	, m_inBeginEndPair(false)
+	, m_depthSortEnabled(true)
+{
+	// アルファテストエフェクトの作成（頂点カラーを使用する）
+	m_effect = std::make_unique<AlphaTestEffect>(device);
+	m_effect->SetVertexColorEnabled(true);
+	m_effect->SetReferenceAlpha(referenceAlpha);
+
+	// 入力レイアウトの作成
+	DX::ThrowIfFailed(
+		CreateInputLayoutFromEffect<VertexPositionColorTexture>(
+			device, m_effect.get(), m_inputLayout.ReleaseAndGetAddressOf())
+	);
+
+	// 頂点バッファの作成
+	D3D11_BUFFER_DESC desc = {};
+	desc.ByteWidth = static_cast<UINT>(sizeof(VertexPositionColorTexture) * 4 * m_maxBillboardsPerDraw);
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+	desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	DX::ThrowIfFailed(device->CreateBuffer(&desc, nullptr, m_vertexBuffer.ReleaseAndGetAddressOf()));
+
+	// インデックスバッファの作成（並びは毎回同じなので最初に作っておく）
+	std::vector<uint16_t> indices(6 * m_maxBillboardsPerDraw);
+	BuildBillboardIndices(m_maxBillboardsPerDraw, indices.data());
+
+	desc.ByteWidth = static_cast<UINT>(sizeof(uint16_t) * indices.size());
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	desc.CPUAccessFlags = 0;
+
+	D3D11_SUBRESOURCE_DATA data = {};
+	data.pSysMem = indices.data();
+	DX::ThrowIfFailed(device->CreateBuffer(&desc, &data, m_indexBuffer.ReleaseAndGetAddressOf()));
+
+	// 頂点を作成する作業用の配列
+	m_vertices.resize(BUILD_CHUNK_SIZE * 4);
+}
+
+// デストラクタ
+BillboardBatch::~BillboardBatch()
+{
+}
+
+// 登録開始
+void BillboardBatch::Begin(
+	const SimpleMath::Matrix& view,
+	const SimpleMath::Matrix& proj,
+	const SimpleMath::Vector3& cameraPosition,
+	const SimpleMath::Vector3& cameraUp)
+{
+	if (m_inBeginEndPair)
+	{
+		throw std::logic_error("Cannot nest Begin calls on a single BillboardBatch.");
+	}
+
+	m_view = view;
+	m_proj = proj;
+
+	m_camera.position[0] = cameraPosition.x;
+	m_camera.position[1] = cameraPosition.y;
+	m_camera.position[2] = cameraPosition.z;
+
+	m_camera.up[0] = cameraUp.x;
+	m_camera.up[1] = cameraUp.y;
+	m_camera.up[2] = cameraUp.z;
+
+	// CreateBillboardでcameraForwardを省略した時と同じ向き
+	m_camera.forward[0] = 0.0f;
+	m_camera.forward[1] = 0.0f;
+	m_camera.forward[2] = 1.0f;
+
+	Clear();
+
+	m_inBeginEndPair = true;
+}
+
+// ビルボードを登録する関数
+void BillboardBatch::Add(
+	const SimpleMath::Vector3& position,
+	const SimpleMath::Vector2& size,
+	FXMVECTOR color,
+	const SimpleMath::Vector4& uv)
+{
+	if (!m_inBeginEndPair)
+	{
+		throw std::logic_error("Begin must be called before Add.");
+	}
+
+	m_positionX.push_back(position.x);
+	m_positionY.push_back(position.y);
+	m_positionZ.push_back(position.z);
+	m_width.push_back(size.x);
+	m_height.push_back(size.y);
+
+	Attribute attribute;
+	attribute.uv[0] = uv.x;
+	attribute.uv[1] = uv.y;
+	attribute.uv[2] = uv.z;
+	attribute.uv[3] = uv.w;
+	XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(attribute.color), color);
+	m_attributes.push_back(attribute);
+}
+
+// 登録されたビルボードを描画する関数
+void BillboardBatch::End(
+	ID3D11DeviceContext* context,
+	CommonStates* states,
+	ID3D11ShaderResourceView* texture,
+	IRenderStateTarget* stateTarget)
+{
+	if (!m_inBeginEndPair)
+	{
+		throw std::logic_error("Begin must be called before End.");
+	}
+
+	m_inBeginEndPair = false;
+	m_drawCount = 0;
+
+	size_t total = m_positionX.size();
+	if (total == 0) return;
+
+	// アルファブレンドが正しく重なるように奥から手前の順に並べ替える
+	if (m_depthSortEnabled)
+	{
+		SortBackToFront();
+	}
+
+	// ステートの設定先（指定がなければデバイスコンテキストに直接設定する）
+	D3DRenderStateTarget direct(context);
+	IRenderStateTarget* target = stateTarget ? stateTarget : &direct;
+
+	// 深度ステンシルバッファの設定
+	target->SetDepthStencilState(states->DepthDefault(), 0);
+
+	// ブレンドステートの設定
+	target->SetBlendState(states->AlphaBlend(), nullptr, 0xffffffff);
+
+	// カリングの設定
+	target->SetRasterizerState(states->CullNone());
+
+	// テクスチャサンプラーの設定
+	ID3D11SamplerState* samplers[] = { states->LinearClamp() };
+	target->SetPSSamplers(0, 1, samplers);
+
+	// 頂点はワールド座標で作るのでワールド行列は単位行列
+	m_effect->SetWorld(SimpleMath::Matrix::Identity);
+	m_effect->SetView(m_view);
+	m_effect->SetProjection(m_proj);
+	m_effect->SetTexture(texture);
+	m_effect->Apply(context);
+
+	// 入力レイアウトとバッファの設定
+	context->IASetInputLayout(m_inputLayout.Get());
+
+	ID3D11Buffer* vertexBuffers[] = { m_vertexBuffer.Get() };
+	UINT strides[] = { sizeof(VertexPositionColorTexture) };
+	UINT offsets[] = { 0 };
+	context->IASetVertexBuffers(0, 1, vertexBuffers, strides, offsets);
+	context->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0);
+	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	BillboardStreams streams =
+	{
+		m_positionX.data(),
+		m_positionY.data(),
+		m_positionZ.data(),
+		m_width.data(),
+		m_height.data(),
+	};
+
+	for (size_t first = 0; first < total; first += m_maxBillboardsPerDraw)
+	{
+		size_t count = std::min(total - first, m_maxBillboardsPerDraw);
+
+		D3D11_MAPPED_SUBRESOURCE mapped;
+		DX::ThrowIfFailed(context->Map(m_vertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+
+		// 頂点バッファへの書き込みは連続させたいので作業用の配列で作成してからコピーする
+		auto dest = static_cast<BillboardVertex*>(mapped.pData);
+		for (size_t chunk = 0; chunk < count; chunk += BUILD_CHUNK_SIZE)
+		{
+			size_t chunkCount = std::min(count - chunk, BUILD_CHUNK_SIZE);
+			size_t offset = first + chunk;
+
+			BillboardStreams chunkStreams =
+			{
+				streams.positionX + offset,
+				streams.positionY + offset,
+				streams.positionZ + offset,
+				streams.width + offset,
+				streams.height + offset,
+			};
+			ExpandBillboardCorners(chunkStreams, chunkCount, m_camera, m_vertices.data(), sizeof(BillboardVertex));
+
+			for (size_t i = 0; i < chunkCount; i++)
+			{
+				const Attribute& attribute = m_attributes[offset + i];
+
+				const float u[4] = { attribute.uv[0], attribute.uv[2], attribute.uv[2], attribute.uv[0] };
+				const float v[4] = { attribute.uv[1], attribute.uv[1], attribute.uv[3], attribute.uv[3] };
+
+				for (size_t j = 0; j < 4; j++)
+				{
+					BillboardVertex& vertex = m_vertices[i * 4 + j];
+					std::copy(attribute.color, attribute.color + 4, vertex.color);
+					vertex.textureCoordinate[0] = u[j];
+					vertex.textureCoordinate[1] = v[j];
+				}
+			}
+
+			std::copy(m_vertices.begin(), m_vertices.begin() + chunkCount * 4, dest + chunk * 4);
+		}
+
+		context->Unmap(m_vertexBuffer.Get(), 0);
+
+		context->DrawIndexed(static_cast<UINT>(count * 6), 0, 0);
+
+		m_drawCount++;
+	}
+
+	Clear();
+}
+
+// 登録されたビルボードを奥から手前の順に並べ替える関数
+void BillboardBatch::SortBackToFront()
+{
+	size_t total = m_positionX.size();
+
+	m_sortItems.resize(total);
+	m_sortTemp.resize(total);
+
+	for (size_t i = 0; i < total; i++)
+	{
+		// ビュー空間のZ（右手座標系なので手前ほど大きい）
+		float viewZ = m_positionX[i] * m_view._13 + m_positionY[i] * m_view._23 + m_positionZ[i] * m_view._33 + m_view._43;
+
+		m_sortItems[i].key = FloatToSortableBits(viewZ);
+		m_sortItems[i].payload = static_cast<uint32_t>(i);
+	}
+
+	RadixSortRenderItems(m_sortItems.data(), m_sortTemp.data(), total);
+
+	Reorder(m_positionX, m_sortFloats, m_sortItems);
+	Reorder(m_positionY, m_sortFloats, m_sortItems);
+	Reorder(m_positionZ, m_sortFloats, m_sortItems);
+	Reorder(m_width, m_sortFloats, m_sortItems);
+	Reorder(m_height, m_sortFloats, m_sortItems);
+	Reorder(m_attributes, m_sortAttributes, m_sortItems);
+}
+
+// 登録されたビルボードをクリアする関数（確保したメモリは次のフレームで再利用する）
+void BillboardBatch::Clear()
+{
+	m_positionX.clear();
+	m_positionY.clear();
+	m_positionZ.clear();
+	m_width.clear();
+	m_height.clear();
+	m_attributes.clear();
+}
@@ -0,0 +1,132 @@
+﻿//--------------------------------------------------------------------------------------
+// File: BillboardBatch.h
+//
+// ビルボードをまとめて描画するクラス
+//
+// Usage: Begin関数とEnd関数の間でAdd関数を呼び出してビルボードを登録します。
+//        End関数で全てのビルボードの頂点をCPUで生成し、ステートの設定は１回で
+//        できるだけ少ない描画回数で描画します。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <vector>
+#include "BillboardKernel.h"
+#include "RenderStateCache.h"
+#include "RenderQueue.h"
+
+namespace Imase
+{
+	class BillboardBatch
+	{
+	public:
+
+		// １回の描画で描画できるビルボードの最大数（16bitインデックスの上限）
+		static const size_t MAX_BILLBOARDS_PER_DRAW = 65536 / 4;
+
+		// コンストラクタ
+		BillboardBatch(
+			ID3D11Device* device,
+			int referenceAlpha = 200,
+			size_t maxBillboardsPerDraw = MAX_BILLBOARDS_PER_DRAW);
+
+		// デストラクタ
+		~BillboardBatch();
+
+		// 登録開始（cameraPositionはCreateBillboardのcameraPositionと同じ意味）
+		void Begin(
+			const DirectX::SimpleMath::Matrix& view,
+			const DirectX::SimpleMath::Matrix& proj,
+			const DirectX::SimpleMath::Vector3& cameraPosition,
+			const DirectX::SimpleMath::Vector3& cameraUp = DirectX::SimpleMath::Vector3::UnitY);
+
+		// ビルボードを登録する関数
+		void Add(
+			const DirectX::SimpleMath::Vector3& position,
+			const DirectX::SimpleMath::Vector2& size = DirectX::SimpleMath::Vector2::One,
+			DirectX::FXMVECTOR color = DirectX::Colors::White,
+			const DirectX::SimpleMath::Vector4& uv = DirectX::SimpleMath::Vector4(0.0f, 0.0f, 1.0f, 1.0f));
+
+		// 登録されたビルボードを描画する関数（stateTargetを指定するとステートはそこに設定する）
+		void End(
+			ID3D11DeviceContext* context,
+			DirectX::CommonStates* states,
+			ID3D11ShaderResourceView* texture,
+			IRenderStateTarget* stateTarget = nullptr);
+
+		// 登録されているビルボードの数を取得する関数
+		size_t GetCount() const { return m_positionX.size(); }
+
+		// 前回のEnd関数での描画回数を取得する関数
+		size_t GetDrawCount() const { return m_drawCount; }
+
+		// 奥から手前の順に並べ替えるか設定する関数（初期値は並べ替える）
+		void SetDepthSortEnabled(bool enabled) { m_depthSortEnabled = enabled; }
+
+	private:
+
+		// 登録されたビルボードをクリアする関数
+		void Clear();
+
+		// 登録されたビルボードを奥から手前の順に並べ替える関数
+		void SortBackToFront();
+
+		// アルファテストエフェクト
+		std::unique_ptr<DirectX::AlphaTestEffect> m_effect;
+
+		// 入力レイアウト
+		Microsoft::WRL::ComPtr<ID3D11InputLayout> m_inputLayout;
+
+		// 頂点バッファ（動的）
+		Microsoft::WRL::ComPtr<ID3D11Buffer> m_vertexBuffer;
+
+		// インデックスバッファ（固定）
+		Microsoft::WRL::ComPtr<ID3D11Buffer> m_indexBuffer;
+
+		// １回の描画で描画できるビルボードの最大数
+		size_t m_maxBillboardsPerDraw;
+
+		// 登録されたビルボードの位置とサイズ（SIMDでまとめて計算するので要素ごとの配列）
+		std::vector<float> m_positionX;
+		std::vector<float> m_positionY;
+		std::vector<float> m_positionZ;
+		std::vector<float> m_width;
+		std::vector<float> m_height;
+
+		// 登録されたビルボードのUV矩形と色
+		struct Attribute
+		{
+			float uv[4];
+			float color[4];
+		};
+		std::vector<Attribute> m_attributes;
+
+		// 頂点を作成する作業用の配列
+		std::vector<BillboardVertex> m_vertices;
+
+		// 並べ替え用の作業用の配列
+		std::vector<RenderItem> m_sortItems;
+		std::vector<RenderItem> m_sortTemp;
+		std::vector<float> m_sortFloats;
+		std::vector<Attribute> m_sortAttributes;
+
+		// カメラの情報
+		BillboardCamera m_camera;
+
+		// ビュー行列
+		DirectX::SimpleMath::Matrix m_view;
+
+		// 射影行列
+		DirectX::SimpleMath::Matrix m_proj;
+
+		// 描画回数
+		size_t m_drawCount;
+
+		// Begin関数が呼ばれているか
+		bool m_inBeginEndPair;
+
+		// 奥から手前の順に並べ替えるか
+		bool m_depthSortEnabled;
+	};
+}
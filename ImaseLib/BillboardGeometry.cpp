@@ -0,0 +1,127 @@
+﻿//--------------------------------------------------------------------------------------
+// File: BillboardGeometry.cpp
+//
+// ビルボードの頂点をCPUで生成する関数群
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "BillboardGeometry.h"
+
+#include <cmath>
+
+using namespace Imase;
+
+namespace
+{
+	// XMVector3Lessで比較しているイプシロン（g_XMEpsilon）
+	const float EPSILON = 1.192092896e-7f;
+
+	// 外積
+	void Cross(const float a[3], const float b[3], float out[3])
+	{
+		float x = a[1] * b[2] - a[2] * b[1];
+		float y = a[2] * b[0] - a[0] * b[2];
+		float z = a[0] * b[1] - a[1] * b[0];
+		out[0] = x;
+		out[1] = y;
+		out[2] = z;
+	}
+
+	// 正規化
+	void Normalize(float v[3])
+	{
+		float length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+		if (length > 0.0f)
+		{
+			v[0] /= length;
+			v[1] /= length;
+			v[2] /= length;
+		}
+	}
+
+	// 四角形の頂点の位置（左上、右上、右下、左下の順）
+	const float CORNER_X[4] = { -0.5f,  0.5f,  0.5f, -0.5f };
+	const float CORNER_Y[4] = {  0.5f,  0.5f, -0.5f, -0.5f };
+
+	// 四角形のインデックス
+	const uint16_t QUAD_INDICES[6] = { 0, 1, 2, 2, 3, 0 };
+}
+
+// １枚のビルボードの右方向と上方向を求める関数
+void Imase::ComputeBillboardAxes(const float object[3], const BillboardCamera& camera, float right[3], float up[3])
+{
+	float z[3] =
+	{
+		object[0] - camera.position[0],
+		object[1] - camera.position[1],
+		object[2] - camera.position[2],
+	};
+
+	if (z[0] * z[0] + z[1] * z[1] + z[2] * z[2] < EPSILON)
+	{
+		// カメラと重なっている場合は前方向の逆を使う
+		z[0] = -camera.forward[0];
+		z[1] = -camera.forward[1];
+		z[2] = -camera.forward[2];
+	}
+	else
+	{
+		Normalize(z);
+	}
+
+	Cross(camera.up, z, right);
+	Normalize(right);
+	Cross(z, right, up);
+}
+
+// ビルボードの頂点を生成する関数
+void Imase::BuildBillboardVertices(
+	const Billboard* billboards,
+	size_t count,
+	const BillboardCamera& camera,
+	BillboardVertex* vertices)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const Billboard& billboard = billboards[i];
+
+		float right[3], up[3];
+		ComputeBillboardAxes(billboard.position, camera, right, up);
+
+		// 頂点の並びに合わせたUV
+		const float u[4] = { billboard.uv[0], billboard.uv[2], billboard.uv[2], billboard.uv[0] };
+		const float v[4] = { billboard.uv[1], billboard.uv[1], billboard.uv[3], billboard.uv[3] };
+
+		for (int j = 0; j < 4; j++)
+		{
+			BillboardVertex& vertex = vertices[i * 4 + j];
+
+			float x = CORNER_X[j] * billboard.size[0];
+			float y = CORNER_Y[j] * billboard.size[1];
+
+			vertex.position[0] = billboard.position[0] + right[0] * x + up[0] * y;
+			vertex.position[1] = billboard.position[1] + right[1] * x + up[1] * y;
+			vertex.position[2] = billboard.position[2] + right[2] * x + up[2] * y;
+
+			vertex.color[0] = billboard.color[0];
+			vertex.color[1] = billboard.color[1];
+			vertex.color[2] = billboard.color[2];
+			vertex.color[3] = billboard.color[3];
+
+			vertex.textureCoordinate[0] = u[j];
+			vertex.textureCoordinate[1] = v[j];
+		}
+	}
+}
+
+// ビルボードのインデックスを生成する関数
+void Imase::BuildBillboardIndices(size_t count, uint16_t* indices)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		for (size_t j = 0; j < 6; j++)
+		{
+			indices[i * 6 + j] = static_cast<uint16_t>(i * 4 + QUAD_INDICES[j]);
+		}
+	}
+}
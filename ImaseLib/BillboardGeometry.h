@@ -0,0 +1,67 @@
+﻿//--------------------------------------------------------------------------------------
+// File: BillboardGeometry.h
+//
+// ビルボードの頂点をCPUで生成する関数群
+//
+// Usage: D3Dに依存しないので単体でビルド・検証できます。
+//        カメラ方向への向け方は SimpleMath::Matrix::CreateBillboard と同じです。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Imase
+{
+	// ビルボードの頂点（VertexPositionColorTextureと同じメモリ配置）
+	struct BillboardVertex
+	{
+		float position[3];
+		float color[4];
+		float textureCoordinate[2];
+	};
+
+	// ビルボード１枚分の情報
+	struct Billboard
+	{
+		// 位置
+		float position[3];
+
+		// サイズ（幅、高さ）
+		float size[2];
+
+		// UV矩形（左、上、右、下）
+		float uv[4];
+
+		// 色
+		float color[4];
+	};
+
+	// ビルボードを向けるカメラの情報
+	struct BillboardCamera
+	{
+		// CreateBillboardのcameraPositionと同じ意味の位置
+		float position[3];
+
+		// 上方向
+		float up[3];
+
+		// 前方向（ビルボードとカメラの位置が重なった時に使用する）
+		float forward[3];
+	};
+
+	// １枚のビルボードの右方向と上方向を求める関数（CreateBillboardの１行目と２行目）
+	void ComputeBillboardAxes(const float object[3], const BillboardCamera& camera, float right[3], float up[3]);
+
+	// ビルボードの頂点を生成する関数（１枚につき４頂点）
+	void BuildBillboardVertices(
+		const Billboard* billboards,
+		size_t count,
+		const BillboardCamera& camera,
+		BillboardVertex* vertices);
+
+	// ビルボードのインデックスを生成する関数（１枚につき６インデックス）
+	void BuildBillboardIndices(size_t count, uint16_t* indices);
+}
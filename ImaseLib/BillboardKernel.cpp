@@ -0,0 +1,278 @@
+﻿//--------------------------------------------------------------------------------------
+// File: BillboardKernel.cpp
+//
+// 大量のビルボードの頂点位置をまとめて計算する関数群
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "BillboardKernel.h"
+
+#if defined(IMASE_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+using namespace Imase;
+
+namespace
+{
+	// CreateBillboardで使われているイプシロン（g_XMEpsilon）
+	const float EPSILON = 1.192092896e-7f;
+
+	// 四角形の頂点の位置（左上、右上、右下、左下の順）
+	const float CORNER_X[4] = { -0.5f,  0.5f,  0.5f, -0.5f };
+	const float CORNER_Y[4] = {  0.5f,  0.5f, -0.5f, -0.5f };
+
+	// 頂点の位置を書き込む
+	inline void StoreCorner(void* output, size_t stride, size_t vertex, float x, float y, float z)
+	{
+		float* position = reinterpret_cast<float*>(static_cast<char*>(output) + vertex * stride);
+		position[0] = x;
+		position[1] = y;
+		position[2] = z;
+	}
+
+	// スカラー版
+	void ExpandScalar(
+		const BillboardStreams& s,
+		size_t first,
+		size_t count,
+		const BillboardCamera& camera,
+		void* output,
+		size_t stride)
+	{
+		for (size_t i = first; i < count; i++)
+		{
+			float object[3] = { s.positionX[i], s.positionY[i], s.positionZ[i] };
+
+			float right[3], up[3];
+			ComputeBillboardAxes(object, camera, right, up);
+
+			for (int j = 0; j < 4; j++)
+			{
+				float x = CORNER_X[j] * s.width[i];
+				float y = CORNER_Y[j] * s.height[i];
+
+				StoreCorner(output, stride, i * 4 + j,
+					object[0] + right[0] * x + up[0] * y,
+					object[1] + right[1] * x + up[1] * y,
+					object[2] + right[2] * x + up[2] * y);
+			}
+		}
+	}
+
+#if defined(IMASE_SIMD_X86)
+
+	// ４枚分の同じ角の位置（要素ごとのレジスタ）を頂点の並びに書き込む
+	// 作業用の配列を経由せず、XYは２つずつ並べ替えて８バイト、Zは４バイトで書き込む
+	// （位置の後ろの色を上書きしないように、１頂点で１６バイトは書き込まない）
+	inline void StoreCorners4(char* vertex, size_t laneStride, __m128 x, __m128 y, __m128 z)
+	{
+		__m128 xy01 = _mm_unpacklo_ps(x, y);
+		__m128 xy23 = _mm_unpackhi_ps(x, y);
+
+		_mm_storel_pi(reinterpret_cast<__m64*>(vertex), xy01);
+		_mm_storeh_pi(reinterpret_cast<__m64*>(vertex + laneStride), xy01);
+		_mm_storel_pi(reinterpret_cast<__m64*>(vertex + laneStride * 2), xy23);
+		_mm_storeh_pi(reinterpret_cast<__m64*>(vertex + laneStride * 3), xy23);
+
+		_mm_store_ss(reinterpret_cast<float*>(vertex + 8), z);
+		_mm_store_ss(reinterpret_cast<float*>(vertex + laneStride + 8), _mm_shuffle_ps(z, z, _MM_SHUFFLE(1, 1, 1, 1)));
+		_mm_store_ss(reinterpret_cast<float*>(vertex + laneStride * 2 + 8), _mm_movehl_ps(z, z));
+		_mm_store_ss(reinterpret_cast<float*>(vertex + laneStride * 3 + 8), _mm_shuffle_ps(z, z, _MM_SHUFFLE(3, 3, 3, 3)));
+	}
+
+	// SSE2版（４枚ずつ）
+	size_t ExpandSSE2(
+		const BillboardStreams& s,
+		size_t count,
+		const BillboardCamera& camera,
+		void* output,
+		size_t stride)
+	{
+		const __m128 cx = _mm_set1_ps(camera.position[0]);
+		const __m128 cy = _mm_set1_ps(camera.position[1]);
+		const __m128 cz = _mm_set1_ps(camera.position[2]);
+		const __m128 ux = _mm_set1_ps(camera.up[0]);
+		const __m128 uy = _mm_set1_ps(camera.up[1]);
+		const __m128 uz = _mm_set1_ps(camera.up[2]);
+		const __m128 fx = _mm_set1_ps(-camera.forward[0]);
+		const __m128 fy = _mm_set1_ps(-camera.forward[1]);
+		const __m128 fz = _mm_set1_ps(-camera.forward[2]);
+		const __m128 epsilon = _mm_set1_ps(EPSILON);
+		const __m128 zero = _mm_setzero_ps();
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 px = _mm_loadu_ps(s.positionX + i);
+			__m128 py = _mm_loadu_ps(s.positionY + i);
+			__m128 pz = _mm_loadu_ps(s.positionZ + i);
+
+			// Z軸（カメラと重なっている場合は前方向の逆）
+			__m128 zx = _mm_sub_ps(px, cx);
+			__m128 zy = _mm_sub_ps(py, cy);
+			__m128 zz = _mm_sub_ps(pz, cz);
+			__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(zx, zx), _mm_mul_ps(zy, zy)), _mm_mul_ps(zz, zz));
+			__m128 degenerate = _mm_cmplt_ps(lengthSq, epsilon);
+			__m128 length = _mm_sqrt_ps(lengthSq);
+			zx = _mm_or_ps(_mm_and_ps(degenerate, fx), _mm_andnot_ps(degenerate, _mm_div_ps(zx, length)));
+			zy = _mm_or_ps(_mm_and_ps(degenerate, fy), _mm_andnot_ps(degenerate, _mm_div_ps(zy, length)));
+			zz = _mm_or_ps(_mm_and_ps(degenerate, fz), _mm_andnot_ps(degenerate, _mm_div_ps(zz, length)));
+
+			// X軸 = up × Z
+			__m128 rx = _mm_sub_ps(_mm_mul_ps(uy, zz), _mm_mul_ps(uz, zy));
+			__m128 ry = _mm_sub_ps(_mm_mul_ps(uz, zx), _mm_mul_ps(ux, zz));
+			__m128 rz = _mm_sub_ps(_mm_mul_ps(ux, zy), _mm_mul_ps(uy, zx));
+			length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_mul_ps(rz, rz)));
+			__m128 valid = _mm_cmpgt_ps(length, zero);
+			rx = _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(rx, length)), _mm_andnot_ps(valid, rx));
+			ry = _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(ry, length)), _mm_andnot_ps(valid, ry));
+			rz = _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(rz, length)), _mm_andnot_ps(valid, rz));
+
+			// Y軸 = Z × X
+			__m128 vx = _mm_sub_ps(_mm_mul_ps(zy, rz), _mm_mul_ps(zz, ry));
+			__m128 vy = _mm_sub_ps(_mm_mul_ps(zz, rx), _mm_mul_ps(zx, rz));
+			__m128 vz = _mm_sub_ps(_mm_mul_ps(zx, ry), _mm_mul_ps(zy, rx));
+
+			__m128 w = _mm_loadu_ps(s.width + i);
+			__m128 h = _mm_loadu_ps(s.height + i);
+
+			for (int j = 0; j < 4; j++)
+			{
+				__m128 x = _mm_mul_ps(_mm_set1_ps(CORNER_X[j]), w);
+				__m128 y = _mm_mul_ps(_mm_set1_ps(CORNER_Y[j]), h);
+
+				// 頂点 (i + lane) * 4 + j に書き込む
+				StoreCorners4(static_cast<char*>(output) + (i * 4 + j) * stride, stride * 4,
+					_mm_add_ps(_mm_add_ps(px, _mm_mul_ps(rx, x)), _mm_mul_ps(vx, y)),
+					_mm_add_ps(_mm_add_ps(py, _mm_mul_ps(ry, x)), _mm_mul_ps(vy, y)),
+					_mm_add_ps(_mm_add_ps(pz, _mm_mul_ps(rz, x)), _mm_mul_ps(vz, y)));
+			}
+		}
+
+		return i;
+	}
+
+	// AVX2版（８枚ずつ）
+	IMASE_TARGET_AVX2
+	size_t ExpandAVX2(
+		const BillboardStreams& s,
+		size_t count,
+		const BillboardCamera& camera,
+		void* output,
+		size_t stride)
+	{
+		const __m256 cx = _mm256_set1_ps(camera.position[0]);
+		const __m256 cy = _mm256_set1_ps(camera.position[1]);
+		const __m256 cz = _mm256_set1_ps(camera.position[2]);
+		const __m256 ux = _mm256_set1_ps(camera.up[0]);
+		const __m256 uy = _mm256_set1_ps(camera.up[1]);
+		const __m256 uz = _mm256_set1_ps(camera.up[2]);
+		const __m256 fx = _mm256_set1_ps(-camera.forward[0]);
+		const __m256 fy = _mm256_set1_ps(-camera.forward[1]);
+		const __m256 fz = _mm256_set1_ps(-camera.forward[2]);
+		const __m256 epsilon = _mm256_set1_ps(EPSILON);
+		const __m256 zero = _mm256_setzero_ps();
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 px = _mm256_loadu_ps(s.positionX + i);
+			__m256 py = _mm256_loadu_ps(s.positionY + i);
+			__m256 pz = _mm256_loadu_ps(s.positionZ + i);
+
+			// Z軸（カメラと重なっている場合は前方向の逆）
+			__m256 zx = _mm256_sub_ps(px, cx);
+			__m256 zy = _mm256_sub_ps(py, cy);
+			__m256 zz = _mm256_sub_ps(pz, cz);
+			__m256 lengthSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(zx, zx), _mm256_mul_ps(zy, zy)), _mm256_mul_ps(zz, zz));
+			__m256 degenerate = _mm256_cmp_ps(lengthSq, epsilon, _CMP_LT_OQ);
+			__m256 length = _mm256_sqrt_ps(lengthSq);
+			zx = _mm256_blendv_ps(_mm256_div_ps(zx, length), fx, degenerate);
+			zy = _mm256_blendv_ps(_mm256_div_ps(zy, length), fy, degenerate);
+			zz = _mm256_blendv_ps(_mm256_div_ps(zz, length), fz, degenerate);
+
+			// X軸 = up × Z
+			__m256 rx = _mm256_sub_ps(_mm256_mul_ps(uy, zz), _mm256_mul_ps(uz, zy));
+			__m256 ry = _mm256_sub_ps(_mm256_mul_ps(uz, zx), _mm256_mul_ps(ux, zz));
+			__m256 rz = _mm256_sub_ps(_mm256_mul_ps(ux, zy), _mm256_mul_ps(uy, zx));
+			length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(rx, rx), _mm256_mul_ps(ry, ry)), _mm256_mul_ps(rz, rz)));
+			__m256 valid = _mm256_cmp_ps(length, zero, _CMP_GT_OQ);
+			rx = _mm256_blendv_ps(rx, _mm256_div_ps(rx, length), valid);
+			ry = _mm256_blendv_ps(ry, _mm256_div_ps(ry, length), valid);
+			rz = _mm256_blendv_ps(rz, _mm256_div_ps(rz, length), valid);
+
+			// Y軸 = Z × X
+			__m256 vx = _mm256_sub_ps(_mm256_mul_ps(zy, rz), _mm256_mul_ps(zz, ry));
+			__m256 vy = _mm256_sub_ps(_mm256_mul_ps(zz, rx), _mm256_mul_ps(zx, rz));
+			__m256 vz = _mm256_sub_ps(_mm256_mul_ps(zx, ry), _mm256_mul_ps(zy, rx));
+
+			__m256 w = _mm256_loadu_ps(s.width + i);
+			__m256 h = _mm256_loadu_ps(s.height + i);
+
+			for (int j = 0; j < 4; j++)
+			{
+				__m256 x = _mm256_mul_ps(_mm256_set1_ps(CORNER_X[j]), w);
+				__m256 y = _mm256_mul_ps(_mm256_set1_ps(CORNER_Y[j]), h);
+
+				__m256 cornerX = _mm256_add_ps(_mm256_add_ps(px, _mm256_mul_ps(rx, x)), _mm256_mul_ps(vx, y));
+				__m256 cornerY = _mm256_add_ps(_mm256_add_ps(py, _mm256_mul_ps(ry, x)), _mm256_mul_ps(vy, y));
+				__m256 cornerZ = _mm256_add_ps(_mm256_add_ps(pz, _mm256_mul_ps(rz, x)), _mm256_mul_ps(vz, y));
+
+				// 前半の４枚と後半の４枚に分けて書き込む
+				char* vertex = static_cast<char*>(output) + (i * 4 + j) * stride;
+				StoreCorners4(vertex, stride * 4,
+					_mm256_castps256_ps128(cornerX), _mm256_castps256_ps128(cornerY), _mm256_castps256_ps128(cornerZ));
+				StoreCorners4(vertex + stride * 16, stride * 4,
+					_mm256_extractf128_ps(cornerX, 1), _mm256_extractf128_ps(cornerY, 1), _mm256_extractf128_ps(cornerZ, 1));
+			}
+		}
+
+		return i;
+	}
+
+#endif
+}
+
+// ビルボードの４頂点の位置を計算する関数
+void Imase::ExpandBillboardCorners(
+	const BillboardStreams& streams,
+	size_t count,
+	const BillboardCamera& camera,
+	void* output,
+	size_t stride)
+{
+	ExpandBillboardCorners(streams, count, camera, output, stride, GetSimdLevel());
+}
+
+// 命令セットを指定して計算する関数
+void Imase::ExpandBillboardCorners(
+	const BillboardStreams& streams,
+	size_t count,
+	const BillboardCamera& camera,
+	void* output,
+	size_t stride,
+	SimdLevel level)
+{
+	// CPUが対応していない命令セットは使わない
+	if (level > GetSimdLevel()) level = GetSimdLevel();
+
+	size_t done = 0;
+
+#if defined(IMASE_SIMD_X86)
+	switch (level)
+	{
+	case SimdLevel::AVX2:
+		done = ExpandAVX2(streams, count, camera, output, stride);
+		break;
+	case SimdLevel::SSE2:
+		done = ExpandSSE2(streams, count, camera, output, stride);
+		break;
+	default:
+		break;
+	}
+#endif
+
+	// 残りはスカラーで計算する
+	ExpandScalar(streams, done, count, camera, output, stride);
+}
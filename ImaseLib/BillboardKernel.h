@@ -0,0 +1,47 @@
+﻿//--------------------------------------------------------------------------------------
+// File: BillboardKernel.h
+//
+// 大量のビルボードの頂点位置をまとめて計算する関数群
+//
+// Usage: 位置とサイズを要素ごとの配列（SoA）で渡すと、１枚につき４頂点の位置を
+//        出力先に書き込みます。SSE2/AVX2は実行時にCPUを調べて切り替えます。
+//        結果は BuildBillboardVertices（CreateBillboardと同じ計算）と一致します。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include "BillboardGeometry.h"
+#include "CpuFeatures.h"
+
+namespace Imase
+{
+	// ビルボードの入力（要素ごとの配列）
+	struct BillboardStreams
+	{
+		const float* positionX;
+		const float* positionY;
+		const float* positionZ;
+		const float* width;
+		const float* height;
+	};
+
+	// ビルボードの４頂点の位置を計算する関数
+	// 頂点 i * 4 + j（左上、右上、右下、左下）の位置を output + (i * 4 + j) * stride バイトに書き込む
+	void ExpandBillboardCorners(
+		const BillboardStreams& streams,
+		size_t count,
+		const BillboardCamera& camera,
+		void* output,
+		size_t stride);
+
+	// 命令セットを指定して計算する関数（速度の比較用）
+	void ExpandBillboardCorners(
+		const BillboardStreams& streams,
+		size_t count,
+		const BillboardCamera& camera,
+		void* output,
+		size_t stride,
+		SimdLevel level);
+}
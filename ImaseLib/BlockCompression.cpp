@@ -0,0 +1,747 @@
+﻿//--------------------------------------------------------------------------------------
+// File: BlockCompression.cpp
+//
+// 4x4ピクセルのブロックをBC1、BC3、BC4形式に圧縮・展開する関数群
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#if defined(IMASE_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+using namespace Imase;
+
+namespace
+{
+	// ブロックのピクセル数
+	const int PIXEL_COUNT = 16;
+
+	// パレットの最大の数
+	const int MAX_PALETTE = 8;
+
+	// 主成分の方向を求める反復の回数
+	const int POWER_ITERATIONS = 8;
+
+	// 最小二乗法で端点を求め直す回数
+	const int NORMAL_REFINE_ITERATIONS = 2;
+	const int HIGH_REFINE_ITERATIONS = 4;
+
+	// Highで端点の近くを探す回数の上限と、BC4で探す範囲
+	const int HIGH_SEARCH_PASSES = 8;
+	const int HIGH_BC4_SEARCH_RADIUS = 3;
+
+	// 色のブロックの圧縮方法
+	enum class ColorMode
+	{
+		// BC1の4色（color0 > color1）
+		Opaque,
+
+		// BC1の3色と透明（color0 <= color1）
+		PunchThrough,
+
+		// BC3の色（常に4色なので端点の順番は問わない）
+		AlwaysFourColors,
+	};
+
+	// 色のブロック（チャンネルごとの配列）
+	struct ColorBlock
+	{
+		float channel[3][PIXEL_COUNT];
+
+		// 誤差の重み（透明なピクセルは0）
+		float weight[PIXEL_COUNT];
+
+		// 透明なピクセル
+		bool transparent[PIXEL_COUNT];
+	};
+
+	// 色の端点（0～255）
+	struct ColorEndpoints
+	{
+		float color[2][3];
+	};
+
+	// 圧縮した色の候補
+	struct ColorCandidate
+	{
+		uint16_t color0;
+		uint16_t color1;
+		uint8_t indices[PIXEL_COUNT];
+		float error;
+	};
+
+	//----------------------------------------------------------------------------------
+	// パレットから最も近い値を選ぶ（誤差は全て整数なので、どの命令セットでも結果は同じ）
+	//----------------------------------------------------------------------------------
+
+	// パレットの値（チャンネルごと、使わないチャンネルは0）
+	struct Palette
+	{
+		float value[MAX_PALETTE][3];
+		int count;
+	};
+
+	// ピクセルごとの最小の誤差を重みを掛けて合計する
+	float SumError(const float* distance, const float* weight)
+	{
+		float error = 0.0f;
+		for (int i = 0; i < PIXEL_COUNT; i++) error += distance[i] * weight[i];
+		return error;
+	}
+
+	// スカラー版
+	float FindNearestScalar(const float* const* channel, int channelCount, const Palette& palette,
+		const float* weight, uint8_t* indices)
+	{
+		float distance[PIXEL_COUNT];
+		for (int i = 0; i < PIXEL_COUNT; i++)
+		{
+			float best = FLT_MAX;
+			int bestIndex = 0;
+			for (int p = 0; p < palette.count; p++)
+			{
+				float d = 0.0f;
+				for (int c = 0; c < channelCount; c++)
+				{
+					float t = channel[c][i] - palette.value[p][c];
+					d += t * t;
+				}
+				if (d < best)
+				{
+					best = d;
+					bestIndex = p;
+				}
+			}
+			distance[i] = best;
+			indices[i] = static_cast<uint8_t>(bestIndex);
+		}
+		return SumError(distance, weight);
+	}
+
+#if defined(IMASE_SIMD_X86)
+
+	// SSE2版（４ピクセルずつ）
+	float FindNearestSSE2(const float* const* channel, int channelCount, const Palette& palette,
+		const float* weight, uint8_t* indices)
+	{
+		alignas(16) float distance[PIXEL_COUNT];
+		alignas(16) int32_t index[PIXEL_COUNT];
+		for (int i = 0; i < PIXEL_COUNT; i += 4)
+		{
+			__m128 x[3];
+			for (int c = 0; c < channelCount; c++) x[c] = _mm_loadu_ps(channel[c] + i);
+
+			__m128 best = _mm_set1_ps(FLT_MAX);
+			__m128i bestIndex = _mm_setzero_si128();
+			for (int p = 0; p < palette.count; p++)
+			{
+				__m128 d = _mm_setzero_ps();
+				for (int c = 0; c < channelCount; c++)
+				{
+					__m128 t = _mm_sub_ps(x[c], _mm_set1_ps(palette.value[p][c]));
+					d = _mm_add_ps(d, _mm_mul_ps(t, t));
+				}
+				__m128i less = _mm_castps_si128(_mm_cmplt_ps(d, best));
+				best = _mm_min_ps(d, best);
+				bestIndex = _mm_or_si128(_mm_and_si128(less, _mm_set1_epi32(p)), _mm_andnot_si128(less, bestIndex));
+			}
+			_mm_store_ps(distance + i, best);
+			_mm_store_si128(reinterpret_cast<__m128i*>(index + i), bestIndex);
+		}
+
+		for (int i = 0; i < PIXEL_COUNT; i++) indices[i] = static_cast<uint8_t>(index[i]);
+		return SumError(distance, weight);
+	}
+
+	// AVX2版（８ピクセルずつ）
+	IMASE_TARGET_AVX2
+	float FindNearestAVX2(const float* const* channel, int channelCount, const Palette& palette,
+		const float* weight, uint8_t* indices)
+	{
+		alignas(32) float distance[PIXEL_COUNT];
+		alignas(32) int32_t index[PIXEL_COUNT];
+		for (int i = 0; i < PIXEL_COUNT; i += 8)
+		{
+			__m256 x[3];
+			for (int c = 0; c < channelCount; c++) x[c] = _mm256_loadu_ps(channel[c] + i);
+
+			__m256 best = _mm256_set1_ps(FLT_MAX);
+			__m256i bestIndex = _mm256_setzero_si256();
+			for (int p = 0; p < palette.count; p++)
+			{
+				__m256 d = _mm256_setzero_ps();
+				for (int c = 0; c < channelCount; c++)
+				{
+					__m256 t = _mm256_sub_ps(x[c], _mm256_set1_ps(palette.value[p][c]));
+					d = _mm256_add_ps(d, _mm256_mul_ps(t, t));
+				}
+				__m256 less = _mm256_cmp_ps(d, best, _CMP_LT_OQ);
+				best = _mm256_min_ps(d, best);
+				bestIndex = _mm256_blendv_epi8(bestIndex, _mm256_set1_epi32(p), _mm256_castps_si256(less));
+			}
+			_mm256_store_ps(distance + i, best);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(index + i), bestIndex);
+		}
+
+		for (int i = 0; i < PIXEL_COUNT; i++) indices[i] = static_cast<uint8_t>(index[i]);
+		return SumError(distance, weight);
+	}
+
+#endif
+
+	// 命令セットを切り替えて最も近い値を選ぶ
+	float FindNearest(const float* const* channel, int channelCount, const Palette& palette,
+		const float* weight, uint8_t* indices, SimdLevel level)
+	{
+#if defined(IMASE_SIMD_X86)
+		switch (level)
+		{
+		case SimdLevel::AVX2:
+			return FindNearestAVX2(channel, channelCount, palette, weight, indices);
+		case SimdLevel::SSE2:
+			return FindNearestSSE2(channel, channelCount, palette, weight, indices);
+		default:
+			break;
+		}
+#else
+		(void)level;
+#endif
+		return FindNearestScalar(channel, channelCount, palette, weight, indices);
+	}
+
+	//----------------------------------------------------------------------------------
+	// 色（BC1とBC3の色のブロック）
+	//----------------------------------------------------------------------------------
+
+	// 565の色を8ビットに展開する
+	void ExpandColor(uint16_t color, int* rgb)
+	{
+		int r = (color >> 11) & 31;
+		int g = (color >> 5) & 63;
+		int b = color & 31;
+		rgb[0] = (r << 3) | (r >> 2);
+		rgb[1] = (g << 2) | (g >> 4);
+		rgb[2] = (b << 3) | (b >> 2);
+	}
+
+	// 8ビットの色（0～255の実数）を565にする
+	uint16_t QuantizeColor(const float* rgb)
+	{
+		int r = static_cast<int>(std::lround(std::min(std::max(rgb[0], 0.0f), 255.0f) * 31.0f / 255.0f));
+		int g = static_cast<int>(std::lround(std::min(std::max(rgb[1], 0.0f), 255.0f) * 63.0f / 255.0f));
+		int b = static_cast<int>(std::lround(std::min(std::max(rgb[2], 0.0f), 255.0f) * 31.0f / 255.0f));
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	// 色のパレットを作る（展開と同じ計算）
+	int MakeColorPalette(uint16_t color0, uint16_t color1, bool fourColors, int (*rgb)[3])
+	{
+		ExpandColor(color0, rgb[0]);
+		ExpandColor(color1, rgb[1]);
+		for (int c = 0; c < 3; c++)
+		{
+			if (fourColors)
+			{
+				rgb[2][c] = (2 * rgb[0][c] + rgb[1][c] + 1) / 3;
+				rgb[3][c] = (rgb[0][c] + 2 * rgb[1][c] + 1) / 3;
+			}
+			else
+			{
+				rgb[2][c] = (rgb[0][c] + rgb[1][c] + 1) / 2;
+				rgb[3][c] = 0;
+			}
+		}
+		return fourColors ? 4 : 3;
+	}
+
+	// 端点の組み合わせを評価する（indicesは書き出す順番で返す）
+	void EvaluateColor(const ColorBlock& block, ColorMode mode, uint16_t color0, uint16_t color1,
+		SimdLevel level, ColorCandidate& result)
+	{
+		// BC1の4色はcolor0 > color1、3色はcolor0 <= color1で書き出す
+		bool swap = (mode == ColorMode::Opaque && color0 < color1) || (mode == ColorMode::PunchThrough && color0 > color1);
+		if (swap) std::swap(color0, color1);
+
+		int rgb[4][3];
+		Palette palette;
+		palette.count = MakeColorPalette(color0, color1, mode != ColorMode::PunchThrough, rgb);
+
+		// BC1の4色で端点が同じ時は3色のモードになってしまうので、最初の色だけを使う
+		if (mode == ColorMode::Opaque && color0 == color1) palette.count = 1;
+
+		for (int p = 0; p < palette.count; p++)
+		{
+			for (int c = 0; c < 3; c++) palette.value[p][c] = static_cast<float>(rgb[p][c]);
+		}
+
+		const float* channel[3] = { block.channel[0], block.channel[1], block.channel[2] };
+		result.color0 = color0;
+		result.color1 = color1;
+		result.error = FindNearest(channel, 3, palette, block.weight, result.indices, level);
+
+		// 透明なピクセルは3番（透明な黒）
+		if (mode == ColorMode::PunchThrough)
+		{
+			for (int i = 0; i < PIXEL_COUNT; i++)
+			{
+				if (block.transparent[i]) result.indices[i] = 3;
+			}
+		}
+	}
+
+	// 端点を評価して良ければ結果を置き換える
+	bool TryColor(const ColorBlock& block, ColorMode mode, uint16_t color0, uint16_t color1,
+		SimdLevel level, ColorCandidate& best)
+	{
+		ColorCandidate candidate;
+		EvaluateColor(block, mode, color0, color1, level, candidate);
+		if (candidate.error >= best.error) return false;
+
+		best = candidate;
+		return true;
+	}
+
+	// 範囲から端点を求める（Fast）
+	ColorEndpoints GetBoundingBoxEndpoints(const ColorBlock& block)
+	{
+		float minimum[3] = { 255.0f, 255.0f, 255.0f };
+		float maximum[3] = { 0.0f, 0.0f, 0.0f };
+		float mean[3] = { 0.0f, 0.0f, 0.0f };
+		float total = 0.0f;
+		for (int i = 0; i < PIXEL_COUNT; i++)
+		{
+			if (block.weight[i] == 0.0f) continue;
+			for (int c = 0; c < 3; c++)
+			{
+				minimum[c] = std::min(minimum[c], block.channel[c][i]);
+				maximum[c] = std::max(maximum[c], block.channel[c][i]);
+				mean[c] += block.channel[c][i];
+			}
+			total += 1.0f;
+		}
+		for (int c = 0; c < 3; c++) mean[c] /= std::max(total, 1.0f);
+
+		// 範囲の最も広いチャンネルと逆に変化するチャンネルは端点を入れ替える
+		int major = 0;
+		for (int c = 1; c < 3; c++)
+		{
+			if (maximum[c] - minimum[c] > maximum[major] - minimum[major]) major = c;
+		}
+		ColorEndpoints endpoints;
+		for (int c = 0; c < 3; c++)
+		{
+			float covariance = 0.0f;
+			for (int i = 0; i < PIXEL_COUNT; i++)
+			{
+				covariance += block.weight[i] * (block.channel[major][i] - mean[major]) * (block.channel[c][i] - mean[c]);
+			}
+
+			// 少し内側に寄せると平均の誤差が小さくなる
+			float inset = (maximum[c] - minimum[c]) / 16.0f;
+			float high = maximum[c] - inset;
+			float low = minimum[c] + inset;
+			endpoints.color[0][c] = covariance < 0.0f ? low : high;
+			endpoints.color[1][c] = covariance < 0.0f ? high : low;
+		}
+		return endpoints;
+	}
+
+	// 主成分の方向の両端から端点を求める（Normal、High）
+	ColorEndpoints GetPrincipalAxisEndpoints(const ColorBlock& block)
+	{
+		float mean[3] = { 0.0f, 0.0f, 0.0f };
+		float total = 0.0f;
+		for (int i = 0; i < PIXEL_COUNT; i++)
+		{
+			for (int c = 0; c < 3; c++) mean[c] += block.weight[i] * block.channel[c][i];
+			total += block.weight[i];
+		}
+		for (int c = 0; c < 3; c++) mean[c] /= std::max(total, 1.0f);
+
+		// 共分散行列
+		float covariance[3][3] = {};
+		for (int i = 0; i < PIXEL_COUNT; i++)
+		{
+			float d[3];
+			for (int c = 0; c < 3; c++) d[c] = block.channel[c][i] - mean[c];
+			for (int a = 0; a < 3; a++)
+			{
+				for (int b = 0; b < 3; b++) covariance[a][b] += block.weight[i] * d[a] * d[b];
+			}
+		}
+
+		// べき乗法で最大の固有ベクトルを求める（最初は対角の大きい方向）
+		float axis[3] = { covariance[0][0], covariance[1][1], covariance[2][2] };
+		for (int iteration = 0; iteration < POWER_ITERATIONS; iteration++)
+		{
+			float next[3];
+			for (int a = 0; a < 3; a++)
+			{
+				next[a] = covariance[a][0] * axis[0] + covariance[a][1] * axis[1] + covariance[a][2] * axis[2];
+			}
+			float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+			if (length < 1e-6f) break;
+			for (int a = 0; a < 3; a++) axis[a] = next[a] / length;
+		}
+		float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+		if (length < 1e-6f)
+		{
+			axis[0] = axis[1] = axis[2] = 0.57735027f;
+		}
+		else
+		{
+			for (int a = 0; a < 3; a++) axis[a] /= length;
+		}
+
+		// 方向に投影した両端
+		float minimum = FLT_MAX;
+		float maximum = -FLT_MAX;
+		for (int i = 0; i < PIXEL_COUNT; i++)
+		{
+			if (block.weight[i] == 0.0f) continue;
+			float t = 0.0f;
+			for (int c = 0; c < 3; c++) t += (block.channel[c][i] - mean[c]) * axis[c];
+			minimum = std::min(minimum, t);
+			maximum = std::max(maximum, t);
+		}
+		if (minimum > maximum) minimum = maximum = 0.0f;
+
+		ColorEndpoints endpoints;
+		for (int c = 0; c < 3; c++)
+		{
+			endpoints.color[0][c] = mean[c] + axis[c] * maximum;
+			endpoints.color[1][c] = mean[c] + axis[c] * minimum;
+		}
+		return endpoints;
+	}
+
+	// インデックスを固定して端点を最小二乗法で求め直す（解けない時はfalse）
+	bool RefineColorEndpoints(const ColorBlock& block, ColorMode mode, const ColorCandidate& candidate, ColorEndpoints& endpoints)
+	{
+		// インデックスごとのcolor0の割合（書き出す順番のインデックス）
+		static const float FOUR_COLOR_WEIGHT[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+		static const float THREE_COLOR_WEIGHT[4] = { 1.0f, 0.0f, 0.5f, 0.0f };
+		const float* indexWeight = mode == ColorMode::PunchThrough ? THREE_COLOR_WEIGHT : FOUR_COLOR_WEIGHT;
+
+		float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+		float ax[3] = {}, bx[3] = {};
+		for (int i = 0; i < PIXEL_COUNT; i++)
+		{
+			if (block.weight[i] == 0.0f) continue;
+
+			float a = indexWeight[candidate.indices[i]];
+			float b = 1.0f - a;
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+			for (int c = 0; c < 3; c++)
+			{
+				ax[c] += a * block.channel[c][i];
+				bx[c] += b * block.channel[c][i];
+			}
+		}
+
+		float determinant = aa * bb - ab * ab;
+		if (std::fabs(determinant) < 1e-6f) return false;
+
+		for (int c = 0; c < 3; c++)
+		{
+			endpoints.color[0][c] = (ax[c] * bb - bx[c] * ab) / determinant;
+			endpoints.color[1][c] = (bx[c] * aa - ax[c] * ab) / determinant;
+		}
+		return true;
+	}
+
+	// 565の色の1つの成分を1段階動かす（動かせない時はfalse）
+	bool StepColor(uint16_t color, int component, int step, uint16_t& result)
+	{
+		static const int SHIFT[3] = { 11, 5, 0 };
+		static const int MAXIMUM[3] = { 31, 63, 31 };
+
+		int value = ((color >> SHIFT[component]) & MAXIMUM[component]) + step;
+		if (value < 0 || value > MAXIMUM[component]) return false;
+
+		result = static_cast<uint16_t>((color & ~(MAXIMUM[component] << SHIFT[component])) | (value << SHIFT[component]));
+		return true;
+	}
+
+	// 色のブロックを圧縮する
+	void EncodeColorBlock(const ColorBlock& block, ColorMode mode, BcQuality quality, SimdLevel level, uint8_t* output)
+	{
+		ColorCandidate best;
+		best.error = FLT_MAX;
+
+		ColorEndpoints endpoints = quality == BcQuality::Fast ? GetBoundingBoxEndpoints(block) : GetPrincipalAxisEndpoints(block);
+		TryColor(block, mode, QuantizeColor(endpoints.color[0]), QuantizeColor(endpoints.color[1]), level, best);
+
+		// 最小二乗法で端点を求め直す
+		int refineIterations = quality == BcQuality::High ? HIGH_REFINE_ITERATIONS
+			: quality == BcQuality::Normal ? NORMAL_REFINE_ITERATIONS : 0;
+		for (int iteration = 0; iteration < refineIterations && best.error > 0.0f; iteration++)
+		{
+			ColorEndpoints refined;
+			if (!RefineColorEndpoints(block, mode, best, refined)) break;
+			if (!TryColor(block, mode, QuantizeColor(refined.color[0]), QuantizeColor(refined.color[1]), level, best)) break;
+		}
+
+		// 端点の各成分を1段階ずつ動かして良くなる間は続ける
+		if (quality == BcQuality::High)
+		{
+			for (int pass = 0; pass < HIGH_SEARCH_PASSES && best.error > 0.0f; pass++)
+			{
+				bool improved = false;
+				for (int endpoint = 0; endpoint < 2; endpoint++)
+				{
+					for (int component = 0; component < 3; component++)
+					{
+						for (int step = -1; step <= 1; step += 2)
+						{
+							uint16_t color0 = best.color0;
+							uint16_t color1 = best.color1;
+							uint16_t& target = endpoint == 0 ? color0 : color1;
+							if (!StepColor(target, component, step, target)) continue;
+							improved |= TryColor(block, mode, color0, color1, level, best);
+						}
+					}
+				}
+				if (!improved) break;
+			}
+		}
+
+		uint32_t indices = 0;
+		for (int i = 0; i < PIXEL_COUNT; i++) indices |= static_cast<uint32_t>(best.indices[i]) << (i * 2);
+
+		output[0] = static_cast<uint8_t>(best.color0);
+		output[1] = static_cast<uint8_t>(best.color0 >> 8);
+		output[2] = static_cast<uint8_t>(best.color1);
+		output[3] = static_cast<uint8_t>(best.color1 >> 8);
+		std::memcpy(output + 4, &indices, sizeof(indices));
+	}
+
+	// RGBAのピクセルから色のブロックを作る（透明なピクセルがあればtrue）
+	bool MakeColorBlock(const uint8_t* rgba, bool punchThrough, ColorBlock& block)
+	{
+		bool hasTransparent = false;
+		for (int i = 0; i < PIXEL_COUNT; i++)
+		{
+			for (int c = 0; c < 3; c++) block.channel[c][i] = rgba[i * 4 + c];
+			block.transparent[i] = punchThrough && rgba[i * 4 + 3] < BC1_ALPHA_THRESHOLD;
+			block.weight[i] = block.transparent[i] ? 0.0f : 1.0f;
+			hasTransparent |= block.transparent[i];
+		}
+		return hasTransparent;
+	}
+
+	// 色のブロックを展開する
+	void DecodeColorBlock(const uint8_t* input, bool alwaysFourColors, uint8_t* rgba)
+	{
+		uint16_t color0 = static_cast<uint16_t>(input[0] | (input[1] << 8));
+		uint16_t color1 = static_cast<uint16_t>(input[2] | (input[3] << 8));
+		uint32_t indices;
+		std::memcpy(&indices, input + 4, sizeof(indices));
+
+		bool fourColors = alwaysFourColors || color0 > color1;
+		int rgb[4][3];
+		MakeColorPalette(color0, color1, fourColors, rgb);
+
+		for (int i = 0; i < PIXEL_COUNT; i++)
+		{
+			int index = (indices >> (i * 2)) & 3;
+			for (int c = 0; c < 3; c++) rgba[i * 4 + c] = static_cast<uint8_t>(rgb[index][c]);
+			rgba[i * 4 + 3] = (!fourColors && index == 3) ? 0 : 255;
+		}
+	}
+
+	//----------------------------------------------------------------------------------
+	// 1チャンネルの値（BC4とBC3のアルファ）
+	//----------------------------------------------------------------------------------
+
+	// 値のパレットを作る（展開と同じ計算）
+	void MakeValuePalette(int value0, int value1, int* values)
+	{
+		values[0] = value0;
+		values[1] = value1;
+		if (value0 > value1)
+		{
+			for (int k = 2; k < 8; k++) values[k] = ((8 - k) * value0 + (k - 1) * value1 + 3) / 7;
+		}
+		else
+		{
+			for (int k = 2; k < 6; k++) values[k] = ((6 - k) * value0 + (k - 1) * value1 + 2) / 5;
+			values[6] = 0;
+			values[7] = 255;
+		}
+	}
+
+	// 値の候補
+	struct ValueCandidate
+	{
+		int value0;
+		int value1;
+		uint8_t indices[PIXEL_COUNT];
+		float error;
+	};
+
+	// 端点の組み合わせを評価して良ければ結果を置き換える
+	bool TryValues(const float* values, int value0, int value1, SimdLevel level, ValueCandidate& best)
+	{
+		static const float WEIGHT[PIXEL_COUNT] = {
+			1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+
+		int palette[8];
+		MakeValuePalette(value0, value1, palette);
+
+		Palette table = {};
+		table.count = 8;
+		for (int p = 0; p < 8; p++) table.value[p][0] = static_cast<float>(palette[p]);
+
+		ValueCandidate candidate;
+		candidate.value0 = value0;
+		candidate.value1 = value1;
+		candidate.error = FindNearest(&values, 1, table, WEIGHT, candidate.indices, level);
+		if (candidate.error >= best.error) return false;
+
+		best = candidate;
+		return true;
+	}
+
+	// 1チャンネルのブロックを圧縮する
+	void EncodeValueBlock(const uint8_t* source, size_t stride, BcQuality quality, SimdLevel level, uint8_t* output)
+	{
+		float values[PIXEL_COUNT];
+		int minimum = 255, maximum = 0;
+		int innerMinimum = 255, innerMaximum = 0;
+		for (int i = 0; i < PIXEL_COUNT; i++)
+		{
+			int value = source[i * stride];
+			values[i] = static_cast<float>(value);
+			minimum = std::min(minimum, value);
+			maximum = std::max(maximum, value);
+
+			// 6段階のモードでは0と255はパレットにあるので範囲から除く
+			if (value != 0 && value != 255)
+			{
+				innerMinimum = std::min(innerMinimum, value);
+				innerMaximum = std::max(innerMaximum, value);
+			}
+		}
+		if (innerMinimum > innerMaximum) innerMinimum = innerMaximum = 0;
+
+		ValueCandidate best;
+		best.error = FLT_MAX;
+
+		// 8段階（value0 > value1）と6段階と0、255（value0 <= value1）のモード
+		TryValues(values, maximum, minimum, level, best);
+		if (quality != BcQuality::Fast && best.error > 0.0f)
+		{
+			TryValues(values, innerMinimum, innerMaximum, level, best);
+		}
+
+		// 端点の近くを全て試す
+		if (quality == BcQuality::High && best.error > 0.0f)
+		{
+			for (int d0 = -HIGH_BC4_SEARCH_RADIUS; d0 <= HIGH_BC4_SEARCH_RADIUS; d0++)
+			{
+				for (int d1 = -HIGH_BC4_SEARCH_RADIUS; d1 <= HIGH_BC4_SEARCH_RADIUS; d1++)
+				{
+					int high = maximum + d0, low = minimum + d1;
+					if (high > low && high <= 255 && low >= 0) TryValues(values, high, low, level, best);
+
+					int innerLow = innerMinimum + d0, innerHigh = innerMaximum + d1;
+					if (innerLow <= innerHigh && innerLow >= 0 && innerHigh <= 255) TryValues(values, innerLow, innerHigh, level, best);
+				}
+			}
+		}
+
+		output[0] = static_cast<uint8_t>(best.value0);
+		output[1] = static_cast<uint8_t>(best.value1);
+		uint64_t indices = 0;
+		for (int i = 0; i < PIXEL_COUNT; i++) indices |= static_cast<uint64_t>(best.indices[i]) << (i * 3);
+		for (int i = 0; i < 6; i++) output[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+	}
+
+	// 1チャンネルのブロックを展開する
+	void DecodeValueBlock(const uint8_t* input, uint8_t* destination, size_t stride)
+	{
+		int palette[8];
+		MakeValuePalette(input[0], input[1], palette);
+
+		uint64_t indices = 0;
+		for (int i = 0; i < 6; i++) indices |= static_cast<uint64_t>(input[2 + i]) << (i * 8);
+
+		for (int i = 0; i < PIXEL_COUNT; i++)
+		{
+			destination[i * stride] = static_cast<uint8_t>(palette[(indices >> (i * 3)) & 7]);
+		}
+	}
+
+	// CPUが対応していない命令セットは使わない
+	SimdLevel LimitSimdLevel(SimdLevel level)
+	{
+		return level > GetSimdLevel() ? GetSimdLevel() : level;
+	}
+}
+
+// BC1に圧縮する関数
+void Imase::EncodeBC1Block(const uint8_t* rgba, uint8_t* block, BcQuality quality)
+{
+	EncodeBC1Block(rgba, block, quality, GetSimdLevel());
+}
+
+void Imase::EncodeBC1Block(const uint8_t* rgba, uint8_t* block, BcQuality quality, SimdLevel level)
+{
+	ColorBlock colors;
+	bool punchThrough = MakeColorBlock(rgba, true, colors);
+	EncodeColorBlock(colors, punchThrough ? ColorMode::PunchThrough : ColorMode::Opaque, quality, LimitSimdLevel(level), block);
+}
+
+// BC3に圧縮する関数
+void Imase::EncodeBC3Block(const uint8_t* rgba, uint8_t* block, BcQuality quality)
+{
+	EncodeBC3Block(rgba, block, quality, GetSimdLevel());
+}
+
+void Imase::EncodeBC3Block(const uint8_t* rgba, uint8_t* block, BcQuality quality, SimdLevel level)
+{
+	level = LimitSimdLevel(level);
+	EncodeValueBlock(rgba + 3, 4, quality, level, block);
+
+	ColorBlock colors;
+	MakeColorBlock(rgba, false, colors);
+	EncodeColorBlock(colors, ColorMode::AlwaysFourColors, quality, level, block + 8);
+}
+
+// BC4に圧縮する関数
+void Imase::EncodeBC4Block(const uint8_t* values, uint8_t* block, BcQuality quality)
+{
+	EncodeBC4Block(values, block, quality, GetSimdLevel());
+}
+
+void Imase::EncodeBC4Block(const uint8_t* values, uint8_t* block, BcQuality quality, SimdLevel level)
+{
+	EncodeValueBlock(values, 1, quality, LimitSimdLevel(level), block);
+}
+
+// 展開する関数
+void Imase::DecodeBC1Block(const uint8_t* block, uint8_t* rgba)
+{
+	DecodeColorBlock(block, false, rgba);
+}
+
+void Imase::DecodeBC3Block(const uint8_t* block, uint8_t* rgba)
+{
+	DecodeColorBlock(block + 8, true, rgba);
+	DecodeValueBlock(block, rgba + 3, 4);
+}
+
+void Imase::DecodeBC4Block(const uint8_t* block, uint8_t* values)
+{
+	DecodeValueBlock(block, values, 1);
+}
@@ -0,0 +1,57 @@
+﻿//--------------------------------------------------------------------------------------
+// File: BlockCompression.h
+//
+// 4x4ピクセルのブロックをBC1、BC3、BC4形式に圧縮・展開する関数群
+//
+// Usage: ブロックのピクセルは左上から行の順に16個並べて渡します（RGBAは1ピクセル4バイト）。
+//        BC1はアルファがBC1_ALPHA_THRESHOLD未満のピクセルがあるブロックを3色と透明の
+//        モードで圧縮します。BC3のアルファとBC4は1チャンネルの値を8段階で表します。
+//        品質はFastが端点を範囲から決めるだけ、Normalは主成分の方向と最小二乗法で
+//        端点を求め、Highはさらに端点の近くを探します。
+//        パレットから最も近い色を選ぶ処理はSSE2/AVX2を実行時に切り替えます。
+//        どの命令セットでも結果は同じになります。D3Dに依存しないので単体でビルド・検証できます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "CpuFeatures.h"
+
+namespace Imase
+{
+	// 圧縮の品質
+	enum class BcQuality
+	{
+		Fast,
+		Normal,
+		High,
+	};
+
+	// ブロックのバイト数
+	const size_t BC1_BLOCK_SIZE = 8;
+	const size_t BC3_BLOCK_SIZE = 16;
+	const size_t BC4_BLOCK_SIZE = 8;
+
+	// BC1でこの値未満のアルファのピクセルは透明にする
+	const uint8_t BC1_ALPHA_THRESHOLD = 128;
+
+	// BC1に圧縮する関数（rgbaは16ピクセル分）
+	void EncodeBC1Block(const uint8_t* rgba, uint8_t* block, BcQuality quality);
+	void EncodeBC1Block(const uint8_t* rgba, uint8_t* block, BcQuality quality, SimdLevel level);
+
+	// BC3に圧縮する関数（rgbaは16ピクセル分）
+	void EncodeBC3Block(const uint8_t* rgba, uint8_t* block, BcQuality quality);
+	void EncodeBC3Block(const uint8_t* rgba, uint8_t* block, BcQuality quality, SimdLevel level);
+
+	// BC4に圧縮する関数（valuesは16個の値）
+	void EncodeBC4Block(const uint8_t* values, uint8_t* block, BcQuality quality);
+	void EncodeBC4Block(const uint8_t* values, uint8_t* block, BcQuality quality, SimdLevel level);
+
+	// 展開する関数（透明なピクセルは0, 0, 0, 0になる）
+	void DecodeBC1Block(const uint8_t* block, uint8_t* rgba);
+	void DecodeBC3Block(const uint8_t* block, uint8_t* rgba);
+	void DecodeBC4Block(const uint8_t* block, uint8_t* values);
+}
@@ -0,0 +1,126 @@
+﻿//--------------------------------------------------------------------------------------
+// File: CpuFeatures.cpp
+//
+// 実行中のCPUが使えるSIMD命令セットを調べる関数群
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "CpuFeatures.h"
+
+#if defined(IMASE_SIMD_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+using namespace Imase;
+
+namespace
+{
+#if defined(IMASE_SIMD_X86)
+	// CPUID命令
+	void CpuId(int leaf, int subLeaf, int regs[4])
+	{
+#if defined(_MSC_VER)
+		__cpuidex(regs, leaf, subLeaf);
+#else
+		unsigned int a = 0, b = 0, c = 0, d = 0;
+		__cpuid_count(leaf, subLeaf, a, b, c, d);
+		regs[0] = static_cast<int>(a);
+		regs[1] = static_cast<int>(b);
+		regs[2] = static_cast<int>(c);
+		regs[3] = static_cast<int>(d);
+#endif
+	}
+
+	// OSが保存するレジスタの状態を取得する（XGETBV）
+	unsigned long long GetXCR0()
+	{
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		unsigned int eax = 0, edx = 0;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+	}
+#endif
+
+	// 命令セットを調べる
+	SimdLevel DetectSimdLevel()
+	{
+#if defined(IMASE_SIMD_X86)
+		int regs[4] = {};
+
+		CpuId(0, 0, regs);
+		int maxLeaf = regs[0];
+
+		CpuId(1, 0, regs);
+		bool sse2 = (regs[3] & (1 << 26)) != 0;
+		bool osxsave = (regs[2] & (1 << 27)) != 0;
+		bool avx = (regs[2] & (1 << 28)) != 0;
+
+		if (!sse2) return SimdLevel::Scalar;
+
+		// OSがYMMレジスタを保存しているか確認する
+		if (maxLeaf >= 7 && osxsave && avx && (GetXCR0() & 0x6) == 0x6)
+		{
+			CpuId(7, 0, regs);
+			if (regs[1] & (1 << 5))
+			{
+				return SimdLevel::AVX2;
+			}
+		}
+
+		return SimdLevel::SSE2;
+#else
+		return SimdLevel::Scalar;
+#endif
+	}
+
+	// 周波数が一定で全コアで同期したタイムスタンプカウンタ（Invariant TSC）があるか調べる
+	bool DetectInvariantTsc()
+	{
+#if defined(IMASE_SIMD_X86)
+		int regs[4] = {};
+
+		CpuId(static_cast<int>(0x80000000), 0, regs);
+		if (static_cast<unsigned int>(regs[0]) < 0x80000007u) return false;
+
+		CpuId(static_cast<int>(0x80000007), 0, regs);
+		return (regs[3] & (1 << 8)) != 0;
+#else
+		return false;
+#endif
+	}
+}
+
+// 使用可能なSIMD命令セットを取得する関数
+SimdLevel Imase::GetSimdLevel()
+{
+	static const SimdLevel s_level = DetectSimdLevel();
+	return s_level;
+}
+
+// 命令セットの名前を取得する関数
+const char* Imase::GetSimdLevelName(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::SSE2:
+		return "SSE2";
+	case SimdLevel::AVX2:
+		return "AVX2";
+	default:
+		return "Scalar";
+	}
+}
+
+// Invariant TSCが使えるか調べる関数（結果はキャッシュされる）
+bool Imase::HasInvariantTsc()
+{
+	static const bool s_invariantTsc = DetectInvariantTsc();
+	return s_invariantTsc;
+}
@@ -0,0 +1,42 @@
+﻿//--------------------------------------------------------------------------------------
+// File: CpuFeatures.h
+//
+// 実行中のCPUが使えるSIMD命令セットを調べる関数群
+//
+// Usage: GetSimdLevel関数で使用可能な命令セットを取得し、処理を切り替えてください。
+//        AVX2は命令セットとOSのレジスタ保存の両方を確認しています。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define IMASE_SIMD_X86 1
+#endif
+
+// AVX2の関数に付ける属性（MSVCは属性なしでAVX2の組み込み関数を使用できる）
+#if defined(IMASE_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define IMASE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define IMASE_TARGET_AVX2
+#endif
+
+namespace Imase
+{
+	// SIMD命令セットのレベル
+	enum class SimdLevel
+	{
+		Scalar,
+		SSE2,
+		AVX2,
+	};
+
+	// 使用可能なSIMD命令セットを取得する関数（結果はキャッシュされる）
+	SimdLevel GetSimdLevel();
+
+	// 命令セットの名前を取得する関数
+	const char* GetSimdLevelName(SimdLevel level);
+
+	// Invariant TSC（周波数が一定のタイムスタンプカウンタ）が使えるか調べる関数
+	bool HasInvariantTsc();
+}
@@ -0,0 +1,657 @@
+﻿//--------------------------------------------------------------------------------------
+// File: CpuProfiler.cpp
+//
+// 入れ子にできるCPU処理時間の計測クラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "CpuProfiler.h"
+#include "CpuFeatures.h"
+
+#include <atomic>
+#include <chrono>
+#include <cwchar>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+#if defined(IMASE_SIMD_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+using namespace Imase;
+
+namespace
+{
+	// リングバッファのインデックスのマスク
+	const uint64_t RING_BUFFER_MASK = CpuProfiler::RING_BUFFER_SIZE - 1;
+
+	// タイムスタンプカウンタの周波数を測定する最短の時間（ミリ秒）
+	const int TSC_CALIBRATION_MILLISECONDS = 20;
+
+	// リングバッファに記録するイベント
+	struct ProfileEvent
+	{
+		// タイムスタンプ
+		uint64_t timestamp;
+
+		// 区間の名前（nullptrは区間の終了）
+		const wchar_t* name;
+	};
+
+	// 集計中の開いている区間
+	struct OpenZone
+	{
+		// 区間のノード番号
+		int node;
+
+		// 開始時刻
+		uint64_t begin;
+
+		// 子の区間の合計時間
+		uint64_t childTicks;
+	};
+
+	// スレッドごとのリングバッファ
+	struct ThreadBuffer
+	{
+		ProfileEvent events[CpuProfiler::RING_BUFFER_SIZE];
+
+		// 書き込み位置（記録するスレッドだけが書き換える）
+		std::atomic<uint64_t> head;
+
+		// 読み込み位置（集計するスレッドだけが書き換える）
+		std::atomic<uint64_t> tail;
+
+		// 記録できなかった区間の数
+		std::atomic<uint64_t> dropped;
+
+		// スレッドが終了して再利用できる
+		std::atomic<bool> released;
+
+		// スレッドの番号
+		uint32_t threadIndex;
+
+		// スレッドの名前（登録と集計の排他の中で読み書きする）
+		const wchar_t* name;
+
+		// 以下は記録するスレッドだけが使う
+
+		// 最後に読んだ読み込み位置（空きが足りない時だけ読み直す）
+		uint64_t cachedTail;
+
+		// 開いている区間の深さ
+		int depth;
+
+		// 開いている区間のうち記録したものの数
+		int recordedDepth;
+
+		// 深さごとに記録したかどうかのビット
+		uint64_t recordedBits;
+
+		// 以下は集計するスレッドだけが使う
+
+		// 開いている区間
+		std::vector<OpenZone> stack;
+
+		// ルートの区間のノード番号
+		std::vector<int> roots;
+
+		explicit ThreadBuffer(uint32_t index)
+			: head(0), tail(0), dropped(0), released(false), threadIndex(index), name(nullptr), cachedTail(0), depth(0), recordedDepth(0), recordedBits(0)
+		{
+		}
+	};
+
+	// 区間の呼び出し階層のノード
+	struct ZoneNode
+	{
+		const wchar_t* name;
+		int parent;
+		int depth;
+		uint32_t threadIndex;
+		std::vector<int> children;
+
+		// フレームごとの集計
+		uint32_t callCount;
+		uint64_t inclusiveTicks;
+		uint64_t exclusiveTicks;
+	};
+
+	// プロファイラの状態
+	struct ProfilerState
+	{
+		// スレッドの登録と集計の排他
+		std::mutex mutex;
+
+		std::vector<std::unique_ptr<ThreadBuffer>> threads;
+		std::vector<ZoneNode> nodes;
+		std::vector<CpuProfileZone> frameZones;
+		std::vector<CpuProfileEvent> frameEvents;
+		bool captureEvents;
+
+		std::atomic<bool> enabled;
+		double overheadNanoseconds;
+		double timestampOverheadNanoseconds;
+
+		// タイムスタンプカウンタ（RDTSC）を使う
+		// OSのタイマーより読み出しが速いが、周波数は最初に使う時に測定する
+		bool useTsc;
+		uint64_t frequency;
+		std::once_flag calibrateFlag;
+		uint64_t calibrationTsc;
+		uint64_t calibrationCounter;
+
+		// オーバーヘッドの測定でタイムスタンプの読み出しが省かれないようにする
+		volatile uint64_t timestampSink;
+
+		ProfilerState();
+	};
+
+	inline ProfilerState& GetState()
+	{
+		static ProfilerState state;
+		return state;
+	}
+
+	// このスレッドのリングバッファ
+	thread_local ThreadBuffer* t_buffer = nullptr;
+
+	// スレッドの終了時にリングバッファを返却するクラス
+	struct ThreadBufferOwner
+	{
+		ThreadBuffer* buffer = nullptr;
+
+		~ThreadBufferOwner()
+		{
+			if (buffer) buffer->released.store(true, std::memory_order_release);
+		}
+	};
+
+	thread_local ThreadBufferOwner t_bufferOwner;
+
+	// OSのタイマーの値を取得する関数
+	uint64_t ReadOsCounter()
+	{
+#ifdef _WIN32
+		LARGE_INTEGER value;
+		QueryPerformanceCounter(&value);
+		return static_cast<uint64_t>(value.QuadPart);
+#else
+		return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+	}
+
+	// OSのタイマーの１秒あたりのカウント数を取得する関数
+	uint64_t GetOsFrequency()
+	{
+#ifdef _WIN32
+		LARGE_INTEGER value;
+		QueryPerformanceFrequency(&value);
+		return static_cast<uint64_t>(value.QuadPart);
+#else
+		return static_cast<uint64_t>(std::chrono::steady_clock::period::den / std::chrono::steady_clock::period::num);
+#endif
+	}
+
+	// タイムスタンプを取得する関数
+	inline uint64_t ReadTimestamp(const ProfilerState& state)
+	{
+#if defined(IMASE_SIMD_X86)
+		if (state.useTsc) return __rdtsc();
+#else
+		(void)state;
+#endif
+		return ReadOsCounter();
+	}
+
+	ProfilerState::ProfilerState()
+		: captureEvents(false), enabled(true), overheadNanoseconds(0.0), timestampOverheadNanoseconds(0.0), useTsc(HasInvariantTsc()), frequency(0), calibrationTsc(0), calibrationCounter(0), timestampSink(0)
+	{
+		if (useTsc)
+		{
+			// 周波数の測定の開始点
+			calibrationTsc = ReadTimestamp(*this);
+			calibrationCounter = ReadOsCounter();
+		}
+		else
+		{
+			frequency = GetOsFrequency();
+		}
+	}
+
+	// タイムスタンプカウンタの周波数をOSのタイマーと比べて求める関数
+	void CalibrateTsc(ProfilerState& state)
+	{
+		uint64_t osFrequency = GetOsFrequency();
+		uint64_t minCounter = osFrequency * TSC_CALIBRATION_MILLISECONDS / 1000;
+
+		// 開始点から十分な時間が経っていなければ待つ
+		uint64_t elapsed = ReadOsCounter() - state.calibrationCounter;
+		if (elapsed < minCounter)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds((minCounter - elapsed) * 1000000 / osFrequency + 1));
+		}
+
+		uint64_t counter = ReadOsCounter();
+		uint64_t tsc = ReadTimestamp(state);
+
+		double seconds = static_cast<double>(counter - state.calibrationCounter) / static_cast<double>(osFrequency);
+		state.frequency = static_cast<uint64_t>(static_cast<double>(tsc - state.calibrationTsc) / seconds);
+	}
+
+	// このスレッドのリングバッファを登録する関数
+	ThreadBuffer* RegisterThreadBuffer()
+	{
+		{
+			ProfilerState& state = GetState();
+			std::lock_guard<std::mutex> lock(state.mutex);
+
+			// 終了したスレッドのリングバッファが集計済みなら再利用する
+			for (auto& buffer : state.threads)
+			{
+				if (buffer->released.load(std::memory_order_acquire)
+					&& buffer->tail.load(std::memory_order_relaxed) == buffer->head.load(std::memory_order_relaxed))
+				{
+					buffer->released.store(false, std::memory_order_relaxed);
+					buffer->cachedTail = buffer->tail.load(std::memory_order_relaxed);
+					buffer->depth = 0;
+					buffer->recordedDepth = 0;
+					buffer->recordedBits = 0;
+					buffer->stack.clear();
+					buffer->name = nullptr;
+					t_buffer = buffer.get();
+					break;
+				}
+			}
+
+			if (!t_buffer)
+			{
+				state.threads.push_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(state.threads.size())));
+				t_buffer = state.threads.back().get();
+			}
+
+			t_bufferOwner.buffer = t_buffer;
+		}
+		return t_buffer;
+	}
+
+	// このスレッドのリングバッファを取得する関数（初回だけ登録する）
+	inline ThreadBuffer* GetThreadBuffer()
+	{
+		ThreadBuffer* buffer = t_buffer;
+		return buffer ? buffer : RegisterThreadBuffer();
+	}
+
+	// 名前が同じか調べる関数（別の翻訳単位の同じ文字列リテラルも同じとみなす）
+	bool IsSameName(const wchar_t* a, const wchar_t* b)
+	{
+		return a == b || std::wcscmp(a, b) == 0;
+	}
+
+	// 親の下にある区間のノードを検索し、なければ追加する関数
+	int FindOrAddNode(ProfilerState& state, ThreadBuffer& buffer, int parent, const wchar_t* name)
+	{
+		std::vector<int>& siblings = parent < 0 ? buffer.roots : state.nodes[parent].children;
+		for (int index : siblings)
+		{
+			if (IsSameName(state.nodes[index].name, name)) return index;
+		}
+
+		ZoneNode node = {};
+		node.name = name;
+		node.parent = parent;
+		node.depth = parent < 0 ? 0 : state.nodes[parent].depth + 1;
+		node.threadIndex = buffer.threadIndex;
+
+		int index = static_cast<int>(state.nodes.size());
+		state.nodes.push_back(node);
+
+		// push_backで参照が無効になる可能性があるので取り直す
+		(parent < 0 ? buffer.roots : state.nodes[parent].children).push_back(index);
+		return index;
+	}
+
+	// リングバッファのイベントを集計する関数
+	void ConsumeEvents(ProfilerState& state, ThreadBuffer& buffer)
+	{
+		uint64_t tail = buffer.tail.load(std::memory_order_relaxed);
+		uint64_t head = buffer.head.load(std::memory_order_acquire);
+
+		for (; tail != head; tail++)
+		{
+			const ProfileEvent& event = buffer.events[tail & RING_BUFFER_MASK];
+
+			if (event.name)
+			{
+				int parent = buffer.stack.empty() ? -1 : buffer.stack.back().node;
+				int node = FindOrAddNode(state, buffer, parent, event.name);
+				buffer.stack.push_back(OpenZone{ node, event.timestamp, 0 });
+			}
+			else if (!buffer.stack.empty())
+			{
+				OpenZone zone = buffer.stack.back();
+				buffer.stack.pop_back();
+
+				uint64_t ticks = event.timestamp - zone.begin;
+				ZoneNode& node = state.nodes[zone.node];
+				node.callCount++;
+				node.inclusiveTicks += ticks;
+				node.exclusiveTicks += ticks > zone.childTicks ? ticks - zone.childTicks : 0;
+
+				if (state.captureEvents)
+				{
+					state.frameEvents.push_back(CpuProfileEvent{
+						node.name, buffer.threadIndex, static_cast<uint32_t>(node.depth), zone.begin, event.timestamp });
+				}
+
+				if (!buffer.stack.empty())
+				{
+					buffer.stack.back().childTicks += ticks;
+				}
+			}
+		}
+
+		buffer.tail.store(head, std::memory_order_release);
+	}
+
+	// 集計結果を深さ優先の順に出力する関数
+	void AppendFrameZones(ProfilerState& state, int index, int parentZone)
+	{
+		const ZoneNode& node = state.nodes[index];
+
+		// このフレームに終わっていない区間は出力しない（子は出力する）
+		int zoneIndex = parentZone;
+		if (node.callCount > 0)
+		{
+			CpuProfileZone zone = {};
+			zone.name = node.name;
+			zone.parent = parentZone;
+			zone.depth = node.depth;
+			zone.threadIndex = node.threadIndex;
+			zone.callCount = node.callCount;
+			zone.inclusiveTicks = node.inclusiveTicks;
+			zone.exclusiveTicks = node.exclusiveTicks;
+
+			zoneIndex = static_cast<int>(state.frameZones.size());
+			state.frameZones.push_back(zone);
+		}
+
+		for (int child : node.children)
+		{
+			AppendFrameZones(state, child, zoneIndex);
+		}
+	}
+}
+
+// 区間の開始
+void CpuProfiler::BeginZone(const wchar_t* name)
+{
+	ThreadBuffer* buffer = GetThreadBuffer();
+
+	int depth = buffer->depth++;
+	if (depth >= MAX_DEPTH) return;
+
+	uint64_t bit = uint64_t(1) << depth;
+	buffer->recordedBits &= ~bit;
+
+	const ProfilerState& state = GetState();
+	if (!state.enabled.load(std::memory_order_relaxed)) return;
+
+	// 開いている区間の終了イベントが必ず書き込めるように空きを残す
+	uint64_t head = buffer->head.load(std::memory_order_relaxed);
+	uint64_t required = head + buffer->recordedDepth + 2 - RING_BUFFER_SIZE;
+	if (static_cast<int64_t>(required - buffer->cachedTail) > 0)
+	{
+		buffer->cachedTail = buffer->tail.load(std::memory_order_acquire);
+		if (static_cast<int64_t>(required - buffer->cachedTail) > 0)
+		{
+			buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	ProfileEvent& event = buffer->events[head & RING_BUFFER_MASK];
+	event.name = name;
+	event.timestamp = ReadTimestamp(state);
+	buffer->head.store(head + 1, std::memory_order_release);
+
+	buffer->recordedBits |= bit;
+	buffer->recordedDepth++;
+}
+
+// 区間の終了
+void CpuProfiler::EndZone()
+{
+	uint64_t timestamp = ReadTimestamp(GetState());
+
+	ThreadBuffer* buffer = GetThreadBuffer();
+	if (buffer->depth == 0) return;
+
+	int depth = --buffer->depth;
+	if (depth >= MAX_DEPTH) return;
+	if ((buffer->recordedBits & (uint64_t(1) << depth)) == 0) return;
+
+	uint64_t head = buffer->head.load(std::memory_order_relaxed);
+	ProfileEvent& event = buffer->events[head & RING_BUFFER_MASK];
+	event.name = nullptr;
+	event.timestamp = timestamp;
+	buffer->head.store(head + 1, std::memory_order_release);
+
+	buffer->recordedDepth--;
+}
+
+// 記録の有効/無効を設定する関数
+void CpuProfiler::SetEnabled(bool enabled)
+{
+	GetState().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+// 記録が有効か取得する関数
+bool CpuProfiler::IsEnabled()
+{
+	return GetState().enabled.load(std::memory_order_relaxed);
+}
+
+// 記録されたイベントを集計する関数
+void CpuProfiler::EndFrame()
+{
+	ProfilerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	for (ZoneNode& node : state.nodes)
+	{
+		node.callCount = 0;
+		node.inclusiveTicks = 0;
+		node.exclusiveTicks = 0;
+	}
+
+	state.frameEvents.clear();
+	for (auto& buffer : state.threads)
+	{
+		ConsumeEvents(state, *buffer);
+	}
+
+	state.frameZones.clear();
+	for (auto& buffer : state.threads)
+	{
+		for (int root : buffer->roots)
+		{
+			AppendFrameZones(state, root, -1);
+		}
+	}
+}
+
+// 前回のEndFrame関数で集計した区間を取得する関数
+const std::vector<CpuProfileZone>& CpuProfiler::GetFrameZones()
+{
+	return GetState().frameZones;
+}
+
+// 区間を１回ずつ記録するか設定する関数
+void CpuProfiler::SetEventCaptureEnabled(bool enabled)
+{
+	ProfilerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	state.captureEvents = enabled;
+}
+
+// 前回のEndFrame関数で終了した区間を１回ずつ取得する関数
+const std::vector<CpuProfileEvent>& CpuProfiler::GetFrameEvents()
+{
+	return GetState().frameEvents;
+}
+
+// 現在のタイムスタンプを取得する関数
+uint64_t CpuProfiler::GetTimestamp()
+{
+	return ReadTimestamp(GetState());
+}
+
+// 呼び出したスレッドに名前を付ける関数
+void CpuProfiler::SetThreadName(const wchar_t* name)
+{
+	ThreadBuffer* buffer = GetThreadBuffer();
+
+	ProfilerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	buffer->name = name;
+}
+
+// 登録されたスレッドの数を取得する関数
+uint32_t CpuProfiler::GetThreadCount()
+{
+	ProfilerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	return static_cast<uint32_t>(state.threads.size());
+}
+
+// スレッドの名前を取得する関数
+const wchar_t* CpuProfiler::GetThreadName(uint32_t threadIndex)
+{
+	ProfilerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	return threadIndex < state.threads.size() ? state.threads[threadIndex]->name : nullptr;
+}
+
+// タイムスタンプの１秒あたりのカウント数を取得する関数
+uint64_t CpuProfiler::GetFrequency()
+{
+	ProfilerState& state = GetState();
+	if (state.useTsc)
+	{
+		std::call_once(state.calibrateFlag, CalibrateTsc, std::ref(state));
+	}
+	return state.frequency;
+}
+
+// タイムスタンプをミリ秒に変換する関数
+double CpuProfiler::TicksToMilliseconds(uint64_t ticks)
+{
+	return static_cast<double>(ticks) * 1000.0 / static_cast<double>(GetFrequency());
+}
+
+// リングバッファがいっぱいで記録できなかった区間の数を取得する関数
+uint64_t CpuProfiler::GetDroppedZoneCount()
+{
+	ProfilerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	uint64_t dropped = 0;
+	for (auto& buffer : state.threads)
+	{
+		dropped += buffer->dropped.load(std::memory_order_relaxed);
+	}
+	return dropped;
+}
+
+// １区間あたりの計測のオーバーヘッドを測定する関数
+double CpuProfiler::CalibrateOverhead(uint32_t iterations)
+{
+	static const wchar_t* const CALIBRATION_ZONE = L"CpuProfiler::CalibrateOverhead";
+
+	// 測定前に溜まっているイベントを集計しておく
+	EndFrame();
+
+	bool enabled = IsEnabled();
+	SetEnabled(true);
+
+	ProfilerState& state = GetState();
+	ThreadBuffer* buffer = GetThreadBuffer();
+
+	// リングバッファが溢れないように分割して測定し、測定用のイベントは捨てる
+	const uint32_t batchSize = static_cast<uint32_t>(RING_BUFFER_SIZE / 2 - MAX_DEPTH);
+	uint64_t totalTicks = 0;
+	uint64_t timestampTicks = 0;
+	uint32_t measured = 0;
+
+	while (measured < iterations)
+	{
+		uint32_t count = iterations - measured < batchSize ? iterations - measured : batchSize;
+
+		uint64_t start = ReadTimestamp(state);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			BeginZone(CALIBRATION_ZONE);
+			EndZone();
+		}
+		totalTicks += ReadTimestamp(state) - start;
+
+		// 同じ回数だけタイムスタンプを２回ずつ読んだ時間（仮想マシンではこれが大半を占める）
+		start = ReadTimestamp(state);
+		uint64_t sink = 0;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			sink += ReadTimestamp(state);
+			sink ^= ReadTimestamp(state);
+		}
+		timestampTicks += ReadTimestamp(state) - start;
+		state.timestampSink = sink;
+
+		measured += count;
+
+		std::lock_guard<std::mutex> lock(state.mutex);
+		buffer->tail.store(buffer->head.load(std::memory_order_relaxed), std::memory_order_release);
+	}
+
+	SetEnabled(enabled);
+
+	if (measured == 0) return state.overheadNanoseconds;
+
+	double nanosecondsPerTick = 1.0e9 / (static_cast<double>(GetFrequency()) * static_cast<double>(measured));
+	state.overheadNanoseconds = static_cast<double>(totalTicks) * nanosecondsPerTick;
+	state.timestampOverheadNanoseconds = static_cast<double>(timestampTicks) * nanosecondsPerTick;
+	return state.overheadNanoseconds;
+}
+
+// 最後に測定したオーバーヘッドを取得する関数
+double CpuProfiler::GetOverheadNanoseconds()
+{
+	return GetState().overheadNanoseconds;
+}
+
+// 最後に測定したオーバーヘッドのうちタイムスタンプの読み出しの時間を取得する関数
+double CpuProfiler::GetTimestampOverheadNanoseconds()
+{
+	return GetState().timestampOverheadNanoseconds;
+}
+
+// 最後に測定したオーバーヘッドが目標を超えているか調べる関数
+bool CpuProfiler::IsOverheadOverBudget()
+{
+	return GetState().overheadNanoseconds > OVERHEAD_BUDGET_NANOSECONDS;
+}
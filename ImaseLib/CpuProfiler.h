@@ -0,0 +1,151 @@
+﻿//--------------------------------------------------------------------------------------
+// File: CpuProfiler.h
+//
+// 入れ子にできるCPU処理時間の計測クラス
+//
+// Usage: 計測したい区間をBeginZone/EndZone関数（またはCpuProfileScope）で囲み、
+//        フレームの終わりにメインスレッドでEndFrame関数を呼んでください。
+//        記録はスレッドごとのリングバッファにロックなしで書き込まれ、
+//        EndFrame関数で区間ごとの合計時間（子を含む）と自身の時間（子を除く）に集計されます。
+//        DX::DeviceResources::PIXBeginEvent/PIXEndEventからも自動で呼ばれます。
+//        区間の名前は文字列リテラルなどフレームをまたいで有効なポインタを渡してください。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Imase
+{
+	// １フレーム分の区間の集計結果
+	struct CpuProfileZone
+	{
+		// 区間の名前
+		const wchar_t* name;
+
+		// 親の区間の番号（ルートは-1）
+		int parent;
+
+		// 入れ子の深さ（ルートは0）
+		int depth;
+
+		// 記録したスレッドの番号（登録順）
+		uint32_t threadIndex;
+
+		// 呼び出し回数
+		uint32_t callCount;
+
+		// 子の区間を含む時間（タイムスタンプの単位）
+		uint64_t inclusiveTicks;
+
+		// 子の区間を除いた時間（タイムスタンプの単位）
+		uint64_t exclusiveTicks;
+	};
+
+	// １回分の区間の記録（タイムライン用）
+	struct CpuProfileEvent
+	{
+		// 区間の名前
+		const wchar_t* name;
+
+		// 記録したスレッドの番号
+		uint32_t threadIndex;
+
+		// 入れ子の深さ
+		uint32_t depth;
+
+		// 開始と終了のタイムスタンプ
+		uint64_t beginTicks;
+		uint64_t endTicks;
+	};
+
+	// CPU処理時間の計測クラス
+	class CpuProfiler
+	{
+	public:
+
+		// スレッドごとのリングバッファに記録できるイベント数（２の累乗）
+		static const size_t RING_BUFFER_SIZE = 4096;
+
+		// 入れ子の最大の深さ（これより深い区間は記録しない）
+		static const int MAX_DEPTH = 64;
+
+		// １区間あたりの計測のオーバーヘッドの目標（ナノ秒）
+		static constexpr double OVERHEAD_BUDGET_NANOSECONDS = 50.0;
+
+	public:
+
+		// 区間の開始（どのスレッドからでも呼べる）
+		static void BeginZone(const wchar_t* name);
+
+		// 区間の終了
+		static void EndZone();
+
+		// 記録の有効/無効を設定する関数
+		static void SetEnabled(bool enabled);
+
+		// 記録が有効か取得する関数
+		static bool IsEnabled();
+
+		// 記録されたイベントを集計する関数（フレームの終わりにメインスレッドから呼ぶ）
+		static void EndFrame();
+
+		// 前回のEndFrame関数で集計した区間を取得する関数（深さ優先の順）
+		static const std::vector<CpuProfileZone>& GetFrameZones();
+
+		// 区間を１回ずつ記録するか設定する関数（トレースの出力用、初期値は無効）
+		static void SetEventCaptureEnabled(bool enabled);
+
+		// 前回のEndFrame関数で終了した区間を１回ずつ取得する関数（スレッドごとに終了した順）
+		static const std::vector<CpuProfileEvent>& GetFrameEvents();
+
+		// 現在のタイムスタンプを取得する関数
+		static uint64_t GetTimestamp();
+
+		// 呼び出したスレッドに名前を付ける関数（文字列リテラルなどを渡す）
+		static void SetThreadName(const wchar_t* name);
+
+		// 登録されたスレッドの数を取得する関数
+		static uint32_t GetThreadCount();
+
+		// スレッドの名前を取得する関数（名前がなければnullptr）
+		static const wchar_t* GetThreadName(uint32_t threadIndex);
+
+		// タイムスタンプの１秒あたりのカウント数を取得する関数
+		static uint64_t GetFrequency();
+
+		// タイムスタンプをミリ秒に変換する関数
+		static double TicksToMilliseconds(uint64_t ticks);
+
+		// リングバッファがいっぱいで記録できなかった区間の数を取得する関数
+		static uint64_t GetDroppedZoneCount();
+
+		// １区間あたりの計測のオーバーヘッドを測定する関数（ナノ秒）
+		static double CalibrateOverhead(uint32_t iterations = 100000);
+
+		// 最後に測定したオーバーヘッドを取得する関数（ナノ秒、未測定は0）
+		static double GetOverheadNanoseconds();
+
+		// 最後に測定したオーバーヘッドのうちタイムスタンプの読み出し（開始と終了の２回分）の時間を取得する関数（ナノ秒）
+		static double GetTimestampOverheadNanoseconds();
+
+		// 最後に測定したオーバーヘッドが目標を超えているか調べる関数
+		static bool IsOverheadOverBudget();
+	};
+
+	// スコープの間を計測するクラス
+	class CpuProfileScope
+	{
+	public:
+
+		explicit CpuProfileScope(const wchar_t* name) { CpuProfiler::BeginZone(name); }
+
+		~CpuProfileScope() { CpuProfiler::EndZone(); }
+
+		CpuProfileScope(const CpuProfileScope&) = delete;
+		CpuProfileScope& operator=(const CpuProfileScope&) = delete;
+	};
+}
@@ -0,0 +1,53 @@
+﻿//--------------------------------------------------------------------------------------
+// File: D3DRenderStateTarget.h
+//
+// デバイスコンテキストにレンダーステートを設定するクラス
+//
+// Usage: RenderStateCacheの設定先として使用します。
+//        単体で使うと毎回そのままデバイスコンテキストに設定します。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include "RenderStateCache.h"
+
+namespace Imase
+{
+	class D3DRenderStateTarget : public IRenderStateTarget
+	{
+	private:
+
+		// デバイスコンテキスト
+		ID3D11DeviceContext* m_context;
+
+	public:
+
+		// コンストラクタ
+		explicit D3DRenderStateTarget(ID3D11DeviceContext* context) : m_context(context) {}
+
+		// 深度ステンシルステートを設定する関数
+		void SetDepthStencilState(ID3D11DepthStencilState* state, uint32_t stencilRef) override
+		{
+			m_context->OMSetDepthStencilState(state, stencilRef);
+		}
+
+		// ブレンドステートを設定する関数
+		void SetBlendState(ID3D11BlendState* state, const float blendFactor[4], uint32_t sampleMask) override
+		{
+			m_context->OMSetBlendState(state, blendFactor, sampleMask);
+		}
+
+		// ラスタライザーステートを設定する関数
+		void SetRasterizerState(ID3D11RasterizerState* state) override
+		{
+			m_context->RSSetState(state);
+		}
+
+		// ピクセルシェーダーのサンプラーを設定する関数
+		void SetPSSamplers(uint32_t startSlot, uint32_t count, ID3D11SamplerState* const* samplers) override
+		{
+			m_context->PSSetSamplers(startSlot, count, samplers);
+		}
+	};
+}
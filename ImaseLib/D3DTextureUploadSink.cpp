@@ -0,0 +1,66 @@
+﻿//--------------------------------------------------------------------------------------
+// File: D3DTextureUploadSink.cpp
+//
+// ストリーミングするテクスチャをD3D11のテクスチャに転送するクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "pch.h"
+#include "D3DTextureUploadSink.h"
+
+using namespace Imase;
+
+// コンストラクタ
+D3DTextureUploadSink::D3DTextureUploadSink(ID3D11Device* device, ID3D11DeviceContext* context)
+	: m_device(device)
+	, m_context(context)
+{
+}
+
+// 全てのミップマップを持つ空のテクスチャを作成する関数
+void D3DTextureUploadSink::CreateTexture(TextureHandle handle, const DdsFile& file)
+{
+	if (file.GetDimension() != DDS_DIMENSION_TEXTURE2D)
+	{
+		throw std::runtime_error("Only 2D textures can be streamed.");
+	}
+
+	const DXGI_FORMAT format = static_cast<DXGI_FORMAT>(file.GetFormat());
+	const uint32_t arraySize = file.GetArraySize();
+
+	// 後からミップマップを転送するのでIMMUTABLEにはできない
+	CD3D11_TEXTURE2D_DESC desc(format, file.GetWidth(), file.GetHeight(), arraySize, file.GetMipLevels(),
+		D3D11_BIND_SHADER_RESOURCE, D3D11_USAGE_DEFAULT, 0, 1, 0, file.IsCubemap() ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0);
+
+	Texture texture;
+	texture.mipLevels = file.GetMipLevels();
+	DX::ThrowIfFailed(m_device->CreateTexture2D(&desc, nullptr, texture.texture.GetAddressOf()));
+
+	D3D11_SRV_DIMENSION dimension = arraySize > 1 ? D3D11_SRV_DIMENSION_TEXTURE2DARRAY : D3D11_SRV_DIMENSION_TEXTURE2D;
+	if (file.IsCubemap())
+	{
+		dimension = arraySize > 6 ? D3D11_SRV_DIMENSION_TEXTURECUBEARRAY : D3D11_SRV_DIMENSION_TEXTURECUBE;
+	}
+	CD3D11_SHADER_RESOURCE_VIEW_DESC viewDesc(texture.texture.Get(), dimension, format);
+	DX::ThrowIfFailed(m_device->CreateShaderResourceView(texture.texture.Get(), &viewDesc, texture.view.GetAddressOf()));
+
+	// 転送するまでは一番小さいミップマップしか使わない
+	m_context->SetResourceMinLOD(texture.texture.Get(), static_cast<float>(texture.mipLevels - 1));
+
+	if (m_textures.size() <= handle) m_textures.resize(handle + 1);
+	m_textures[handle] = texture;
+}
+
+// １つのサーフェスを転送する関数
+void D3DTextureUploadSink::UploadSurface(TextureHandle handle, uint32_t item, uint32_t mip, const DdsSurface& surface)
+{
+	const Texture& texture = m_textures[handle];
+	m_context->UpdateSubresource(texture.texture.Get(), D3D11CalcSubresource(mip, item, texture.mipLevels),
+		nullptr, surface.data, static_cast<UINT>(surface.rowPitch), static_cast<UINT>(surface.slicePitch));
+}
+
+// 描画に使う最も詳細なミップマップを設定する関数
+void D3DTextureUploadSink::SetResidentMip(TextureHandle handle, uint32_t mip)
+{
+	m_context->SetResourceMinLOD(m_textures[handle].texture.Get(), static_cast<float>(mip));
+}
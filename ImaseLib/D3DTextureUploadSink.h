@@ -0,0 +1,52 @@
+﻿//--------------------------------------------------------------------------------------
+// File: D3DTextureUploadSink.h
+//
+// ストリーミングするテクスチャをD3D11のテクスチャに転送するクラス
+//
+// Usage: TextureStreamerの転送先として使用します。
+//        テクスチャは全てのミップマップを確保して作成し、UpdateSubresourceで転送します。
+//        まだ転送していないミップマップは SetResourceMinLOD で描画に使わないようにします。
+//        GetTexture関数で得たビューはストリーミング中もそのまま使えます。
+//        2Dテクスチャ（配列、キューブマップを含む）に対応します。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include "TextureStreamer.h"
+
+namespace Imase
+{
+	class D3DTextureUploadSink : public ITextureUploadSink
+	{
+	private:
+
+		// テクスチャの情報
+		struct Texture
+		{
+			Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+			Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> view;
+			uint32_t mipLevels;
+		};
+
+		// デバイスとデバイスコンテキスト
+		ID3D11Device* m_device;
+		ID3D11DeviceContext* m_context;
+
+		// テクスチャ（TextureHandleの順）
+		std::vector<Texture> m_textures;
+
+	public:
+
+		// コンストラクタ
+		D3DTextureUploadSink(ID3D11Device* device, ID3D11DeviceContext* context);
+
+		// テクスチャのビューを取得する関数
+		ID3D11ShaderResourceView* GetTexture(TextureHandle handle) const { return m_textures[handle].view.Get(); }
+
+		// ITextureUploadSink
+		void CreateTexture(TextureHandle handle, const DdsFile& file) override;
+		void UploadSurface(TextureHandle handle, uint32_t item, uint32_t mip, const DdsSurface& surface) override;
+		void SetResidentMip(TextureHandle handle, uint32_t mip) override;
+	};
+}
@@ -0,0 +1,397 @@
+﻿//--------------------------------------------------------------------------------------
+// File: DdsFile.cpp
+//
+// DDS形式（DirectDraw Surface）のテクスチャファイルを読み込むクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "DdsFile.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace Imase;
+
+namespace
+{
+	// ファイルの先頭の"DDS "
+	const uint32_t DDS_MAGIC = 0x20534444;
+
+	// fourCCの"DX10"
+	const uint32_t DDS_FOURCC_DX10 = 0x30315844;
+
+	// ヘッダーのフラグ
+	const uint32_t DDS_HEADER_FLAGS_HEIGHT = 0x00000002;
+	const uint32_t DDS_HEADER_FLAGS_VOLUME = 0x00800000;
+
+	// ピクセルフォーマットのフラグ
+	const uint32_t DDS_PF_ALPHAPIXELS = 0x00000001;
+	const uint32_t DDS_PF_ALPHA = 0x00000002;
+	const uint32_t DDS_PF_FOURCC = 0x00000004;
+	const uint32_t DDS_PF_RGB = 0x00000040;
+	const uint32_t DDS_PF_LUMINANCE = 0x00020000;
+
+	// caps2のフラグ
+	const uint32_t DDS_CAPS2_CUBEMAP = 0x00000200;
+	const uint32_t DDS_CAPS2_CUBEMAP_ALLFACES = 0x0000fc00;
+	const uint32_t DDS_CAPS2_VOLUME = 0x00200000;
+
+	// DX10拡張ヘッダーのキューブマップのフラグ
+	const uint32_t DDS_MISC_TEXTURECUBE = 0x00000004;
+
+	// 大きさの上限（D3D11の制限）
+	const uint32_t DDS_MAX_DIMENSION = 16384;
+	const uint32_t DDS_MAX_VOLUME_DIMENSION = 2048;
+	const uint32_t DDS_MAX_ARRAY_SIZE = 2048;
+
+	// キューブマップの面の数
+	const uint32_t DDS_CUBEMAP_FACES = 6;
+
+	// DXGI_FORMATの値
+	const uint32_t FORMAT_R32G32B32A32_FLOAT = 2;
+	const uint32_t FORMAT_R16G16B16A16_FLOAT = 10;
+	const uint32_t FORMAT_R16G16B16A16_UNORM = 11;
+	const uint32_t FORMAT_R16G16B16A16_SNORM = 13;
+	const uint32_t FORMAT_R32G32_FLOAT = 16;
+	const uint32_t FORMAT_R10G10B10A2_UNORM = 24;
+	const uint32_t FORMAT_R8G8B8A8_UNORM = 28;
+	const uint32_t FORMAT_R16G16_FLOAT = 34;
+	const uint32_t FORMAT_R16G16_UNORM = 35;
+	const uint32_t FORMAT_R32_FLOAT = 41;
+	const uint32_t FORMAT_R8G8_UNORM = 49;
+	const uint32_t FORMAT_R16_FLOAT = 54;
+	const uint32_t FORMAT_R16_UNORM = 56;
+	const uint32_t FORMAT_R8_UNORM = 61;
+	const uint32_t FORMAT_A8_UNORM = 65;
+	const uint32_t FORMAT_BC1_UNORM = 71;
+	const uint32_t FORMAT_BC2_UNORM = 74;
+	const uint32_t FORMAT_BC3_UNORM = 77;
+	const uint32_t FORMAT_BC4_UNORM = 80;
+	const uint32_t FORMAT_BC4_SNORM = 81;
+	const uint32_t FORMAT_BC5_UNORM = 83;
+	const uint32_t FORMAT_BC5_SNORM = 84;
+	const uint32_t FORMAT_B5G6R5_UNORM = 85;
+	const uint32_t FORMAT_B5G5R5A1_UNORM = 86;
+	const uint32_t FORMAT_B8G8R8A8_UNORM = 87;
+	const uint32_t FORMAT_B8G8R8X8_UNORM = 88;
+	const uint32_t FORMAT_B4G4R4A4_UNORM = 115;
+
+	// 4文字のコード
+	uint32_t MakeFourCC(char a, char b, char c, char d)
+	{
+		return static_cast<uint32_t>(static_cast<uint8_t>(a))
+			| (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8)
+			| (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16)
+			| (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+	}
+
+	// ピクセルフォーマットのビットマスクが一致するか調べる関数
+	bool IsBitMask(const DdsPixelFormat& pf, uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+	{
+		return pf.rBitMask == r && pf.gBitMask == g && pf.bBitMask == b && pf.aBitMask == a;
+	}
+
+	// 大きさからミップマップのレベル数の上限を求める関数
+	uint32_t CountMipLevels(uint32_t size)
+	{
+		uint32_t levels = 1;
+		while (size > 1)
+		{
+			size >>= 1;
+			levels++;
+		}
+		return levels;
+	}
+}
+
+// フォーマットの情報を取得する関数
+bool Imase::GetDdsFormatInfo(uint32_t format, DdsFormatInfo& info)
+{
+	info.blockCompressed = false;
+
+	if (format >= 1 && format <= 4) info.bytesPerElement = 16;			// R32G32B32A32
+	else if (format >= 5 && format <= 8) info.bytesPerElement = 12;		// R32G32B32
+	else if (format >= 9 && format <= 22) info.bytesPerElement = 8;	// R16G16B16A16, R32G32, R32G8X24
+	else if (format >= 23 && format <= 47) info.bytesPerElement = 4;	// R10G10B10A2, R8G8B8A8, R16G16, R32, R24G8
+	else if (format >= 48 && format <= 59) info.bytesPerElement = 2;	// R8G8, R16
+	else if (format >= 60 && format <= 65) info.bytesPerElement = 1;	// R8, A8
+	else if (format == 67) info.bytesPerElement = 4;					// R9G9B9E5
+	else if (format >= 70 && format <= 84)
+	{
+		// BC1とBC4は8バイト、BC2、BC3、BC5は16バイトのブロック
+		info.blockCompressed = true;
+		info.bytesPerElement = (format <= 72 || (format >= 79 && format <= 81)) ? 8 : 16;
+	}
+	else if (format == 85 || format == 86) info.bytesPerElement = 2;	// B5G6R5, B5G5R5A1
+	else if (format >= 87 && format <= 93) info.bytesPerElement = 4;	// B8G8R8A8, B8G8R8X8
+	else if (format >= 94 && format <= 99)
+	{
+		// BC6H, BC7
+		info.blockCompressed = true;
+		info.bytesPerElement = 16;
+	}
+	else if (format == 115) info.bytesPerElement = 2;					// B4G4R4A4
+	else
+	{
+		info.bytesPerElement = 0;
+		return false;
+	}
+
+	return true;
+}
+
+// コンストラクタ（ファイルをマップして読み込む）
+DdsFile::DdsFile(const wchar_t* fileName)
+	: m_file(fileName)
+{
+	Parse(m_file.GetData(), m_file.GetSize());
+}
+
+// コンストラクタ（メモリ上の内容を読み込む）
+DdsFile::DdsFile(const uint8_t* data, size_t size)
+{
+	Parse(data, size);
+}
+
+// 幅・高さ・深さがmaxSize以下になる最も詳細なミップマップを求める関数
+uint32_t DdsFile::FindMipForSize(uint32_t maxSize) const
+{
+	if (maxSize == DDS_TEXTURE_NO_LIMIT) return 0;
+
+	uint32_t mip = 0;
+	while (mip + 1 < m_mipLevels)
+	{
+		const DdsSurface& surface = m_surfaces[mip];
+		if (surface.width <= maxSize && surface.height <= maxSize && surface.depth <= maxSize) break;
+		mip++;
+	}
+
+	return mip;
+}
+
+// 従来のヘッダーのピクセルフォーマットからDXGI_FORMATを求める関数（対応していなければ0）
+uint32_t DdsFile::GetLegacyFormat(const DdsPixelFormat& pf)
+{
+	if (pf.flags & DDS_PF_FOURCC)
+	{
+		if (pf.fourCC == MakeFourCC('D', 'X', 'T', '1')) return FORMAT_BC1_UNORM;
+		if (pf.fourCC == MakeFourCC('D', 'X', 'T', '2')) return FORMAT_BC2_UNORM;
+		if (pf.fourCC == MakeFourCC('D', 'X', 'T', '3')) return FORMAT_BC2_UNORM;
+		if (pf.fourCC == MakeFourCC('D', 'X', 'T', '4')) return FORMAT_BC3_UNORM;
+		if (pf.fourCC == MakeFourCC('D', 'X', 'T', '5')) return FORMAT_BC3_UNORM;
+		if (pf.fourCC == MakeFourCC('A', 'T', 'I', '1')) return FORMAT_BC4_UNORM;
+		if (pf.fourCC == MakeFourCC('B', 'C', '4', 'U')) return FORMAT_BC4_UNORM;
+		if (pf.fourCC == MakeFourCC('B', 'C', '4', 'S')) return FORMAT_BC4_SNORM;
+		if (pf.fourCC == MakeFourCC('A', 'T', 'I', '2')) return FORMAT_BC5_UNORM;
+		if (pf.fourCC == MakeFourCC('B', 'C', '5', 'U')) return FORMAT_BC5_UNORM;
+		if (pf.fourCC == MakeFourCC('B', 'C', '5', 'S')) return FORMAT_BC5_SNORM;
+
+		// D3DFORMATの値が直接入っているもの
+		switch (pf.fourCC)
+		{
+		case 36: return FORMAT_R16G16B16A16_UNORM;
+		case 110: return FORMAT_R16G16B16A16_SNORM;
+		case 111: return FORMAT_R16_FLOAT;
+		case 112: return FORMAT_R16G16_FLOAT;
+		case 113: return FORMAT_R16G16B16A16_FLOAT;
+		case 114: return FORMAT_R32_FLOAT;
+		case 115: return FORMAT_R32G32_FLOAT;
+		case 116: return FORMAT_R32G32B32A32_FLOAT;
+		default: return 0;
+		}
+	}
+
+	if (pf.flags & DDS_PF_RGB)
+	{
+		switch (pf.rgbBitCount)
+		{
+		case 32:
+			if (IsBitMask(pf, 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000)) return FORMAT_R8G8B8A8_UNORM;
+			if (IsBitMask(pf, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000)) return FORMAT_B8G8R8A8_UNORM;
+			if (IsBitMask(pf, 0x00ff0000, 0x0000ff00, 0x000000ff, 0)) return FORMAT_B8G8R8X8_UNORM;
+			if (IsBitMask(pf, 0x000003ff, 0x000ffc00, 0x3ff00000, 0xc0000000)) return FORMAT_R10G10B10A2_UNORM;
+			if (IsBitMask(pf, 0x0000ffff, 0xffff0000, 0, 0)) return FORMAT_R16G16_UNORM;
+			if (IsBitMask(pf, 0xffffffff, 0, 0, 0)) return FORMAT_R32_FLOAT;
+			return 0;
+		case 16:
+			if (IsBitMask(pf, 0x7c00, 0x03e0, 0x001f, 0x8000)) return FORMAT_B5G5R5A1_UNORM;
+			if (IsBitMask(pf, 0xf800, 0x07e0, 0x001f, 0)) return FORMAT_B5G6R5_UNORM;
+			if (IsBitMask(pf, 0x0f00, 0x00f0, 0x000f, 0xf000)) return FORMAT_B4G4R4A4_UNORM;
+			return 0;
+		default:
+			return 0;
+		}
+	}
+
+	if (pf.flags & DDS_PF_LUMINANCE)
+	{
+		if (pf.rgbBitCount == 8 && IsBitMask(pf, 0xff, 0, 0, 0)) return FORMAT_R8_UNORM;
+		if (pf.rgbBitCount == 16 && IsBitMask(pf, 0xffff, 0, 0, 0)) return FORMAT_R16_UNORM;
+		if (pf.rgbBitCount == 16 && (pf.flags & DDS_PF_ALPHAPIXELS) && IsBitMask(pf, 0x00ff, 0, 0, 0xff00)) return FORMAT_R8G8_UNORM;
+		return 0;
+	}
+
+	if ((pf.flags & DDS_PF_ALPHA) && pf.rgbBitCount == 8) return FORMAT_A8_UNORM;
+
+	return 0;
+}
+
+// ファイルの中身を解析する関数
+void DdsFile::Parse(const uint8_t* data, size_t size)
+{
+	m_data = data;
+	m_size = size;
+	m_headerDxt10 = nullptr;
+
+	// 先頭の"DDS "とヘッダー
+	size_t offset = sizeof(uint32_t) + sizeof(DdsHeader);
+	if (size < offset) throw std::runtime_error("DDS file is too small.");
+
+	if (reinterpret_cast<uintptr_t>(data) % alignof(DdsHeader) != 0)
+	{
+		throw std::runtime_error("DDS header is misaligned.");
+	}
+
+	if (*reinterpret_cast<const uint32_t*>(data) != DDS_MAGIC) throw std::runtime_error("Not a DDS file.");
+
+	m_header = reinterpret_cast<const DdsHeader*>(data + sizeof(uint32_t));
+	const DdsHeader& header = *m_header;
+	if (header.size != sizeof(DdsHeader) || header.pixelFormat.size != sizeof(DdsPixelFormat))
+	{
+		throw std::runtime_error("DDS header size is invalid.");
+	}
+
+	m_width = header.width;
+	m_height = header.height;
+	m_depth = 1;
+	m_arraySize = 1;
+	m_mipLevels = header.mipMapCount ? header.mipMapCount : 1;
+	m_cubemap = false;
+
+	if ((header.pixelFormat.flags & DDS_PF_FOURCC) && header.pixelFormat.fourCC == DDS_FOURCC_DX10)
+	{
+		// DX10拡張ヘッダー
+		if (size - offset < sizeof(DdsHeaderDxt10)) throw std::runtime_error("DDS file is too small.");
+		m_headerDxt10 = reinterpret_cast<const DdsHeaderDxt10*>(data + offset);
+		offset += sizeof(DdsHeaderDxt10);
+
+		const DdsHeaderDxt10& extension = *m_headerDxt10;
+		m_format = extension.dxgiFormat;
+		m_arraySize = extension.arraySize;
+		if (m_arraySize == 0) throw std::runtime_error("DDS array size is zero.");
+
+		switch (extension.resourceDimension)
+		{
+		case DDS_DIMENSION_TEXTURE1D:
+			if ((header.flags & DDS_HEADER_FLAGS_HEIGHT) && m_height != 1) throw std::runtime_error("DDS 1D texture has a height.");
+			m_height = 1;
+			break;
+
+		case DDS_DIMENSION_TEXTURE2D:
+			if (extension.miscFlag & DDS_MISC_TEXTURECUBE)
+			{
+				if (m_arraySize > DDS_MAX_ARRAY_SIZE / DDS_CUBEMAP_FACES) throw std::runtime_error("DDS array size is too large.");
+				m_arraySize *= DDS_CUBEMAP_FACES;
+				m_cubemap = true;
+			}
+			break;
+
+		case DDS_DIMENSION_TEXTURE3D:
+			if (!(header.flags & DDS_HEADER_FLAGS_VOLUME)) throw std::runtime_error("DDS volume texture has no depth.");
+			if (m_arraySize != 1) throw std::runtime_error("DDS volume texture cannot be an array.");
+			m_depth = header.depth;
+			break;
+
+		default:
+			throw std::runtime_error("DDS resource dimension is invalid.");
+		}
+
+		m_dimension = static_cast<DdsDimension>(extension.resourceDimension);
+	}
+	else
+	{
+		// 従来のヘッダー
+		m_format = GetLegacyFormat(header.pixelFormat);
+
+		if (header.caps2 & DDS_CAPS2_VOLUME)
+		{
+			m_dimension = DDS_DIMENSION_TEXTURE3D;
+			m_depth = header.depth;
+		}
+		else
+		{
+			m_dimension = DDS_DIMENSION_TEXTURE2D;
+			if (header.caps2 & DDS_CAPS2_CUBEMAP)
+			{
+				// 一部の面だけのキューブマップはD3D11では使えない
+				if ((header.caps2 & DDS_CAPS2_CUBEMAP_ALLFACES) != DDS_CAPS2_CUBEMAP_ALLFACES)
+				{
+					throw std::runtime_error("DDS cubemap does not have all faces.");
+				}
+				m_arraySize = DDS_CUBEMAP_FACES;
+				m_cubemap = true;
+			}
+		}
+	}
+
+	DdsFormatInfo info;
+	if (!GetDdsFormatInfo(m_format, info)) throw std::runtime_error("DDS format is not supported.");
+
+	// 大きさとレベル数
+	const uint32_t maxDimension = m_dimension == DDS_DIMENSION_TEXTURE3D ? DDS_MAX_VOLUME_DIMENSION : DDS_MAX_DIMENSION;
+	if (m_width == 0 || m_height == 0 || m_depth == 0
+		|| m_width > maxDimension || m_height > maxDimension || m_depth > maxDimension)
+	{
+		throw std::runtime_error("DDS texture size is invalid.");
+	}
+
+	if (m_arraySize > DDS_MAX_ARRAY_SIZE) throw std::runtime_error("DDS array size is too large.");
+
+	if (m_mipLevels > CountMipLevels(std::max(m_width, std::max(m_height, m_depth))))
+	{
+		throw std::runtime_error("DDS mip count is invalid.");
+	}
+
+	// サブリソースの位置を求める（配列の要素ごとにミップマップが並ぶ）
+	m_surfaces.clear();
+	m_surfaces.reserve(static_cast<size_t>(m_arraySize) * m_mipLevels);
+
+	for (uint32_t item = 0; item < m_arraySize; item++)
+	{
+		uint32_t width = m_width, height = m_height, depth = m_depth;
+		for (uint32_t mip = 0; mip < m_mipLevels; mip++)
+		{
+			uint64_t rowPitch, rowCount;
+			if (info.blockCompressed)
+			{
+				rowPitch = static_cast<uint64_t>(std::max(1u, (width + 3) / 4)) * info.bytesPerElement;
+				rowCount = std::max(1u, (height + 3) / 4);
+			}
+			else
+			{
+				rowPitch = static_cast<uint64_t>(width) * info.bytesPerElement;
+				rowCount = height;
+			}
+
+			// 上限の大きさなので64bitで溢れない
+			const uint64_t slicePitch = rowPitch * rowCount;
+			const uint64_t surfaceSize = slicePitch * depth;
+			if (surfaceSize > size - offset) throw std::runtime_error("DDS surface data is out of range.");
+
+			DdsSurface surface;
+			surface.data = data + offset;
+			surface.rowPitch = static_cast<size_t>(rowPitch);
+			surface.rowCount = static_cast<size_t>(rowCount);
+			surface.slicePitch = static_cast<size_t>(slicePitch);
+			surface.width = width;
+			surface.height = height;
+			surface.depth = depth;
+			m_surfaces.push_back(surface);
+
+			offset += static_cast<size_t>(surfaceSize);
+			width = std::max(1u, width / 2);
+			height = std::max(1u, height / 2);
+			depth = std::max(1u, depth / 2);
+		}
+	}
+}
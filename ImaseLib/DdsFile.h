@@ -0,0 +1,193 @@
+﻿//--------------------------------------------------------------------------------------
+// File: DdsFile.h
+//
+// DDS形式（DirectDraw Surface）のテクスチャファイルを読み込むクラス
+//
+// Usage: ファイルをメモリにマップし、ミップマップの各レベルはマップした中身を直接
+//        参照します（コピーしません）。GetSurface関数で得た位置と行のバイト数は
+//        そのままD3D11_SUBRESOURCE_DATAに渡せるので、必要なミップだけを使えます。
+//        DX10拡張ヘッダー、1D/2D/3Dテクスチャ、テクスチャ配列、キューブマップに対応します。
+//        ヘッダーの値とデータの範囲は読み込み時に全て確認し、壊れている時や
+//        対応していないフォーマットの時は std::runtime_error を投げます。
+//        フォーマットはDXGI_FORMATと同じ値です。D3Dに依存しないので単体でビルド・検証できます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace Imase
+{
+	// 大きさの制限なし
+	const uint32_t DDS_TEXTURE_NO_LIMIT = 0;
+
+	// テクスチャの次元（D3D11_RESOURCE_DIMENSIONと同じ値）
+	enum DdsDimension : uint32_t
+	{
+		DDS_DIMENSION_TEXTURE1D = 2,
+		DDS_DIMENSION_TEXTURE2D = 3,
+		DDS_DIMENSION_TEXTURE3D = 4,
+	};
+
+	// ピクセルフォーマット
+	struct DdsPixelFormat
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t fourCC;
+		uint32_t rgbBitCount;
+		uint32_t rBitMask;
+		uint32_t gBitMask;
+		uint32_t bBitMask;
+		uint32_t aBitMask;
+	};
+
+	// ファイルのヘッダー（先頭の"DDS "の後ろ）
+	struct DdsHeader
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t height;
+		uint32_t width;
+		uint32_t pitchOrLinearSize;
+		uint32_t depth;
+		uint32_t mipMapCount;
+		uint32_t reserved1[11];
+		DdsPixelFormat pixelFormat;
+		uint32_t caps;
+		uint32_t caps2;
+		uint32_t caps3;
+		uint32_t caps4;
+		uint32_t reserved2;
+	};
+
+	// DX10拡張ヘッダー（fourCCが"DX10"の時にヘッダーの後ろにある）
+	struct DdsHeaderDxt10
+	{
+		uint32_t dxgiFormat;
+		uint32_t resourceDimension;
+		uint32_t miscFlag;
+		uint32_t arraySize;
+		uint32_t miscFlags2;
+	};
+
+	static_assert(sizeof(DdsPixelFormat) == 32, "DdsPixelFormat layout mismatch.");
+	static_assert(sizeof(DdsHeader) == 124, "DdsHeader layout mismatch.");
+	static_assert(sizeof(DdsHeaderDxt10) == 20, "DdsHeaderDxt10 layout mismatch.");
+
+	// ミップマップの１つのレベル（サブリソース）
+	struct DdsSurface
+	{
+		// 先頭の位置（マップしたファイルの中）
+		const uint8_t* data;
+
+		// 行（ブロック圧縮は４行のブロック）のバイト数と、行の数
+		size_t rowPitch;
+		size_t rowCount;
+
+		// 深さ１枚分のバイト数（３Dテクスチャ以外は全体のバイト数）
+		size_t slicePitch;
+
+		// ピクセル単位の大きさ
+		uint32_t width;
+		uint32_t height;
+		uint32_t depth;
+	};
+
+	// フォーマットの情報
+	struct DdsFormatInfo
+	{
+		// 1ピクセル（ブロック圧縮は1ブロック）のバイト数
+		uint32_t bytesPerElement;
+
+		// ブロック圧縮（4x4ピクセル単位）か
+		bool blockCompressed;
+	};
+
+	// フォーマットの情報を取得する関数（対応していないフォーマットはfalseを返す）
+	bool GetDdsFormatInfo(uint32_t format, DdsFormatInfo& info);
+
+	class DdsFile
+	{
+	private:
+
+		// マップしたファイル
+		MappedFile m_file;
+
+		// ファイルの中身
+		const uint8_t* m_data;
+		size_t m_size;
+
+		// ヘッダー（ファイルの中身を直接参照。DX10拡張ヘッダーがない時はnullptr）
+		const DdsHeader* m_header;
+		const DdsHeaderDxt10* m_headerDxt10;
+
+		// テクスチャの情報
+		uint32_t m_format;
+		DdsDimension m_dimension;
+		uint32_t m_width;
+		uint32_t m_height;
+		uint32_t m_depth;
+		uint32_t m_arraySize;
+		uint32_t m_mipLevels;
+		bool m_cubemap;
+
+		// 全てのサブリソース（D3D11のサブリソースの順で、番号は mip + item * mipLevels）
+		std::vector<DdsSurface> m_surfaces;
+
+	public:
+
+		// コンストラクタ（ファイルをマップして読み込む）
+		explicit DdsFile(const wchar_t* fileName);
+
+		// コンストラクタ（メモリ上の内容を読み込む。dataは参照するだけなので長く残すこと）
+		DdsFile(const uint8_t* data, size_t size);
+
+		// ファイルの中身を取得する関数（CreateDDSTextureFromMemoryなどにそのまま渡せる）
+		const uint8_t* GetData() const { return m_data; }
+		size_t GetSize() const { return m_size; }
+
+		// ヘッダーを取得する関数
+		const DdsHeader& GetHeader() const { return *m_header; }
+		const DdsHeaderDxt10* GetHeaderDxt10() const { return m_headerDxt10; }
+
+		// フォーマット（DXGI_FORMATの値）
+		uint32_t GetFormat() const { return m_format; }
+
+		// テクスチャの次元と大きさ
+		DdsDimension GetDimension() const { return m_dimension; }
+		uint32_t GetWidth() const { return m_width; }
+		uint32_t GetHeight() const { return m_height; }
+		uint32_t GetDepth() const { return m_depth; }
+
+		// 配列の要素数（キューブマップは面の数なので６の倍数）
+		uint32_t GetArraySize() const { return m_arraySize; }
+
+		// ミップマップのレベル数
+		uint32_t GetMipLevels() const { return m_mipLevels; }
+
+		// キューブマップか
+		bool IsCubemap() const { return m_cubemap; }
+
+		// サブリソースを取得する関数
+		const DdsSurface& GetSurface(size_t item, size_t mip) const { return m_surfaces[mip + item * m_mipLevels]; }
+		const DdsSurface* GetSurfaces() const { return m_surfaces.data(); }
+		size_t GetSurfaceCount() const { return m_surfaces.size(); }
+
+		// 幅・高さ・深さがmaxSize以下になる最も詳細なミップマップを求める関数（なければ最後のレベル）
+		uint32_t FindMipForSize(uint32_t maxSize) const;
+
+	private:
+
+		// ファイルの中身を解析する関数
+		void Parse(const uint8_t* data, size_t size);
+
+		// 従来のヘッダーのピクセルフォーマットからDXGI_FORMATを求める関数
+		static uint32_t GetLegacyFormat(const DdsPixelFormat& pixelFormat);
+	};
+}
@@ -0,0 +1,102 @@
+﻿//--------------------------------------------------------------------------------------
+// File: DdsTexture.cpp
+//
+// DDSファイルの内容からテクスチャを作成する関数
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "pch.h"
+#include "DdsTexture.h"
+
+using namespace Imase;
+
+// maxSizeに収めるために省く先頭のミップマップの数を求める関数
+uint32_t Imase::GetDdsSkipMipCount(const DdsFile& file, uint32_t maxSize)
+{
+	DdsFormatInfo info;
+	GetDdsFormatInfo(file.GetFormat(), info);
+
+	uint32_t skip = file.FindMipForSize(maxSize);
+
+	// ブロック圧縮は先頭のレベルが４の倍数でないと作成できない
+	while (skip > 0 && info.blockCompressed)
+	{
+		const DdsSurface& surface = file.GetSurface(0, skip);
+		if (surface.width % 4 == 0 && surface.height % 4 == 0) break;
+		skip--;
+	}
+
+	return skip;
+}
+
+// DDSファイルの内容からテクスチャを作成する関数
+void Imase::CreateTextureFromDds(ID3D11Device* device, const DdsFile& file, ID3D11ShaderResourceView** textureView, uint32_t maxSize)
+{
+	const uint32_t skip = GetDdsSkipMipCount(file, maxSize);
+	const uint32_t mipLevels = file.GetMipLevels() - skip;
+	const uint32_t arraySize = file.GetArraySize();
+	const DXGI_FORMAT format = static_cast<DXGI_FORMAT>(file.GetFormat());
+	const DdsSurface& top = file.GetSurface(0, skip);
+
+	// 使うミップマップだけをファイルの中身から直接渡す
+	std::vector<D3D11_SUBRESOURCE_DATA> data;
+	data.reserve(static_cast<size_t>(arraySize) * mipLevels);
+	for (uint32_t item = 0; item < arraySize; item++)
+	{
+		for (uint32_t mip = skip; mip < file.GetMipLevels(); mip++)
+		{
+			const DdsSurface& surface = file.GetSurface(item, mip);
+			D3D11_SUBRESOURCE_DATA subresource = {};
+			subresource.pSysMem = surface.data;
+			subresource.SysMemPitch = static_cast<UINT>(surface.rowPitch);
+			subresource.SysMemSlicePitch = static_cast<UINT>(surface.slicePitch);
+			data.push_back(subresource);
+		}
+	}
+
+	Microsoft::WRL::ComPtr<ID3D11Resource> texture;
+	CD3D11_SHADER_RESOURCE_VIEW_DESC viewDesc(D3D11_SRV_DIMENSION_TEXTURE2D, format);
+
+	switch (file.GetDimension())
+	{
+	case DDS_DIMENSION_TEXTURE1D:
+	{
+		CD3D11_TEXTURE1D_DESC desc(format, top.width, arraySize, mipLevels, D3D11_BIND_SHADER_RESOURCE, D3D11_USAGE_IMMUTABLE);
+		Microsoft::WRL::ComPtr<ID3D11Texture1D> texture1D;
+		DX::ThrowIfFailed(device->CreateTexture1D(&desc, data.data(), texture1D.GetAddressOf()));
+		texture = texture1D;
+		viewDesc = CD3D11_SHADER_RESOURCE_VIEW_DESC(texture1D.Get(),
+			arraySize > 1 ? D3D11_SRV_DIMENSION_TEXTURE1DARRAY : D3D11_SRV_DIMENSION_TEXTURE1D, format);
+		break;
+	}
+
+	case DDS_DIMENSION_TEXTURE3D:
+	{
+		CD3D11_TEXTURE3D_DESC desc(format, top.width, top.height, top.depth, mipLevels, D3D11_BIND_SHADER_RESOURCE, D3D11_USAGE_IMMUTABLE);
+		Microsoft::WRL::ComPtr<ID3D11Texture3D> texture3D;
+		DX::ThrowIfFailed(device->CreateTexture3D(&desc, data.data(), texture3D.GetAddressOf()));
+		texture = texture3D;
+		viewDesc = CD3D11_SHADER_RESOURCE_VIEW_DESC(texture3D.Get(), format);
+		break;
+	}
+
+	default:
+	{
+		CD3D11_TEXTURE2D_DESC desc(format, top.width, top.height, arraySize, mipLevels, D3D11_BIND_SHADER_RESOURCE, D3D11_USAGE_IMMUTABLE,
+			0, 1, 0, file.IsCubemap() ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0);
+		Microsoft::WRL::ComPtr<ID3D11Texture2D> texture2D;
+		DX::ThrowIfFailed(device->CreateTexture2D(&desc, data.data(), texture2D.GetAddressOf()));
+		texture = texture2D;
+
+		D3D11_SRV_DIMENSION dimension = arraySize > 1 ? D3D11_SRV_DIMENSION_TEXTURE2DARRAY : D3D11_SRV_DIMENSION_TEXTURE2D;
+		if (file.IsCubemap())
+		{
+			dimension = arraySize > 6 ? D3D11_SRV_DIMENSION_TEXTURECUBEARRAY : D3D11_SRV_DIMENSION_TEXTURECUBE;
+		}
+		viewDesc = CD3D11_SHADER_RESOURCE_VIEW_DESC(texture2D.Get(), dimension, format);
+		break;
+	}
+	}
+
+	DX::ThrowIfFailed(device->CreateShaderResourceView(texture.Get(), &viewDesc, textureView));
+}
@@ -0,0 +1,28 @@
+﻿//--------------------------------------------------------------------------------------
+// File: DdsTexture.h
+//
+// DDSファイルの内容からテクスチャを作成する関数
+//
+// Usage: DdsFileクラスで読み込んだファイルの各ミップマップを直接参照してテクスチャを作成します。
+//        maxSizeを指定すると、幅か高さがmaxSizeより大きいミップマップは読まずに省きます。
+//        （ブロック圧縮のフォーマットは先頭のレベルが４の倍数になる所までしか省きません）
+//        作成に失敗した時は DX::ThrowIfFailed で例外を投げます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include "DdsFile.h"
+
+namespace Imase
+{
+	// DDSファイルの内容からテクスチャを作成する関数
+	void CreateTextureFromDds(
+		ID3D11Device* device,
+		const DdsFile& file,
+		ID3D11ShaderResourceView** textureView,
+		uint32_t maxSize = DDS_TEXTURE_NO_LIMIT);
+
+	// maxSizeに収めるために省く先頭のミップマップの数を求める関数
+	uint32_t GetDdsSkipMipCount(const DdsFile& file, uint32_t maxSize);
+}
@@ -8,36 +8,86 @@
 //--------------------------------------------------------------------------------------
 #include "pch.h"
 #include "DebugFont.h"
+#include "Frustum.h"
 #include "DirectXHelpers.h"
 #include "VertexTypes.h"
 
 using namespace DirectX;
 using namespace Imase;
 
+namespace
+{
+	// SpriteBatchが１回の描画でまとめる最大のスプライト数（SpriteBatch::Impl::MaxBatchSize）
+	const size_t SPRITE_BATCH_MAX_SIZE = 2048;
+}
+
 // コンストラクタ
 DebugFont::DebugFont(ID3D11Device* device, ID3D11DeviceContext* context, wchar_t const* fileName)
-	: m_fontHeight{}
+	: DebugFont(device, context, std::make_shared<SpriteFontFile>(fileName))
+{
+}
+
+// コンストラクタ（読み込み済みのフォントファイルを使う）
+DebugFont::DebugFont(ID3D11Device* device, ID3D11DeviceContext* context, std::shared_ptr<const SpriteFontFile> fontFile)
+	: DebugFont(context, fontFile, CreateTexture(device, *fontFile))
+{
+}
+
+// コンストラクタ（作成済みのテクスチャを使う）
+DebugFont::DebugFont(ID3D11DeviceContext* context, std::shared_ptr<const SpriteFontFile> fontFile,
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> texture)
+	: m_fontFile(std::move(fontFile))
+	, m_texture(std::move(texture))
+	, m_fontHeight{}
+	, m_drawCount(0)
 {
 	m_spriteBatch = std::make_unique<SpriteBatch>(context);
-	m_spriteFont = std::make_unique<DirectX::SpriteFont>(device, fileName);
 
 	// フォントの縦サイズを取得する
-	m_fontHeight = m_spriteFont->GetLineSpacing();
+	m_fontHeight = m_fontFile->GetLineSpacing();
+}
+
+// フォントのテクスチャを作成する関数
+Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> DebugFont::CreateTexture(ID3D11Device* device, const SpriteFontFile& fontFile)
+{
+	// マップしたファイルの画素から直接テクスチャを作成する
+	const SpriteFontTexture& fontTexture = fontFile.GetTexture();
+	DXGI_FORMAT format = static_cast<DXGI_FORMAT>(fontTexture.format);
+
+	CD3D11_TEXTURE2D_DESC textureDesc(format, fontTexture.width, fontTexture.height, 1, 1, D3D11_BIND_SHADER_RESOURCE, D3D11_USAGE_IMMUTABLE);
+	D3D11_SUBRESOURCE_DATA data = {};
+	data.pSysMem = fontTexture.data;
+	data.SysMemPitch = fontTexture.stride;
+
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+	DX::ThrowIfFailed(device->CreateTexture2D(&textureDesc, &data, texture.GetAddressOf()));
+
+	CD3D11_SHADER_RESOURCE_VIEW_DESC viewDesc(D3D11_SRV_DIMENSION_TEXTURE2D, format);
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> view;
+	DX::ThrowIfFailed(device->CreateShaderResourceView(texture.Get(), &viewDesc, view.GetAddressOf()));
+
+	return view;
 }
 
 // デストラクタ
 DebugFont::~DebugFont()
 {
-	m_spriteFont.reset();
 	m_spriteBatch.reset();
+	m_texture.Reset();
 }
 
 // 描画する文字列を登録する関数
 void DebugFont::AddString(const wchar_t * string, DirectX::SimpleMath::Vector2 pos, FXMVECTOR color, float scale)
+{
+	AddString(m_textArena.Append(string), pos, color, scale);
+}
+
+// 格納済みの文字列を登録する関数
+void DebugFont::AddString(TextSpan text, DirectX::SimpleMath::Vector2 pos, FXMVECTOR color, float scale)
 {
 	String str;
 
-	str.string = std::wstring(string);
+	str.string = text;
 	str.pos = pos;
 	str.color = color;
 	str.scale = scale;
@@ -49,28 +99,53 @@ void DebugFont::AddString(const wchar_t * string, DirectX::SimpleMath::Vector2 p
 void DebugFont::Render(DirectX::CommonStates* states)
 {
 	m_spriteBatch->Begin(SpriteSortMode_Deferred, nullptr, nullptr, states->DepthNone(), states->CullCounterClockwise());
-	
+
+	size_t spriteCount = 0;
 	for (size_t i = 0; i < m_strings.size(); i++)
 	{
-		m_spriteFont->DrawString(
-			m_spriteBatch.get(),
-			m_strings[i].string.c_str(),
-			m_strings[i].pos,
-			m_strings[i].color,
-			0.0f,
-			SimpleMath::Vector2(0.0f, 0.0f),
-			m_strings[i].scale);
+		const String& str = m_strings[i];
+
+		// 文字を並べる（SpriteFont::DrawStringと同じ並べ方、同じ文字列は前の結果を使う）
+		const TextLayout& layout = m_layoutCache.Get(
+			m_fontFile->GetGlyphTable(), m_fontHeight, m_textArena.GetText(str.string), str.string.length);
+
+		for (const GlyphQuad& quad : layout.quads)
+		{
+			RECT subrect = {
+				static_cast<LONG>(quad.subrect[0]), static_cast<LONG>(quad.subrect[1]),
+				static_cast<LONG>(quad.subrect[2]), static_cast<LONG>(quad.subrect[3]) };
+			SimpleMath::Vector2 position(str.pos.x + quad.position[0] * str.scale, str.pos.y + quad.position[1] * str.scale);
+
+			m_spriteBatch->Draw(m_texture.Get(), position, &subrect, str.color, 0.0f, SimpleMath::Vector2::Zero, str.scale);
+		}
+		spriteCount += layout.quads.size();
 	}
 
 	m_spriteBatch->End();
 
-	// 登録されている文字列をクリア
+	// テクスチャは１枚なので、スプライトバッチは最大数ごとに描画する
+	m_drawCount = (spriteCount + SPRITE_BATCH_MAX_SIZE - 1) / SPRITE_BATCH_MAX_SIZE;
+
+	// 登録されている文字列をクリア（メモリは次のフレームで再利用する）
 	m_strings.clear();
+	m_textArena.Reset();
 }
 
+static_assert(sizeof(BillboardVertex) == sizeof(VertexPositionColorTexture), "BillboardVertex layout mismatch.");
+
 // コンストラクタ
 DebugFont3D::DebugFont3D(ID3D11Device* device, ID3D11DeviceContext* context, wchar_t const* fileName)
-	: DebugFont(device, context, fileName)
+	: DebugFont3D(device, context, std::make_shared<SpriteFontFile>(fileName))
+{
+}
+
+// コンストラクタ（読み込み済みのフォントファイルを使う）
+DebugFont3D::DebugFont3D(ID3D11Device* device, ID3D11DeviceContext* context, std::shared_ptr<const SpriteFontFile> fontFile)
+	: DebugFont(device, context, std::move(fontFile))
+	, m_inverseTextureSize{ 1.0f, 1.0f }
+	, m_cullDistance(0.0f)
+	, m_drawnCount(0)
+	, m_culledCount(0)
 {	
 	// エフェクトを作成
 	m_effect = std::make_unique<BasicEffect>(device);
@@ -87,11 +162,39 @@ DebugFont3D::DebugFont3D(ID3D11Device* device, ID3D11DeviceContext* context, wch
 			VertexPositionColorTexture::InputElementCount,
 			m_inputLayout.ReleaseAndGetAddressOf())
 	);
+
+	// 頂点バッファの作成
+	D3D11_BUFFER_DESC desc = {};
+	desc.ByteWidth = static_cast<UINT>(sizeof(VertexPositionColorTexture) * 4 * MAX_GLYPHS_PER_DRAW);
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+	desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	DX::ThrowIfFailed(device->CreateBuffer(&desc, nullptr, m_vertexBuffer.ReleaseAndGetAddressOf()));
+
+	// インデックスバッファの作成（並びは毎回同じなので最初に作っておく）
+	std::vector<uint16_t> indices(6 * MAX_GLYPHS_PER_DRAW);
+	BuildBillboardIndices(MAX_GLYPHS_PER_DRAW, indices.data());
+
+	desc.ByteWidth = static_cast<UINT>(sizeof(uint16_t) * indices.size());
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	desc.CPUAccessFlags = 0;
+
+	D3D11_SUBRESOURCE_DATA data = {};
+	data.pSysMem = indices.data();
+	DX::ThrowIfFailed(device->CreateBuffer(&desc, &data, m_indexBuffer.ReleaseAndGetAddressOf()));
+
+	// フォントのテクスチャの大きさ
+	const SpriteFontTexture& fontTexture = m_fontFile->GetTexture();
+	m_inverseTextureSize[0] = 1.0f / static_cast<float>(fontTexture.width);
+	m_inverseTextureSize[1] = 1.0f / static_cast<float>(fontTexture.height);
 }
 
 // デストラクタ
 Imase::DebugFont3D::~DebugFont3D()
 {
+	m_indexBuffer.Reset();
+	m_vertexBuffer.Reset();
 	m_inputLayout.Reset();
 	m_effect.reset();
 }
@@ -102,10 +205,16 @@ void DebugFont3D::AddString(
 	DirectX::SimpleMath::Vector3 pos,
 	DirectX::FXMVECTOR color,
 	float scale)
+{
+	AddString(m_textArena.Append(string), pos, color, scale);
+}
+
+// 格納済みの文字列を登録する関数（3D版）
+void DebugFont3D::AddString(TextSpan text, DirectX::SimpleMath::Vector3 pos, FXMVECTOR color, float scale)
 {
 	String str;
 
-	str.string = std::wstring(string);
+	str.string = text;
 	str.pos = pos;
 	str.color = color;
 	// 文字の高さが3D空間内で１になるよう調整している（余白があるのできっちりではない）
@@ -121,48 +230,109 @@ void DebugFont3D::Render(
 	const DirectX::SimpleMath::Matrix& view,
 	const DirectX::SimpleMath::Matrix& proj)
 {
-	// スクリーン座標はY軸が＋－逆なので
-	SimpleMath::Matrix invertY = SimpleMath::Matrix::CreateScale(1.0f, -1.0f, 1.0f);
+	m_drawnCount = 0;
+	m_culledCount = 0;
+	m_vertices.clear();
 
-	// ビュー行列の回転を打ち消す行列を作成する
+	// 逆ビュー行列の１行目と２行目が画面の右方向と上方向、４行目がカメラの位置
 	SimpleMath::Matrix invView = view.Invert();
-	invView._41 = 0.0f;
-	invView._42 = 0.0f;
-	invView._43 = 0.0f;
+	const float right[3] = { invView._11, invView._12, invView._13 };
+	const float up[3] = { invView._21, invView._22, invView._23 };
+	const SimpleMath::Vector3 eye(invView._41, invView._42, invView._43);
 
-	// エフェクトにビュー行列と射影行列を設定する
-	m_effect->SetView(view);
-	m_effect->SetProjection(proj);
+	// 視錐台の平面
+	SimpleMath::Matrix viewProj = view * proj;
+	float planes[FRUSTUM_PLANE_COUNT][4];
+	ExtractFrustumPlanes(&viewProj._11, planes);
 
 	for (size_t i = 0; i < m_strings.size(); i++)
 	{
-		m_spriteBatch->Begin(SpriteSortMode_Deferred, nullptr, nullptr, states->DepthNone(), states->CullCounterClockwise(), [=]
-			{
-				// ワールド行列作成
-				SimpleMath::Matrix world = invertY * invView * SimpleMath::Matrix::CreateTranslation(m_strings[i].pos);
-				// エフェクトを適応する
-				m_effect->SetWorld(world);
-				m_effect->Apply(context);
-				// 入力レイアウトを設定する
-				context->IASetInputLayout(m_inputLayout.Get());
-			}
-		);
-
-		// 文字列の中心が表示位置になるように設定
-		SimpleMath::Vector2 textOrigin = m_spriteFont->MeasureString(m_strings[i].string.c_str()) / 2.0f;
-
-		m_spriteFont->DrawString(
-			m_spriteBatch.get(),
-			m_strings[i].string.c_str(),
-			SimpleMath::Vector2::Zero,
-			m_strings[i].color,
-			0.0f,
-			textOrigin,
-			m_strings[i].scale);
-
-		m_spriteBatch->End();
+		const String& str = m_strings[i];
+
+		// 遠すぎる文字列は文字を並べる前に省く
+		if (m_cullDistance > 0.0f && SimpleMath::Vector3::DistanceSquared(str.pos, eye) > m_cullDistance * m_cullDistance)
+		{
+			m_culledCount++;
+			continue;
+		}
+
+		// 文字を並べる（同じ文字列は前の結果を使う）
+		const TextLayout& layout = m_layoutCache.Get(
+			m_fontFile->GetGlyphTable(), m_fontHeight, m_textArena.GetText(str.string), str.string.length);
+		const float* textSize = layout.size;
+
+		// 文字列を囲む球が視錐台の外なら省く
+		const float center[3] = { str.pos.x, str.pos.y, str.pos.z };
+		float radius = 0.5f * std::sqrt(textSize[0] * textSize[0] + textSize[1] * textSize[1]) * str.scale;
+		if (!IsSphereInFrustum(planes, center, radius))
+		{
+			m_culledCount++;
+			continue;
+		}
+
+		// 文字列の中心が表示位置になるように頂点を作成する
+		const float origin[2] = { textSize[0] * 0.5f, textSize[1] * 0.5f };
+		const float color[4] = { str.color.x, str.color.y, str.color.z, str.color.w };
+
+		size_t first = m_vertices.size();
+		m_vertices.resize(first + layout.quads.size() * 4);
+		ExpandGlyphQuads(
+			layout.quads.data(), layout.quads.size(),
+			center, right, up, str.scale, origin, color, m_inverseTextureSize,
+			m_vertices.data() + first);
+
+		m_drawnCount++;
+	}
+
+	if (!m_vertices.empty())
+	{
+		// ステートの設定（SpriteBatchの既定と同じ）
+		context->OMSetDepthStencilState(states->DepthNone(), 0);
+		context->OMSetBlendState(states->AlphaBlend(), nullptr, 0xffffffff);
+		context->RSSetState(states->CullNone());
+
+		ID3D11SamplerState* samplers[] = { states->LinearClamp() };
+		context->PSSetSamplers(0, 1, samplers);
+
+		// 頂点はワールド座標で作るのでワールド行列は単位行列
+		m_effect->SetWorld(SimpleMath::Matrix::Identity);
+		m_effect->SetView(view);
+		m_effect->SetProjection(proj);
+		m_effect->SetTexture(m_texture.Get());
+		m_effect->Apply(context);
+
+		DrawVertices(context);
 	}
 
-	// 登録されている文字列をクリア
+	// 登録されている文字列をクリア（メモリは次のフレームで再利用する）
 	m_strings.clear();
+	m_textArena.Reset();
+}
+
+// 頂点を描画する関数
+void DebugFont3D::DrawVertices(ID3D11DeviceContext* context)
+{
+	context->IASetInputLayout(m_inputLayout.Get());
+
+	ID3D11Buffer* vertexBuffers[] = { m_vertexBuffer.Get() };
+	UINT strides[] = { sizeof(VertexPositionColorTexture) };
+	UINT offsets[] = { 0 };
+	context->IASetVertexBuffers(0, 1, vertexBuffers, strides, offsets);
+	context->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0);
+	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	// 頂点バッファに入り切らない時だけ分けて描画する
+	size_t totalGlyphs = m_vertices.size() / 4;
+	for (size_t first = 0; first < totalGlyphs; first += MAX_GLYPHS_PER_DRAW)
+	{
+		size_t count = std::min(totalGlyphs - first, size_t(MAX_GLYPHS_PER_DRAW));
+
+		D3D11_MAPPED_SUBRESOURCE mapped;
+		DX::ThrowIfFailed(context->Map(m_vertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+		auto begin = m_vertices.begin() + first * 4;
+		std::copy(begin, begin + count * 4, static_cast<BillboardVertex*>(mapped.pData));
+		context->Unmap(m_vertexBuffer.Get(), 0);
+
+		context->DrawIndexed(static_cast<UINT>(count * 6), 0, 0);
+	}
 }
@@ -7,15 +7,25 @@
 //        AddString関数で文字列を登録します。登録された情報は描画後クリアされます。
 //        デバッグ用の文字列の表示などに使用してください。
 //		  ※デバッグ用なので深度バッファはみていません。（必ず描画される）
+//        フォントファイルはメモリにマップしたまま参照し、文字の検索は文字コードで直接引きます。
+//        並べた文字列はキャッシュしておき、前のフレームと同じ文字列は並べ直しません。
+//        3D版は全ての文字の頂点をCPUで作成し、まとめて描画します。
+//        視錐台の外や SetCullDistance 関数で設定した距離より遠い文字列は描画しません。
 //
 // Date: 2023.3.13
 // Author: Hideyasu Imase
 //--------------------------------------------------------------------------------------
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <string>
 
+#include "TextArena.h"
+#include "GlyphLayout.h"
+#include "SpriteFontFile.h"
+#include "TextLayoutCache.h"
+
 namespace Imase
 {
 
@@ -29,8 +39,8 @@ namespace Imase
 			// 位置
 			DirectX::SimpleMath::Vector2 pos;
 
-			// 文字列
-			std::wstring string;
+			// 文字列（m_textArena内の位置）
+			TextSpan string;
 
 			// 色
 			DirectX::SimpleMath::Color color;
@@ -44,38 +54,53 @@ namespace Imase
 
 	protected:
 
+		// 登録された文字列の格納先（描画後にリセットして再利用する）
+		TextArena m_textArena;
+
+		// フォントファイル（メモリにマップしたまま文字の情報を参照する）
+		std::shared_ptr<const SpriteFontFile> m_fontFile;
+
+		// フォントのテクスチャ
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_texture;
+
 		// スプライトバッチ
 		std::unique_ptr<DirectX::SpriteBatch> m_spriteBatch;
 
-		// スプライトフォント
-		std::unique_ptr<DirectX::SpriteFont> m_spriteFont;
-
 		// フォントの縦サイズ
 		float m_fontHeight;
 
+		// 文字列を並べた結果のキャッシュ
+		TextLayoutCache m_layoutCache;
+
+		// 前回の描画での描画回数
+		size_t m_drawCount;
+
 	public:
 
 		// コンストラクタ
 		DebugFont(ID3D11Device* device, ID3D11DeviceContext* context, wchar_t const* fileName);
 
+		// コンストラクタ（読み込み済みのフォントファイルを使う）
+		DebugFont(ID3D11Device* device, ID3D11DeviceContext* context, std::shared_ptr<const SpriteFontFile> fontFile);
+
+		// コンストラクタ（CreateTexture関数で作成済みのテクスチャを使う）
+		DebugFont(ID3D11DeviceContext* context, std::shared_ptr<const SpriteFontFile> fontFile,
+			Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> texture);
+
 		// デストラクタ
 		virtual ~DebugFont();
 
+		// フォントのテクスチャを作成する関数（デバイスだけを使うのでワーカースレッドから呼べる）
+		static Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> CreateTexture(ID3D11Device* device, const SpriteFontFile& fontFile);
+
 		// 描画する文字列を登録する関数
 		template <class... Args>
 		void AddString(int x, int y, const DirectX::FXMVECTOR& color, const wchar_t* format, const Args& ... args)
 		{
-			int textLength = std::swprintf(nullptr, 0, format, args ...);
-			if (textLength < 0)
-			{
-				throw std::runtime_error("String Formatting Error.");
-			}
+			// 書式はフレーム用のバッファに直接展開する
+			TextSpan text = m_textArena.Format(format, args ...);
 
-			size_t bufferSize = textLength + sizeof(L'\0');
-			std::unique_ptr<wchar_t[]> buffer = std::make_unique<wchar_t[]>(bufferSize);
-			std::swprintf(buffer.get(), bufferSize, format, args ...);
-
-			AddString(buffer.get(), DirectX::SimpleMath::Vector2{ static_cast<float>(x),static_cast<float>(y) }, color);
+			AddString(text, DirectX::SimpleMath::Vector2{ static_cast<float>(x),static_cast<float>(y) }, color, 1.0f);
 		}
 
 		// 描画する文字列を登録する関数
@@ -90,10 +115,26 @@ namespace Imase
 
 		// フォントの高さを取得する関数
 		float GetFontHeight() {	return m_fontHeight; }
+
+		// 文字列を並べた結果のキャッシュを取得する関数（統計の表示用）
+		const TextLayoutCache& GetLayoutCache() const { return m_layoutCache; }
+
+		// 前回のRender関数での描画回数を取得する関数
+		size_t GetDrawCount() const { return m_drawCount; }
+
+	private:
+
+		// 格納済みの文字列を登録する関数
+		void AddString(TextSpan text, DirectX::SimpleMath::Vector2 pos, DirectX::FXMVECTOR color, float scale);
 	};
 
 	class DebugFont3D : protected DebugFont
 	{
+	public:
+
+		// １回の描画で描画できる文字の最大数（16bitインデックスの上限）
+		static const size_t MAX_GLYPHS_PER_DRAW = 65536 / 4;
+
 	private:
 
 		// 文字列情報
@@ -102,8 +143,8 @@ namespace Imase
 			// 位置
 			DirectX::SimpleMath::Vector3 pos;
 
-			// 文字列
-			std::wstring string;
+			// 文字列（m_textArena内の位置）
+			TextSpan string;
 
 			// 色
 			DirectX::SimpleMath::Color color;
@@ -121,6 +162,23 @@ namespace Imase
 		// 入力レイアウト
 		Microsoft::WRL::ComPtr<ID3D11InputLayout> m_inputLayout;
 
+		// 頂点バッファとインデックスバッファ
+		Microsoft::WRL::ComPtr<ID3D11Buffer> m_vertexBuffer;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> m_indexBuffer;
+
+		// テクスチャの幅と高さの逆数
+		float m_inverseTextureSize[2];
+
+		// 作業用の配列（確保したメモリは次のフレームで再利用する）
+		std::vector<BillboardVertex> m_vertices;
+
+		// この距離より遠い文字列は描画しない（0以下は無制限）
+		float m_cullDistance;
+
+		// 前回の描画で描画した文字列と省いた文字列の数
+		size_t m_drawnCount;
+		size_t m_culledCount;
+
 	public:
 
 		// コンストラクタ
@@ -129,6 +187,12 @@ namespace Imase
 			ID3D11DeviceContext* context,
 			wchar_t const* fileName);
 
+		// コンストラクタ（読み込み済みのフォントファイルを使う）
+		DebugFont3D(
+			ID3D11Device* device,
+			ID3D11DeviceContext* context,
+			std::shared_ptr<const SpriteFontFile> fontFile);
+
 		// デストラクタ
 		~DebugFont3D();
 
@@ -136,17 +200,10 @@ namespace Imase
 		template <class... Args>
 		void AddString(DirectX::SimpleMath::Vector3 pos, const DirectX::FXMVECTOR& color, const wchar_t* format, const Args& ... args)
 		{
-			int textLength = std::swprintf(nullptr, 0, format, args ...);
-			if (textLength < 0)
-			{
-				throw std::runtime_error("String Formatting Error.");
-			}
+			// 書式はフレーム用のバッファに直接展開する
+			TextSpan text = m_textArena.Format(format, args ...);
 
-			size_t bufferSize = textLength + sizeof(L'\0');
-			std::unique_ptr<wchar_t[]> buffer = std::make_unique<wchar_t[]>(bufferSize);
-			std::swprintf(buffer.get(), bufferSize, format, args ...);
-
-			AddString(buffer.get(), pos, color);
+			AddString(text, pos, color, 1.0f);
 		}
 
 		// 描画する文字列を登録する関数
@@ -165,6 +222,26 @@ namespace Imase
 
 		// フォントの高さを取得する関数
 		float GetFontHeight() { return m_fontHeight; }
+
+		// 文字列を並べた結果のキャッシュを取得する関数（統計の表示用）
+		const TextLayoutCache& GetLayoutCache() const { return m_layoutCache; }
+
+		// この距離より遠い文字列を描画しないように設定する関数（0以下は無制限）
+		void SetCullDistance(float distance) { m_cullDistance = distance; }
+
+		// 前回の描画で描画した文字列の数を取得する関数
+		size_t GetDrawnCount() const { return m_drawnCount; }
+
+		// 前回の描画でカリングした文字列の数を取得する関数
+		size_t GetCulledCount() const { return m_culledCount; }
+
+	private:
+
+		// 格納済みの文字列を登録する関数
+		void AddString(TextSpan text, DirectX::SimpleMath::Vector3 pos, DirectX::FXMVECTOR color, float scale);
+
+		// 頂点を描画する関数
+		void DrawVertices(ID3D11DeviceContext* context);
 	};
 
 }
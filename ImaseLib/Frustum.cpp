@@ -0,0 +1,57 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Frustum.cpp
+//
+// 視錐台カリングの関数群
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "Frustum.h"
+
+#include <cmath>
+
+using namespace Imase;
+
+// ビュー行列×射影行列から視錐台の平面を取り出す関数
+void Imase::ExtractFrustumPlanes(const float viewProjection[16], float planes[FRUSTUM_PLANE_COUNT][4])
+{
+	// 行ベクトルなのでクリップ座標の各成分は行列の列との内積になる
+	const float* m = viewProjection;
+	for (int i = 0; i < 4; i++)
+	{
+		float x = m[i * 4 + 0];
+		float y = m[i * 4 + 1];
+		float z = m[i * 4 + 2];
+		float w = m[i * 4 + 3];
+
+		planes[0][i] = w + x;	// 左
+		planes[1][i] = w - x;	// 右
+		planes[2][i] = w + y;	// 下
+		planes[3][i] = w - y;	// 上
+		planes[4][i] = z;		// 近（Direct3Dは0～w）
+		planes[5][i] = w - z;	// 遠
+	}
+
+	// 距離を比べられるように正規化する
+	for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++)
+	{
+		float length = std::sqrt(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] + planes[i][2] * planes[i][2]);
+		if (length > 0.0f)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				planes[i][j] /= length;
+			}
+		}
+	}
+}
+
+// 球が視錐台と重なるか調べる関数
+bool Imase::IsSphereInFrustum(const float planes[FRUSTUM_PLANE_COUNT][4], const float center[3], float radius)
+{
+	for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++)
+	{
+		float distance = planes[i][0] * center[0] + planes[i][1] * center[1] + planes[i][2] * center[2] + planes[i][3];
+		if (distance < -radius) return false;
+	}
+	return true;
+}
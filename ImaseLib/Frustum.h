@@ -0,0 +1,25 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Frustum.h
+//
+// 視錐台カリングの関数群
+//
+// Usage: ExtractFrustumPlanes関数でビュー行列×射影行列から６枚の平面を取り出し、
+//        IsSphereInFrustum関数で球が視錐台と重なるか調べてください。
+//        行列はSimpleMath::Matrixと同じ行ベクトルの並び（_11, _12, ... の順）です。
+//        深度の範囲はDirect3Dと同じ0～wです。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+namespace Imase
+{
+	// 視錐台の平面の数（左、右、下、上、近、遠）
+	const int FRUSTUM_PLANE_COUNT = 6;
+
+	// ビュー行列×射影行列から視錐台の平面を取り出す関数（法線は内側向きで正規化済み）
+	void ExtractFrustumPlanes(const float viewProjection[16], float planes[FRUSTUM_PLANE_COUNT][4]);
+
+	// 球が視錐台と重なるか調べる関数
+	bool IsSphereInFrustum(const float planes[FRUSTUM_PLANE_COUNT][4], const float center[3], float radius);
+}
@@ -0,0 +1,187 @@
+﻿//--------------------------------------------------------------------------------------
+// File: GlyphLayout.cpp
+//
+// 文字列を文字ごとの四角形に並べ、3D空間の頂点に展開する関数群
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "GlyphLayout.h"
+
+#include <algorithm>
+#include <cwctype>
+
+using namespace Imase;
+
+namespace
+{
+	// 直接参照の表に入れる文字コードの上限（BMP）
+	const uint32_t DIRECT_INDEX_LIMIT = 0x10000;
+}
+
+const uint32_t GlyphTable::NO_GLYPH;
+
+// 文字の情報の配列から表を作る関数
+void GlyphTable::Build(const GlyphMetrics* glyphs, size_t count)
+{
+	m_glyphs = glyphs;
+	m_count = count;
+	m_directIndex.clear();
+	m_fallback.clear();
+	m_firstCharacter = 0;
+	m_defaultGlyph = nullptr;
+
+	// BMPの中で使われている範囲だけ表にする
+	uint32_t first = DIRECT_INDEX_LIMIT;
+	uint32_t last = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		uint32_t character = glyphs[i].character;
+		if (character < DIRECT_INDEX_LIMIT)
+		{
+			first = std::min(first, character);
+			last = std::max(last, character);
+		}
+	}
+
+	if (first <= last)
+	{
+		m_firstCharacter = first;
+		m_directIndex.assign(last - first + 1, NO_GLYPH);
+	}
+
+	// 同じ文字が複数あれば先のものを使う
+	for (size_t i = 0; i < count; i++)
+	{
+		uint32_t character = glyphs[i].character;
+		uint32_t index = static_cast<uint32_t>(i);
+		if (character < DIRECT_INDEX_LIMIT)
+		{
+			uint32_t& slot = m_directIndex[character - m_firstCharacter];
+			if (slot == NO_GLYPH) slot = index;
+		}
+		else
+		{
+			m_fallback.emplace(character, index);
+		}
+	}
+}
+
+// 直接参照の表に入らない文字を検索する関数
+const GlyphMetrics* GlyphTable::FindFallback(uint32_t character) const
+{
+	if (m_fallback.empty()) return nullptr;
+
+	auto it = m_fallback.find(character);
+	return it != m_fallback.end() ? &m_glyphs[it->second] : nullptr;
+}
+
+// 文字列を文字ごとの四角形に並べる関数
+void Imase::LayoutGlyphs(
+	const GlyphTable& table,
+	const wchar_t* text,
+	float lineSpacing,
+	std::vector<GlyphQuad>& quads,
+	float textSize[2])
+{
+	float x = 0.0f;
+	float y = 0.0f;
+
+	textSize[0] = 0.0f;
+	textSize[1] = 0.0f;
+
+	for (; *text; text++)
+	{
+		wchar_t character = *text;
+
+		if (character == L'\r') continue;
+
+		if (character == L'\n')
+		{
+			x = 0.0f;
+			y += lineSpacing;
+			continue;
+		}
+
+		// フォントにない文字は飛ばす（SpriteFontは例外になる）
+		const GlyphMetrics* glyph = table.Find(static_cast<uint32_t>(character));
+		if (!glyph) continue;
+
+		x += glyph->xOffset;
+		if (x < 0.0f) x = 0.0f;
+
+		float width = static_cast<float>(glyph->subrect[2] - glyph->subrect[0]);
+		float height = static_cast<float>(glyph->subrect[3] - glyph->subrect[1]);
+		float advance = width + glyph->xAdvance;
+
+		// 空白は描画しない
+		bool whitespace = std::iswspace(static_cast<wint_t>(character)) != 0;
+		if (!whitespace || width > 1.0f || height > 1.0f)
+		{
+			GlyphQuad quad;
+			quad.position[0] = x;
+			quad.position[1] = y + glyph->yOffset;
+			quad.position[2] = x + width;
+			quad.position[3] = y + glyph->yOffset + height;
+			for (int i = 0; i < 4; i++)
+			{
+				quad.subrect[i] = static_cast<float>(glyph->subrect[i]);
+			}
+			quads.push_back(quad);
+
+			// MeasureStringと同じ大きさの求め方
+			float h = whitespace ? lineSpacing : std::max(height + glyph->yOffset, lineSpacing);
+			textSize[0] = std::max(textSize[0], x + width);
+			textSize[1] = std::max(textSize[1], y + h);
+		}
+
+		x += advance;
+	}
+}
+
+// 四角形をワールド座標の頂点に展開する関数
+void Imase::ExpandGlyphQuads(
+	const GlyphQuad* quads,
+	size_t count,
+	const float position[3],
+	const float right[3],
+	const float up[3],
+	float scale,
+	const float origin[2],
+	const float color[4],
+	const float inverseTextureSize[2],
+	BillboardVertex* vertices)
+{
+	// 画面のY軸は下向きなので上方向を反転して使う
+	for (size_t i = 0; i < count; i++)
+	{
+		const GlyphQuad& quad = quads[i];
+
+		const float left = (quad.position[0] - origin[0]) * scale;
+		const float rightEdge = (quad.position[2] - origin[0]) * scale;
+		const float top = -(quad.position[1] - origin[1]) * scale;
+		const float bottom = -(quad.position[3] - origin[1]) * scale;
+
+		const float u0 = quad.subrect[0] * inverseTextureSize[0];
+		const float v0 = quad.subrect[1] * inverseTextureSize[1];
+		const float u1 = quad.subrect[2] * inverseTextureSize[0];
+		const float v1 = quad.subrect[3] * inverseTextureSize[1];
+
+		// 左上、右上、右下、左下（BuildBillboardIndicesの並び）
+		const float cornerX[4] = { left, rightEdge, rightEdge, left };
+		const float cornerY[4] = { top, top, bottom, bottom };
+		const float cornerU[4] = { u0, u1, u1, u0 };
+		const float cornerV[4] = { v0, v0, v1, v1 };
+
+		for (int j = 0; j < 4; j++)
+		{
+			BillboardVertex& vertex = vertices[i * 4 + j];
+			for (int k = 0; k < 3; k++)
+			{
+				vertex.position[k] = position[k] + right[k] * cornerX[j] + up[k] * cornerY[j];
+			}
+			std::copy(color, color + 4, vertex.color);
+			vertex.textureCoordinate[0] = cornerU[j];
+			vertex.textureCoordinate[1] = cornerV[j];
+		}
+	}
+}
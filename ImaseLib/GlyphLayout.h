@@ -0,0 +1,145 @@
+﻿//--------------------------------------------------------------------------------------
+// File: GlyphLayout.h
+//
+// 文字列を文字ごとの四角形に並べ、3D空間の頂点に展開する関数群
+//
+// Usage: GlyphTableに文字の情報の配列（SpriteFont::Glyphと同じ並び）を渡し、
+//        LayoutGlyphs関数で文字列をピクセル単位の四角形に並べます。
+//        GlyphTableは配列を参照するだけなので、配列はテーブルより長く残してください。
+//        BMPの文字は文字コードで直接引く表、それ以外はハッシュで検索します。
+//        並べ方は SpriteFont::DrawString / MeasureString と同じです。
+//        ExpandGlyphQuads関数で四角形をワールド座標の頂点（１文字４頂点）に展開します。
+//        D3Dに依存しないので単体でビルド・検証できます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "BillboardGeometry.h"
+
+namespace Imase
+{
+	// 文字の情報（SpriteFont::Glyph、.spritefontファイルと同じ並び）
+	struct GlyphMetrics
+	{
+		// 文字コード
+		uint32_t character;
+
+		// テクスチャ内の矩形（左、上、右、下、ピクセル）
+		int32_t subrect[4];
+
+		// 描画位置のずらし量
+		float xOffset;
+		float yOffset;
+
+		// 文字の幅に加える送り量
+		float xAdvance;
+	};
+
+	static_assert(sizeof(GlyphMetrics) == 32, "GlyphMetrics must match the .spritefont glyph layout.");
+
+	// 文字１つ分の四角形
+	struct GlyphQuad
+	{
+		// 文字列内の矩形（左、上、右、下、ピクセル）
+		float position[4];
+
+		// テクスチャ内の矩形（左、上、右、下、ピクセル）
+		float subrect[4];
+	};
+
+	// 文字コードから文字の情報を検索するテーブル
+	class GlyphTable
+	{
+	private:
+
+		// 直接参照の表で文字がないことを表す値
+		static const uint32_t NO_GLYPH = 0xffffffff;
+
+		// 文字の情報の配列（参照のみ）
+		const GlyphMetrics* m_glyphs;
+		size_t m_count;
+
+		// BMPの文字の番号（m_firstCharacterからの文字コードの差で直接引く）
+		std::vector<uint32_t> m_directIndex;
+		uint32_t m_firstCharacter;
+
+		// 直接参照の表に入らない文字の番号
+		std::unordered_map<uint32_t, uint32_t> m_fallback;
+
+		// 見つからない時に使う文字
+		const GlyphMetrics* m_defaultGlyph;
+
+	public:
+
+		// コンストラクタ
+		GlyphTable() : m_glyphs(nullptr), m_count(0), m_firstCharacter(0), m_defaultGlyph(nullptr) {}
+
+		// 文字の情報の配列から表を作る関数
+		void Build(const GlyphMetrics* glyphs, size_t count);
+
+		// 見つからない時に使う文字を設定する関数（0またはフォントにない文字は使わない）
+		void SetDefaultCharacter(uint32_t character) { m_defaultGlyph = FindExact(character); }
+
+		// 文字を検索する関数（見つからなければnullptr）
+		const GlyphMetrics* FindExact(uint32_t character) const
+		{
+			uint32_t offset = character - m_firstCharacter;
+			if (offset < m_directIndex.size())
+			{
+				uint32_t index = m_directIndex[offset];
+				return index != NO_GLYPH ? &m_glyphs[index] : nullptr;
+			}
+			return FindFallback(character);
+		}
+
+		// 文字が登録されているか調べる関数
+		bool Contains(uint32_t character) const { return FindExact(character) != nullptr; }
+
+		// 文字を検索する関数（見つからなければ既定の文字、それもなければnullptr）
+		const GlyphMetrics* Find(uint32_t character) const
+		{
+			const GlyphMetrics* glyph = FindExact(character);
+			return glyph ? glyph : m_defaultGlyph;
+		}
+
+		// 登録されている文字の数を取得する関数
+		size_t GetCount() const { return m_count; }
+
+	private:
+
+		// 直接参照の表に入らない文字を検索する関数
+		const GlyphMetrics* FindFallback(uint32_t character) const;
+	};
+
+	// 文字列を文字ごとの四角形に並べる関数（quadsの末尾に追加し、textSizeにMeasureStringと同じ大きさを返す）
+	void LayoutGlyphs(
+		const GlyphTable& table,
+		const wchar_t* text,
+		float lineSpacing,
+		std::vector<GlyphQuad>& quads,
+		float textSize[2]);
+
+	// 四角形をワールド座標の頂点に展開する関数
+	//   position    : 文字列の原点のワールド座標
+	//   right, up   : 画面の右方向と上方向のワールド座標での向き（逆ビュー行列の１行目と２行目）
+	//   scale       : １ピクセルあたりのワールド座標の大きさ
+	//   origin      : positionに合わせる文字列内の位置（ピクセル）
+	//   inverseTextureSize : テクスチャの幅と高さの逆数
+	void ExpandGlyphQuads(
+		const GlyphQuad* quads,
+		size_t count,
+		const float position[3],
+		const float right[3],
+		const float up[3],
+		float scale,
+		const float origin[2],
+		const float color[4],
+		const float inverseTextureSize[2],
+		BillboardVertex* vertices);
+}
@@ -9,6 +9,7 @@
 #include "pch.h"
 #include "GridFloor.h"
 #include "DebugDraw.h"
+#include "D3DRenderStateTarget.h"
 
 using namespace DirectX;
 using namespace Imase;
@@ -51,15 +52,20 @@ GridFloor::GridFloor(
 void GridFloor::Render(
 	ID3D11DeviceContext* pContext,
 	const SimpleMath::Matrix& view,
-	const SimpleMath::Matrix& proj
+	const SimpleMath::Matrix& proj,
+	IRenderStateTarget* pStateTarget
 )
 {
+	// Xe[g̐ݒiw肪Ȃ΃foCXReLXgɒڐݒ肷j
+	D3DRenderStateTarget direct(pContext);
+	IRenderStateTarget* pTarget = pStateTarget ? pStateTarget : &direct;
+
 	// uhXe[g̐ݒisj
-	pContext->OMSetBlendState(m_pStates->Opaque(), nullptr, 0xFFFFFFFF);
+	pTarget->SetBlendState(m_pStates->Opaque(), nullptr, 0xFFFFFFFF);
 	// [xobt@̐ݒiʏj
-	pContext->OMSetDepthStencilState(m_pStates->DepthDefault(), 0);
+	pTarget->SetDepthStencilState(m_pStates->DepthDefault(), 0);
 	// JO̐ݒiJOȂj
-	pContext->RSSetState(m_pStates->CullNone());
+	pTarget->SetRasterizerState(m_pStates->CullNone());
 
 	// es̐ݒ
 	SimpleMath::Matrix world;
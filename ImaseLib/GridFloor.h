@@ -8,6 +8,8 @@
 //--------------------------------------------------------------------------------------
 #pragma once
 
+#include "RenderStateCache.h"
+
 namespace Imase
 {
 	// Obh̏\^XN
@@ -25,11 +27,12 @@ namespace Imase
 			size_t divs = FLOOR_DIVS
 		);
 
-		// `
+		// `ipStateTargetw肷ƃXe[g͂ɐݒ肷j
 		void Render(
 			ID3D11DeviceContext* pContext,
 			const DirectX::SimpleMath::Matrix& view,
-			const DirectX::SimpleMath::Matrix& proj
+			const DirectX::SimpleMath::Matrix& proj,
+			IRenderStateTarget* pStateTarget = nullptr
 		);
 
 	private:
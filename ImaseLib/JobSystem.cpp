@@ -0,0 +1,467 @@
+﻿//--------------------------------------------------------------------------------------
+// File: JobSystem.cpp
+//
+// ワークスティーリングで処理（ジョブ）を実行するクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "JobSystem.h"
+#include "CpuProfiler.h"
+
+#include <algorithm>
+#include <exception>
+
+using namespace Imase;
+
+namespace
+{
+	// キャッシュラインのバイト数（スレッドごとの変数を別のラインに置く）
+	const size_t CACHE_LINE_SIZE = 64;
+
+	// 眠る前にジョブを探す回数
+	const int SPIN_COUNT = 64;
+
+	// ParallelForで自動で分ける時の、スレッドあたりの分割数
+	const size_t SPLITS_PER_THREAD = 4;
+}
+
+// ジョブ
+struct Imase::Job
+{
+	// 処理
+	std::function<void()> function;
+
+	// 親のジョブ
+	JobHandle parent;
+
+	// 自身と子のジョブのうち終わっていない数
+	std::atomic<int> unfinished;
+
+	// 実行待ちになるまでの条件の数（Run関数の分 + 終わっていない依存するジョブの数）
+	std::atomic<int> pending;
+
+	// 終わったか
+	std::atomic<bool> finished;
+
+	// 終わった時に条件を１つ減らすジョブと、投げられた例外（mutexで保護）
+	std::mutex mutex;
+	std::vector<JobHandle> continuations;
+	std::exception_ptr error;
+
+	// キューに入っている間と実行中の自身の参照
+	JobHandle self;
+
+	Job() : unfinished(1), pending(1), finished(false) {}
+};
+
+// スレッドごとの情報
+struct JobSystem::Worker
+{
+	// Chase-Lev方式の両端キュー（盗む側が前のm_top、持ち主が後ろのm_bottomを動かす）
+	std::atomic<int64_t> top;
+	char padding0[CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+	std::atomic<int64_t> bottom;
+	char padding1[CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+	std::atomic<Job*> buffer[QUEUE_CAPACITY];
+
+	// 統計
+	std::atomic<uint64_t> executed;
+	std::atomic<uint64_t> stolen;
+
+	// 次に盗みに行くスレッドを選ぶ乱数
+	uint32_t random;
+
+	explicit Worker(uint32_t seed) : top(0), bottom(0), executed(0), stolen(0), random(seed * 2654435761u + 1)
+	{
+		for (std::atomic<Job*>& job : buffer) job.store(nullptr, std::memory_order_relaxed);
+	}
+
+	// 後ろに追加する（持ち主だけが呼ぶ。いっぱいならfalse）
+	bool Push(Job* job)
+	{
+		int64_t b = bottom.load(std::memory_order_relaxed);
+		int64_t t = top.load(std::memory_order_acquire);
+		if (b - t >= static_cast<int64_t>(QUEUE_CAPACITY)) return false;
+
+		buffer[b & (QUEUE_CAPACITY - 1)].store(job, std::memory_order_relaxed);
+		bottom.store(b + 1, std::memory_order_release);
+		return true;
+	}
+
+	// 後ろから取り出す（持ち主だけが呼ぶ）
+	Job* Pop()
+	{
+		// bottomの書き込みとtopの読み込みの順序はseq_cstの操作で守る
+		// （フェンスはThreadSanitizerが扱えないので使わない。x86ではどちらも同じ命令になる）
+		int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_seq_cst);
+		int64_t t = top.load(std::memory_order_seq_cst);
+
+		if (t > b)
+		{
+			// 空だった
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		Job* job = buffer[b & (QUEUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+		if (t == b)
+		{
+			// 最後の１つは盗む側と取り合う
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return job;
+	}
+
+	// 前から盗む（どのスレッドからでも呼べる。取り合いに負けたらnullptr）
+	Job* Steal()
+	{
+		int64_t t = top.load(std::memory_order_seq_cst);
+		int64_t b = bottom.load(std::memory_order_seq_cst);
+		if (t >= b) return nullptr;
+
+		Job* job = buffer[t & (QUEUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+		return job;
+	}
+
+	// 次の乱数（xorshift）
+	uint32_t NextRandom()
+	{
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+		return random;
+	}
+};
+
+namespace
+{
+	// 呼び出したスレッドが属するJobSystemと番号
+	thread_local const JobSystem* t_system = nullptr;
+	thread_local uint32_t t_index = 0;
+
+	// 呼び出したスレッドで実行中のジョブ
+	thread_local Job* t_currentJob = nullptr;
+}
+
+// コンストラクタ
+JobSystem::JobSystem(uint32_t workerCount)
+	: m_ownerThread(std::this_thread::get_id())
+	, m_queuedCount(0)
+	, m_sleepingCount(0)
+	, m_stop(false)
+{
+	for (uint32_t i = 0; i <= workerCount; i++)
+	{
+		m_workers.push_back(std::make_unique<Worker>(i));
+	}
+	for (uint32_t i = 1; i <= workerCount; i++)
+	{
+		m_threads.emplace_back(&JobSystem::WorkerMain, this, i);
+	}
+}
+
+// デストラクタ
+JobSystem::~JobSystem()
+{
+	// 作ったスレッドのキューに残ったジョブも実行する
+	while (Job* job = FindJob(0))
+	{
+		Execute(job, 0);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_condition.notify_all();
+
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+// ジョブを作る関数
+JobHandle JobSystem::Create(std::function<void()> function, const JobHandle& parent)
+{
+	JobHandle job = std::make_shared<Job>();
+	job->function = std::move(function);
+	if (parent)
+	{
+		job->parent = parent;
+		parent->unfinished.fetch_add(1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+// jobをprerequisiteが終わった後に実行するように設定する関数
+void JobSystem::AddDependency(const JobHandle& job, const JobHandle& prerequisite)
+{
+	job->pending.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(prerequisite->mutex);
+		if (!prerequisite->finished.load(std::memory_order_relaxed))
+		{
+			prerequisite->continuations.push_back(job);
+			return;
+		}
+	}
+
+	// もう終わっていた
+	job->pending.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// ジョブを実行待ちにする関数
+void JobSystem::Run(const JobHandle& job)
+{
+	Release(job);
+}
+
+// jobが終わった後に実行するジョブを作って実行待ちにする関数
+JobHandle JobSystem::Then(const JobHandle& job, std::function<void()> function)
+{
+	JobHandle continuation = Create(std::move(function));
+	AddDependency(continuation, job);
+	Run(continuation);
+	return continuation;
+}
+
+// ジョブが終わるまで、他のジョブを実行しながら待つ関数
+void JobSystem::Wait(const JobHandle& job)
+{
+	int index = GetThreadIndex();
+	while (!job->finished.load(std::memory_order_acquire))
+	{
+		// このJobSystemのスレッドでなければ盗むだけ
+		Job* found = FindJob(index >= 0 ? static_cast<uint32_t>(index) : 0);
+		if (found) Execute(found, index >= 0 ? static_cast<uint32_t>(index) : 0);
+		else std::this_thread::yield();
+	}
+
+	std::lock_guard<std::mutex> lock(job->mutex);
+	if (job->error) std::rethrow_exception(job->error);
+}
+
+// ジョブが終わったか
+bool JobSystem::IsFinished(const JobHandle& job)
+{
+	return job->finished.load(std::memory_order_acquire);
+}
+
+// [begin, end)を分けて実行するジョブを作る関数
+JobHandle JobSystem::CreateParallelFor(size_t begin, size_t end, size_t grain, std::function<void(size_t, size_t)> function)
+{
+	if (grain == 0) grain = std::max<size_t>(1, (end - begin) / (GetThreadCount() * SPLITS_PER_THREAD));
+
+	// 分けたジョブで同じ処理を共有する
+	auto shared = std::make_shared<std::function<void(size_t, size_t)>>(std::move(function));
+	return Create([this, begin, end, grain, shared]()
+		{
+			if (begin < end) Split(begin, end, grain, shared);
+		});
+}
+
+// [begin, end)を分けて実行し、終わるまで待つ関数
+void JobSystem::ParallelFor(size_t begin, size_t end, size_t grain, std::function<void(size_t, size_t)> function)
+{
+	JobHandle job = CreateParallelFor(begin, end, grain, std::move(function));
+	Run(job);
+	Wait(job);
+}
+
+// 実行したジョブの数
+uint64_t JobSystem::GetExecutedCount() const
+{
+	uint64_t count = 0;
+	for (const std::unique_ptr<Worker>& worker : m_workers) count += worker->executed.load(std::memory_order_relaxed);
+	return count;
+}
+
+// 他のスレッドから盗んだジョブの数
+uint64_t JobSystem::GetStolenCount() const
+{
+	uint64_t count = 0;
+	for (const std::unique_ptr<Worker>& worker : m_workers) count += worker->stolen.load(std::memory_order_relaxed);
+	return count;
+}
+
+// 実行待ちのジョブを１つ探す関数
+Job* JobSystem::FindJob(uint32_t index)
+{
+	Worker& worker = *m_workers[index];
+	bool own = GetThreadIndex() == static_cast<int>(index);
+
+	// 自分のキューの後ろから（最後に入れた、キャッシュに残っているジョブ）
+	Job* job = own ? worker.Pop() : nullptr;
+
+	// 共有のキュー
+	if (!job && m_queuedCount.load(std::memory_order_relaxed) > 0)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_sharedQueue.empty())
+		{
+			job = m_sharedQueue.front();
+			m_sharedQueue.pop_front();
+		}
+	}
+
+	// 他のスレッドのキューの前から盗む（最初に見るスレッドは乱数で選ぶ）
+	if (!job && m_workers.size() > 1)
+	{
+		size_t count = m_workers.size();
+		size_t first = own ? worker.NextRandom() % count : 0;
+		for (size_t i = 0; i < count && !job; i++)
+		{
+			size_t victim = (first + i) % count;
+			if (own && victim == index) continue;
+			job = m_workers[victim]->Steal();
+			if (job && own) worker.stolen.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	if (job) m_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+	return job;
+}
+
+// ジョブを実行する関数
+void JobSystem::Execute(Job* job, uint32_t index)
+{
+	// 終わった後に他のスレッドで参照が消えても、この関数の中では消えないようにする
+	JobHandle self = job->self;
+
+	Job* previous = t_currentJob;
+	t_currentJob = job;
+	try
+	{
+		job->function();
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock(job->mutex);
+		job->error = std::current_exception();
+	}
+	t_currentJob = previous;
+
+	// 処理とキューが持っていた参照は使い終わったので先に解放する
+	job->function = nullptr;
+	job->self.reset();
+
+	if (GetThreadIndex() == static_cast<int>(index)) m_workers[index]->executed.fetch_add(1, std::memory_order_relaxed);
+	Finish(job);
+}
+
+// ジョブか子のジョブが終わった時の関数
+void JobSystem::Finish(Job* job)
+{
+	if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+	std::vector<JobHandle> continuations;
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(job->mutex);
+		continuations.swap(job->continuations);
+		error = job->error;
+		job->finished.store(true, std::memory_order_release);
+	}
+
+	for (const JobHandle& continuation : continuations) Release(continuation);
+
+	// 親に終わったことと例外を伝える
+	JobHandle parent = std::move(job->parent);
+	if (parent)
+	{
+		if (error)
+		{
+			std::lock_guard<std::mutex> lock(parent->mutex);
+			if (!parent->error) parent->error = error;
+		}
+		Finish(parent.get());
+	}
+}
+
+// 実行の条件が１つそろった時の関数
+void JobSystem::Release(const JobHandle& job)
+{
+	if (job->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) Push(job);
+}
+
+// キューに入れる関数
+void JobSystem::Push(const JobHandle& job)
+{
+	job->self = job;
+
+	// このJobSystemのスレッドなら自分のキュー、いっぱいか他のスレッドなら共有のキューに入れる
+	int index = GetThreadIndex();
+	bool pushed = index >= 0 && m_workers[index]->Push(job.get());
+	m_queuedCount.fetch_add(1, std::memory_order_seq_cst);
+	if (!pushed)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_sharedQueue.push_back(job.get());
+	}
+
+	// 眠っているワーカースレッドがあれば起こす
+	if (m_sleepingCount.load(std::memory_order_seq_cst) > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+		}
+		m_condition.notify_one();
+	}
+}
+
+// 範囲を半分ずつに分けて実行する関数
+void JobSystem::Split(size_t begin, size_t end, size_t grain, const std::shared_ptr<std::function<void(size_t, size_t)>>& function)
+{
+	// 後ろ半分は子のジョブにして、盗まれなければこのスレッドで続けて実行する
+	JobHandle parent = t_currentJob->self;
+	while (end - begin > grain)
+	{
+		size_t middle = begin + (end - begin) / 2;
+		Run(Create([this, middle, end, grain, function]() { Split(middle, end, grain, function); }, parent));
+		end = middle;
+	}
+	(*function)(begin, end);
+}
+
+// 呼び出したスレッドの番号
+int JobSystem::GetThreadIndex() const
+{
+	if (t_system == this) return static_cast<int>(t_index);
+	if (std::this_thread::get_id() == m_ownerThread) return 0;
+	return -1;
+}
+
+// ワーカースレッドの処理
+void JobSystem::WorkerMain(uint32_t index)
+{
+	t_system = this;
+	t_index = index;
+	CpuProfiler::SetThreadName(L"Job");
+
+	for (;;)
+	{
+		// しばらくはジョブを探し続ける
+		Job* job = nullptr;
+		for (int i = 0; i < SPIN_COUNT && !job; i++)
+		{
+			job = FindJob(index);
+			if (!job) std::this_thread::yield();
+		}
+		if (job)
+		{
+			Execute(job, index);
+			continue;
+		}
+
+		// 実行待ちのジョブがなければ眠る
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_sleepingCount.fetch_add(1, std::memory_order_seq_cst);
+		m_condition.wait(lock, [this]() { return m_stop || m_queuedCount.load(std::memory_order_seq_cst) > 0; });
+		m_sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+		if (m_stop && m_queuedCount.load(std::memory_order_relaxed) == 0) return;
+	}
+}
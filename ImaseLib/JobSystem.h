@@ -0,0 +1,143 @@
+﻿//--------------------------------------------------------------------------------------
+// File: JobSystem.h
+//
+// ワークスティーリングで処理（ジョブ）を実行するクラス
+//
+// Usage: Create関数でジョブを作り、Run関数で実行待ちにします。Wait関数は終わるまでの間、
+//        待っているスレッドでも他のジョブを実行します（ブロックして待ちません）。
+//        スレッドごとにChase-Lev方式の両端キューを持ち、作ったスレッドが後ろから取り出し、
+//        仕事のないスレッドが他のスレッドのキューの前から盗みます。
+//        作ったスレッド（メインスレッド）も番号0のキューを持ち、Wait関数の間は実行に加わります。
+//        ・親を指定して作ったジョブが全て終わるまで、親のジョブは終わりません。
+//          親の実行中か、親のRun関数の前に作ってください。
+//        ・AddDependency関数で指定したジョブが終わるまで実行を待ちます（Run関数の前に呼ぶ）。
+//          Then関数は続けて実行するジョブ（継続）を作って実行待ちにします。
+//        ・ParallelFor関数は範囲を半分ずつに分けて実行し、終わるまで待ちます。
+//        ジョブが投げた例外は親に伝わり、Wait関数で投げ直されます。
+//        ワーカースレッドはCpuProfilerに"Job"という名前で登録します。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace Imase
+{
+	// ジョブ（中身はJobSystem.cppで定義する）
+	struct Job;
+
+	// ジョブの参照
+	using JobHandle = std::shared_ptr<Job>;
+
+	class JobSystem
+	{
+	public:
+
+		// スレッドごとのキューに入るジョブの数（２の累乗。あふれた分は共有のキューに入る）
+		static const size_t QUEUE_CAPACITY = 4096;
+
+	private:
+
+		// スレッドごとの情報
+		struct Worker;
+
+		// スレッド（番号0は作ったスレッドの分で、スレッドはない）
+		std::vector<std::unique_ptr<Worker>> m_workers;
+		std::vector<std::thread> m_threads;
+
+		// 作ったスレッド
+		std::thread::id m_ownerThread;
+
+		// どのスレッドのキューにも入れられなかったジョブ（m_mutexで保護）
+		std::deque<Job*> m_sharedQueue;
+
+		// 実行待ちのジョブの数と、眠っているワーカースレッドの数
+		std::atomic<int64_t> m_queuedCount;
+		std::atomic<int> m_sleepingCount;
+
+		// 眠っているワーカースレッドを起こす
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_stop;
+
+	public:
+
+		// コンストラクタ（workerCountは作るスレッドの数。0なら作ったスレッドだけで実行する）
+		explicit JobSystem(uint32_t workerCount = ThreadPool::GetDefaultThreadCount());
+
+		// デストラクタ（実行待ちのジョブは全て実行する）
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		// ジョブを作る関数（まだ実行待ちにはしない）
+		JobHandle Create(std::function<void()> function, const JobHandle& parent = nullptr);
+
+		// jobをprerequisiteが終わった後に実行するように設定する関数（jobのRun関数の前に呼ぶ）
+		void AddDependency(const JobHandle& job, const JobHandle& prerequisite);
+
+		// ジョブを実行待ちにする関数（依存するジョブが終わっていなければ、終わった時に実行待ちになる）
+		void Run(const JobHandle& job);
+
+		// jobが終わった後に実行するジョブを作って実行待ちにする関数
+		JobHandle Then(const JobHandle& job, std::function<void()> function);
+
+		// ジョブ（と子のジョブ）が終わるまで、他のジョブを実行しながら待つ関数
+		void Wait(const JobHandle& job);
+
+		// ジョブが終わったか
+		static bool IsFinished(const JobHandle& job);
+
+		// [begin, end)を分けて実行するジョブを作る関数（function(first, last)を呼ぶ。grainは１回の最大数、0は自動）
+		JobHandle CreateParallelFor(size_t begin, size_t end, size_t grain, std::function<void(size_t, size_t)> function);
+
+		// [begin, end)を分けて実行し、終わるまで待つ関数
+		void ParallelFor(size_t begin, size_t end, size_t grain, std::function<void(size_t, size_t)> function);
+
+		// 実行するスレッドの数（作ったスレッドを含む）
+		size_t GetThreadCount() const { return m_workers.size(); }
+
+		// 実行したジョブの数と、そのうち他のスレッドから盗んだ数
+		uint64_t GetExecutedCount() const;
+		uint64_t GetStolenCount() const;
+
+	private:
+
+		// 実行待ちのジョブを１つ探す関数（なければnullptr）
+		Job* FindJob(uint32_t index);
+
+		// ジョブを実行する関数
+		void Execute(Job* job, uint32_t index);
+
+		// ジョブか子のジョブが終わった時の関数
+		void Finish(Job* job);
+
+		// 実行の条件が１つそろった時の関数（全てそろえば実行待ちにする）
+		void Release(const JobHandle& job);
+
+		// キューに入れる関数
+		void Push(const JobHandle& job);
+
+		// 範囲を半分ずつに分けて実行する関数
+		void Split(size_t begin, size_t end, size_t grain, const std::shared_ptr<std::function<void(size_t, size_t)>>& function);
+
+		// 呼び出したスレッドの番号（このJobSystemのスレッドでなければ-1）
+		int GetThreadIndex() const;
+
+		// ワーカースレッドの処理
+		void WorkerMain(uint32_t index);
+	};
+}
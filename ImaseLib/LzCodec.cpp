@@ -0,0 +1,275 @@
+﻿//--------------------------------------------------------------------------------------
+// File: LzCodec.cpp
+//
+// バイト列を圧縮・展開する簡単なLZ77形式のコーデック
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "LzCodec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace Imase;
+
+//
+// 形式は並びの繰り返しです。
+//   トークン（上位4ビットがリテラルの長さ、下位4ビットが一致の長さ - MIN_MATCH）
+//   リテラルの長さの続き（トークンの値が15の時、255の間続く）
+//   リテラル
+//   一致の距離（2バイト、リトルエンディアン）
+//   一致の長さの続き（トークンの値が15の時、255の間続く）
+// 最後の並びはリテラルだけで終わります。
+//
+namespace
+{
+	// 一致の最小の長さ
+	const size_t MIN_MATCH = 4;
+
+	// 一致を探さない末尾のバイト数（最後の並びは必ずリテラルになる）
+	const size_t LAST_LITERALS = 5;
+
+	// 一致の最大の距離
+	const size_t MAX_DISTANCE = 65535;
+
+	// トークンの長さの上限（これ以上は続きのバイトで表す）
+	const size_t TOKEN_LENGTH_MASK = 15;
+
+	// ハッシュテーブルのビット数
+	const int HASH_BITS = 14;
+
+	// 4バイトを読む
+	uint32_t Read32(const uint8_t* p)
+	{
+		uint32_t value;
+		std::memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	// 4バイトのハッシュ
+	uint32_t Hash(uint32_t value)
+	{
+		return (value * 2654435761u) >> (32 - HASH_BITS);
+	}
+
+	// 書き込み先（容量を超えたら失敗にする）
+	class Writer
+	{
+	private:
+
+		uint8_t* m_data;
+		size_t m_capacity;
+		size_t m_position;
+		bool m_overflow;
+
+	public:
+
+		Writer(uint8_t* data, size_t capacity) : m_data(data), m_capacity(capacity), m_position(0), m_overflow(false) {}
+
+		void Put(uint8_t value)
+		{
+			if (m_position >= m_capacity)
+			{
+				m_overflow = true;
+				return;
+			}
+			m_data[m_position++] = value;
+		}
+
+		void Put(const uint8_t* data, size_t size)
+		{
+			if (size > m_capacity - m_position)
+			{
+				m_overflow = true;
+				return;
+			}
+			std::memcpy(m_data + m_position, data, size);
+			m_position += size;
+		}
+
+		// 長さの続きを書き込む
+		void PutLength(size_t length)
+		{
+			while (length >= 255)
+			{
+				Put(255);
+				length -= 255;
+			}
+			Put(static_cast<uint8_t>(length));
+		}
+
+		size_t GetPosition() const { return m_position; }
+		bool HasOverflowed() const { return m_overflow; }
+	};
+
+	// 並びを一つ書き込む（matchLengthが0の時はリテラルだけ）
+	void WriteSequence(Writer& writer, const uint8_t* literals, size_t literalLength, size_t distance, size_t matchLength)
+	{
+		size_t matchCode = matchLength ? matchLength - MIN_MATCH : 0;
+		uint8_t token = static_cast<uint8_t>(
+			(std::min(literalLength, TOKEN_LENGTH_MASK) << 4) | std::min(matchCode, TOKEN_LENGTH_MASK));
+		writer.Put(token);
+		if (literalLength >= TOKEN_LENGTH_MASK) writer.PutLength(literalLength - TOKEN_LENGTH_MASK);
+		writer.Put(literals, literalLength);
+
+		if (matchLength == 0) return;
+
+		writer.Put(static_cast<uint8_t>(distance & 0xff));
+		writer.Put(static_cast<uint8_t>(distance >> 8));
+		if (matchCode >= TOKEN_LENGTH_MASK) writer.PutLength(matchCode - TOKEN_LENGTH_MASK);
+	}
+
+	// 展開でまとめて写すバイト数
+	const size_t COPY_CHUNK = 16;
+
+	// 展開でsizeバイトを固定の長さでまとめて写す（末尾をCOPY_CHUNK - 1バイトまで書きすぎる）
+	void CopyChunks(uint8_t* destination, const uint8_t* source, size_t size)
+	{
+		for (size_t i = 0; i < size; i += COPY_CHUNK) std::memcpy(destination + i, source + i, COPY_CHUNK);
+	}
+
+	// 展開で長さの続きを読む
+	size_t ReadLength(const uint8_t*& source, const uint8_t* end)
+	{
+		size_t length = 0;
+		uint8_t value;
+		do
+		{
+			if (source >= end) throw std::runtime_error("Compressed data is truncated.");
+			value = *source++;
+			length += value;
+		} while (value == 255);
+		return length;
+	}
+}
+
+// 圧縮したデータの最大サイズを求める関数
+size_t Imase::LzCompressBound(size_t size)
+{
+	// 全てリテラルの時は、トークンと255バイトごとの続きが増える
+	return size + size / 255 + 16;
+}
+
+// 圧縮する関数
+size_t Imase::LzCompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t capacity)
+{
+	Writer writer(destination, capacity);
+
+	size_t anchor = 0;
+	if (sourceSize > MIN_MATCH + LAST_LITERALS)
+	{
+		// 4バイトの値ごとに最後に現れた位置（+1、0は未登録）
+		std::vector<uint32_t> table(static_cast<size_t>(1) << HASH_BITS, 0);
+
+		size_t matchLimit = sourceSize - LAST_LITERALS;
+		size_t position = 0;
+		while (position + MIN_MATCH <= matchLimit)
+		{
+			uint32_t value = Read32(source + position);
+			uint32_t& slot = table[Hash(value)];
+			size_t candidate = slot;
+			slot = static_cast<uint32_t>(position + 1);
+
+			if (candidate == 0 || position - (candidate - 1) > MAX_DISTANCE || Read32(source + candidate - 1) != value)
+			{
+				position++;
+				continue;
+			}
+			candidate--;
+
+			// 一致を伸ばす
+			size_t length = MIN_MATCH;
+			while (position + length < matchLimit && source[candidate + length] == source[position + length])
+			{
+				length++;
+			}
+
+			WriteSequence(writer, source + anchor, position - anchor, position - candidate, length);
+			if (writer.HasOverflowed()) return 0;
+
+			// 一致の終わりの手前も登録しておく
+			position += length;
+			if (position + MIN_MATCH <= matchLimit)
+			{
+				table[Hash(Read32(source + position - 2))] = static_cast<uint32_t>(position - 2 + 1);
+			}
+			anchor = position;
+		}
+	}
+
+	WriteSequence(writer, source + anchor, sourceSize - anchor, 0, 0);
+	if (writer.HasOverflowed()) return 0;
+
+	return writer.GetPosition();
+}
+
+// 展開する関数
+void Imase::LzDecompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize)
+{
+	const uint8_t* end = source + sourceSize;
+	size_t position = 0;
+
+	while (true)
+	{
+		if (source >= end) throw std::runtime_error("Compressed data is truncated.");
+		uint8_t token = *source++;
+
+		// リテラル
+		size_t literalLength = token >> 4;
+		if (literalLength == TOKEN_LENGTH_MASK) literalLength += ReadLength(source, end);
+		if (literalLength > static_cast<size_t>(end - source) || literalLength > destinationSize - position)
+		{
+			throw std::runtime_error("Compressed data is corrupt.");
+		}
+		if (literalLength + COPY_CHUNK - 1 <= std::min(static_cast<size_t>(end - source), destinationSize - position))
+		{
+			CopyChunks(destination + position, source, literalLength);
+		}
+		else if (literalLength)
+		{
+			std::memcpy(destination + position, source, literalLength);
+		}
+		source += literalLength;
+		position += literalLength;
+
+		// 最後の並びはリテラルだけ
+		if (source == end) break;
+
+		// 一致
+		if (end - source < 2) throw std::runtime_error("Compressed data is truncated.");
+		size_t distance = static_cast<size_t>(source[0]) | (static_cast<size_t>(source[1]) << 8);
+		source += 2;
+
+		size_t matchLength = token & TOKEN_LENGTH_MASK;
+		if (matchLength == TOKEN_LENGTH_MASK) matchLength += ReadLength(source, end);
+		matchLength += MIN_MATCH;
+
+		if (distance == 0 || distance > position || matchLength > destinationSize - position)
+		{
+			throw std::runtime_error("Compressed data is corrupt.");
+		}
+
+		uint8_t* output = destination + position;
+		const uint8_t* match = output - distance;
+		if (distance >= COPY_CHUNK && matchLength + COPY_CHUNK - 1 <= destinationSize - position)
+		{
+			CopyChunks(output, match, matchLength);
+		}
+		else
+		{
+			// 重なっている時は、写し終えた範囲がdistanceの周期で繰り返すことを使って倍々に写す
+			size_t copied = 0;
+			while (copied < matchLength)
+			{
+				size_t length = std::min(distance + copied, matchLength - copied);
+				std::memcpy(output + copied, match, length);
+				copied += length;
+			}
+		}
+		position += matchLength;
+	}
+
+	if (position != destinationSize) throw std::runtime_error("Compressed data has the wrong size.");
+}
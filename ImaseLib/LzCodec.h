@@ -0,0 +1,28 @@
+﻿//--------------------------------------------------------------------------------------
+// File: LzCodec.h
+//
+// バイト列を圧縮・展開する簡単なLZ77形式のコーデック
+//
+// Usage: LzCompress関数で圧縮し、LzDecompress関数で展開します。
+//        展開は速さを優先し、圧縮は4バイトのハッシュで一致を探すだけの単純なものです。
+//        形式はLZ4のブロックに近く、一つのブロックだけで完結します（辞書は持ち越しません）。
+//        展開する時は全ての範囲を確認し、壊れたデータは std::runtime_error を投げます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Imase
+{
+	// 圧縮したデータの最大サイズを求める関数（圧縮できないデータでもこれ以下になる）
+	size_t LzCompressBound(size_t size);
+
+	// 圧縮する関数（圧縮後のサイズを返す。capacityに収まらない時は0を返す）
+	size_t LzCompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t capacity);
+
+	// 展開する関数（展開後のサイズがdestinationSizeと一致しない時も例外を投げる）
+	void LzDecompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize);
+}
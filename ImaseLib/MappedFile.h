@@ -0,0 +1,59 @@
+﻿//--------------------------------------------------------------------------------------
+// File: MappedFile.h
+//
+// ファイルを読み取り専用でメモリにマップするクラス
+//
+// Usage: コンストラクタでファイルを開き、GetData関数でファイルの中身を直接参照します。
+//        ファイルは読み込まずにOSのページとして参照するので、コピーは発生しません。
+//        開けなかった時は std::runtime_error を投げます。
+//        POSIXではファイル名の '\' を '/' に置き換えて開きます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Imase
+{
+	class MappedFile
+	{
+	private:
+
+		// ファイルの中身（空のファイルはnullptr）
+		const uint8_t* m_data;
+
+		// ファイルのサイズ
+		size_t m_size;
+
+	public:
+
+		// コンストラクタ（何も開いていない状態）
+		MappedFile() : m_data(nullptr), m_size(0) {}
+
+		// コンストラクタ（ファイルを開く）
+		explicit MappedFile(const wchar_t* fileName);
+
+		// デストラクタ
+		~MappedFile() { Close(); }
+
+		// ムーブのみ可能
+		MappedFile(MappedFile&& other);
+		MappedFile& operator=(MappedFile&& other);
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// マップを解除する関数
+		void Close();
+
+		// ファイルの中身を取得する関数
+		const uint8_t* GetData() const { return m_data; }
+
+		// ファイルのサイズを取得する関数
+		size_t GetSize() const { return m_size; }
+	};
+
+	// マップした範囲のページを触ってメモリに読み込む関数（ページフォルトを呼び出したスレッドで済ませる）
+	void TouchPages(const uint8_t* data, size_t size);
+}
@@ -0,0 +1,495 @@
+﻿//--------------------------------------------------------------------------------------
+// File: MipGenerator.cpp
+//
+// テクスチャのミップマップをCPUで作成する関数群
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(IMASE_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+using namespace Imase;
+
+namespace
+{
+	// Kaiser窓の形（大きいほど裾が小さくなる）と、縮小後のピクセル単位の半径
+	const float KAISER_ALPHA = 4.0f;
+	const float KAISER_RADIUS = 3.0f;
+
+	// カバレッジを合わせるアルファの拡大率の上限と、二分探索の回数
+	const float MAX_ALPHA_SCALE = 4.0f;
+	const int COVERAGE_SEARCH_STEPS = 16;
+
+	const float PI = 3.14159265358979f;
+
+	// sRGBの変換表
+	struct SrgbTables
+	{
+		// 8ビットの値からリニアの値
+		float toLinear[256];
+
+		// 8ビットの値の境目のリニアの値（k + 0.5に当たる値）
+		float thresholds[255];
+
+		SrgbTables()
+		{
+			for (int i = 0; i < 256; i++) toLinear[i] = SrgbToLinear(i / 255.0f);
+			for (int i = 0; i < 255; i++) thresholds[i] = SrgbToLinear((i + 0.5f) / 255.0f);
+		}
+
+		static float SrgbToLinear(float value)
+		{
+			return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+	};
+
+	const SrgbTables& GetSrgbTables()
+	{
+		static const SrgbTables s_tables;
+		return s_tables;
+	}
+
+	// 0～1の値を8ビットにする
+	uint8_t ToUnorm8(float value)
+	{
+		return static_cast<uint8_t>(std::lround(std::min(std::max(value, 0.0f), 1.0f) * 255.0f));
+	}
+
+	// リニアの値をsRGBの8ビットにする（境目の表を二分探索する）
+	uint8_t ToSrgb8(float value, const SrgbTables& tables)
+	{
+		return static_cast<uint8_t>(std::upper_bound(tables.thresholds, tables.thresholds + 255, value) - tables.thresholds);
+	}
+
+	// 縮小に使う元のピクセルと重み（全ての出力で数をそろえ、足りない分は重み0）
+	struct FilterTaps
+	{
+		int count;
+		std::vector<int> index;
+		std::vector<float> weight;
+	};
+
+	// 0次の第1種変形ベッセル関数
+	float BesselI0(float x)
+	{
+		float sum = 1.0f;
+		float term = 1.0f;
+		for (int k = 1; k < 32; k++)
+		{
+			float t = x / (2.0f * k);
+			term *= t * t;
+			sum += term;
+			if (term < sum * 1e-8f) break;
+		}
+		return sum;
+	}
+
+	// Kaiser窓のsinc（xは縮小後のピクセル単位）
+	float KaiserSinc(float x)
+	{
+		if (std::fabs(x) >= KAISER_RADIUS) return 0.0f;
+
+		float sinc = x == 0.0f ? 1.0f : std::sin(PI * x) / (PI * x);
+		float r = x / KAISER_RADIUS;
+		return sinc * BesselI0(KAISER_ALPHA * std::sqrt(1.0f - r * r)) / BesselI0(KAISER_ALPHA);
+	}
+
+	// 元のピクセルの番号を範囲に収める
+	int AddressPixel(int index, int size, bool wrap)
+	{
+		if (wrap) return ((index % size) + size) % size;
+		return std::min(std::max(index, 0), size - 1);
+	}
+
+	// 1方向の縮小の重みを作る
+	FilterTaps MakeFilterTaps(uint32_t sourceSize, uint32_t destinationSize, MipFilter filter, bool wrap)
+	{
+		float scale = static_cast<float>(sourceSize) / destinationSize;
+		float radius = filter == MipFilter::Box ? scale * 0.5f : KAISER_RADIUS * scale;
+
+		FilterTaps taps;
+		taps.count = static_cast<int>(std::ceil(radius * 2.0f)) + 1;
+		taps.index.resize(static_cast<size_t>(destinationSize) * taps.count);
+		taps.weight.resize(static_cast<size_t>(destinationSize) * taps.count);
+
+		for (uint32_t i = 0; i < destinationSize; i++)
+		{
+			float center = (i + 0.5f) * scale;
+			int first = static_cast<int>(std::floor(center - radius));
+
+			float total = 0.0f;
+			for (int k = 0; k < taps.count; k++)
+			{
+				int j = first + k;
+				float weight;
+				if (filter == MipFilter::Box)
+				{
+					// ピクセル [j, j + 1) が範囲に重なる長さ
+					weight = std::max(0.0f, std::min(j + 1.0f, center + radius) - std::max(static_cast<float>(j), center - radius));
+				}
+				else
+				{
+					weight = KaiserSinc((j + 0.5f - center) / scale);
+				}
+
+				size_t tap = static_cast<size_t>(i) * taps.count + k;
+				taps.index[tap] = AddressPixel(j, static_cast<int>(sourceSize), wrap);
+				taps.weight[tap] = weight;
+				total += weight;
+			}
+
+			for (int k = 0; k < taps.count; k++) taps.weight[static_cast<size_t>(i) * taps.count + k] /= total;
+		}
+		return taps;
+	}
+
+	//----------------------------------------------------------------------------------
+	// 横方向の縮小（出力のピクセルごとに元の行のピクセルを重み付けして足す）
+	//----------------------------------------------------------------------------------
+
+	void FilterRowScalar(const float* source, float* destination, uint32_t width, const FilterTaps& taps)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			const int* index = taps.index.data() + static_cast<size_t>(x) * taps.count;
+			const float* weight = taps.weight.data() + static_cast<size_t>(x) * taps.count;
+			for (int c = 0; c < 4; c++)
+			{
+				float sum = 0.0f;
+				for (int k = 0; k < taps.count; k++) sum += weight[k] * source[index[k] * 4 + c];
+				destination[x * 4 + c] = sum;
+			}
+		}
+	}
+
+	//----------------------------------------------------------------------------------
+	// 縦方向の縮小（出力の行ごとに元の行を重み付けして足す）
+	//----------------------------------------------------------------------------------
+
+	void FilterColumnsScalar(const float* const* rows, const float* weight, int count, float* destination, size_t size)
+	{
+		for (size_t i = 0; i < size; i++)
+		{
+			float sum = 0.0f;
+			for (int k = 0; k < count; k++) sum += weight[k] * rows[k][i];
+			destination[i] = sum;
+		}
+	}
+
+#if defined(IMASE_SIMD_X86)
+
+	// SSE2版（１ピクセルのRGBAを１つのレジスタで）
+	void FilterRowSSE2(const float* source, float* destination, uint32_t width, const FilterTaps& taps)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			const int* index = taps.index.data() + static_cast<size_t>(x) * taps.count;
+			const float* weight = taps.weight.data() + static_cast<size_t>(x) * taps.count;
+			__m128 sum = _mm_setzero_ps();
+			for (int k = 0; k < taps.count; k++)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weight[k]), _mm_loadu_ps(source + index[k] * 4)));
+			}
+			_mm_storeu_ps(destination + x * 4, sum);
+		}
+	}
+
+	// SSE2版（４つずつ）
+	size_t FilterColumnsSSE2(const float* const* rows, const float* weight, int count, float* destination, size_t size)
+	{
+		size_t i = 0;
+		for (; i + 4 <= size; i += 4)
+		{
+			__m128 sum = _mm_setzero_ps();
+			for (int k = 0; k < count; k++)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weight[k]), _mm_loadu_ps(rows[k] + i)));
+			}
+			_mm_storeu_ps(destination + i, sum);
+		}
+		return i;
+	}
+
+	// AVX2版（２ピクセルずつ）
+	IMASE_TARGET_AVX2
+	void FilterRowAVX2(const float* source, float* destination, uint32_t width, const FilterTaps& taps)
+	{
+		uint32_t x = 0;
+		for (; x + 2 <= width; x += 2)
+		{
+			const int* index0 = taps.index.data() + static_cast<size_t>(x) * taps.count;
+			const int* index1 = index0 + taps.count;
+			const float* weight0 = taps.weight.data() + static_cast<size_t>(x) * taps.count;
+			const float* weight1 = weight0 + taps.count;
+			__m256 sum = _mm256_setzero_ps();
+			for (int k = 0; k < taps.count; k++)
+			{
+				__m256 pixels = _mm256_insertf128_ps(
+					_mm256_castps128_ps256(_mm_loadu_ps(source + index0[k] * 4)), _mm_loadu_ps(source + index1[k] * 4), 1);
+				__m256 weights = _mm256_insertf128_ps(
+					_mm256_castps128_ps256(_mm_set1_ps(weight0[k])), _mm_set1_ps(weight1[k]), 1);
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(weights, pixels));
+			}
+			_mm256_storeu_ps(destination + x * 4, sum);
+		}
+
+		// 奇数の幅の最後のピクセル
+		if (x < width)
+		{
+			const int* index = taps.index.data() + static_cast<size_t>(x) * taps.count;
+			const float* weight = taps.weight.data() + static_cast<size_t>(x) * taps.count;
+			__m128 sum = _mm_setzero_ps();
+			for (int k = 0; k < taps.count; k++)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weight[k]), _mm_loadu_ps(source + index[k] * 4)));
+			}
+			_mm_storeu_ps(destination + x * 4, sum);
+		}
+	}
+
+	// AVX2版（８つずつ）
+	IMASE_TARGET_AVX2
+	size_t FilterColumnsAVX2(const float* const* rows, const float* weight, int count, float* destination, size_t size)
+	{
+		size_t i = 0;
+		for (; i + 8 <= size; i += 8)
+		{
+			__m256 sum = _mm256_setzero_ps();
+			for (int k = 0; k < count; k++)
+			{
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weight[k]), _mm256_loadu_ps(rows[k] + i)));
+			}
+			_mm256_storeu_ps(destination + i, sum);
+		}
+		return i;
+	}
+
+#endif
+
+	// 命令セットを切り替えて横方向に縮小する
+	void FilterRow(const float* source, float* destination, uint32_t width, const FilterTaps& taps, SimdLevel level)
+	{
+#if defined(IMASE_SIMD_X86)
+		switch (level)
+		{
+		case SimdLevel::AVX2:
+			FilterRowAVX2(source, destination, width, taps);
+			return;
+		case SimdLevel::SSE2:
+			FilterRowSSE2(source, destination, width, taps);
+			return;
+		default:
+			break;
+		}
+#else
+		(void)level;
+#endif
+		FilterRowScalar(source, destination, width, taps);
+	}
+
+	// 命令セットを切り替えて縦方向に縮小する
+	void FilterColumns(const float* const* rows, const float* weight, int count, float* destination, size_t size, SimdLevel level)
+	{
+		size_t done = 0;
+#if defined(IMASE_SIMD_X86)
+		switch (level)
+		{
+		case SimdLevel::AVX2:
+			done = FilterColumnsAVX2(rows, weight, count, destination, size);
+			break;
+		case SimdLevel::SSE2:
+			done = FilterColumnsSSE2(rows, weight, count, destination, size);
+			break;
+		default:
+			break;
+		}
+#else
+		(void)level;
+#endif
+
+		// 残りはスカラーで計算する
+		std::vector<const float*> rest(rows, rows + count);
+		for (const float*& row : rest) row += done;
+		FilterColumnsScalar(rest.data(), weight, count, destination + done, size - done);
+	}
+
+	// アルファを拡大した値が基準値より大きいか（8ビットにした値で比べる）
+	bool PassesAlphaTest(float alpha, float alphaScale, int alphaReference)
+	{
+		return ToUnorm8(alpha * alphaScale) > alphaReference;
+	}
+
+	// 並べ替えたアルファのうち、拡大するとアルファテストを通るものの割合
+	float GetSortedCoverage(const std::vector<float>& alphas, int alphaReference, float alphaScale)
+	{
+		std::vector<float>::const_iterator first = std::partition_point(alphas.begin(), alphas.end(),
+			[alphaReference, alphaScale](float alpha) { return !PassesAlphaTest(alpha, alphaScale, alphaReference); });
+		return static_cast<float>(alphas.end() - first) / alphas.size();
+	}
+
+	// カバレッジが目標に最も近くなるアルファの拡大率を求める
+	// （アルファを並べ替えておき、拡大率ごとのカバレッジは二分探索で数える）
+	float FindAlphaScale(const MipImage& image, int alphaReference, float targetCoverage)
+	{
+		std::vector<float> alphas;
+		alphas.reserve(image.rgba.size() / 4);
+		for (size_t i = 3; i < image.rgba.size(); i += 4) alphas.push_back(image.rgba[i]);
+		std::sort(alphas.begin(), alphas.end());
+
+		float low = 0.0f;
+		float high = MAX_ALPHA_SCALE;
+		for (int step = 0; step < COVERAGE_SEARCH_STEPS; step++)
+		{
+			float middle = (low + high) * 0.5f;
+			if (GetSortedCoverage(alphas, alphaReference, middle) < targetCoverage) low = middle;
+			else high = middle;
+		}
+
+		float lowError = std::fabs(GetSortedCoverage(alphas, alphaReference, low) - targetCoverage);
+		float highError = std::fabs(GetSortedCoverage(alphas, alphaReference, high) - targetCoverage);
+		return lowError < highError ? low : high;
+	}
+}
+
+// 大きさから1x1までのレベル数を求める関数
+uint32_t Imase::CountMipLevels(uint32_t width, uint32_t height)
+{
+	uint32_t size = std::max(width, height);
+	uint32_t levels = 1;
+	while (size > 1)
+	{
+		size >>= 1;
+		levels++;
+	}
+	return levels;
+}
+
+// 8ビットのRGBAを読み込む関数
+void Imase::LoadMipImage(const uint8_t* rgba, uint32_t width, uint32_t height, size_t rowPitch, bool srgb, MipImage& image)
+{
+	const SrgbTables& tables = GetSrgbTables();
+
+	image.width = width;
+	image.height = height;
+	image.rgba.resize(static_cast<size_t>(width) * height * 4);
+
+	float* output = image.rgba.data();
+	for (uint32_t y = 0; y < height; y++)
+	{
+		const uint8_t* row = rgba + y * rowPitch;
+		for (uint32_t x = 0; x < width * 4; x += 4, output += 4)
+		{
+			for (int c = 0; c < 3; c++) output[c] = srgb ? tables.toLinear[row[x + c]] : row[x + c] / 255.0f;
+			output[3] = row[x + 3] / 255.0f;
+		}
+	}
+}
+
+// 8ビットのRGBAに書き出す関数
+void Imase::StoreMipImage(const MipImage& image, bool srgb, uint8_t* rgba)
+{
+	const SrgbTables& tables = GetSrgbTables();
+
+	const float* input = image.rgba.data();
+	size_t count = static_cast<size_t>(image.width) * image.height * 4;
+	for (size_t i = 0; i < count; i += 4)
+	{
+		for (int c = 0; c < 3; c++) rgba[i + c] = srgb ? ToSrgb8(input[i + c], tables) : ToUnorm8(input[i + c]);
+		rgba[i + 3] = ToUnorm8(input[i + 3]);
+	}
+}
+
+// 半分の大きさに縮小する関数
+void Imase::DownsampleMipImage(const MipImage& source, MipImage& destination, const MipOptions& options)
+{
+	SimdLevel level = options.level > GetSimdLevel() ? GetSimdLevel() : options.level;
+
+	uint32_t width = std::max(1u, source.width / 2);
+	uint32_t height = std::max(1u, source.height / 2);
+	FilterTaps horizontal = MakeFilterTaps(source.width, width, options.filter, options.wrap);
+	FilterTaps vertical = MakeFilterTaps(source.height, height, options.filter, options.wrap);
+
+	// 横に縮小した全ての行
+	size_t rowSize = static_cast<size_t>(width) * 4;
+	std::vector<float> rows(rowSize * source.height);
+	for (uint32_t y = 0; y < source.height; y++)
+	{
+		FilterRow(source.rgba.data() + static_cast<size_t>(y) * source.width * 4, rows.data() + y * rowSize, width, horizontal, level);
+	}
+
+	// 縦に縮小する
+	destination.width = width;
+	destination.height = height;
+	destination.rgba.resize(rowSize * height);
+
+	std::vector<const float*> taps(vertical.count);
+	for (uint32_t y = 0; y < height; y++)
+	{
+		for (int k = 0; k < vertical.count; k++)
+		{
+			taps[k] = rows.data() + vertical.index[static_cast<size_t>(y) * vertical.count + k] * rowSize;
+		}
+		FilterColumns(taps.data(), vertical.weight.data() + static_cast<size_t>(y) * vertical.count, vertical.count,
+			destination.rgba.data() + y * rowSize, rowSize, level);
+	}
+}
+
+// アルファが基準値より大きいピクセルの割合を求める関数
+float Imase::GetAlphaCoverage(const MipImage& image, int alphaReference, float alphaScale)
+{
+	size_t count = static_cast<size_t>(image.width) * image.height;
+	if (count == 0) return 0.0f;
+
+	size_t passed = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (PassesAlphaTest(image.rgba[i * 4 + 3], alphaScale, alphaReference)) passed++;
+	}
+	return static_cast<float>(passed) / count;
+}
+
+// 全てのミップマップを作る関数
+void Imase::GenerateMipChain(std::vector<MipImage>& levels, const MipOptions& options,
+	std::vector<MipLevelStatistics>* statistics)
+{
+	uint32_t levelCount = CountMipLevels(levels[0].width, levels[0].height);
+	levels.resize(levelCount);
+
+	bool preserveCoverage = options.alphaReference >= 0;
+	float targetCoverage = preserveCoverage ? GetAlphaCoverage(levels[0], options.alphaReference) : 0.0f;
+	if (statistics) statistics->assign(1, MipLevelStatistics{ targetCoverage, targetCoverage, 1.0f });
+
+	// 次のレベルはアルファを拡大する前の画像から作る
+	MipImage current;
+	const MipImage* source = &levels[0];
+	for (uint32_t level = 1; level < levelCount; level++)
+	{
+		MipImage next;
+		DownsampleMipImage(*source, next, options);
+
+		MipImage& output = levels[level];
+		output = next;
+
+		MipLevelStatistics levelStatistics = { 0.0f, 0.0f, 1.0f };
+		if (preserveCoverage)
+		{
+			levelStatistics.coverageBefore = GetAlphaCoverage(next, options.alphaReference);
+			levelStatistics.alphaScale = FindAlphaScale(next, options.alphaReference, targetCoverage);
+			for (size_t i = 3; i < output.rgba.size(); i += 4)
+			{
+				output.rgba[i] = std::min(output.rgba[i] * levelStatistics.alphaScale, 1.0f);
+			}
+			levelStatistics.coverageAfter = GetAlphaCoverage(output, options.alphaReference);
+		}
+		if (statistics) statistics->push_back(levelStatistics);
+
+		current = std::move(next);
+		source = &current;
+	}
+}
@@ -0,0 +1,88 @@
+﻿//--------------------------------------------------------------------------------------
+// File: MipGenerator.h
+//
+// テクスチャのミップマップをCPUで作成する関数群
+//
+// Usage: LoadMipImage関数で8ビットのRGBAを実数の画像にし、GenerateMipChain関数で
+//        1x1までの全てのミップマップを作り、StoreMipImage関数で8ビットに戻します。
+//        色は既定でsRGBとして扱い、リニアに直してから縮小します（アルファはそのまま）。
+//        フィルターは2x2の平均（Box、奇数の大きさは面積で重み付け）と、Kaiser窓の
+//        sinc（Kaiser、ぼけにくいが輪郭に少しリンギングが出る）から選べます。
+//        alphaReferenceを指定すると、AlphaTestEffectでアルファがこの値より大きいピクセル
+//        の割合（カバレッジ）が元の画像と同じになるように各レベルのアルファを拡大します。
+//        縮小の計算はSSE2/AVX2を実行時に切り替えます。どの命令セットでも結果は同じです。
+//        D3Dに依存しないので単体でビルド・検証できます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CpuFeatures.h"
+
+namespace Imase
+{
+	// 縮小のフィルター
+	enum class MipFilter
+	{
+		Box,
+		Kaiser,
+	};
+
+	// 実数のRGBAの画像（色はリニア、0～1）
+	struct MipImage
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<float> rgba;
+	};
+
+	// ミップマップの作成の設定
+	struct MipOptions
+	{
+		// フィルター
+		MipFilter filter = MipFilter::Box;
+
+		// 端を繰り返す（タイル状に並べるテクスチャ用。falseは端のピクセルを延ばす）
+		bool wrap = false;
+
+		// カバレッジを保つアルファテストの基準値（0～255、負の値は保たない）
+		int alphaReference = -1;
+
+		// 使う命令セットの上限
+		SimdLevel level = GetSimdLevel();
+	};
+
+	// 作成したレベルの情報
+	struct MipLevelStatistics
+	{
+		// アルファテストを通るピクセルの割合（アルファの拡大の前と後、8ビットにした値で数える）
+		float coverageBefore;
+		float coverageAfter;
+
+		// アルファに掛けた値
+		float alphaScale;
+	};
+
+	// 大きさから1x1までのレベル数を求める関数
+	uint32_t CountMipLevels(uint32_t width, uint32_t height);
+
+	// 8ビットのRGBAを読み込む関数（srgbがtrueなら色をリニアに直す）
+	void LoadMipImage(const uint8_t* rgba, uint32_t width, uint32_t height, size_t rowPitch, bool srgb, MipImage& image);
+
+	// 8ビットのRGBAに書き出す関数（行の間は詰める）
+	void StoreMipImage(const MipImage& image, bool srgb, uint8_t* rgba);
+
+	// 半分の大きさ（1未満は1）に縮小する関数
+	void DownsampleMipImage(const MipImage& source, MipImage& destination, const MipOptions& options);
+
+	// アルファが基準値より大きいピクセルの割合を求める関数（8ビットにした値で数える）
+	float GetAlphaCoverage(const MipImage& image, int alphaReference, float alphaScale = 1.0f);
+
+	// 全てのミップマップを作る関数（levels[0]に元の画像を入れて渡す。statisticsはレベルごと）
+	void GenerateMipChain(std::vector<MipImage>& levels, const MipOptions& options,
+		std::vector<MipLevelStatistics>* statistics = nullptr);
+}
@@ -0,0 +1,266 @@
+﻿//--------------------------------------------------------------------------------------
+// File: QuantizedVertex.cpp
+//
+// 頂点を小さな整数や半精度浮動小数点数に詰めて保存するための関数群
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "QuantizedVertex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace Imase;
+
+namespace
+{
+	// 16bitのSNORMの最大値
+	const float SNORM16_MAX = 32767.0f;
+
+	// 符号（0は正とする）
+	float SignNotZero(float value)
+	{
+		return value >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	// 八面体の展開（正規化済みの法線から-1～1の２つの値へ）
+	void OctahedralWrap(const float normal[3], float result[2])
+	{
+		float length = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+		if (length <= 0.0f)
+		{
+			result[0] = 0.0f;
+			result[1] = 0.0f;
+			return;
+		}
+
+		float x = normal[0] / length;
+		float y = normal[1] / length;
+		if (normal[2] < 0.0f)
+		{
+			float wrappedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+			float wrappedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+			x = wrappedX;
+			y = wrappedY;
+		}
+
+		result[0] = x;
+		result[1] = y;
+	}
+}
+
+// 位置の配列を囲む箱の中心と大きさを求める関数
+void Imase::ComputeBoundingBox(const uint8_t* positions, size_t count, size_t stride, float center[3], float extents[3])
+{
+	float minimum[3] = { 0.0f, 0.0f, 0.0f };
+	float maximum[3] = { 0.0f, 0.0f, 0.0f };
+
+	for (size_t i = 0; i < count; i++)
+	{
+		float position[3];
+		std::memcpy(position, positions + i * stride, sizeof(position));
+
+		for (int k = 0; k < 3; k++)
+		{
+			minimum[k] = i ? std::min(minimum[k], position[k]) : position[k];
+			maximum[k] = i ? std::max(maximum[k], position[k]) : position[k];
+		}
+	}
+
+	for (int k = 0; k < 3; k++)
+	{
+		center[k] = (minimum[k] + maximum[k]) * 0.5f;
+		extents[k] = (maximum[k] - minimum[k]) * 0.5f;
+	}
+}
+
+// 中心と大きさから量子化の範囲を作る関数
+QuantizationBounds Imase::MakeQuantizationBounds(const float center[3], const float extents[3])
+{
+	QuantizationBounds bounds;
+	std::copy(center, center + 3, bounds.center);
+
+	// 一様なスケールにして法線の向きが変わらないようにする
+	bounds.scale = std::max(extents[0], std::max(extents[1], extents[2]));
+	if (!(bounds.scale > 0.0f)) bounds.scale = 1.0f;
+
+	return bounds;
+}
+
+// floatを16bitのSNORMに変換する関数
+int16_t Imase::FloatToSnorm16(float value)
+{
+	if (!(value > -1.0f)) value = -1.0f;
+	if (value > 1.0f) value = 1.0f;
+	return static_cast<int16_t>(std::lround(value * SNORM16_MAX));
+}
+
+// 16bitのSNORMをfloatに変換する関数（D3Dと同じく-32768は-1.0）
+float Imase::Snorm16ToFloat(int16_t value)
+{
+	return std::max(static_cast<float>(value) / SNORM16_MAX, -1.0f);
+}
+
+// floatを半精度浮動小数点数に変換する関数
+uint16_t Imase::FloatToHalf(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	const uint32_t sign = (bits >> 16) & 0x8000;
+	const uint32_t magnitude = bits & 0x7fffffff;
+
+	// 無限大とNaN
+	if (magnitude >= 0x7f800000)
+	{
+		return static_cast<uint16_t>(sign | (magnitude > 0x7f800000 ? 0x7e00 : 0x7c00));
+	}
+
+	// 65520以上は丸めると無限大
+	if (magnitude >= 0x477ff000)
+	{
+		return static_cast<uint16_t>(sign | 0x7c00);
+	}
+
+	// 非正規化数（2^-14未満）
+	if (magnitude < 0x38800000)
+	{
+		// 2^-25以下は0に丸める
+		if (magnitude <= 0x33000000) return static_cast<uint16_t>(sign);
+
+		uint32_t exponent = magnitude >> 23;
+		uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+		uint32_t shift = 126 - exponent;
+
+		uint32_t half = mantissa >> shift;
+		uint32_t remainder = mantissa & ((1u << shift) - 1);
+		uint32_t halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (half & 1))) half++;
+
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	// 正規化数（指数のバイアスを127から15に変える。仮数の繰り上がりは指数に伝わる）
+	uint32_t half = (magnitude - 0x38000000) >> 13;
+	uint32_t remainder = magnitude & 0x1fff;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) half++;
+
+	return static_cast<uint16_t>(sign | half);
+}
+
+// 半精度浮動小数点数をfloatに変換する関数
+float Imase::HalfToFloat(uint16_t value)
+{
+	const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+	const uint32_t exponent = (value >> 10) & 0x1f;
+	const uint32_t mantissa = value & 0x3ff;
+
+	uint32_t bits;
+	if (exponent == 0)
+	{
+		// 0と非正規化数（仮数 * 2^-24）
+		float result = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+		return sign ? -result : result;
+	}
+	else if (exponent == 31)
+	{
+		bits = sign | 0x7f800000 | (mantissa << 13);
+	}
+	else
+	{
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	}
+
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+// 位置を量子化する関数
+void Imase::QuantizePosition(const float position[3], const QuantizationBounds& bounds, int16_t result[4])
+{
+	const float inverseScale = 1.0f / bounds.scale;
+	for (int k = 0; k < 3; k++)
+	{
+		result[k] = FloatToSnorm16((position[k] - bounds.center[k]) * inverseScale);
+	}
+
+	// 同次座標のw（復元すると1.0）
+	result[3] = INT16_MAX;
+}
+
+// 位置を復元する関数
+void Imase::DequantizePosition(const int16_t quantized[4], const QuantizationBounds& bounds, float result[3])
+{
+	for (int k = 0; k < 3; k++)
+	{
+		result[k] = bounds.center[k] + Snorm16ToFloat(quantized[k]) * bounds.scale;
+	}
+}
+
+// 法線を八面体に展開する関数
+void Imase::EncodeOctahedralNormal(const float normal[3], int16_t result[2])
+{
+	float wrapped[2];
+	OctahedralWrap(normal, wrapped);
+
+	float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+	if (length <= 0.0f)
+	{
+		result[0] = 0;
+		result[1] = 0;
+		return;
+	}
+
+	// 切り捨てと切り上げの組み合わせから、復元した時に一番近い向きになるものを選ぶ
+	// （内積は1.0に近いとfloatの精度で差が出ないので、差の長さの２乗で比べる）
+	float bestDistance = 5.0f;
+	for (int i = 0; i < 4; i++)
+	{
+		int16_t candidate[2];
+		for (int k = 0; k < 2; k++)
+		{
+			float scaled = wrapped[k] * SNORM16_MAX;
+			float rounded = ((i >> k) & 1) ? std::ceil(scaled) : std::floor(scaled);
+			rounded = std::max(-SNORM16_MAX, std::min(SNORM16_MAX, rounded));
+			candidate[k] = static_cast<int16_t>(rounded);
+		}
+
+		float decoded[3];
+		DecodeOctahedralNormal(candidate, decoded);
+		float distance = 0.0f;
+		for (int k = 0; k < 3; k++)
+		{
+			float difference = decoded[k] - normal[k] / length;
+			distance += difference * difference;
+		}
+		if (distance < bestDistance)
+		{
+			bestDistance = distance;
+			result[0] = candidate[0];
+			result[1] = candidate[1];
+		}
+	}
+}
+
+// 八面体に展開した法線を復元する関数
+void Imase::DecodeOctahedralNormal(const int16_t encoded[2], float result[3])
+{
+	float x = Snorm16ToFloat(encoded[0]);
+	float y = Snorm16ToFloat(encoded[1]);
+	float z = 1.0f - std::fabs(x) - std::fabs(y);
+
+	if (z < 0.0f)
+	{
+		float unwrappedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+		float unwrappedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+		x = unwrappedX;
+		y = unwrappedY;
+	}
+
+	float length = std::sqrt(x * x + y * y + z * z);
+	result[0] = x / length;
+	result[1] = y / length;
+	result[2] = z / length;
+}
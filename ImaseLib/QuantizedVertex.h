@@ -0,0 +1,64 @@
+﻿//--------------------------------------------------------------------------------------
+// File: QuantizedVertex.h
+//
+// 頂点を小さな整数や半精度浮動小数点数に詰めて保存するための関数群
+//
+// Usage: 位置はメッシュの範囲に対する16bitのSNORM（w=1.0）、法線は八面体に展開した
+//        16bitのSNORM２つ、UVは半精度浮動小数点数２つで、１頂点16バイトになります
+//        （位置・法線・UVがfloatの32バイトの頂点の半分）。
+//        位置は center + 値 * scale で復元します。scaleは範囲の最大の辺の半分なので、
+//        復元は一様なスケールと平行移動の行列で表せます（法線の向きは変わりません）。
+//        法線の復元には DecodeOctahedralNormal 関数と同じ計算が必要です。
+//        D3Dに依存しないので単体でビルド・検証できます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Imase
+{
+	// 量子化した頂点（DXGI_FORMAT_R16G16B16A16_SNORM、R16G16_SNORM、R16G16_FLOAT）
+	struct QuantizedVertex
+	{
+		int16_t position[4];
+		int16_t normal[2];
+		uint16_t textureCoordinate[2];
+	};
+
+	static_assert(sizeof(QuantizedVertex) == 16, "QuantizedVertex must be 16 bytes.");
+
+	// 位置の量子化の範囲
+	struct QuantizationBounds
+	{
+		// 範囲の中心
+		float center[3];
+
+		// 量子化した値1.0に対応する大きさ
+		float scale;
+	};
+
+	// 位置の配列を囲む箱の中心と大きさ（各辺の半分）を求める関数（positionsはfloat3の先頭、strideは頂点の間隔）
+	void ComputeBoundingBox(const uint8_t* positions, size_t count, size_t stride, float center[3], float extents[3]);
+
+	// 中心と大きさ（各辺の半分）から量子化の範囲を作る関数
+	QuantizationBounds MakeQuantizationBounds(const float center[3], const float extents[3]);
+
+	// floatと16bitのSNORMの変換
+	int16_t FloatToSnorm16(float value);
+	float Snorm16ToFloat(int16_t value);
+
+	// floatと半精度浮動小数点数の変換（最近接偶数丸め）
+	uint16_t FloatToHalf(float value);
+	float HalfToFloat(uint16_t value);
+
+	// 位置の量子化と復元
+	void QuantizePosition(const float position[3], const QuantizationBounds& bounds, int16_t result[4]);
+	void DequantizePosition(const int16_t quantized[4], const QuantizationBounds& bounds, float result[3]);
+
+	// 法線の八面体の展開と復元（復元した法線は正規化される）
+	void EncodeOctahedralNormal(const float normal[3], int16_t result[2]);
+	void DecodeOctahedralNormal(const int16_t encoded[2], float result[3]);
+}
@@ -0,0 +1,168 @@
+﻿//--------------------------------------------------------------------------------------
+// File: RenderQueue.cpp
+//
+// ソートキーで描画順を並べ替えるレンダーキュー
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Imase;
+
+namespace
+{
+	// 各フィールドの位置
+	const int LAYER_SHIFT = 60;
+	const int TRANSPARENT_SHIFT = 59;
+
+	// 不透明
+	const int OPAQUE_MATERIAL_SHIFT = 47;
+	const int OPAQUE_TEXTURE_SHIFT = 35;
+	const int OPAQUE_DEPTH_SHIFT = 11;
+
+	// 半透明
+	const int TRANSPARENT_DEPTH_SHIFT = 35;
+	const int TRANSPARENT_MATERIAL_SHIFT = 23;
+	const int TRANSPARENT_TEXTURE_SHIFT = 11;
+
+	// 基数ソートの１回で並べ替えるビット数
+	const int RADIX_BITS = 8;
+	const int RADIX_SIZE = 1 << RADIX_BITS;
+	const int RADIX_PASSES = 64 / RADIX_BITS;
+
+	// これ以下の数は挿入ソートで並べ替える
+	// （ヒストグラムの作成と書き込み位置の計算が要らない分、128個程度までは挿入ソートの方が速い）
+	const size_t INSERTION_SORT_THRESHOLD = 64;
+
+	// 挿入ソート（安定）
+	void InsertionSortRenderItems(RenderItem* items, size_t count)
+	{
+		for (size_t i = 1; i < count; i++)
+		{
+			RenderItem item = items[i];
+			size_t j = i;
+			while (j > 0 && items[j - 1].key > item.key)
+			{
+				items[j] = items[j - 1];
+				j--;
+			}
+			items[j] = item;
+		}
+	}
+}
+
+// 不透明の描画のソートキーを作成する関数
+uint64_t Imase::MakeOpaqueRenderKey(uint32_t layer, uint32_t material, uint32_t texture, uint32_t depth)
+{
+	return (static_cast<uint64_t>(layer & RENDER_KEY_MAX_LAYER) << LAYER_SHIFT)
+		| (static_cast<uint64_t>(material & RENDER_KEY_MAX_MATERIAL) << OPAQUE_MATERIAL_SHIFT)
+		| (static_cast<uint64_t>(texture & RENDER_KEY_MAX_TEXTURE) << OPAQUE_TEXTURE_SHIFT)
+		| (static_cast<uint64_t>(depth & RENDER_KEY_MAX_DEPTH) << OPAQUE_DEPTH_SHIFT);
+}
+
+// 半透明の描画のソートキーを作成する関数
+uint64_t Imase::MakeTransparentRenderKey(uint32_t layer, uint32_t depth, uint32_t material, uint32_t texture)
+{
+	// 奥から手前に並ぶように深度を反転する
+	uint32_t invertedDepth = RENDER_KEY_MAX_DEPTH - (depth & RENDER_KEY_MAX_DEPTH);
+
+	return (static_cast<uint64_t>(layer & RENDER_KEY_MAX_LAYER) << LAYER_SHIFT)
+		| (uint64_t(1) << TRANSPARENT_SHIFT)
+		| (static_cast<uint64_t>(invertedDepth) << TRANSPARENT_DEPTH_SHIFT)
+		| (static_cast<uint64_t>(material & RENDER_KEY_MAX_MATERIAL) << TRANSPARENT_MATERIAL_SHIFT)
+		| (static_cast<uint64_t>(texture & RENDER_KEY_MAX_TEXTURE) << TRANSPARENT_TEXTURE_SHIFT);
+}
+
+// ソートキーが半透明の描画か調べる関数
+bool Imase::IsTransparentRenderKey(uint64_t key)
+{
+	return ((key >> TRANSPARENT_SHIFT) & 1) != 0;
+}
+
+// ビュー空間の距離を24bitの深度に変換する関数
+uint32_t Imase::QuantizeRenderDepth(float distance, float nearZ, float farZ)
+{
+	float t = (distance - nearZ) / (farZ - nearZ);
+	t = std::min(std::max(t, 0.0f), 1.0f);
+	return static_cast<uint32_t>(t * static_cast<float>(RENDER_KEY_MAX_DEPTH));
+}
+
+// floatの大小関係を保ったまま符号なし整数に変換する関数
+uint32_t Imase::FloatToSortableBits(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	// 負の数は全ビット反転、正の数は符号ビットだけ反転する
+	return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+// キーで並べ替える関数
+void Imase::RadixSortRenderItems(RenderItem* items, RenderItem* temp, size_t count)
+{
+	if (count <= INSERTION_SORT_THRESHOLD)
+	{
+		InsertionSortRenderItems(items, count);
+		return;
+	}
+
+	// 全ての桁のヒストグラムを１回の走査で作成する
+	uint32_t histogram[RADIX_PASSES][RADIX_SIZE] = {};
+	for (size_t i = 0; i < count; i++)
+	{
+		uint64_t key = items[i].key;
+		for (int pass = 0; pass < RADIX_PASSES; pass++)
+		{
+			histogram[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+		}
+	}
+
+	RenderItem* src = items;
+	RenderItem* dst = temp;
+
+	for (int pass = 0; pass < RADIX_PASSES; pass++)
+	{
+		uint32_t* counts = histogram[pass];
+
+		// 全て同じ値の桁は並べ替える必要がない
+		uint64_t firstDigit = (src[0].key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1);
+		if (counts[firstDigit] == count) continue;
+
+		// 書き込み位置を求める
+		uint32_t offset = 0;
+		for (int digit = 0; digit < RADIX_SIZE; digit++)
+		{
+			uint32_t n = counts[digit];
+			counts[digit] = offset;
+			offset += n;
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			uint64_t digit = (src[i].key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1);
+			dst[counts[digit]++] = src[i];
+		}
+
+		std::swap(src, dst);
+	}
+
+	// 作業領域に結果がある場合は元の配列に戻す
+	if (src != items)
+	{
+		std::copy(src, src + count, items);
+	}
+}
+
+// キーで並べ替える関数
+void RenderQueue::Sort()
+{
+	if (m_temp.size() < m_items.size())
+	{
+		m_temp.resize(m_items.size());
+	}
+
+	RadixSortRenderItems(m_items.data(), m_temp.data(), m_items.size());
+}
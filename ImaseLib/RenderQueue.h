@@ -0,0 +1,87 @@
+﻿//--------------------------------------------------------------------------------------
+// File: RenderQueue.h
+//
+// ソートキーで描画順を並べ替えるレンダーキュー
+//
+// Usage: 描画１回ごとに64bitのソートキーとペイロード（描画コマンドの番号など）を
+//        Submit関数で登録し、Sort関数で並べ替えてから先頭から順に実行してください。
+//        キーは上位から レイヤー(4) 半透明(1) の順で、不透明は
+//        マテリアル(12) テクスチャ(12) 深度(24) の順（手前から奥）、半透明は
+//        深度(24) マテリアル(12) テクスチャ(12) の順（奥から手前）に並びます。
+//        並べ替えは基数ソート（64個以下は挿入ソート、どちらも安定）なので
+//        同じキーは登録順に実行されます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Imase
+{
+	// レンダーキューに登録する描画
+	struct RenderItem
+	{
+		// ソートキー
+		uint64_t key;
+
+		// ペイロード
+		uint32_t payload;
+	};
+
+	// ソートキーの各フィールドの最大値
+	const uint32_t RENDER_KEY_MAX_LAYER = 0xf;
+	const uint32_t RENDER_KEY_MAX_MATERIAL = 0xfff;
+	const uint32_t RENDER_KEY_MAX_TEXTURE = 0xfff;
+	const uint32_t RENDER_KEY_MAX_DEPTH = 0xffffff;
+
+	// 不透明の描画のソートキーを作成する関数（深度は手前から奥）
+	uint64_t MakeOpaqueRenderKey(uint32_t layer, uint32_t material, uint32_t texture, uint32_t depth);
+
+	// 半透明の描画のソートキーを作成する関数（深度は奥から手前）
+	uint64_t MakeTransparentRenderKey(uint32_t layer, uint32_t depth, uint32_t material, uint32_t texture);
+
+	// ソートキーが半透明の描画か調べる関数
+	bool IsTransparentRenderKey(uint64_t key);
+
+	// ビュー空間の距離を24bitの深度に変換する関数
+	uint32_t QuantizeRenderDepth(float distance, float nearZ, float farZ);
+
+	// floatの大小関係を保ったまま符号なし整数に変換する関数
+	uint32_t FloatToSortableBits(float value);
+
+	// キーで並べ替える関数（基数ソート、64個以下は挿入ソート、tempはcount個分の作業領域）
+	void RadixSortRenderItems(RenderItem* items, RenderItem* temp, size_t count);
+
+	// レンダーキュー
+	class RenderQueue
+	{
+	private:
+
+		// 登録された描画
+		std::vector<RenderItem> m_items;
+
+		// 並べ替え用の作業領域
+		std::vector<RenderItem> m_temp;
+
+	public:
+
+		// 登録された描画をクリアする関数（確保したメモリは再利用する）
+		void Clear() { m_items.clear(); }
+
+		// 描画を登録する関数
+		void Submit(uint64_t key, uint32_t payload) { m_items.push_back(RenderItem{ key, payload }); }
+
+		// キーで並べ替える関数
+		void Sort();
+
+		// 登録された描画の数を取得する関数
+		size_t GetCount() const { return m_items.size(); }
+
+		// 範囲for文用
+		const RenderItem* begin() const { return m_items.data(); }
+		const RenderItem* end() const { return m_items.data() + m_items.size(); }
+	};
+}
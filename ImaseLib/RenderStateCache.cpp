@@ -0,0 +1,157 @@
+﻿//--------------------------------------------------------------------------------------
+// File: RenderStateCache.cpp
+//
+// 設定済みのレンダーステートを覚えておき、同じステートの再設定を省くクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "RenderStateCache.h"
+
+#include <cstring>
+
+using namespace Imase;
+
+namespace
+{
+	// blendFactorにnullptrを指定した時の値
+	const float DEFAULT_BLEND_FACTOR[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+}
+
+// コンストラクタ
+RenderStateCache::RenderStateCache(IRenderStateTarget* target)
+	: m_target(target)
+	, m_depthStencilValid(false)
+	, m_depthStencilState(nullptr)
+	, m_stencilRef(0)
+	, m_blendValid(false)
+	, m_blendState(nullptr)
+	, m_blendFactor{}
+	, m_sampleMask(0)
+	, m_rasterizerValid(false)
+	, m_rasterizerState(nullptr)
+	, m_samplerValid{}
+	, m_samplers{}
+	, m_statistics{}
+	, m_lastFrameStatistics{}
+{
+}
+
+// フレームの開始
+void RenderStateCache::BeginFrame()
+{
+	m_lastFrameStatistics = m_statistics;
+	m_statistics = Statistics{};
+
+	// 前のフレームの最後に誰が何を設定したかはわからないので破棄する
+	Invalidate();
+}
+
+// 覚えているステートを破棄する関数
+void RenderStateCache::Invalidate()
+{
+	m_depthStencilValid = false;
+	m_blendValid = false;
+	m_rasterizerValid = false;
+
+	for (uint32_t i = 0; i < SAMPLER_SLOT_COUNT; i++)
+	{
+		m_samplerValid[i] = false;
+	}
+}
+
+// 深度ステンシルステートを設定する関数
+void RenderStateCache::SetDepthStencilState(ID3D11DepthStencilState* state, uint32_t stencilRef)
+{
+	if (m_depthStencilValid && m_depthStencilState == state && m_stencilRef == stencilRef)
+	{
+		m_statistics.skipped++;
+		return;
+	}
+
+	m_target->SetDepthStencilState(state, stencilRef);
+	m_statistics.bound++;
+
+	m_depthStencilValid = true;
+	m_depthStencilState = state;
+	m_stencilRef = stencilRef;
+}
+
+// ブレンドステートを設定する関数
+void RenderStateCache::SetBlendState(ID3D11BlendState* state, const float blendFactor[4], uint32_t sampleMask)
+{
+	const float* factor = blendFactor ? blendFactor : DEFAULT_BLEND_FACTOR;
+
+	if (m_blendValid
+		&& m_blendState == state
+		&& m_sampleMask == sampleMask
+		&& std::memcmp(m_blendFactor, factor, sizeof(m_blendFactor)) == 0)
+	{
+		m_statistics.skipped++;
+		return;
+	}
+
+	m_target->SetBlendState(state, blendFactor, sampleMask);
+	m_statistics.bound++;
+
+	m_blendValid = true;
+	m_blendState = state;
+	std::memcpy(m_blendFactor, factor, sizeof(m_blendFactor));
+	m_sampleMask = sampleMask;
+}
+
+// ラスタライザーステートを設定する関数
+void RenderStateCache::SetRasterizerState(ID3D11RasterizerState* state)
+{
+	if (m_rasterizerValid && m_rasterizerState == state)
+	{
+		m_statistics.skipped++;
+		return;
+	}
+
+	m_target->SetRasterizerState(state);
+	m_statistics.bound++;
+
+	m_rasterizerValid = true;
+	m_rasterizerState = state;
+}
+
+// ピクセルシェーダーのサンプラーを設定する関数
+void RenderStateCache::SetPSSamplers(uint32_t startSlot, uint32_t count, ID3D11SamplerState* const* samplers)
+{
+	// 範囲外はそのまま設定先に任せる
+	if (startSlot >= SAMPLER_SLOT_COUNT || count > SAMPLER_SLOT_COUNT - startSlot)
+	{
+		m_target->SetPSSamplers(startSlot, count, samplers);
+		m_statistics.bound++;
+		return;
+	}
+
+	// 変更があるスロットの範囲を求める
+	uint32_t first = count;
+	uint32_t last = 0;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint32_t slot = startSlot + i;
+		if (!m_samplerValid[slot] || m_samplers[slot] != samplers[i])
+		{
+			if (first == count) first = i;
+			last = i;
+		}
+	}
+
+	if (first == count)
+	{
+		m_statistics.skipped++;
+		return;
+	}
+
+	// 変更がある範囲だけ設定する
+	m_target->SetPSSamplers(startSlot + first, last - first + 1, samplers + first);
+	m_statistics.bound++;
+
+	for (uint32_t i = first; i <= last; i++)
+	{
+		m_samplerValid[startSlot + i] = true;
+		m_samplers[startSlot + i] = samplers[i];
+	}
+}
@@ -0,0 +1,114 @@
+﻿//--------------------------------------------------------------------------------------
+// File: RenderStateCache.h
+//
+// 設定済みのレンダーステートを覚えておき、同じステートの再設定を省くクラス
+//
+// Usage: IRenderStateTargetの実装（D3DRenderStateTarget）をRenderStateCacheに渡し、
+//        ステートはRenderStateCache経由で設定してください。
+//        SpriteBatchやModel::Drawなど、直接デバイスコンテキストにステートを設定する
+//        処理の後はInvalidate関数を呼び出してください。
+//        フレームの最初にBeginFrame関数を呼び出すと設定回数と省略回数を集計します。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+
+struct ID3D11DepthStencilState;
+struct ID3D11BlendState;
+struct ID3D11RasterizerState;
+struct ID3D11SamplerState;
+
+namespace Imase
+{
+	// レンダーステートの設定先のインターフェイス
+	class IRenderStateTarget
+	{
+	public:
+
+		virtual ~IRenderStateTarget() = default;
+
+		// 深度ステンシルステートを設定する関数
+		virtual void SetDepthStencilState(ID3D11DepthStencilState* state, uint32_t stencilRef) = 0;
+
+		// ブレンドステートを設定する関数（blendFactorがnullptrの時は{1,1,1,1}）
+		virtual void SetBlendState(ID3D11BlendState* state, const float blendFactor[4], uint32_t sampleMask) = 0;
+
+		// ラスタライザーステートを設定する関数
+		virtual void SetRasterizerState(ID3D11RasterizerState* state) = 0;
+
+		// ピクセルシェーダーのサンプラーを設定する関数
+		virtual void SetPSSamplers(uint32_t startSlot, uint32_t count, ID3D11SamplerState* const* samplers) = 0;
+	};
+
+	// 同じステートの再設定を省くクラス
+	class RenderStateCache : public IRenderStateTarget
+	{
+	public:
+
+		// サンプラーのスロット数（D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT）
+		static const uint32_t SAMPLER_SLOT_COUNT = 16;
+
+		// 設定回数の統計
+		struct Statistics
+		{
+			// 実際に設定した回数
+			uint32_t bound;
+
+			// 設定済みなので省略した回数
+			uint32_t skipped;
+		};
+
+	public:
+
+		// コンストラクタ
+		explicit RenderStateCache(IRenderStateTarget* target);
+
+		// フレームの開始（統計を切り替えて、覚えているステートを破棄する）
+		void BeginFrame();
+
+		// 覚えているステートを破棄する関数
+		void Invalidate();
+
+		// 現在のフレームの統計を取得する関数
+		const Statistics& GetStatistics() const { return m_statistics; }
+
+		// 前のフレームの統計を取得する関数
+		const Statistics& GetLastFrameStatistics() const { return m_lastFrameStatistics; }
+
+		// IRenderStateTarget
+		void SetDepthStencilState(ID3D11DepthStencilState* state, uint32_t stencilRef) override;
+		void SetBlendState(ID3D11BlendState* state, const float blendFactor[4], uint32_t sampleMask) override;
+		void SetRasterizerState(ID3D11RasterizerState* state) override;
+		void SetPSSamplers(uint32_t startSlot, uint32_t count, ID3D11SamplerState* const* samplers) override;
+
+	private:
+
+		// 設定先
+		IRenderStateTarget* m_target;
+
+		// 深度ステンシルステート
+		bool m_depthStencilValid;
+		ID3D11DepthStencilState* m_depthStencilState;
+		uint32_t m_stencilRef;
+
+		// ブレンドステート
+		bool m_blendValid;
+		ID3D11BlendState* m_blendState;
+		float m_blendFactor[4];
+		uint32_t m_sampleMask;
+
+		// ラスタライザーステート
+		bool m_rasterizerValid;
+		ID3D11RasterizerState* m_rasterizerState;
+
+		// サンプラー
+		bool m_samplerValid[SAMPLER_SLOT_COUNT];
+		ID3D11SamplerState* m_samplers[SAMPLER_SLOT_COUNT];
+
+		// 統計
+		Statistics m_statistics;
+		Statistics m_lastFrameStatistics;
+	};
+}
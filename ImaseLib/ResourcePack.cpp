@@ -0,0 +1,265 @@
+﻿//--------------------------------------------------------------------------------------
+// File: ResourcePack.cpp
+//
+// 複数のリソースファイルを一つにまとめたパックファイルを読み込むクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "ResourcePack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "LzCodec.h"
+#include "Utf8.h"
+
+using namespace Imase;
+
+static_assert(sizeof(ResourcePackHeader) == 48, "ResourcePackHeader must match the file layout.");
+static_assert(sizeof(ResourcePackEntry) == 48, "ResourcePackEntry must match the file layout.");
+
+namespace
+{
+	// バケットのビット数の上限
+	const uint32_t MAX_BUCKET_BITS = 24;
+
+	// FNV-1aの定数
+	const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+	const uint64_t FNV_PRIME = 1099511628211ull;
+
+	// offsetからsizeバイトがtotalに収まるか
+	bool InRange(uint64_t offset, uint64_t size, uint64_t total)
+	{
+		return offset <= total && size <= total - offset;
+	}
+
+	// ハッシュが入るバケット
+	uint64_t GetBucket(uint64_t hash, uint32_t bucketBits)
+	{
+		return bucketBits ? hash >> (64 - bucketBits) : 0;
+	}
+
+	// ブロックの数
+	uint64_t GetBlockCount(const ResourcePackEntry& entry)
+	{
+		return (entry.size + entry.blockSize - 1) / entry.blockSize;
+	}
+}
+
+// パスを正規化する関数
+std::string Imase::NormalizeResourcePath(const char* utf8Path)
+{
+	if (utf8Path[0] == '.' && (utf8Path[1] == '/' || utf8Path[1] == '\\')) utf8Path += 2;
+
+	std::string path(utf8Path);
+	for (char& c : path)
+	{
+		if (c == '/') c = '\\';
+		else if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+	}
+	return path;
+}
+
+std::string Imase::NormalizeResourcePath(const wchar_t* path)
+{
+	std::string utf8;
+	AppendUtf8(utf8, path);
+	return NormalizeResourcePath(utf8.c_str());
+}
+
+// 正規化したパスのハッシュを求める関数
+uint64_t Imase::HashResourcePath(const std::string& normalizedPath)
+{
+	uint64_t hash = FNV_OFFSET_BASIS;
+	for (char c : normalizedPath)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+// コンストラクタ（ファイルをマップして読み込む）
+ResourcePack::ResourcePack(const wchar_t* fileName)
+	: m_file(fileName)
+{
+	Parse(m_file.GetData(), m_file.GetSize());
+}
+
+// コンストラクタ（メモリ上の内容を読み込む）
+ResourcePack::ResourcePack(const uint8_t* data, size_t size)
+{
+	Parse(data, size);
+}
+
+// パスからエントリを探す関数
+const ResourcePackEntry* ResourcePack::Find(const wchar_t* path) const
+{
+	std::string name = NormalizeResourcePath(path);
+	return Find(name, HashResourcePath(name));
+}
+
+const ResourcePackEntry* ResourcePack::Find(const std::string& normalizedPath, uint64_t hash) const
+{
+	uint64_t bucket = GetBucket(hash, m_header->bucketBits);
+	for (uint32_t i = m_buckets[bucket]; i < m_buckets[bucket + 1]; i++)
+	{
+		const ResourcePackEntry& entry = m_entries[i];
+		if (entry.hash == hash
+			&& entry.nameLength == normalizedPath.size()
+			&& std::memcmp(m_names + entry.nameOffset, normalizedPath.data(), entry.nameLength) == 0)
+		{
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+// エントリの正規化したパスを取得する関数
+std::string ResourcePack::GetName(const ResourcePackEntry& entry) const
+{
+	return std::string(m_names + entry.nameOffset, entry.nameLength);
+}
+
+// 中身を展開する関数
+void ResourcePack::Decompress(const ResourcePackEntry& entry, uint8_t* destination) const
+{
+	const uint8_t* stored = GetStoredData(entry);
+	size_t size = static_cast<size_t>(entry.size);
+
+	if (entry.codec == RESOURCE_CODEC_NONE)
+	{
+		if (size) std::memcpy(destination, stored, size);
+		return;
+	}
+
+	// ブロックの範囲は読み込み時に確認してある
+	size_t blockCount = static_cast<size_t>(GetBlockCount(entry));
+	const uint8_t* block = stored + blockCount * sizeof(uint32_t);
+	for (size_t i = 0; i < blockCount; i++)
+	{
+		uint32_t blockStoredSize;
+		std::memcpy(&blockStoredSize, stored + i * sizeof(uint32_t), sizeof(blockStoredSize));
+
+		size_t offset = i * entry.blockSize;
+		size_t blockSize = std::min(static_cast<size_t>(entry.blockSize), size - offset);
+		if (blockStoredSize & RESOURCE_BLOCK_UNCOMPRESSED)
+		{
+			std::memcpy(destination + offset, block, blockSize);
+			block += blockSize;
+		}
+		else
+		{
+			LzDecompress(block, blockStoredSize, destination + offset, blockSize);
+			block += blockStoredSize;
+		}
+	}
+}
+
+// 索引を解析する関数
+void ResourcePack::Parse(const uint8_t* data, size_t size)
+{
+	m_data = data;
+	m_size = size;
+
+	if (size < sizeof(ResourcePackHeader)) throw std::runtime_error("Resource pack is too small.");
+	m_header = reinterpret_cast<const ResourcePackHeader*>(data);
+
+	const ResourcePackHeader& header = *m_header;
+	if (header.magic != RESOURCE_PACK_MAGIC) throw std::runtime_error("Not a resource pack.");
+	if (header.version != RESOURCE_PACK_VERSION) throw std::runtime_error("Unsupported resource pack version.");
+	if (header.bucketBits > MAX_BUCKET_BITS) throw std::runtime_error("Resource pack has too many buckets.");
+
+	// 索引の範囲（配列として参照するので境界も確認する）
+	uint64_t bucketCount = (static_cast<uint64_t>(1) << header.bucketBits) + 1;
+	if (header.bucketOffset % alignof(uint32_t) != 0
+		|| !InRange(header.bucketOffset, bucketCount * sizeof(uint32_t), size)
+		|| header.entryOffset % alignof(ResourcePackEntry) != 0
+		|| !InRange(header.entryOffset, static_cast<uint64_t>(header.entryCount) * sizeof(ResourcePackEntry), size)
+		|| !InRange(header.nameOffset, header.nameSize, size))
+	{
+		throw std::runtime_error("Resource pack index is out of range.");
+	}
+
+	m_buckets = reinterpret_cast<const uint32_t*>(data + header.bucketOffset);
+	m_entries = reinterpret_cast<const ResourcePackEntry*>(data + header.entryOffset);
+	m_names = reinterpret_cast<const char*>(data + header.nameOffset);
+
+	// バケットは各エントリの範囲を順に区切っている
+	if (m_buckets[0] != 0 || m_buckets[bucketCount - 1] != header.entryCount)
+	{
+		throw std::runtime_error("Resource pack buckets are corrupt.");
+	}
+	for (uint64_t bucket = 0; bucket + 1 < bucketCount; bucket++)
+	{
+		if (m_buckets[bucket] > m_buckets[bucket + 1]) throw std::runtime_error("Resource pack buckets are corrupt.");
+
+		for (uint32_t i = m_buckets[bucket]; i < m_buckets[bucket + 1]; i++)
+		{
+			if (GetBucket(m_entries[i].hash, header.bucketBits) != bucket)
+			{
+				throw std::runtime_error("Resource pack entry is in the wrong bucket.");
+			}
+		}
+	}
+
+	// エントリ
+	for (uint32_t i = 0; i < header.entryCount; i++)
+	{
+		const ResourcePackEntry& entry = m_entries[i];
+
+		if (i > 0 && m_entries[i - 1].hash > entry.hash) throw std::runtime_error("Resource pack entries are not sorted.");
+		if (!InRange(entry.nameOffset, entry.nameLength, header.nameSize))
+		{
+			throw std::runtime_error("Resource pack entry name is out of range.");
+		}
+		if (entry.offset % RESOURCE_PACK_ALIGNMENT != 0 || !InRange(entry.offset, entry.storedSize, size)
+			|| entry.size > SIZE_MAX)
+		{
+			throw std::runtime_error("Resource pack entry is out of range.");
+		}
+
+		if (entry.codec == RESOURCE_CODEC_NONE)
+		{
+			if (entry.storedSize != entry.size) throw std::runtime_error("Resource pack entry has the wrong size.");
+		}
+		else if (entry.codec == RESOURCE_CODEC_LZ)
+		{
+			if (entry.blockSize == 0) throw std::runtime_error("Resource pack entry has no block size.");
+
+			// ブロックの表とブロックが中身に収まるか
+			uint64_t blockCount = GetBlockCount(entry);
+			if (blockCount > entry.storedSize / sizeof(uint32_t))
+			{
+				throw std::runtime_error("Resource pack entry blocks are out of range.");
+			}
+			const uint8_t* stored = GetStoredData(entry);
+			uint64_t total = blockCount * sizeof(uint32_t);
+			for (uint64_t block = 0; block < blockCount; block++)
+			{
+				uint32_t blockStoredSize;
+				std::memcpy(&blockStoredSize, stored + block * sizeof(uint32_t), sizeof(blockStoredSize));
+
+				uint64_t blockSize = std::min(static_cast<uint64_t>(entry.blockSize), entry.size - block * entry.blockSize);
+				if (blockStoredSize & RESOURCE_BLOCK_UNCOMPRESSED)
+				{
+					if ((blockStoredSize & ~RESOURCE_BLOCK_UNCOMPRESSED) != blockSize)
+					{
+						throw std::runtime_error("Resource pack block has the wrong size.");
+					}
+					total += blockSize;
+				}
+				else
+				{
+					total += blockStoredSize;
+				}
+			}
+			if (total > entry.storedSize) throw std::runtime_error("Resource pack entry blocks are out of range.");
+		}
+		else
+		{
+			throw std::runtime_error("Resource pack entry has an unknown codec.");
+		}
+	}
+}
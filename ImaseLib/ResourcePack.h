@@ -0,0 +1,156 @@
+﻿//--------------------------------------------------------------------------------------
+// File: ResourcePack.h
+//
+// 複数のリソースファイルを一つにまとめたパックファイルを読み込むクラス
+//
+// Usage: パックファイルをメモリにマップし、Find関数で "Resources\\Models\\ball.dds" のような
+//        パスからエントリを探します。パスは大文字小文字と '/' '\' の違いを区別しません。
+//        エントリはパスのハッシュ順に並んでいて、ハッシュの上位ビットで引くバケットの表から
+//        直接範囲を求めるので、エントリの数によらず一定の時間で見つかります。
+//        中身は4096バイト境界に置かれていて、圧縮していないエントリはGetStoredData関数で
+//        マップした中身を直接参照できます（コピーしません）。
+//        圧縮したエントリはDecompress関数でエントリのサイズのバッファに展開してください。
+//        パックファイルはTools/ResourcePackerで作成します。
+//        ヘッダーと索引は読み込み時に全て確認し、壊れている時は std::runtime_error を投げます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "MappedFile.h"
+
+namespace Imase
+{
+	// ファイルの先頭の"IPAK"
+	const uint32_t RESOURCE_PACK_MAGIC = 0x4b415049;
+
+	// 形式のバージョン
+	const uint32_t RESOURCE_PACK_VERSION = 1;
+
+	// 中身を置く境界
+	const uint64_t RESOURCE_PACK_ALIGNMENT = 4096;
+
+	// 中身の圧縮方法
+	enum ResourceCodec : uint32_t
+	{
+		// 圧縮なし
+		RESOURCE_CODEC_NONE = 0,
+
+		// blockSizeごとにLzCompress関数で圧縮
+		// 中身の先頭にブロックごとの圧縮後のサイズ（uint32_t）の配列が並び、その後にブロックが続く
+		// サイズの最上位ビットが立っているブロックは圧縮せずにそのまま入っている
+		RESOURCE_CODEC_LZ = 1,
+	};
+
+	// 圧縮せずに入っているブロックのフラグ
+	const uint32_t RESOURCE_BLOCK_UNCOMPRESSED = 0x80000000;
+
+	// ヘッダー
+	struct ResourcePackHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+
+		// エントリの数
+		uint32_t entryCount;
+
+		// バケットの数は 1 << bucketBits（バケットの表は (1 << bucketBits) + 1 個のエントリの番号）
+		uint32_t bucketBits;
+
+		// バケットの表、エントリの配列、パスの文字列の位置
+		uint64_t bucketOffset;
+		uint64_t entryOffset;
+		uint64_t nameOffset;
+		uint64_t nameSize;
+	};
+
+	// エントリ（hashの小さい順に並ぶ）
+	struct ResourcePackEntry
+	{
+		// 正規化したパスのハッシュ（HashResourcePath関数）
+		uint64_t hash;
+
+		// 中身の位置（RESOURCE_PACK_ALIGNMENTの倍数）とパックの中のサイズ
+		uint64_t offset;
+		uint64_t storedSize;
+
+		// 元のファイルのサイズ
+		uint64_t size;
+
+		// 圧縮方法とブロックのサイズ
+		ResourceCodec codec;
+		uint32_t blockSize;
+
+		// 正規化したパスの位置（パスの文字列の中）と長さ
+		uint32_t nameOffset;
+		uint32_t nameLength;
+	};
+
+	// パスを正規化する関数（ASCIIの大文字を小文字に、'/' を '\' にし、先頭の ".\" を除く）
+	std::string NormalizeResourcePath(const char* utf8Path);
+	std::string NormalizeResourcePath(const wchar_t* path);
+
+	// 正規化したパスのハッシュを求める関数（64ビットのFNV-1a）
+	uint64_t HashResourcePath(const std::string& normalizedPath);
+
+	class ResourcePack
+	{
+	private:
+
+		// マップしたファイル
+		MappedFile m_file;
+
+		// パックの中身
+		const uint8_t* m_data;
+		size_t m_size;
+
+		// 索引（m_dataの中を指す）
+		const ResourcePackHeader* m_header;
+		const uint32_t* m_buckets;
+		const ResourcePackEntry* m_entries;
+		const char* m_names;
+
+	public:
+
+		// コンストラクタ（ファイルをマップして読み込む）
+		explicit ResourcePack(const wchar_t* fileName);
+
+		// コンストラクタ（メモリ上の内容を読み込む。dataは参照するだけなので長く残すこと）
+		ResourcePack(const uint8_t* data, size_t size);
+
+		// パスからエントリを探す関数（見つからない時はnullptr）
+		const ResourcePackEntry* Find(const wchar_t* path) const;
+		const ResourcePackEntry* Find(const std::string& normalizedPath, uint64_t hash) const;
+
+		// エントリの数
+		size_t GetEntryCount() const { return m_header->entryCount; }
+
+		// エントリを取得する関数
+		const ResourcePackEntry& GetEntry(size_t index) const { return m_entries[index]; }
+
+		// エントリの正規化したパスを取得する関数
+		std::string GetName(const ResourcePackEntry& entry) const;
+
+		// 圧縮されているか
+		static bool IsCompressed(const ResourcePackEntry& entry) { return entry.codec != RESOURCE_CODEC_NONE; }
+
+		// パックの中の中身を取得する関数（圧縮していなければ元のファイルの中身そのもの）
+		const uint8_t* GetStoredData(const ResourcePackEntry& entry) const { return m_data + entry.offset; }
+
+		// 中身を展開する関数（destinationにはentry.sizeバイトが必要）
+		void Decompress(const ResourcePackEntry& entry, uint8_t* destination) const;
+
+		// パックの中身を取得する関数
+		const uint8_t* GetData() const { return m_data; }
+		size_t GetSize() const { return m_size; }
+
+	private:
+
+		// 索引を解析する関数
+		void Parse(const uint8_t* data, size_t size);
+	};
+}
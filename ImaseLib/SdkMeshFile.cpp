@@ -0,0 +1,284 @@
+﻿//--------------------------------------------------------------------------------------
+// File: SdkMeshFile.cpp
+//
+// SDKMESH形式（DXUTのメッシュファイル）を読み込むクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "SdkMeshFile.h"
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace Imase;
+
+namespace
+{
+	// 先頭からsizeバイトの位置にlimitまでの範囲が収まるか調べる関数（オーバーフローを考慮）
+	bool IsRangeInside(uint64_t offset, uint64_t size, uint64_t limit)
+	{
+		return offset <= limit && size <= limit - offset;
+	}
+
+	// 名前が終端文字で終わっているか調べる関数
+	void CheckName(const char* name, size_t length)
+	{
+		if (!std::memchr(name, 0, length)) throw std::runtime_error("SDKMESH name is not terminated.");
+	}
+
+	// フレームの番号が正しいか調べる関数
+	void CheckFrameLink(uint32_t index, uint32_t count)
+	{
+		if (index != SDKMESH_INVALID_FRAME && index >= count) throw std::runtime_error("SDKMESH frame link is out of range.");
+	}
+}
+
+// コンストラクタ（ファイルをマップして読み込む）
+SdkMeshFile::SdkMeshFile(const wchar_t* fileName)
+	: m_file(fileName)
+{
+	Parse(m_file.GetData(), m_file.GetSize());
+}
+
+// コンストラクタ（メモリ上の内容を読み込む）
+SdkMeshFile::SdkMeshFile(const uint8_t* data, size_t size)
+{
+	Parse(data, size);
+}
+
+// 頂点バッファのデータを取得する関数
+SdkMeshBufferData SdkMeshFile::GetVertexData(size_t index) const
+{
+	const SdkMeshVertexBufferHeader& header = m_vertexBuffers[index];
+	SdkMeshBufferData buffer = { m_data + header.dataOffset, static_cast<size_t>(header.sizeBytes) };
+	return buffer;
+}
+
+// インデックスバッファのデータを取得する関数
+SdkMeshBufferData SdkMeshFile::GetIndexData(size_t index) const
+{
+	const SdkMeshIndexBufferHeader& header = m_indexBuffers[index];
+	SdkMeshBufferData buffer = { m_data + header.dataOffset, static_cast<size_t>(header.sizeBytes) };
+	return buffer;
+}
+
+// メッシュのサブセットの番号を取得する関数
+const uint32_t* SdkMeshFile::GetMeshSubsets(size_t meshIndex) const
+{
+	const SdkMeshMesh& mesh = m_meshes[meshIndex];
+	if (mesh.numSubsets == 0) return nullptr;
+
+	return reinterpret_cast<const uint32_t*>(m_data + mesh.subsetOffset);
+}
+
+// メッシュに影響するフレームの番号を取得する関数
+const uint32_t* SdkMeshFile::GetMeshFrameInfluences(size_t meshIndex) const
+{
+	const SdkMeshMesh& mesh = m_meshes[meshIndex];
+	if (mesh.numFrameInfluences == 0) return nullptr;
+
+	return reinterpret_cast<const uint32_t*>(m_data + mesh.frameInfluenceOffset);
+}
+
+// ファイル内の位置から配列を取得する関数
+template <class T>
+const T* SdkMeshFile::GetArray(uint64_t offset, uint64_t count, uint64_t limit) const
+{
+	// 空の配列は位置を使わない
+	if (count == 0) return nullptr;
+
+	if (count > limit / sizeof(T) || !IsRangeInside(offset, count * sizeof(T), limit))
+	{
+		throw std::runtime_error("SDKMESH table is out of range.");
+	}
+
+	const uint8_t* data = m_data + offset;
+	if (reinterpret_cast<uintptr_t>(data) % alignof(T) != 0)
+	{
+		throw std::runtime_error("SDKMESH table is misaligned.");
+	}
+
+	return reinterpret_cast<const T*>(data);
+}
+
+// ファイルの中身を解析する関数
+void SdkMeshFile::Parse(const uint8_t* data, size_t size)
+{
+	m_data = data;
+	m_size = size;
+
+	// ヘッダー
+	m_header = GetArray<SdkMeshHeader>(0, 1, size);
+
+	const SdkMeshHeader& header = *m_header;
+	if (header.version != SDKMESH_FILE_VERSION && header.version != SDKMESH_FILE_VERSION_V2)
+	{
+		throw std::runtime_error("Not a supported SDKMESH file version.");
+	}
+
+	if (header.isBigEndian)
+	{
+		throw std::runtime_error("Big-endian SDKMESH files are not supported.");
+	}
+
+	// ヘッダーの大きさには頂点バッファとインデックスバッファのヘッダーも含まれる
+	const uint64_t headerSize = sizeof(SdkMeshHeader)
+		+ static_cast<uint64_t>(header.numVertexBuffers) * sizeof(SdkMeshVertexBufferHeader)
+		+ static_cast<uint64_t>(header.numIndexBuffers) * sizeof(SdkMeshIndexBufferHeader);
+	if (header.headerSize != headerSize)
+	{
+		throw std::runtime_error("SDKMESH header size is invalid.");
+	}
+
+	// ヘッダー以外のテーブルとバッファのデータの範囲
+	if (!IsRangeInside(header.headerSize, header.nonBufferDataSize, size))
+	{
+		throw std::runtime_error("SDKMESH file is truncated.");
+	}
+
+	const uint64_t bufferDataOffset = header.headerSize + header.nonBufferDataSize;
+	if (!IsRangeInside(bufferDataOffset, header.bufferDataSize, size))
+	{
+		throw std::runtime_error("SDKMESH file is truncated.");
+	}
+
+	const uint64_t bufferDataEnd = bufferDataOffset + header.bufferDataSize;
+
+	// 各テーブル（バッファのデータより前にある）
+	m_vertexBuffers = GetArray<SdkMeshVertexBufferHeader>(header.vertexStreamHeadersOffset, header.numVertexBuffers, bufferDataOffset);
+	m_indexBuffers = GetArray<SdkMeshIndexBufferHeader>(header.indexStreamHeadersOffset, header.numIndexBuffers, bufferDataOffset);
+	m_meshes = GetArray<SdkMeshMesh>(header.meshDataOffset, header.numMeshes, bufferDataOffset);
+	m_subsets = GetArray<SdkMeshSubset>(header.subsetDataOffset, header.numTotalSubsets, bufferDataOffset);
+	m_frames = GetArray<SdkMeshFrame>(header.frameDataOffset, header.numFrames, bufferDataOffset);
+	m_materials = GetArray<SdkMeshMaterial>(header.materialDataOffset, header.numMaterials, bufferDataOffset);
+
+	// 頂点バッファ
+	for (uint32_t i = 0; i < header.numVertexBuffers; i++)
+	{
+		const SdkMeshVertexBufferHeader& vertexBuffer = m_vertexBuffers[i];
+		if (bufferDataOffset > vertexBuffer.dataOffset
+			|| !IsRangeInside(vertexBuffer.dataOffset, vertexBuffer.sizeBytes, bufferDataEnd))
+		{
+			throw std::runtime_error("SDKMESH vertex buffer is out of range.");
+		}
+
+		if (vertexBuffer.strideBytes == 0
+			|| vertexBuffer.numVertices > vertexBuffer.sizeBytes / vertexBuffer.strideBytes)
+		{
+			throw std::runtime_error("SDKMESH vertex buffer size is invalid.");
+		}
+	}
+
+	// インデックスバッファ
+	for (uint32_t i = 0; i < header.numIndexBuffers; i++)
+	{
+		const SdkMeshIndexBufferHeader& indexBuffer = m_indexBuffers[i];
+		if (bufferDataOffset > indexBuffer.dataOffset
+			|| !IsRangeInside(indexBuffer.dataOffset, indexBuffer.sizeBytes, bufferDataEnd))
+		{
+			throw std::runtime_error("SDKMESH index buffer is out of range.");
+		}
+
+		uint64_t indexSize = 0;
+		switch (indexBuffer.indexType)
+		{
+		case SDKMESH_INDEX_16: indexSize = 2; break;
+		case SDKMESH_INDEX_32: indexSize = 4; break;
+		default: throw std::runtime_error("SDKMESH index type is invalid.");
+		}
+
+		if (indexBuffer.numIndices > indexBuffer.sizeBytes / indexSize)
+		{
+			throw std::runtime_error("SDKMESH index buffer size is invalid.");
+		}
+	}
+
+	// サブセット
+	for (uint32_t i = 0; i < header.numTotalSubsets; i++)
+	{
+		const SdkMeshSubset& subset = m_subsets[i];
+		CheckName(subset.name, sizeof(subset.name));
+
+		if (subset.materialId >= header.numMaterials)
+		{
+			throw std::runtime_error("SDKMESH subset material is out of range.");
+		}
+	}
+
+	// メッシュ
+	for (uint32_t i = 0; i < header.numMeshes; i++)
+	{
+		const SdkMeshMesh& mesh = m_meshes[i];
+		CheckName(mesh.name, sizeof(mesh.name));
+
+		if (mesh.numVertexBuffers == 0 || mesh.numVertexBuffers > SDKMESH_MAX_VERTEX_STREAMS)
+		{
+			throw std::runtime_error("SDKMESH mesh vertex stream count is invalid.");
+		}
+
+		for (uint32_t j = 0; j < mesh.numVertexBuffers; j++)
+		{
+			if (mesh.vertexBuffers[j] >= header.numVertexBuffers)
+			{
+				throw std::runtime_error("SDKMESH mesh vertex buffer is out of range.");
+			}
+		}
+
+		if (mesh.indexBuffer >= header.numIndexBuffers)
+		{
+			throw std::runtime_error("SDKMESH mesh index buffer is out of range.");
+		}
+
+		const uint32_t* subsets = GetArray<uint32_t>(mesh.subsetOffset, mesh.numSubsets, bufferDataOffset);
+		GetArray<uint32_t>(mesh.frameInfluenceOffset, mesh.numFrameInfluences, bufferDataOffset);
+
+		// サブセットの描画範囲がメッシュのインデックスバッファに収まるか
+		const uint64_t numIndices = m_indexBuffers[mesh.indexBuffer].numIndices;
+		const uint64_t numVertices = m_vertexBuffers[mesh.vertexBuffers[0]].numVertices;
+		for (uint32_t j = 0; j < mesh.numSubsets; j++)
+		{
+			if (subsets[j] >= header.numTotalSubsets)
+			{
+				throw std::runtime_error("SDKMESH mesh subset is out of range.");
+			}
+
+			const SdkMeshSubset& subset = m_subsets[subsets[j]];
+			if (!IsRangeInside(subset.indexStart, subset.indexCount, numIndices)
+				|| !IsRangeInside(subset.vertexStart, subset.vertexCount, numVertices))
+			{
+				throw std::runtime_error("SDKMESH subset range is out of range.");
+			}
+		}
+	}
+
+	// フレーム
+	for (uint32_t i = 0; i < header.numFrames; i++)
+	{
+		const SdkMeshFrame& frame = m_frames[i];
+		CheckName(frame.name, sizeof(frame.name));
+
+		if (frame.mesh != SDKMESH_INVALID_FRAME && frame.mesh >= header.numMeshes)
+		{
+			throw std::runtime_error("SDKMESH frame mesh is out of range.");
+		}
+
+		CheckFrameLink(frame.parentFrame, header.numFrames);
+		CheckFrameLink(frame.childFrame, header.numFrames);
+		CheckFrameLink(frame.siblingFrame, header.numFrames);
+	}
+
+	// マテリアル（バージョン200はテクスチャ名の並びが異なるので名前だけ確認する）
+	for (uint32_t i = 0; i < header.numMaterials; i++)
+	{
+		const SdkMeshMaterial& material = m_materials[i];
+		CheckName(material.name, sizeof(material.name));
+
+		if (header.version == SDKMESH_FILE_VERSION)
+		{
+			CheckName(material.materialInstancePath, sizeof(material.materialInstancePath));
+			CheckName(material.diffuseTexture, sizeof(material.diffuseTexture));
+			CheckName(material.normalTexture, sizeof(material.normalTexture));
+			CheckName(material.specularTexture, sizeof(material.specularTexture));
+		}
+	}
+}
@@ -0,0 +1,275 @@
+﻿//--------------------------------------------------------------------------------------
+// File: SdkMeshFile.h
+//
+// SDKMESH形式（DXUTのメッシュファイル）を読み込むクラス
+//
+// Usage: ファイルをメモリにマップし、ヘッダーや頂点・インデックスのデータはマップした
+//        中身を直接参照します（コピーしません）。
+//        GetVertexData関数などで得たデータはそのままバッファの作成に渡せます。
+//        各テーブルの位置と個数、テーブル間の番号は読み込み時に全て確認し、
+//        壊れている時は std::runtime_error を投げます。
+//        D3Dに依存しないので単体でビルド・検証できます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "MappedFile.h"
+
+namespace Imase
+{
+	// ファイルのバージョン（200はPBR用のマテリアル）
+	const uint32_t SDKMESH_FILE_VERSION = 101;
+	const uint32_t SDKMESH_FILE_VERSION_V2 = 200;
+
+	// 名前の長さ（終端文字を含む）
+	const size_t SDKMESH_MAX_NAME = 100;
+	const size_t SDKMESH_MAX_PATH = 260;
+
+	// メッシュが参照できる頂点バッファの数と、頂点の要素の数
+	const size_t SDKMESH_MAX_VERTEX_STREAMS = 16;
+	const size_t SDKMESH_MAX_VERTEX_ELEMENTS = 32;
+
+	// フレームの番号がないことを表す値
+	const uint32_t SDKMESH_INVALID_FRAME = 0xffffffff;
+
+	// インデックスの型
+	enum SdkMeshIndexType : uint32_t
+	{
+		SDKMESH_INDEX_16 = 0,
+		SDKMESH_INDEX_32 = 1,
+	};
+
+	// 頂点の要素の型（D3DDECLTYPEと同じ値）
+	enum SdkMeshDeclType : uint8_t
+	{
+		SDKMESH_DECLTYPE_FLOAT2 = 1,
+		SDKMESH_DECLTYPE_FLOAT3 = 2,
+		SDKMESH_DECLTYPE_SHORT2N = 9,
+		SDKMESH_DECLTYPE_SHORT4N = 10,
+		SDKMESH_DECLTYPE_FLOAT16_2 = 15,
+	};
+
+	// 頂点の要素の用途（D3DDECLUSAGEと同じ値）
+	enum SdkMeshDeclUsage : uint8_t
+	{
+		SDKMESH_DECLUSAGE_POSITION = 0,
+		SDKMESH_DECLUSAGE_NORMAL = 3,
+		SDKMESH_DECLUSAGE_TEXCOORD = 5,
+	};
+
+	// 頂点の要素の終わりを表すストリーム番号（D3DDECL_END）
+	const uint16_t SDKMESH_DECL_END_STREAM = 0xff;
+
+	// ファイルのヘッダー
+	struct SdkMeshHeader
+	{
+		uint32_t version;
+		uint8_t isBigEndian;
+		uint8_t padding[3];
+		uint64_t headerSize;
+		uint64_t nonBufferDataSize;
+		uint64_t bufferDataSize;
+
+		uint32_t numVertexBuffers;
+		uint32_t numIndexBuffers;
+		uint32_t numMeshes;
+		uint32_t numTotalSubsets;
+		uint32_t numFrames;
+		uint32_t numMaterials;
+
+		// 各テーブルのファイル先頭からの位置
+		uint64_t vertexStreamHeadersOffset;
+		uint64_t indexStreamHeadersOffset;
+		uint64_t meshDataOffset;
+		uint64_t subsetDataOffset;
+		uint64_t frameDataOffset;
+		uint64_t materialDataOffset;
+	};
+
+	// 頂点の要素（D3DVERTEXELEMENT9と同じ）
+	struct SdkMeshVertexElement
+	{
+		uint16_t stream;
+		uint16_t offset;
+		uint8_t type;
+		uint8_t method;
+		uint8_t usage;
+		uint8_t usageIndex;
+	};
+
+	// 頂点バッファのヘッダー
+	struct SdkMeshVertexBufferHeader
+	{
+		uint64_t numVertices;
+		uint64_t sizeBytes;
+		uint64_t strideBytes;
+		SdkMeshVertexElement decl[SDKMESH_MAX_VERTEX_ELEMENTS];
+		uint64_t dataOffset;
+	};
+
+	// インデックスバッファのヘッダー
+	struct SdkMeshIndexBufferHeader
+	{
+		uint64_t numIndices;
+		uint64_t sizeBytes;
+		uint32_t indexType;
+		uint32_t padding;
+		uint64_t dataOffset;
+	};
+
+	// メッシュ
+	struct SdkMeshMesh
+	{
+		char name[SDKMESH_MAX_NAME];
+		uint8_t numVertexBuffers;
+		uint8_t padding[3];
+		uint32_t vertexBuffers[SDKMESH_MAX_VERTEX_STREAMS];
+		uint32_t indexBuffer;
+		uint32_t numSubsets;
+		uint32_t numFrameInfluences;
+		float boundingBoxCenter[3];
+		float boundingBoxExtents[3];
+		uint32_t padding2;
+
+		// サブセットの番号の配列と影響するフレームの番号の配列の位置
+		uint64_t subsetOffset;
+		uint64_t frameInfluenceOffset;
+	};
+
+	// サブセット（マテリアルごとの描画の範囲）
+	struct SdkMeshSubset
+	{
+		char name[SDKMESH_MAX_NAME];
+		uint32_t materialId;
+		uint32_t primitiveType;
+		uint32_t padding;
+		uint64_t indexStart;
+		uint64_t indexCount;
+		uint64_t vertexStart;
+		uint64_t vertexCount;
+	};
+
+	// フレーム（階層構造のノード）
+	struct SdkMeshFrame
+	{
+		char name[SDKMESH_MAX_NAME];
+		uint32_t mesh;
+		uint32_t parentFrame;
+		uint32_t childFrame;
+		uint32_t siblingFrame;
+		float matrix[16];
+		uint32_t animationDataIndex;
+	};
+
+	// マテリアル（バージョン101の並び。200は同じ大きさで中身の意味が異なる）
+	struct SdkMeshMaterial
+	{
+		char name[SDKMESH_MAX_NAME];
+		char materialInstancePath[SDKMESH_MAX_PATH];
+		char diffuseTexture[SDKMESH_MAX_PATH];
+		char normalTexture[SDKMESH_MAX_PATH];
+		char specularTexture[SDKMESH_MAX_PATH];
+		float diffuse[4];
+		float ambient[4];
+		float specular[4];
+		float emissive[4];
+		float power;
+		uint64_t reserved[6];
+	};
+
+	static_assert(sizeof(SdkMeshHeader) == 104, "SdkMeshHeader layout mismatch.");
+	static_assert(sizeof(SdkMeshVertexBufferHeader) == 288, "SdkMeshVertexBufferHeader layout mismatch.");
+	static_assert(sizeof(SdkMeshIndexBufferHeader) == 32, "SdkMeshIndexBufferHeader layout mismatch.");
+	static_assert(sizeof(SdkMeshMesh) == 224, "SdkMeshMesh layout mismatch.");
+	static_assert(sizeof(SdkMeshSubset) == 144, "SdkMeshSubset layout mismatch.");
+	static_assert(sizeof(SdkMeshFrame) == 184, "SdkMeshFrame layout mismatch.");
+	static_assert(sizeof(SdkMeshMaterial) == 1256, "SdkMeshMaterial layout mismatch.");
+
+	// ファイル内のバッファのデータ
+	struct SdkMeshBufferData
+	{
+		const uint8_t* data;
+		size_t size;
+	};
+
+	class SdkMeshFile
+	{
+	private:
+
+		// マップしたファイル
+		MappedFile m_file;
+
+		// ファイルの中身
+		const uint8_t* m_data;
+		size_t m_size;
+
+		// 各テーブル（ファイルの中身を直接参照）
+		const SdkMeshHeader* m_header;
+		const SdkMeshVertexBufferHeader* m_vertexBuffers;
+		const SdkMeshIndexBufferHeader* m_indexBuffers;
+		const SdkMeshMesh* m_meshes;
+		const SdkMeshSubset* m_subsets;
+		const SdkMeshFrame* m_frames;
+		const SdkMeshMaterial* m_materials;
+
+	public:
+
+		// コンストラクタ（ファイルをマップして読み込む）
+		explicit SdkMeshFile(const wchar_t* fileName);
+
+		// コンストラクタ（メモリ上の内容を読み込む。dataは参照するだけなので長く残すこと）
+		SdkMeshFile(const uint8_t* data, size_t size);
+
+		// ファイルの中身を取得する関数（Model::CreateFromSDKMESHなどにそのまま渡せる）
+		const uint8_t* GetData() const { return m_data; }
+		size_t GetSize() const { return m_size; }
+
+		// ヘッダーを取得する関数
+		const SdkMeshHeader& GetHeader() const { return *m_header; }
+
+		// 頂点バッファ
+		const SdkMeshVertexBufferHeader* GetVertexBuffers() const { return m_vertexBuffers; }
+		size_t GetVertexBufferCount() const { return m_header->numVertexBuffers; }
+		SdkMeshBufferData GetVertexData(size_t index) const;
+
+		// インデックスバッファ
+		const SdkMeshIndexBufferHeader* GetIndexBuffers() const { return m_indexBuffers; }
+		size_t GetIndexBufferCount() const { return m_header->numIndexBuffers; }
+		SdkMeshBufferData GetIndexData(size_t index) const;
+
+		// メッシュ
+		const SdkMeshMesh* GetMeshes() const { return m_meshes; }
+		size_t GetMeshCount() const { return m_header->numMeshes; }
+
+		// メッシュのサブセットの番号（個数はnumSubsets）
+		const uint32_t* GetMeshSubsets(size_t meshIndex) const;
+
+		// メッシュに影響するフレームの番号（個数はnumFrameInfluences）
+		const uint32_t* GetMeshFrameInfluences(size_t meshIndex) const;
+
+		// サブセット
+		const SdkMeshSubset* GetSubsets() const { return m_subsets; }
+		size_t GetSubsetCount() const { return m_header->numTotalSubsets; }
+
+		// フレーム
+		const SdkMeshFrame* GetFrames() const { return m_frames; }
+		size_t GetFrameCount() const { return m_header->numFrames; }
+
+		// マテリアル
+		const SdkMeshMaterial* GetMaterials() const { return m_materials; }
+		size_t GetMaterialCount() const { return m_header->numMaterials; }
+
+	private:
+
+		// ファイルの中身を解析する関数
+		void Parse(const uint8_t* data, size_t size);
+
+		// ファイル内の位置から配列を取得する関数（範囲と境界を確認する）
+		template <class T>
+		const T* GetArray(uint64_t offset, uint64_t count, uint64_t limit) const;
+	};
+}
@@ -0,0 +1,130 @@
+﻿//--------------------------------------------------------------------------------------
+// File: SpriteFontFile.cpp
+//
+// MakeSpriteFontで作成した.spritefontファイルを読み込むクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "SpriteFontFile.h"
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace Imase;
+
+namespace
+{
+	// ファイルの先頭の識別子
+	const char SPRITE_FONT_MAGIC[] = "DXTKfont";
+	const size_t SPRITE_FONT_MAGIC_SIZE = sizeof(SPRITE_FONT_MAGIC) - 1;
+
+	// 範囲を確認しながら先頭から順に読み進めるクラス
+	class Reader
+	{
+	private:
+
+		const uint8_t* m_data;
+		size_t m_size;
+		size_t m_position;
+
+	public:
+
+		Reader(const uint8_t* data, size_t size) : m_data(data), m_size(size), m_position(0) {}
+
+		// 指定したバイト数を読み飛ばして先頭を返す
+		const uint8_t* Skip(size_t size)
+		{
+			if (size > m_size - m_position) throw std::runtime_error("SpriteFont file is truncated.");
+
+			const uint8_t* data = m_data + m_position;
+			m_position += size;
+			return data;
+		}
+
+		template <class T>
+		T Read()
+		{
+			T value;
+			std::memcpy(&value, Skip(sizeof(T)), sizeof(T));
+			return value;
+		}
+
+		size_t GetRemaining() const { return m_size - m_position; }
+	};
+}
+
+// コンストラクタ（ファイルをマップして読み込む）
+SpriteFontFile::SpriteFontFile(const wchar_t* fileName)
+	: m_file(fileName)
+{
+	Parse(m_file.GetData(), m_file.GetSize());
+}
+
+// コンストラクタ（メモリ上の内容を読み込む）
+SpriteFontFile::SpriteFontFile(const uint8_t* data, size_t size)
+{
+	Parse(data, size);
+}
+
+// ファイルの中身を解析する関数
+void SpriteFontFile::Parse(const uint8_t* data, size_t size)
+{
+	m_data = data;
+	m_size = size;
+
+	Reader reader(data, size);
+
+	if (std::memcmp(reader.Skip(SPRITE_FONT_MAGIC_SIZE), SPRITE_FONT_MAGIC, SPRITE_FONT_MAGIC_SIZE) != 0)
+	{
+		throw std::runtime_error("Not a MakeSpriteFont output binary.");
+	}
+
+	// 文字の情報（コピーせずに直接参照する）
+	uint32_t glyphCount = reader.Read<uint32_t>();
+	if (glyphCount > reader.GetRemaining() / sizeof(GlyphMetrics))
+	{
+		throw std::runtime_error("SpriteFont file is truncated.");
+	}
+
+	const uint8_t* glyphs = reader.Skip(glyphCount * sizeof(GlyphMetrics));
+	if (reinterpret_cast<uintptr_t>(glyphs) % alignof(GlyphMetrics) != 0)
+	{
+		throw std::runtime_error("SpriteFont data is misaligned.");
+	}
+
+	m_glyphs = reinterpret_cast<const GlyphMetrics*>(glyphs);
+	m_glyphCount = glyphCount;
+
+	m_lineSpacing = reader.Read<float>();
+	m_defaultCharacter = reader.Read<uint32_t>();
+
+	// テクスチャ（コピーせずに直接参照する）
+	m_texture.width = reader.Read<uint32_t>();
+	m_texture.height = reader.Read<uint32_t>();
+	m_texture.format = reader.Read<uint32_t>();
+	m_texture.stride = reader.Read<uint32_t>();
+	m_texture.rows = reader.Read<uint32_t>();
+
+	uint64_t textureSize = static_cast<uint64_t>(m_texture.stride) * m_texture.rows;
+	if (textureSize > reader.GetRemaining())
+	{
+		throw std::runtime_error("SpriteFont file is truncated.");
+	}
+
+	m_texture.data = reader.Skip(static_cast<size_t>(textureSize));
+
+	// 文字がテクスチャからはみ出していないか確認する
+	for (size_t i = 0; i < m_glyphCount; i++)
+	{
+		const int32_t* subrect = m_glyphs[i].subrect;
+		if (subrect[0] < 0 || subrect[1] < 0 || subrect[0] > subrect[2] || subrect[1] > subrect[3]
+			|| static_cast<uint32_t>(subrect[2]) > m_texture.width
+			|| static_cast<uint32_t>(subrect[3]) > m_texture.height)
+		{
+			throw std::runtime_error("SpriteFont glyph is outside the texture.");
+		}
+	}
+
+	m_glyphTable.Build(m_glyphs, m_glyphCount);
+	m_glyphTable.SetDefaultCharacter(m_defaultCharacter);
+}
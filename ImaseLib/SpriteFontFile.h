@@ -0,0 +1,103 @@
+﻿//--------------------------------------------------------------------------------------
+// File: SpriteFontFile.h
+//
+// MakeSpriteFontで作成した.spritefontファイルを読み込むクラス
+//
+// Usage: ファイルをメモリにマップし、文字の情報とテクスチャはマップした中身を直接参照します。
+//        GetGlyphTable関数で文字コードから文字の情報をO(1)で検索できます。
+//        ファイルの内容が壊れている時は std::runtime_error を投げます。
+//        D3Dに依存しないので単体でビルド・検証できます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "GlyphLayout.h"
+#include "MappedFile.h"
+
+namespace Imase
+{
+	// .spritefontファイルのテクスチャ
+	struct SpriteFontTexture
+	{
+		// 幅と高さ（ピクセル）
+		uint32_t width;
+		uint32_t height;
+
+		// DXGI_FORMATの値
+		uint32_t format;
+
+		// １行のバイト数と行数（圧縮形式はブロック単位）
+		uint32_t stride;
+		uint32_t rows;
+
+		// 画素（ファイルの中身を直接参照）
+		const uint8_t* data;
+	};
+
+	class SpriteFontFile
+	{
+	private:
+
+		// マップしたファイル
+		MappedFile m_file;
+
+		// ファイルの中身
+		const uint8_t* m_data;
+		size_t m_size;
+
+		// 文字の情報（ファイルの中身を直接参照）
+		const GlyphMetrics* m_glyphs;
+		size_t m_glyphCount;
+
+		// 行の高さ
+		float m_lineSpacing;
+
+		// フォントにない文字の代わりに使う文字（0は使わない）
+		uint32_t m_defaultCharacter;
+
+		// テクスチャ
+		SpriteFontTexture m_texture;
+
+		// 文字コードから文字の情報を検索するテーブル
+		GlyphTable m_glyphTable;
+
+	public:
+
+		// コンストラクタ（ファイルをマップして読み込む）
+		explicit SpriteFontFile(const wchar_t* fileName);
+
+		// コンストラクタ（メモリ上の内容を読み込む。dataは参照するだけなので長く残すこと）
+		SpriteFontFile(const uint8_t* data, size_t size);
+
+		// ファイルの中身を取得する関数
+		const uint8_t* GetData() const { return m_data; }
+		size_t GetSize() const { return m_size; }
+
+		// 文字の情報を取得する関数
+		const GlyphMetrics* GetGlyphs() const { return m_glyphs; }
+
+		// 文字の数を取得する関数
+		size_t GetGlyphCount() const { return m_glyphCount; }
+
+		// 行の高さを取得する関数
+		float GetLineSpacing() const { return m_lineSpacing; }
+
+		// フォントにない文字の代わりに使う文字を取得する関数
+		uint32_t GetDefaultCharacter() const { return m_defaultCharacter; }
+
+		// テクスチャを取得する関数
+		const SpriteFontTexture& GetTexture() const { return m_texture; }
+
+		// 文字コードから文字の情報を検索するテーブルを取得する関数
+		const GlyphTable& GetGlyphTable() const { return m_glyphTable; }
+
+	private:
+
+		// ファイルの中身を解析する関数
+		void Parse(const uint8_t* data, size_t size);
+	};
+}
@@ -0,0 +1,51 @@
+﻿//--------------------------------------------------------------------------------------
+// File: TextArena.cpp
+//
+// フレームごとに使い捨てる文字列をまとめて格納するクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "TextArena.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Imase;
+
+// コンストラクタ
+TextArena::TextArena(size_t initialCapacity)
+	: m_buffer(std::max<size_t>(initialCapacity, 16))
+	, m_used(0)
+{
+}
+
+// 文字列をそのまま追加する関数
+TextSpan TextArena::Append(const wchar_t* text)
+{
+	size_t length = std::wcslen(text);
+	if (m_buffer.size() - m_used <= length)
+	{
+		Grow(length + 1);
+	}
+
+	std::memcpy(m_buffer.data() + m_used, text, (length + 1) * sizeof(wchar_t));
+	return Commit(length);
+}
+
+// 書き込んだ文字列を確定する関数
+TextSpan TextArena::Commit(size_t length)
+{
+	TextSpan span = { static_cast<uint32_t>(m_used), static_cast<uint32_t>(length) };
+
+	// 終端文字の分も進める
+	m_used += length + 1;
+	return span;
+}
+
+// 残りの容量が指定した文字数以上になるように拡張する関数
+void TextArena::Grow(size_t available)
+{
+	// 何度も拡張しないように倍々で増やす
+	size_t capacity = std::max(m_buffer.size() * 2, m_used + available);
+	m_buffer.resize(capacity);
+}
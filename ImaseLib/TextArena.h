@@ -0,0 +1,100 @@
+﻿//--------------------------------------------------------------------------------------
+// File: TextArena.h
+//
+// フレームごとに使い捨てる文字列をまとめて格納するクラス
+//
+// Usage: Format関数またはAppend関数で文字列を追加すると、格納位置（TextSpan）が返ります。
+//        文字列はGetText関数で取得してください（終端文字付き）。
+//        Reset関数で中身を空にしますが、確保したメモリは次のフレームで再利用するので
+//        文字列の量が安定すればメモリの確保は発生しません。
+//        格納位置は番号なので、バッファが拡張されても無効になりません。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cwchar>
+#include <stdexcept>
+#include <vector>
+
+namespace Imase
+{
+	// TextArenaに格納した文字列の位置
+	struct TextSpan
+	{
+		// 先頭の位置
+		uint32_t offset;
+
+		// 文字数（終端文字を除く）
+		uint32_t length;
+	};
+
+	class TextArena
+	{
+	public:
+
+		// １つの文字列の最大の文字数（書式の展開がこれを超えるとエラー）
+		static const size_t MAX_STRING_LENGTH = 64 * 1024;
+
+	private:
+
+		// 文字列を格納するバッファ（size()は確保済みの容量として使う）
+		std::vector<wchar_t> m_buffer;
+
+		// 使用済みの文字数
+		size_t m_used;
+
+	public:
+
+		// コンストラクタ（初期容量を文字数で指定）
+		explicit TextArena(size_t initialCapacity = 4096);
+
+		// 中身を空にする関数（確保したメモリは再利用する）
+		void Reset() { m_used = 0; }
+
+		// 書式を展開して追加する関数（swprintfと同じ書式）
+		template <class... Args>
+		TextSpan Format(const wchar_t* format, const Args& ... args)
+		{
+			// 残りの容量に直接書き込み、足りなければ拡張してやり直す
+			for (;;)
+			{
+				size_t available = m_buffer.size() - m_used;
+				int length = std::swprintf(m_buffer.data() + m_used, available, format, args ...);
+				if (length >= 0 && static_cast<size_t>(length) < available)
+				{
+					if (static_cast<size_t>(length) > MAX_STRING_LENGTH) break;
+					return Commit(static_cast<size_t>(length));
+				}
+
+				if (available > MAX_STRING_LENGTH) break;
+
+				Grow(available * 2);
+			}
+
+			throw std::runtime_error("String Formatting Error.");
+		}
+
+		// 文字列をそのまま追加する関数
+		TextSpan Append(const wchar_t* text);
+
+		// 文字列を取得する関数
+		const wchar_t* GetText(TextSpan span) const { return m_buffer.data() + span.offset; }
+
+		// 使用済みの文字数を取得する関数
+		size_t GetUsed() const { return m_used; }
+
+		// 確保済みの容量を取得する関数
+		size_t GetCapacity() const { return m_buffer.size(); }
+
+	private:
+
+		// 書き込んだ文字列を確定する関数
+		TextSpan Commit(size_t length);
+
+		// 残りの容量が指定した文字数以上になるように拡張する関数
+		void Grow(size_t available);
+	};
+}
@@ -0,0 +1,140 @@
+﻿//--------------------------------------------------------------------------------------
+// File: TextLayoutCache.cpp
+//
+// 文字列を並べた結果（文字ごとの四角形と大きさ）を使い回すキャッシュ
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "TextLayoutCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+using namespace Imase;
+
+namespace
+{
+	// FNV-1a（64bit）
+	const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+	const uint64_t FNV_PRIME = 1099511628211ull;
+
+	// 文字列と並べる条件からハッシュ値を求める関数
+	uint64_t HashLayoutKey(const GlyphTable* table, float lineSpacing, const wchar_t* text, size_t length)
+	{
+		uint64_t hash = FNV_OFFSET_BASIS;
+
+		for (size_t i = 0; i < length; i++)
+		{
+			hash ^= static_cast<uint64_t>(text[i]);
+			hash *= FNV_PRIME;
+		}
+
+		uint32_t spacing;
+		std::memcpy(&spacing, &lineSpacing, sizeof(spacing));
+
+		hash ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(table));
+		hash *= FNV_PRIME;
+		hash ^= spacing;
+		hash *= FNV_PRIME;
+
+		return hash;
+	}
+}
+
+// コンストラクタ
+TextLayoutCache::TextLayoutCache(size_t capacity)
+	: m_capacity(std::max<size_t>(capacity, 1))
+	, m_hitCount(0)
+	, m_missCount(0)
+	, m_evictionCount(0)
+{
+	m_index.reserve(m_capacity);
+}
+
+// 文字列を並べた結果を取得する関数
+const TextLayout& TextLayoutCache::Get(const GlyphTable& table, float lineSpacing, const wchar_t* text, size_t length)
+{
+	uint64_t hash = HashLayoutKey(&table, lineSpacing, text, length);
+
+	auto it = m_index.find(hash);
+	if (it != m_index.end())
+	{
+		Entry& entry = *it->second;
+		if (entry.table == &table
+			&& entry.lineSpacing == lineSpacing
+			&& entry.text.size() == length
+			&& std::wmemcmp(entry.text.data(), text, length) == 0)
+		{
+			// 最近使ったものとして先頭に移す
+			m_entries.splice(m_entries.begin(), m_entries, it->second);
+			m_hitCount++;
+			return entry.layout;
+		}
+
+		// ハッシュ値が同じ別の文字列は置き換える
+		m_entries.erase(it->second);
+		m_index.erase(it);
+	}
+
+	m_missCount++;
+
+	// 容量が一杯なら一番古いものを捨て、そのメモリを再利用する
+	if (m_entries.size() >= m_capacity)
+	{
+		m_index.erase(m_entries.back().hash);
+		m_entries.splice(m_entries.begin(), m_entries, std::prev(m_entries.end()));
+		m_evictionCount++;
+	}
+	else
+	{
+		m_entries.emplace_front();
+	}
+
+	Entry& entry = m_entries.front();
+	entry.hash = hash;
+	entry.table = &table;
+	entry.lineSpacing = lineSpacing;
+	entry.text.assign(text, length);
+
+	entry.layout.quads.clear();
+	LayoutGlyphs(table, entry.text.c_str(), lineSpacing, entry.layout.quads, entry.layout.size);
+
+	m_index[hash] = m_entries.begin();
+
+	return entry.layout;
+}
+
+// 容量を設定する関数
+void TextLayoutCache::SetCapacity(size_t capacity)
+{
+	m_capacity = std::max<size_t>(capacity, 1);
+
+	while (m_entries.size() > m_capacity)
+	{
+		EvictLeastRecent();
+	}
+}
+
+// 保存している結果を全て捨てる関数
+void TextLayoutCache::Clear()
+{
+	m_entries.clear();
+	m_index.clear();
+}
+
+// 統計をリセットする関数
+void TextLayoutCache::ResetCounters()
+{
+	m_hitCount = 0;
+	m_missCount = 0;
+	m_evictionCount = 0;
+}
+
+// 一番長く使われていない結果を捨てる関数
+void TextLayoutCache::EvictLeastRecent()
+{
+	m_index.erase(m_entries.back().hash);
+	m_entries.pop_back();
+	m_evictionCount++;
+}
@@ -0,0 +1,112 @@
+﻿//--------------------------------------------------------------------------------------
+// File: TextLayoutCache.h
+//
+// 文字列を並べた結果（文字ごとの四角形と大きさ）を使い回すキャッシュ
+//
+// Usage: Get関数に文字の情報のテーブル、行の高さ、文字列を渡すと並べた結果が返ります。
+//        前と同じ内容の文字列なら並べ直さずに保存しておいた結果を返します。
+//        容量を超えると一番長く使われていない結果から捨てます（LRU）。
+//        並べた結果はスケールに依存しないので、スケールは展開する時に掛けてください。
+//        返した結果は次にGet関数を呼ぶまで有効です。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "GlyphLayout.h"
+
+namespace Imase
+{
+	// 文字列を並べた結果
+	struct TextLayout
+	{
+		// 文字ごとの四角形
+		std::vector<GlyphQuad> quads;
+
+		// 文字列の大きさ（MeasureStringと同じ）
+		float size[2];
+	};
+
+	class TextLayoutCache
+	{
+	public:
+
+		// 既定の容量（文字列の数）
+		static const size_t DEFAULT_CAPACITY = 256;
+
+	private:
+
+		// 保存しておく結果
+		struct Entry
+		{
+			// 検索用のハッシュ値
+			uint64_t hash;
+
+			// 並べた時の条件
+			const GlyphTable* table;
+			float lineSpacing;
+			std::wstring text;
+
+			// 並べた結果
+			TextLayout layout;
+		};
+
+		// 使った順に並べた結果（先頭が最近使ったもの）
+		std::list<Entry> m_entries;
+
+		// ハッシュ値から結果を検索するテーブル
+		std::unordered_map<uint64_t, std::list<Entry>::iterator> m_index;
+
+		// 容量
+		size_t m_capacity;
+
+		// 統計
+		uint64_t m_hitCount;
+		uint64_t m_missCount;
+		uint64_t m_evictionCount;
+
+	public:
+
+		// コンストラクタ
+		explicit TextLayoutCache(size_t capacity = DEFAULT_CAPACITY);
+
+		// 文字列を並べた結果を取得する関数（なければ並べて保存する）
+		const TextLayout& Get(const GlyphTable& table, float lineSpacing, const wchar_t* text, size_t length);
+
+		// 容量を設定する関数（超えた分は捨てる）
+		void SetCapacity(size_t capacity);
+
+		// 保存している結果を全て捨てる関数
+		void Clear();
+
+		// 統計をリセットする関数
+		void ResetCounters();
+
+		// 保存している結果の数を取得する関数
+		size_t GetSize() const { return m_entries.size(); }
+
+		// 容量を取得する関数
+		size_t GetCapacity() const { return m_capacity; }
+
+		// 保存した結果を使えた回数を取得する関数
+		uint64_t GetHitCount() const { return m_hitCount; }
+
+		// 並べ直した回数を取得する関数
+		uint64_t GetMissCount() const { return m_missCount; }
+
+		// 容量を超えて捨てた回数を取得する関数
+		uint64_t GetEvictionCount() const { return m_evictionCount; }
+
+	private:
+
+		// 一番長く使われていない結果を捨てる関数
+		void EvictLeastRecent();
+	};
+}
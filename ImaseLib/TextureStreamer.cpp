@@ -0,0 +1,267 @@
+﻿//--------------------------------------------------------------------------------------
+// File: TextureStreamer.cpp
+//
+// テクスチャを小さいミップマップから順に読み込むクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "TextureStreamer.h"
+
+#include <algorithm>
+
+using namespace Imase;
+
+namespace
+{
+	// ミップマップの全ての要素のバイト数を求める関数
+	size_t GetLevelBytes(const DdsFile& file, uint32_t mip)
+	{
+		size_t bytes = 0;
+		for (uint32_t item = 0; item < file.GetArraySize(); item++)
+		{
+			const DdsSurface& surface = file.GetSurface(item, mip);
+			bytes += surface.slicePitch * surface.depth;
+		}
+		return bytes;
+	}
+
+	// ミップマップの全ての要素のページを触ってメモリに読み込む関数
+	void ReadLevel(const DdsFile& file, uint32_t mip)
+	{
+		for (uint32_t item = 0; item < file.GetArraySize(); item++)
+		{
+			const DdsSurface& surface = file.GetSurface(item, mip);
+			TouchPages(surface.data, surface.slicePitch * surface.depth);
+		}
+	}
+}
+
+const uint32_t TextureStreamer::DEFAULT_INITIAL_SIZE;
+const uint32_t TextureStreamer::DEFAULT_WORKER_COUNT;
+const size_t TextureStreamer::MAX_LEVELS_IN_FLIGHT;
+
+// コンストラクタ
+TextureStreamer::TextureStreamer(ITextureUploadSink* sink, uint32_t workerCount)
+	: m_sink(sink)
+	, m_stop(false)
+	, m_statistics{}
+{
+	for (uint32_t i = 0; i < workerCount; i++)
+	{
+		m_workers.emplace_back(&TextureStreamer::WorkerMain, this);
+	}
+}
+
+// デストラクタ
+TextureStreamer::~TextureStreamer()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_condition.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+// テクスチャを登録する関数（ファイルをマップする）
+TextureHandle TextureStreamer::Add(const wchar_t* fileName, uint32_t initialSize)
+{
+	return Add(std::make_shared<DdsFile>(fileName), initialSize);
+}
+
+// テクスチャを登録する関数
+TextureHandle TextureStreamer::Add(std::shared_ptr<const DdsFile> file, uint32_t initialSize)
+{
+	const TextureHandle handle = static_cast<TextureHandle>(m_textures.size());
+
+	std::unique_ptr<Texture> texture = std::make_unique<Texture>();
+	texture->file = std::move(file);
+	texture->residentMip = texture->file->FindMipForSize(initialSize);
+	texture->wantedMip = 0;
+	texture->loadingMip = texture->residentMip;
+	texture->uploadedItems = 0;
+	texture->state = LevelState::None;
+	texture->levelBytes = 0;
+
+	// 小さいミップマップはすぐに転送して描画に使えるようにする
+	const DdsFile& dds = *texture->file;
+	m_sink->CreateTexture(handle, dds);
+	for (uint32_t item = 0; item < dds.GetArraySize(); item++)
+	{
+		for (uint32_t mip = texture->residentMip; mip < dds.GetMipLevels(); mip++)
+		{
+			m_sink->UploadSurface(handle, item, mip, dds.GetSurface(item, mip));
+		}
+	}
+	m_sink->SetResidentMip(handle, texture->residentMip);
+
+	m_textures.push_back(std::move(texture));
+	CountPending();
+
+	return handle;
+}
+
+// 必要な大きさを指定する関数
+void TextureStreamer::RequestSize(TextureHandle handle, uint32_t maxSize)
+{
+	Texture& texture = *m_textures[handle];
+	texture.wantedMip = texture.file->FindMipForSize(maxSize);
+	CountPending();
+}
+
+// 毎フレーム呼び出す関数
+void TextureStreamer::Update(size_t uploadBudget)
+{
+	// 読み込みが済んだミップマップを受け取る
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (TextureHandle handle : m_completed)
+		{
+			m_textures[handle]->state = LevelState::Ready;
+			m_ready.push_back(handle);
+		}
+		m_completed.clear();
+	}
+
+	UploadReadyLevels(uploadBudget);
+	ScheduleReads();
+	CountPending();
+}
+
+// ワーカースレッドの処理
+void TextureStreamer::WorkerMain()
+{
+	for (;;)
+	{
+		ReadRequest request;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_stop || !m_requests.empty(); });
+			if (m_stop) return;
+
+			request = m_requests.front();
+			m_requests.pop_front();
+		}
+
+		ReadLevel(*request.file, request.mip);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_completed.push_back(request.handle);
+	}
+}
+
+// 読み込みを依頼する関数
+void TextureStreamer::ScheduleReads()
+{
+	size_t inFlight = 0;
+	std::vector<TextureHandle> candidates;
+	for (TextureHandle handle = 0; handle < m_textures.size(); handle++)
+	{
+		const Texture& texture = *m_textures[handle];
+		if (texture.state != LevelState::None)
+		{
+			inFlight++;
+		}
+		else if (texture.residentMip > texture.wantedMip)
+		{
+			candidates.push_back(handle);
+		}
+	}
+
+	// 次のミップマップが小さいテクスチャから順に読み込む
+	std::stable_sort(candidates.begin(), candidates.end(), [this](TextureHandle a, TextureHandle b)
+		{
+			return GetLevelBytes(*m_textures[a]->file, m_textures[a]->residentMip - 1)
+				< GetLevelBytes(*m_textures[b]->file, m_textures[b]->residentMip - 1);
+		});
+
+	bool requested = false;
+	for (TextureHandle handle : candidates)
+	{
+		if (inFlight >= MAX_LEVELS_IN_FLIGHT) break;
+		inFlight++;
+
+		Texture& texture = *m_textures[handle];
+		texture.loadingMip = texture.residentMip - 1;
+		texture.uploadedItems = 0;
+		texture.levelBytes = GetLevelBytes(*texture.file, texture.loadingMip);
+
+		if (m_workers.empty())
+		{
+			// ワーカースレッドがない時はその場で読み込む
+			ReadLevel(*texture.file, texture.loadingMip);
+			texture.state = LevelState::Ready;
+			m_ready.push_back(handle);
+			continue;
+		}
+
+		texture.state = LevelState::Reading;
+		ReadRequest request = { handle, texture.file.get(), texture.loadingMip };
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_requests.push_back(request);
+		requested = true;
+	}
+
+	if (requested) m_condition.notify_all();
+}
+
+// 読み込みが済んだミップマップを転送する関数
+void TextureStreamer::UploadReadyLevels(size_t uploadBudget)
+{
+	m_statistics.uploadedSurfaces = 0;
+	m_statistics.uploadedBytes = 0;
+
+	// 小さいミップマップから順に転送する
+	std::stable_sort(m_ready.begin(), m_ready.end(), [this](TextureHandle a, TextureHandle b)
+		{
+			return m_textures[a]->levelBytes < m_textures[b]->levelBytes;
+		});
+
+	size_t finished = 0;
+	for (TextureHandle handle : m_ready)
+	{
+		Texture& texture = *m_textures[handle];
+		const DdsFile& file = *texture.file;
+
+		while (texture.uploadedItems < file.GetArraySize())
+		{
+			const DdsSurface& surface = file.GetSurface(texture.uploadedItems, texture.loadingMip);
+			const size_t bytes = surface.slicePitch * surface.depth;
+
+			// 予算を超える時は次のフレームに回す（毎フレーム最低１つは転送する）
+			if (m_statistics.uploadedSurfaces > 0 && m_statistics.uploadedBytes + bytes > uploadBudget) break;
+
+			m_sink->UploadSurface(handle, texture.uploadedItems, texture.loadingMip, surface);
+			m_statistics.uploadedSurfaces++;
+			m_statistics.uploadedBytes += bytes;
+			texture.uploadedItems++;
+		}
+
+		if (texture.uploadedItems < file.GetArraySize()) break;
+
+		// 全ての要素を転送したら描画に使う
+		texture.residentMip = texture.loadingMip;
+		texture.state = LevelState::None;
+		m_sink->SetResidentMip(handle, texture.residentMip);
+		finished++;
+	}
+
+	m_ready.erase(m_ready.begin(), m_ready.begin() + finished);
+}
+
+// 統計の読み込み中と未完了の数を数え直す関数
+void TextureStreamer::CountPending()
+{
+	m_statistics.pendingLevels = 0;
+	m_statistics.streamingTextures = 0;
+	for (const std::unique_ptr<Texture>& texture : m_textures)
+	{
+		if (texture->state != LevelState::None) m_statistics.pendingLevels++;
+		if (texture->residentMip > texture->wantedMip) m_statistics.streamingTextures++;
+	}
+}
@@ -0,0 +1,187 @@
+﻿//--------------------------------------------------------------------------------------
+// File: TextureStreamer.h
+//
+// テクスチャを小さいミップマップから順に読み込むクラス
+//
+// Usage: ITextureUploadSinkの実装（D3DTextureUploadSink）をTextureStreamerに渡し、
+//        Add関数でDDSファイルを登録します。登録時は initialSize 以下の小さいミップマップ
+//        だけを転送するので、すぐに描画に使えます。
+//        大きいミップマップはワーカースレッドでファイルの中身を読み込み（ページを触る）、
+//        毎フレームのUpdate関数で、指定したバイト数の範囲で小さいものから順に転送します。
+//        RequestSize関数で必要な大きさを指定すると、それより大きいミップマップは読み込みません。
+//        （小さい大きさを指定し直しても、転送済みのミップマップはそのまま使います）
+//        D3Dに依存しないので、転送先を差し替えて単体で検証できます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "DdsFile.h"
+
+namespace Imase
+{
+	// ストリーミングするテクスチャの番号
+	typedef uint32_t TextureHandle;
+
+	// テクスチャの転送先のインターフェイス
+	class ITextureUploadSink
+	{
+	public:
+
+		virtual ~ITextureUploadSink() = default;
+
+		// 全てのミップマップを持つ空のテクスチャを作成する関数
+		virtual void CreateTexture(TextureHandle handle, const DdsFile& file) = 0;
+
+		// １つのサーフェスを転送する関数
+		virtual void UploadSurface(TextureHandle handle, uint32_t item, uint32_t mip, const DdsSurface& surface) = 0;
+
+		// 描画に使う最も詳細なミップマップを設定する関数
+		virtual void SetResidentMip(TextureHandle handle, uint32_t mip) = 0;
+	};
+
+	class TextureStreamer
+	{
+	public:
+
+		// 登録時に転送するミップマップの大きさの上限
+		static const uint32_t DEFAULT_INITIAL_SIZE = 64;
+
+		// ワーカースレッドの数
+		static const uint32_t DEFAULT_WORKER_COUNT = 2;
+
+		// 同時に読み込むミップマップの数の上限
+		static const size_t MAX_LEVELS_IN_FLIGHT = 8;
+
+		// 転送の統計
+		struct Statistics
+		{
+			// 前回のUpdate関数で転送したサーフェスの数とバイト数
+			uint32_t uploadedSurfaces;
+			size_t uploadedBytes;
+
+			// 読み込み中と転送待ちのミップマップの数
+			uint32_t pendingLevels;
+
+			// 必要な大きさまで転送が済んでいないテクスチャの数
+			uint32_t streamingTextures;
+		};
+
+	private:
+
+		// ミップマップの読み込みの状態
+		enum class LevelState
+		{
+			None,
+			Reading,
+			Ready,
+		};
+
+		// テクスチャの情報
+		struct Texture
+		{
+			// ファイル（メモリにマップしたまま参照する）
+			std::shared_ptr<const DdsFile> file;
+
+			// 描画に使っている最も詳細なミップマップ
+			uint32_t residentMip;
+
+			// 必要な最も詳細なミップマップ
+			uint32_t wantedMip;
+
+			// 読み込み中のミップマップと、転送済みの配列の要素の数
+			uint32_t loadingMip;
+			uint32_t uploadedItems;
+			LevelState state;
+
+			// 読み込み中のミップマップの全ての要素のバイト数
+			size_t levelBytes;
+		};
+
+		// ワーカースレッドへの読み込みの依頼
+		struct ReadRequest
+		{
+			TextureHandle handle;
+			const DdsFile* file;
+			uint32_t mip;
+		};
+
+		// 転送先
+		ITextureUploadSink* m_sink;
+
+		// テクスチャ（ワーカースレッドが参照するので要素のアドレスは変えない）
+		std::vector<std::unique_ptr<Texture>> m_textures;
+
+		// 転送待ちのテクスチャ（メインスレッドだけが使う）
+		std::vector<TextureHandle> m_ready;
+
+		// 読み込みの依頼と完了の通知（m_mutexで保護）
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::deque<ReadRequest> m_requests;
+		std::vector<TextureHandle> m_completed;
+		bool m_stop;
+
+		// ワーカースレッド
+		std::vector<std::thread> m_workers;
+
+		// 統計
+		Statistics m_statistics;
+
+	public:
+
+		// コンストラクタ
+		explicit TextureStreamer(ITextureUploadSink* sink, uint32_t workerCount = DEFAULT_WORKER_COUNT);
+
+		// デストラクタ（読み込み中のワーカースレッドの終了を待つ）
+		~TextureStreamer();
+
+		TextureStreamer(const TextureStreamer&) = delete;
+		TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+		// テクスチャを登録する関数（initialSize以下のミップマップはここで転送する）
+		TextureHandle Add(const wchar_t* fileName, uint32_t initialSize = DEFAULT_INITIAL_SIZE);
+		TextureHandle Add(std::shared_ptr<const DdsFile> file, uint32_t initialSize = DEFAULT_INITIAL_SIZE);
+
+		// 必要な大きさを指定する関数（DDS_TEXTURE_NO_LIMITは全てのミップマップ）
+		void RequestSize(TextureHandle handle, uint32_t maxSize);
+
+		// 毎フレーム呼び出す関数（読み込みを依頼し、読み込みが済んだものをuploadBudgetバイトまで転送する）
+		void Update(size_t uploadBudget);
+
+		// 描画に使っている最も詳細なミップマップを取得する関数
+		uint32_t GetResidentMip(TextureHandle handle) const { return m_textures[handle]->residentMip; }
+
+		// 必要な大きさまで転送が済んだか調べる関数
+		bool IsComplete(TextureHandle handle) const { return m_textures[handle]->residentMip <= m_textures[handle]->wantedMip; }
+
+		// 全てのテクスチャの転送が済んだか調べる関数
+		bool IsIdle() const { return m_statistics.streamingTextures == 0; }
+
+		// 統計を取得する関数
+		const Statistics& GetStatistics() const { return m_statistics; }
+
+	private:
+
+		// ワーカースレッドの処理
+		void WorkerMain();
+
+		// 読み込みを依頼する関数
+		void ScheduleReads();
+
+		// 読み込みが済んだミップマップを転送する関数
+		void UploadReadyLevels(size_t uploadBudget);
+
+		// 統計の読み込み中と未完了の数を数え直す関数
+		void CountPending();
+	};
+}
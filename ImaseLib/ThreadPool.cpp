@@ -0,0 +1,77 @@
+﻿//--------------------------------------------------------------------------------------
+// File: ThreadPool.cpp
+//
+// 決まった数のワーカースレッドで処理を実行するクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+using namespace Imase;
+
+// コンストラクタ
+ThreadPool::ThreadPool(uint32_t threadCount)
+	: m_stop(false)
+{
+	threadCount = std::max(threadCount, 1u);
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		m_threads.emplace_back(&ThreadPool::WorkerMain, this);
+	}
+}
+
+// デストラクタ
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_condition.notify_all();
+
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+// 既定のワーカースレッドの数
+uint32_t ThreadPool::GetDefaultThreadCount()
+{
+	// メインスレッドの分を残す（取得できない時は0）
+	uint32_t count = std::thread::hardware_concurrency();
+	return count > 1 ? count - 1 : 1;
+}
+
+// 処理を実行待ちに追加する関数
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push_back(std::move(task));
+	}
+	m_condition.notify_one();
+}
+
+// ワーカースレッドの処理
+void ThreadPool::WorkerMain()
+{
+	for (;;)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+
+			// 終了の指示があっても登録済みの処理は実行する
+			if (m_tasks.empty()) return;
+
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+
+		task();
+	}
+}
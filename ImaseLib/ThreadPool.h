@@ -0,0 +1,78 @@
+﻿//--------------------------------------------------------------------------------------
+// File: ThreadPool.h
+//
+// 決まった数のワーカースレッドで処理を実行するクラス
+//
+// Usage: Submit関数に渡した処理はワーカースレッドで登録順に実行されます。
+//        戻り値のstd::futureで結果を受け取ります。処理が投げた例外はget関数で投げ直されます。
+//        デストラクタは登録済みの処理が全て終わるのを待ちます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Imase
+{
+	class ThreadPool
+	{
+	private:
+
+		// ワーカースレッド
+		std::vector<std::thread> m_threads;
+
+		// 実行待ちの処理（m_mutexで保護）
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::deque<std::function<void()>> m_tasks;
+		bool m_stop;
+
+	public:
+
+		// コンストラクタ
+		explicit ThreadPool(uint32_t threadCount = GetDefaultThreadCount());
+
+		// デストラクタ（登録済みの処理が全て終わるのを待つ）
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// 処理を登録する関数
+		template <class F>
+		auto Submit(F&& function) -> std::future<decltype(function())>
+		{
+			typedef decltype(function()) Result;
+
+			// packaged_taskはコピーできないので共有して渡す
+			auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(function));
+			std::future<Result> future = task->get_future();
+			Enqueue([task]() { (*task)(); });
+			return future;
+		}
+
+		// ワーカースレッドの数を取得する関数
+		size_t GetThreadCount() const { return m_threads.size(); }
+
+		// 既定のワーカースレッドの数（論理コア数 - 1、最低１）
+		static uint32_t GetDefaultThreadCount();
+
+	private:
+
+		// 処理を実行待ちに追加する関数
+		void Enqueue(std::function<void()> task);
+
+		// ワーカースレッドの処理
+		void WorkerMain();
+	};
+}
@@ -0,0 +1,486 @@
+﻿//--------------------------------------------------------------------------------------
+// File: TraceCapture.cpp
+//
+// CPUプロファイラの記録を指定したフレーム数だけファイルに書き出すクラス
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "TraceCapture.h"
+#include "Utf8.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace Imase;
+
+namespace
+{
+	// バイナリ形式のレコードの種類
+	enum BinaryRecord : uint8_t
+	{
+		RECORD_STRING = 1,
+		RECORD_THREAD = 2,
+		RECORD_FRAME = 3,
+		RECORD_ZONE = 4,
+		RECORD_COUNTER = 5,
+	};
+
+	// JSONのプロセスID
+	const int TRACE_PROCESS_ID = 1;
+
+	// JSONの文字列として追加する関数
+	void AppendJsonString(std::string& out, const std::string& text)
+	{
+		out += '"';
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\')
+			{
+				out += '\\';
+				out += c;
+			}
+			else if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char escaped[8];
+				std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+				out += escaped;
+			}
+			else
+			{
+				out += c;
+			}
+		}
+		out += '"';
+	}
+
+	// 符号なし整数をvarintで追加する関数
+	void AppendVarint(std::vector<uint8_t>& out, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			out.push_back(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<uint8_t>(value));
+	}
+
+	// 符号付き整数をzigzag varintで追加する関数
+	void AppendSignedVarint(std::vector<uint8_t>& out, int64_t value)
+	{
+		AppendVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+	}
+
+	// 固定長の整数をリトルエンディアンで追加する関数
+	void AppendFixed(std::vector<uint8_t>& out, uint64_t value, int bytes)
+	{
+		for (int i = 0; i < bytes; i++)
+		{
+			out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+		}
+	}
+}
+
+// コンストラクタ
+TraceCapture::TraceCapture()
+	: m_stopRequested(false)
+	, m_error(false)
+	, m_writing(false)
+	, m_jsonFile(nullptr)
+	, m_binaryFile(nullptr)
+	, m_capturing(false)
+	, m_remainingFrames(0)
+	, m_frameIndex(0)
+	, m_startTicks(0)
+	, m_frequency(1)
+	, m_firstJsonEvent(true)
+{
+}
+
+// デストラクタ
+TraceCapture::~TraceCapture()
+{
+	Wait();
+}
+
+// キャプチャを開始する関数
+bool TraceCapture::Start(const char* jsonPath, const char* binaryPath, uint32_t frameCount)
+{
+	if (m_capturing || frameCount == 0 || (!jsonPath && !binaryPath)) return false;
+
+	// 前回のキャプチャの書き込み中はメインスレッドで待たずに断る
+	if (IsWriting()) return false;
+
+	// 書き込みスレッドは終わっているのですぐに戻る
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+
+	if (jsonPath) m_jsonFile = std::fopen(jsonPath, "wb");
+	if (binaryPath) m_binaryFile = std::fopen(binaryPath, "wb");
+
+	if ((jsonPath && !m_jsonFile) || (binaryPath && !m_binaryFile))
+	{
+		if (m_jsonFile) std::fclose(m_jsonFile);
+		if (m_binaryFile) std::fclose(m_binaryFile);
+		m_jsonFile = nullptr;
+		m_binaryFile = nullptr;
+		return false;
+	}
+
+	// 書き込みスレッドの開始前に初期化しておく
+	// 周波数の初回の測定で待つことがあるので先に取得する
+	m_frequency = CpuProfiler::GetFrequency();
+	m_startTicks = CpuProfiler::GetTimestamp();
+	m_firstJsonEvent = true;
+	m_stringIds.clear();
+	m_stopRequested = false;
+	m_error = false;
+	m_writing = true;
+
+	if (m_jsonFile)
+	{
+		std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", m_jsonFile);
+	}
+
+	if (m_binaryFile)
+	{
+		m_bytes.clear();
+		const char magic[8] = { 'I', 'M', 'T', 'R', 'A', 'C', 'E', '\0' };
+		for (char c : magic)
+		{
+			m_bytes.push_back(static_cast<uint8_t>(c));
+		}
+		AppendFixed(m_bytes, BINARY_VERSION, 4);
+		AppendFixed(m_bytes, m_frequency, 8);
+		AppendFixed(m_bytes, m_startTicks, 8);
+		std::fwrite(m_bytes.data(), 1, m_bytes.size(), m_binaryFile);
+	}
+
+	m_capturing = true;
+	m_remainingFrames = frameCount;
+	m_frameIndex = 0;
+	m_threadNames.clear();
+	m_counters.clear();
+
+	CpuProfiler::SetEventCaptureEnabled(true);
+
+	m_thread = std::thread(&TraceCapture::WriterThread, this);
+	return true;
+}
+
+// キャプチャを途中で終了する関数
+void TraceCapture::Stop()
+{
+	if (!m_capturing) return;
+
+	m_capturing = false;
+	CpuProfiler::SetEventCaptureEnabled(false);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopRequested = true;
+	}
+	m_condition.notify_one();
+}
+
+// 書き込みが終わるまで待つ関数
+void TraceCapture::Wait()
+{
+	Stop();
+
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+}
+
+// このフレームのカウンタの値を設定する関数
+void TraceCapture::SetCounter(const char* name, double value)
+{
+	if (!m_capturing) return;
+
+	for (Counter& counter : m_counters)
+	{
+		if (counter.name == name)
+		{
+			counter.value = value;
+			return;
+		}
+	}
+	m_counters.push_back(Counter{ name, value });
+}
+
+// フレームの記録を書き込みスレッドに渡す関数
+void TraceCapture::EndFrame()
+{
+	if (!m_capturing) return;
+
+	std::unique_ptr<Frame> frame;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_freeFrames.empty())
+		{
+			frame = std::move(m_freeFrames.back());
+			m_freeFrames.pop_back();
+		}
+	}
+	if (!frame)
+	{
+		frame = std::make_unique<Frame>();
+	}
+
+	// 再利用するフレームは確保済みのメモリにコピーする
+	frame->frameIndex = m_frameIndex++;
+	frame->timestamp = CpuProfiler::GetTimestamp();
+	frame->events.assign(CpuProfiler::GetFrameEvents().begin(), CpuProfiler::GetFrameEvents().end());
+	frame->counters.assign(m_counters.begin(), m_counters.end());
+	m_counters.clear();
+
+	// 新しいスレッドや名前が変わったスレッドを知らせる
+	frame->threadNames.clear();
+	uint32_t threadCount = CpuProfiler::GetThreadCount();
+	if (m_threadNames.size() < threadCount)
+	{
+		m_threadNames.resize(threadCount, nullptr);
+	}
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		const wchar_t* name = CpuProfiler::GetThreadName(i);
+		if (name && name != m_threadNames[i])
+		{
+			m_threadNames[i] = name;
+			frame->threadNames.push_back(std::make_pair(i, name));
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_queue.push_back(std::move(frame));
+	}
+	m_condition.notify_one();
+
+	if (--m_remainingFrames == 0)
+	{
+		Stop();
+	}
+}
+
+// 書き込みスレッドがファイルを書き込み中か調べる関数
+bool TraceCapture::IsWriting()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_writing;
+}
+
+// 書き込みでエラーが発生したか調べる関数
+bool TraceCapture::HasError()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_error;
+}
+
+// 書き込みスレッドの処理
+void TraceCapture::WriterThread()
+{
+	CpuProfiler::SetThreadName(L"TraceWriter");
+
+	for (;;)
+	{
+		std::unique_ptr<Frame> frame;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return !m_queue.empty() || m_stopRequested; });
+
+			if (m_queue.empty()) break;
+
+			frame = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+
+		WriteFrame(*frame);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_freeFrames.push_back(std::move(frame));
+	}
+
+	CloseFiles();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_writing = false;
+}
+
+// 記録を書き込む関数
+void TraceCapture::WriteFrame(const Frame& frame)
+{
+	m_text.clear();
+	m_bytes.clear();
+
+	const double microsecondsPerTick = 1.0e6 / static_cast<double>(m_frequency);
+	const int64_t frameTicks = static_cast<int64_t>(frame.timestamp - m_startTicks);
+	char number[128];
+	std::string name;
+
+	// JSONのイベントの区切り
+	auto beginJsonEvent = [this]()
+	{
+		if (!m_firstJsonEvent) m_text += ",\n";
+		m_firstJsonEvent = false;
+	};
+
+	// スレッド名
+	for (const auto& thread : frame.threadNames)
+	{
+		name.clear();
+		AppendUtf8(name, thread.second);
+
+		if (m_jsonFile)
+		{
+			beginJsonEvent();
+			std::snprintf(number, sizeof(number), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":",
+				TRACE_PROCESS_ID, thread.first);
+			m_text += number;
+			AppendJsonString(m_text, name);
+			m_text += "}}";
+		}
+
+		if (m_binaryFile)
+		{
+			uint32_t id = GetStringId(thread.second, name);
+			m_bytes.push_back(RECORD_THREAD);
+			AppendVarint(m_bytes, thread.first);
+			AppendVarint(m_bytes, id);
+		}
+	}
+
+	// フレームの区切り
+	if (m_jsonFile)
+	{
+		beginJsonEvent();
+		std::snprintf(number, sizeof(number), "{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":%d,\"tid\":0,\"ts\":%.3f,",
+			TRACE_PROCESS_ID, static_cast<double>(frameTicks) * microsecondsPerTick);
+		m_text += number;
+		std::snprintf(number, sizeof(number), "\"args\":{\"frame\":%llu}}", static_cast<unsigned long long>(frame.frameIndex));
+		m_text += number;
+	}
+	if (m_binaryFile)
+	{
+		m_bytes.push_back(RECORD_FRAME);
+		AppendVarint(m_bytes, frame.frameIndex);
+		AppendVarint(m_bytes, static_cast<uint64_t>(frameTicks));
+	}
+
+	// 区間
+	for (const CpuProfileEvent& event : frame.events)
+	{
+		const int64_t beginTicks = static_cast<int64_t>(event.beginTicks - m_startTicks);
+		const uint64_t durationTicks = event.endTicks - event.beginTicks;
+
+		name.clear();
+		AppendUtf8(name, event.name);
+
+		if (m_jsonFile)
+		{
+			beginJsonEvent();
+			m_text += "{\"name\":";
+			AppendJsonString(m_text, name);
+			std::snprintf(number, sizeof(number), ",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,", TRACE_PROCESS_ID, event.threadIndex);
+			m_text += number;
+			std::snprintf(number, sizeof(number), "\"ts\":%.3f,\"dur\":%.3f}",
+				static_cast<double>(beginTicks) * microsecondsPerTick, static_cast<double>(durationTicks) * microsecondsPerTick);
+			m_text += number;
+		}
+
+		if (m_binaryFile)
+		{
+			uint32_t id = GetStringId(event.name, name);
+			m_bytes.push_back(RECORD_ZONE);
+			AppendVarint(m_bytes, id);
+			AppendVarint(m_bytes, event.threadIndex);
+			AppendVarint(m_bytes, event.depth);
+			AppendSignedVarint(m_bytes, beginTicks - frameTicks);
+			AppendVarint(m_bytes, durationTicks);
+		}
+	}
+
+	// カウンタ
+	for (const Counter& counter : frame.counters)
+	{
+		double value = std::isfinite(counter.value) ? counter.value : 0.0;
+
+		if (m_jsonFile)
+		{
+			beginJsonEvent();
+			m_text += "{\"name\":";
+			AppendJsonString(m_text, counter.name);
+			std::snprintf(number, sizeof(number), ",\"ph\":\"C\",\"pid\":%d,\"ts\":%.3f,",
+				TRACE_PROCESS_ID, static_cast<double>(frameTicks) * microsecondsPerTick);
+			m_text += number;
+			std::snprintf(number, sizeof(number), "\"args\":{\"value\":%.17g}}", value);
+			m_text += number;
+		}
+
+		if (m_binaryFile)
+		{
+			uint32_t id = GetStringId(counter.name, counter.name);
+			uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			m_bytes.push_back(RECORD_COUNTER);
+			AppendVarint(m_bytes, id);
+			AppendFixed(m_bytes, bits, 8);
+		}
+	}
+
+	bool failed = false;
+	if (m_jsonFile && std::fwrite(m_text.data(), 1, m_text.size(), m_jsonFile) != m_text.size()) failed = true;
+	if (m_binaryFile && std::fwrite(m_bytes.data(), 1, m_bytes.size(), m_binaryFile) != m_bytes.size()) failed = true;
+
+	if (failed)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_error = true;
+	}
+}
+
+// ファイルを閉じる関数
+void TraceCapture::CloseFiles()
+{
+	bool failed = false;
+
+	if (m_jsonFile)
+	{
+		if (std::fputs("\n]}\n", m_jsonFile) < 0) failed = true;
+		if (std::fclose(m_jsonFile) != 0) failed = true;
+		m_jsonFile = nullptr;
+	}
+
+	if (m_binaryFile)
+	{
+		if (std::fclose(m_binaryFile) != 0) failed = true;
+		m_binaryFile = nullptr;
+	}
+
+	if (failed)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_error = true;
+	}
+}
+
+// 文字列の番号を取得する関数
+uint32_t TraceCapture::GetStringId(const void* key, const std::string& utf8)
+{
+	auto it = m_stringIds.find(key);
+	if (it != m_stringIds.end()) return it->second;
+
+	uint32_t id = static_cast<uint32_t>(m_stringIds.size());
+	m_stringIds.emplace(key, id);
+
+	// 文字列のレコードは使うレコードより前に書き込む
+	m_bytes.push_back(RECORD_STRING);
+	AppendVarint(m_bytes, id);
+	AppendVarint(m_bytes, utf8.size());
+	m_bytes.insert(m_bytes.end(), utf8.begin(), utf8.end());
+
+	return id;
+}
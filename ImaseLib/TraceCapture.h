@@ -0,0 +1,149 @@
+﻿//--------------------------------------------------------------------------------------
+// File: TraceCapture.h
+//
+// CPUプロファイラの記録を指定したフレーム数だけファイルに書き出すクラス
+//
+// Usage: Start関数で出力先とフレーム数を指定し、毎フレーム CpuProfiler::EndFrame の後に
+//        SetCounter関数でカウンタ（FPSや描画回数など）を設定してからEndFrame関数を呼んでください。
+//        Chrome Trace Event形式のJSON（chrome://tracing や Perfetto で開ける）と
+//        独自のバイナリ形式のどちらか、または両方を出力できます。
+//        ファイルへの変換と書き込みはバックグラウンドのスレッドで行います。
+//        前回のキャプチャを書き込み中の間はStart関数は待たずにfalseを返します。
+//
+//        バイナリ形式（数値はリトルエンディアン、varintは7bitずつのLEB128）
+//          ヘッダ  : "IMTRACE\0" u32:バージョン u64:タイムスタンプの周波数 u64:開始時刻
+//          レコード: u8:種類 に続けて
+//            1 文字列   varint:番号 varint:バイト数 UTF-8の文字列
+//            2 スレッド varint:スレッド番号 varint:名前の文字列番号
+//            3 フレーム varint:フレーム番号 varint:時刻
+//            4 区間     varint:名前の文字列番号 varint:スレッド番号 varint:深さ
+//                       zigzag varint:開始時刻（直前のフレームの時刻との差） varint:長さ
+//            5 カウンタ varint:名前の文字列番号 f64:値（時刻は直前のフレーム）
+//          時刻は開始時刻からのタイムスタンプのカウント数です。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "CpuProfiler.h"
+
+namespace Imase
+{
+	class TraceCapture
+	{
+	public:
+
+		// バイナリ形式のバージョン
+		static const uint32_t BINARY_VERSION = 1;
+
+	private:
+
+		// カウンタ
+		struct Counter
+		{
+			const char* name;
+			double value;
+		};
+
+		// １フレーム分の記録（書き込みスレッドに渡す）
+		struct Frame
+		{
+			uint64_t frameIndex;
+			uint64_t timestamp;
+			std::vector<CpuProfileEvent> events;
+			std::vector<Counter> counters;
+			std::vector<std::pair<uint32_t, const wchar_t*>> threadNames;
+		};
+
+		// 書き込みスレッド
+		std::thread m_thread;
+
+		// 書き込み待ちのフレームと再利用するフレーム
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::deque<std::unique_ptr<Frame>> m_queue;
+		std::vector<std::unique_ptr<Frame>> m_freeFrames;
+		bool m_stopRequested;
+		bool m_error;
+		bool m_writing;
+
+		// 出力先
+		FILE* m_jsonFile;
+		FILE* m_binaryFile;
+
+		// キャプチャの状態（メインスレッドだけが使う）
+		bool m_capturing;
+		uint32_t m_remainingFrames;
+		uint64_t m_frameIndex;
+		std::vector<const wchar_t*> m_threadNames;
+		std::vector<Counter> m_counters;
+
+		// 以下は書き込みスレッドだけが使う
+		uint64_t m_startTicks;
+		uint64_t m_frequency;
+		bool m_firstJsonEvent;
+		std::unordered_map<const void*, uint32_t> m_stringIds;
+		std::string m_text;
+		std::vector<uint8_t> m_bytes;
+
+	public:
+
+		// コンストラクタ
+		TraceCapture();
+
+		// デストラクタ（書き込みが終わるまで待つ）
+		~TraceCapture();
+
+		TraceCapture(const TraceCapture&) = delete;
+		TraceCapture& operator=(const TraceCapture&) = delete;
+
+		// キャプチャを開始する関数（出力しない形式はnullptr、開けない時と前回の書き込み中はfalse）
+		bool Start(const char* jsonPath, const char* binaryPath, uint32_t frameCount);
+
+		// キャプチャを途中で終了する関数（書き込みの完了は待たない）
+		void Stop();
+
+		// 書き込みが終わるまで待つ関数
+		void Wait();
+
+		// キャプチャ中か調べる関数
+		bool IsCapturing() const { return m_capturing; }
+
+		// このフレームのカウンタの値を設定する関数（名前は文字列リテラルなどを渡す）
+		void SetCounter(const char* name, double value);
+
+		// フレームの記録を書き込みスレッドに渡す関数（CpuProfiler::EndFrameの後に呼ぶ）
+		void EndFrame();
+
+		// 書き込みスレッドがファイルを書き込み中か調べる関数
+		bool IsWriting();
+
+		// 書き込みでエラーが発生したか調べる関数
+		bool HasError();
+
+	private:
+
+		// 書き込みスレッドの処理
+		void WriterThread();
+
+		// 記録を書き込む関数
+		void WriteFrame(const Frame& frame);
+
+		// ファイルを閉じる関数
+		void CloseFiles();
+
+		// 文字列の番号を取得する関数（初めての文字列はバイナリに書き込む）
+		uint32_t GetStringId(const void* key, const std::string& utf8);
+	};
+}
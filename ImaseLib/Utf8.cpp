@@ -0,0 +1,51 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Utf8.cpp
+//
+// ワイド文字列をUTF-8に変換する関数
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "Utf8.h"
+
+#include <cstdint>
+
+using namespace Imase;
+
+// ワイド文字列をUTF-8に変換してoutの末尾に追加する関数
+void Imase::AppendUtf8(std::string& out, const wchar_t* text)
+{
+	for (; *text; text++)
+	{
+		uint32_t code = static_cast<uint32_t>(*text);
+
+		// サロゲートペア
+		if (sizeof(wchar_t) == 2 && code >= 0xd800 && code <= 0xdbff && text[1] >= 0xdc00 && text[1] <= 0xdfff)
+		{
+			code = 0x10000 + ((code - 0xd800) << 10) + (static_cast<uint32_t>(text[1]) - 0xdc00);
+			text++;
+		}
+
+		if (code < 0x80)
+		{
+			out += static_cast<char>(code);
+		}
+		else if (code < 0x800)
+		{
+			out += static_cast<char>(0xc0 | (code >> 6));
+			out += static_cast<char>(0x80 | (code & 0x3f));
+		}
+		else if (code < 0x10000)
+		{
+			out += static_cast<char>(0xe0 | (code >> 12));
+			out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+			out += static_cast<char>(0x80 | (code & 0x3f));
+		}
+		else
+		{
+			out += static_cast<char>(0xf0 | (code >> 18));
+			out += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+			out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+			out += static_cast<char>(0x80 | (code & 0x3f));
+		}
+	}
+}
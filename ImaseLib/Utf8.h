@@ -0,0 +1,19 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Utf8.h
+//
+// ワイド文字列をUTF-8に変換する関数
+//
+// Usage: wchar_tはWindowsではUTF-16、それ以外ではUTF-32として扱います。
+//        ファイルへの書き出しやPOSIXのファイル名に使ってください。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <string>
+
+namespace Imase
+{
+	// ワイド文字列をUTF-8に変換してoutの末尾に追加する関数
+	void AppendUtf8(std::string& out, const wchar_t* text);
+}
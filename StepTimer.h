@@ -4,18 +4,291 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <exception>
+#include <memory>
+#include <thread>
+
+#ifdef _WIN32
+#include <timeapi.h>
+
+// Windows 10 version 1803 and later. Older SDK headers do not define it.
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
 
 
 namespace DX
 {
+    // Clock backends for BasicStepTimer. A clock reports a monotonic counter
+    // in its own units and how many of those units make up one second.
+    // SleepFor blocks the calling thread for roughly the given number of counter
+    // units; it may oversleep (see BasicFramePacer). Spin is one iteration of a
+    // busy wait.
+
+#ifdef _WIN32
+    // QueryPerformanceCounter backend.
+    // SleepFor waits on a high resolution waitable timer, which wakes within about 0.5 ms
+    // instead of rounding up to the 15.6 ms default timer interrupt. Where the high
+    // resolution flag is not supported (before Windows 10 1803), it waits on a regular
+    // waitable timer and raises the system timer resolution to 1 ms while the timer exists.
+    class QpcClock
+    {
+    public:
+        QpcClock() noexcept(false) :
+            m_frequency(0)
+        {
+            LARGE_INTEGER frequency;
+            if (!QueryPerformanceFrequency(&frequency))
+            {
+                throw std::exception();
+            }
+
+            m_frequency = static_cast<uint64_t>(frequency.QuadPart);
+        }
+
+        uint64_t GetFrequency() const noexcept { return m_frequency; }
+
+        uint64_t GetCounter() const
+        {
+            LARGE_INTEGER counter;
+            if (!QueryPerformanceCounter(&counter))
+            {
+                throw std::exception();
+            }
+
+            return static_cast<uint64_t>(counter.QuadPart);
+        }
+
+        void SleepFor(uint64_t counterDelta) const
+        {
+            // Relative due times are negative, in 100 ns units.
+            const uint64_t hundredNanoseconds = (counterDelta / m_frequency) * 10000000
+                + (counterDelta % m_frequency) * 10000000 / m_frequency;
+            if (hundredNanoseconds == 0)
+            {
+                return;
+            }
+
+            if (!m_sleepTimer)
+            {
+                m_sleepTimer = std::make_shared<SleepTimer>();
+            }
+
+            LARGE_INTEGER dueTime;
+            dueTime.QuadPart = -static_cast<LONGLONG>(hundredNanoseconds);
+            if (m_sleepTimer->handle && SetWaitableTimer(m_sleepTimer->handle, &dueTime, 0, nullptr, nullptr, FALSE))
+            {
+                WaitForSingleObject(m_sleepTimer->handle, INFINITE);
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(hundredNanoseconds / 10));
+            }
+        }
+
+        void Spin() const noexcept { std::this_thread::yield(); }
+
+    private:
+        // Waitable timer shared by copies of the clock, created on the first sleep.
+        struct SleepTimer
+        {
+            HANDLE handle;
+            bool raisedTimerResolution;
+
+            SleepTimer() noexcept :
+                handle(nullptr),
+                raisedTimerResolution(false)
+            {
+                handle = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+                if (!handle)
+                {
+                    handle = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+                    raisedTimerResolution = timeBeginPeriod(1) == TIMERR_NOERROR;
+                }
+            }
+
+            ~SleepTimer()
+            {
+                if (handle)
+                {
+                    CloseHandle(handle);
+                }
+
+                if (raisedTimerResolution)
+                {
+                    timeEndPeriod(1);
+                }
+            }
+
+            SleepTimer(const SleepTimer&) = delete;
+            SleepTimer& operator=(const SleepTimer&) = delete;
+        };
+
+        uint64_t m_frequency;
+        mutable std::shared_ptr<SleepTimer> m_sleepTimer;
+    };
+#endif
+
+    // std::chrono::steady_clock backend (clock_gettime(CLOCK_MONOTONIC) on Linux).
+    class SteadyClock
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        static_assert(clock::period::num == 1, "steady_clock period must be a fraction of a second");
+
+        uint64_t GetFrequency() const noexcept { return static_cast<uint64_t>(clock::period::den); }
+
+        uint64_t GetCounter() const noexcept { return static_cast<uint64_t>(clock::now().time_since_epoch().count()); }
+
+        void SleepFor(uint64_t counterDelta) const { std::this_thread::sleep_for(clock::duration(counterDelta)); }
+
+        void Spin() const noexcept { std::this_thread::yield(); }
+    };
+
+    // Deterministic clock that only moves when told to, for tests and benchmarks.
+    class ManualClock
+    {
+    public:
+        explicit ManualClock(uint64_t frequency = 10000000) noexcept :
+            m_frequency(frequency),
+            m_counter(0),
+            m_sleepOvershoot(0),
+            m_spinCount(0)
+        {
+        }
+
+        uint64_t GetFrequency() const noexcept { return m_frequency; }
+        uint64_t GetCounter() const noexcept { return m_counter; }
+
+        // Move the clock forward.
+        void Advance(uint64_t counterDelta) noexcept { m_counter += counterDelta; }
+        void AdvanceSeconds(double seconds) noexcept { m_counter += static_cast<uint64_t>(seconds * static_cast<double>(m_frequency)); }
+
+        void SetCounter(uint64_t counter) noexcept { m_counter = counter; }
+
+        // Sleeping just advances the clock, plus an optional overshoot to simulate scheduler latency.
+        void SleepFor(uint64_t counterDelta) noexcept { m_counter += counterDelta + m_sleepOvershoot; }
+        void SetSleepOvershoot(uint64_t counterDelta) noexcept { m_sleepOvershoot = counterDelta; }
+
+        // Each spin iteration advances the clock by one microsecond.
+        void Spin() noexcept { m_counter += std::max<uint64_t>(m_frequency / 1000000, 1); m_spinCount++; }
+        uint64_t GetSpinCount() const noexcept { return m_spinCount; }
+
+    private:
+        uint64_t m_frequency;
+        uint64_t m_counter;
+        uint64_t m_sleepOvershoot;
+        uint64_t m_spinCount;
+    };
+
+    // Summary of recent frame or update durations, in the canonical tick format.
+    struct FrameTimeStatistics
+    {
+        uint32_t sampleCount;
+        uint64_t minTicks;
+        uint64_t averageTicks;
+        uint64_t p50Ticks;
+        uint64_t p95Ticks;
+        uint64_t p99Ticks;
+        uint64_t maxTicks;
+        uint32_t overBudgetCount;
+    };
+
+    // Fixed-size ring buffer of recent durations. Recording never allocates.
+    class FrameTimeHistory
+    {
+    public:
+        static constexpr uint32_t Capacity = 256;
+
+        FrameTimeHistory() noexcept :
+            m_samples{},
+            m_next(0),
+            m_count(0)
+        {
+        }
+
+        void Record(uint64_t ticks) noexcept
+        {
+            m_samples[m_next] = ticks;
+            m_next = (m_next + 1) % Capacity;
+            if (m_count < Capacity)
+            {
+                m_count++;
+            }
+        }
+
+        void Clear() noexcept
+        {
+            m_next = 0;
+            m_count = 0;
+        }
+
+        uint32_t GetCount() const noexcept { return m_count; }
+
+        // Compute the summary over the recorded window. Sorting happens on a stack copy.
+        FrameTimeStatistics Compute(uint64_t budgetTicks) const noexcept
+        {
+            FrameTimeStatistics stats = {};
+            stats.sampleCount = m_count;
+
+            if (m_count == 0)
+            {
+                return stats;
+            }
+
+            std::array<uint64_t, Capacity> sorted;
+            std::copy(m_samples.begin(), m_samples.begin() + m_count, sorted.begin());
+            std::sort(sorted.begin(), sorted.begin() + m_count);
+
+            uint64_t sum = 0;
+            for (uint32_t i = 0; i < m_count; i++)
+            {
+                sum += sorted[i];
+                if (budgetTicks != 0 && sorted[i] > budgetTicks)
+                {
+                    stats.overBudgetCount++;
+                }
+            }
+
+            stats.minTicks = sorted[0];
+            stats.maxTicks = sorted[m_count - 1];
+            stats.averageTicks = sum / m_count;
+            stats.p50Ticks = sorted[PercentileIndex(50)];
+            stats.p95Ticks = sorted[PercentileIndex(95)];
+            stats.p99Ticks = sorted[PercentileIndex(99)];
+
+            return stats;
+        }
+
+    private:
+        // Nearest-rank percentile.
+        uint32_t PercentileIndex(uint32_t percent) const noexcept
+        {
+            uint32_t rank = (percent * m_count + 99) / 100;
+            return rank == 0 ? 0 : rank - 1;
+        }
+
+        std::array<uint64_t, Capacity> m_samples;
+        uint32_t m_next;
+        uint32_t m_count;
+    };
+
     // Helper class for animation and simulation timing.
-    class StepTimer
+    // All timing math is done in integers, so a given sequence of counter values
+    // produces the same Tick results with any clock backend.
+    template<typename TClock>
+    class BasicStepTimer
     {
     public:
-        StepTimer() noexcept(false) :
+        explicit BasicStepTimer(const TClock& clock = TClock()) noexcept(false) :
+            m_clock(clock),
             m_elapsedTicks(0),
             m_totalTicks(0),
             m_leftOverTicks(0),
@@ -24,22 +297,32 @@ namespace DX
             m_framesThisSecond(0),
             m_qpcSecondCounter(0),
             m_isFixedTimeStep(false),
-            m_targetElapsedTicks(TicksPerSecond / 60)
+            m_targetElapsedTicks(TicksPerSecond / 60),
+            m_frameBudgetTicks(TicksPerSecond / 60),
+            m_totalFramesOverBudget(0),
+            m_maxUpdatesPerTick(0),
+            m_dropExcessTime(false),
+            m_lastUpdateCount(0),
+            m_updateLimitHitCount(0),
+            m_deltaClampCount(0),
+            m_droppedTicks(0)
         {
-            if (!QueryPerformanceFrequency(&m_qpcFrequency))
+            m_qpcFrequency = m_clock.GetFrequency();
+            if (m_qpcFrequency == 0)
             {
                 throw std::exception();
             }
 
-            if (!QueryPerformanceCounter(&m_qpcLastTime))
-            {
-                throw std::exception();
-            }
+            m_qpcLastTime = m_clock.GetCounter();
 
             // Initialize max delta to 1/10 of a second.
-            m_qpcMaxDelta = static_cast<uint64_t>(m_qpcFrequency.QuadPart / 10);
+            m_qpcMaxDelta = m_qpcFrequency / 10;
         }
 
+        // Get the clock backend (e.g. to advance a ManualClock).
+        TClock& GetClock() noexcept { return m_clock; }
+        const TClock& GetClock() const noexcept { return m_clock; }
+
         // Get elapsed time since the previous Update call.
         uint64_t GetElapsedTicks() const noexcept { return m_elapsedTicks; }
         double GetElapsedSeconds() const noexcept { return TicksToSeconds(m_elapsedTicks); }
@@ -61,6 +344,46 @@ namespace DX
         void SetTargetElapsedTicks(uint64_t targetElapsed) noexcept { m_targetElapsedTicks = targetElapsed; }
         void SetTargetElapsedSeconds(double targetElapsed) noexcept { m_targetElapsedTicks = SecondsToTicks(targetElapsed); }
 
+        // Limit how many fixed timestep updates a single Tick may run (0 means no limit).
+        // When the limit is hit the remaining time is carried over to the next Tick,
+        // or thrown away if SetDropExcessTime(true) was called.
+        void SetMaxUpdatesPerTick(uint32_t maxUpdates) noexcept { m_maxUpdatesPerTick = maxUpdates; }
+        void SetDropExcessTime(bool dropExcessTime) noexcept { m_dropExcessTime = dropExcessTime; }
+
+        // Get how far the fixed timestep clock is into the next update, in the range [0, 1].
+        // Render can blend between the previous and current state with this value.
+        // Variable timestep mode always returns 1 (the current state is up to date).
+        double GetInterpolationAlpha() const noexcept
+        {
+            if (!m_isFixedTimeStep || m_targetElapsedTicks == 0)
+            {
+                return 1.0;
+            }
+
+            // Time carried over by the update limit can exceed one step; the current state is the best we have.
+            return std::min(static_cast<double>(m_leftOverTicks) / static_cast<double>(m_targetElapsedTicks), 1.0);
+        }
+
+        // Telemetry for the catch-up protection.
+        uint32_t GetLastUpdateCount() const noexcept { return m_lastUpdateCount; }
+        uint64_t GetUpdateLimitHitCount() const noexcept { return m_updateLimitHitCount; }
+        uint64_t GetDeltaClampCount() const noexcept { return m_deltaClampCount; }
+        uint64_t GetDroppedTicks() const noexcept { return m_droppedTicks; }
+
+        // Frame time statistics over the last FrameTimeHistory::Capacity ticks.
+        // Frame durations are the unclamped wall time between Tick calls;
+        // update durations are the time spent in the update callbacks of one Tick.
+        FrameTimeStatistics GetFrameStatistics() const noexcept { return m_frameHistory.Compute(m_frameBudgetTicks); }
+        FrameTimeStatistics GetUpdateStatistics() const noexcept { return m_updateHistory.Compute(m_frameBudgetTicks); }
+
+        // Set the frame time above which a frame counts as over budget.
+        void SetFrameBudgetTicks(uint64_t budget) noexcept { m_frameBudgetTicks = budget; }
+        void SetFrameBudgetSeconds(double budget) noexcept { m_frameBudgetTicks = SecondsToTicks(budget); }
+        uint64_t GetFrameBudgetTicks() const noexcept { return m_frameBudgetTicks; }
+
+        // Get the number of frames over budget since the start of the program.
+        uint64_t GetTotalFramesOverBudget() const noexcept { return m_totalFramesOverBudget; }
+
         // Integer format represents time using 10,000,000 ticks per second.
         static constexpr uint64_t TicksPerSecond = 10000000;
 
@@ -73,15 +396,15 @@ namespace DX
 
         void ResetElapsedTime()
         {
-            if (!QueryPerformanceCounter(&m_qpcLastTime))
-            {
-                throw std::exception();
-            }
+            m_qpcLastTime = m_clock.GetCounter();
 
             m_leftOverTicks = 0;
             m_framesPerSecond = 0;
             m_framesThisSecond = 0;
             m_qpcSecondCounter = 0;
+
+            m_frameHistory.Clear();
+            m_updateHistory.Clear();
         }
 
         // Update timer state, calling the specified Update function the appropriate number of times.
@@ -89,27 +412,32 @@ namespace DX
         void Tick(const TUpdate& update)
         {
             // Query the current time.
-            LARGE_INTEGER currentTime;
-
-            if (!QueryPerformanceCounter(&currentTime))
-            {
-                throw std::exception();
-            }
+            const uint64_t currentTime = m_clock.GetCounter();
 
-            uint64_t timeDelta = static_cast<uint64_t>(currentTime.QuadPart - m_qpcLastTime.QuadPart);
+            uint64_t timeDelta = currentTime - m_qpcLastTime;
 
             m_qpcLastTime = currentTime;
             m_qpcSecondCounter += timeDelta;
 
+            // Record the unclamped frame time so hitches show up in the statistics.
+            const uint64_t frameTicks = ClockToTicks(timeDelta);
+            m_frameHistory.Record(frameTicks);
+            if (frameTicks > m_frameBudgetTicks)
+            {
+                m_totalFramesOverBudget++;
+            }
+
             // Clamp excessively large time deltas (e.g. after paused in the debugger).
             if (timeDelta > m_qpcMaxDelta)
             {
+                m_droppedTicks += ClockToTicks(timeDelta - m_qpcMaxDelta);
+                m_deltaClampCount++;
                 timeDelta = m_qpcMaxDelta;
             }
 
-            // Convert QPC units into a canonical tick format. This cannot overflow due to the previous clamp.
+            // Convert clock units into a canonical tick format. This cannot overflow due to the previous clamp.
             timeDelta *= TicksPerSecond;
-            timeDelta /= static_cast<uint64_t>(m_qpcFrequency.QuadPart);
+            timeDelta /= m_qpcFrequency;
 
             const uint32_t lastFrameCount = m_frameCount;
 
@@ -131,15 +459,36 @@ namespace DX
 
                 m_leftOverTicks += timeDelta;
 
+                uint32_t updateCount = 0;
+
                 while (m_leftOverTicks >= m_targetElapsedTicks)
                 {
+                    // Stop catching up once the per-tick limit is reached, so a slow update
+                    // cannot keep making the next frame even slower.
+                    if (m_maxUpdatesPerTick != 0 && updateCount >= m_maxUpdatesPerTick)
+                    {
+                        m_updateLimitHitCount++;
+
+                        if (m_dropExcessTime)
+                        {
+                            // Keep only the partial step so the interpolation alpha stays valid.
+                            const uint64_t remainder = m_leftOverTicks % m_targetElapsedTicks;
+                            m_droppedTicks += m_leftOverTicks - remainder;
+                            m_leftOverTicks = remainder;
+                        }
+                        break;
+                    }
+
                     m_elapsedTicks = m_targetElapsedTicks;
                     m_totalTicks += m_targetElapsedTicks;
                     m_leftOverTicks -= m_targetElapsedTicks;
                     m_frameCount++;
+                    updateCount++;
 
                     update();
                 }
+
+                m_lastUpdateCount = updateCount;
             }
             else
             {
@@ -148,6 +497,7 @@ namespace DX
                 m_totalTicks += timeDelta;
                 m_leftOverTicks = 0;
                 m_frameCount++;
+                m_lastUpdateCount = 1;
 
                 update();
             }
@@ -156,20 +506,32 @@ namespace DX
             if (m_frameCount != lastFrameCount)
             {
                 m_framesThisSecond++;
+
+                m_updateHistory.Record(ClockToTicks(m_clock.GetCounter() - currentTime));
             }
 
-            if (m_qpcSecondCounter >= static_cast<uint64_t>(m_qpcFrequency.QuadPart))
+            if (m_qpcSecondCounter >= m_qpcFrequency)
             {
                 m_framesPerSecond = m_framesThisSecond;
                 m_framesThisSecond = 0;
-                m_qpcSecondCounter %= static_cast<uint64_t>(m_qpcFrequency.QuadPart);
+                m_qpcSecondCounter %= m_qpcFrequency;
             }
         }
 
     private:
-        // Source timing data uses QPC units.
-        LARGE_INTEGER m_qpcFrequency;
-        LARGE_INTEGER m_qpcLastTime;
+        // Convert a clock interval of any length into ticks without overflowing.
+        uint64_t ClockToTicks(uint64_t clockDelta) const noexcept
+        {
+            return (clockDelta / m_qpcFrequency) * TicksPerSecond
+                + (clockDelta % m_qpcFrequency) * TicksPerSecond / m_qpcFrequency;
+        }
+
+        // Clock backend.
+        TClock m_clock;
+
+        // Source timing data uses clock units.
+        uint64_t m_qpcFrequency;
+        uint64_t m_qpcLastTime;
         uint64_t m_qpcMaxDelta;
 
         // Derived timing data uses a canonical tick format.
@@ -186,5 +548,26 @@ namespace DX
         // Members for configuring fixed timestep mode.
         bool m_isFixedTimeStep;
         uint64_t m_targetElapsedTicks;
+
+        // Members for frame time statistics.
+        FrameTimeHistory m_frameHistory;
+        FrameTimeHistory m_updateHistory;
+        uint64_t m_frameBudgetTicks;
+        uint64_t m_totalFramesOverBudget;
+
+        // Members for limiting fixed timestep catch-up and reporting when it happens.
+        uint32_t m_maxUpdatesPerTick;
+        bool m_dropExcessTime;
+        uint32_t m_lastUpdateCount;
+        uint64_t m_updateLimitHitCount;
+        uint64_t m_deltaClampCount;
+        uint64_t m_droppedTicks;
     };
+
+    // Default timer uses QPC on Windows and steady_clock elsewhere.
+#ifdef _WIN32
+    using StepTimer = BasicStepTimer<QpcClock>;
+#else
+    using StepTimer = BasicStepTimer<SteadyClock>;
+#endif
 }
@@ -0,0 +1,313 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// デバイスの消失からの復帰を模したAssetCacheのテストとベンチマーク
+//
+// Usage: AssetCacheTest [--iterations <n>]
+//        Game::CreateDeviceDependentResources と同じく、同梱の14個のリソース（フォント、DDS、SDKMESH）を
+//        取得してGPUのリソースを作り直す処理（ここでは内容のコピーで代用）を、デバイスの消失から
+//        復帰するたびに行います。AssetCacheを使わない場合（以前の流れ）と使う場合の、起動時と
+//        復帰時（n回、既定は20回の中央値）の時間を表示します。
+//        復帰の前にファイルキャッシュを捨てる（cold、POSIXのみ）場合と捨てない（warm）場合を計ります。
+//        また、以下を確かめ、失敗した項目を表示して1を返します。
+//        ・キャッシュを使うと２回目以降の復帰でファイルを読み込まず、作り直した内容が同じこと
+//        ・Trim関数は参照されているアセットを残し、使われていない順に予算まで破棄すること
+//        ・読み込みに失敗したアセットはTrim関数で破棄され、次のGet関数で読み直すこと
+//        ・同じファイルを違う型で取得すると例外を投げること
+//
+//        ビルド例（リポジトリのルートで実行）
+//          g++ -std=c++14 -O2 -pthread -o AssetCacheTest Tools/AssetCacheTest/Main.cpp ImaseLib/AssetCache.cpp ImaseLib/AssetLoader.cpp ImaseLib/ThreadPool.cpp ImaseLib/DdsFile.cpp ImaseLib/SdkMeshFile.cpp ImaseLib/SpriteFontFile.cpp ImaseLib/GlyphLayout.cpp ImaseLib/ResourcePack.cpp ImaseLib/LzCodec.cpp ImaseLib/MappedFile.cpp ImaseLib/Utf8.cpp
+//          g++ -std=c++14 -O1 -g -fsanitize=thread -o AssetCacheTest （ファイルは同じ）
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/AssetCache.h"
+#include "../../ImaseLib/DdsFile.h"
+#include "../../ImaseLib/SdkMeshFile.h"
+#include "../../ImaseLib/SpriteFontFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace Imase;
+
+namespace
+{
+	// 既定の復帰の回数
+	const int DEFAULT_ITERATIONS = 20;
+
+	// Game.cppと同じ予算
+	const size_t ASSET_CACHE_BUDGET = 16 * 1024 * 1024;
+
+	// 同梱のリソース
+	const wchar_t* const FONT_FILE = L"Resources\\Font\\SegoeUI_18.spritefont";
+	const wchar_t* const TEXTURE_FILES[] =
+	{
+		L"Resources\\Models\\ball.dds",
+		L"Resources\\Models\\floor.dds",
+		L"Resources\\Models\\image1.dds",
+		L"Resources\\Models\\image2.dds",
+		L"Resources\\Models\\image3.dds",
+		L"Resources\\Models\\shadow.dds",
+	};
+	const wchar_t* const MESH_FILES[] =
+	{
+		L"Resources\\Models\\Dice.sdkmesh",
+		L"Resources\\Models\\RingX.sdkmesh",
+		L"Resources\\Models\\RingY.sdkmesh",
+		L"Resources\\Models\\RingZ.sdkmesh",
+		L"Resources\\Models\\ball.sdkmesh",
+		L"Resources\\Models\\floor.sdkmesh",
+		L"Resources\\Models\\player.sdkmesh",
+	};
+	const size_t RESOURCE_COUNT = 1 + sizeof(TEXTURE_FILES) / sizeof(TEXTURE_FILES[0]) + sizeof(MESH_FILES) / sizeof(MESH_FILES[0]);
+
+	// 時間の計測
+	typedef std::chrono::steady_clock Clock;
+
+	// 失敗した数
+	int g_failures = 0;
+
+	void Check(bool condition, const char* message)
+	{
+		if (condition) return;
+		if (g_failures < 20) std::printf("FAILED: %s\n", message);
+		g_failures++;
+	}
+
+	// GPUのリソースの代わり（デバイスが消失すると全て破棄する）
+	struct Device
+	{
+		std::vector<std::vector<uint8_t>> resources;
+
+		template <class T>
+		void Create(const T& asset)
+		{
+			resources.emplace_back(asset.GetData(), asset.GetData() + asset.GetSize());
+		}
+	};
+
+#ifndef _WIN32
+	// ファイルキャッシュを捨てる
+	void DropFileCache(const wchar_t* fileName)
+	{
+		std::string path(fileName, fileName + std::wcslen(fileName));
+		std::replace(path.begin(), path.end(), '\\', '/');
+
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) throw std::runtime_error("Failed to open file: " + path);
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		close(fd);
+	}
+
+	void DropFileCaches()
+	{
+		DropFileCache(FONT_FILE);
+		for (const wchar_t* fileName : TEXTURE_FILES) DropFileCache(fileName);
+		for (const wchar_t* fileName : MESH_FILES) DropFileCache(fileName);
+	}
+#endif
+
+	// 以前のGame::CreateDeviceDependentResources（毎回ディスクから読み込む）
+	void CreateWithoutCache(AssetLoader& loader, Device& device)
+	{
+		auto font = loader.Load<SpriteFontFile>(FONT_FILE);
+		std::vector<std::future<std::shared_ptr<const DdsFile>>> textures;
+		for (const wchar_t* fileName : TEXTURE_FILES) textures.push_back(loader.Load<DdsFile>(fileName));
+		std::vector<std::future<std::shared_ptr<const SdkMeshFile>>> meshes;
+		for (const wchar_t* fileName : MESH_FILES) meshes.push_back(loader.Load<SdkMeshFile>(fileName));
+
+		device.Create(*font.get());
+		for (auto& texture : textures) device.Create(*texture.get());
+		for (auto& mesh : meshes) device.Create(*mesh.get());
+	}
+
+	// 今のGame::CreateDeviceDependentResources（キャッシュから取得し、最後に予算に収める）
+	void CreateWithCache(AssetCache& cache, Device& device)
+	{
+		auto font = cache.Get<SpriteFontFile>(FONT_FILE);
+		std::vector<std::shared_future<std::shared_ptr<const DdsFile>>> textures;
+		for (const wchar_t* fileName : TEXTURE_FILES) textures.push_back(cache.Get<DdsFile>(fileName));
+		std::vector<std::shared_future<std::shared_ptr<const SdkMeshFile>>> meshes;
+		for (const wchar_t* fileName : MESH_FILES) meshes.push_back(cache.Get<SdkMeshFile>(fileName));
+
+		device.Create(*font.get());
+		for (auto& texture : textures) device.Create(*texture.get());
+		for (auto& mesh : meshes) device.Create(*mesh.get());
+
+		cache.Trim();
+	}
+
+	// 起動と、デバイスの消失からの復帰をn回行い、起動時間と復帰時間の中央値（ミリ秒）を求める
+	template <class F>
+	void MeasureRestore(const char* label, bool cold, int iterations, F&& create, std::vector<std::vector<uint8_t>>& result)
+	{
+		Device device;
+		std::vector<double> times;
+		double startup = 0.0;
+		for (int i = 0; i <= iterations; i++)
+		{
+			// デバイスの消失
+			device.resources.clear();
+#ifndef _WIN32
+			if (cold) DropFileCaches();
+#endif
+			Clock::time_point start = Clock::now();
+			create(device);
+			double time = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			if (i == 0) startup = time;
+			else times.push_back(time);
+		}
+
+		std::sort(times.begin(), times.end());
+		std::printf("%-14s %-5s startup %7.3f ms  restore median %7.3f ms  min %7.3f ms  max %7.3f ms\n",
+			label, cold ? "cold" : "warm", startup, times[times.size() / 2], times.front(), times.back());
+		result = device.resources;
+	}
+
+	// 復帰の時間を比べ、作り直した内容とキャッシュの統計を確かめる
+	void TestRestore(int iterations)
+	{
+		std::vector<bool> modes;
+#ifndef _WIN32
+		modes.push_back(true);
+#endif
+		modes.push_back(false);
+
+		for (bool cold : modes)
+		{
+			std::vector<std::vector<uint8_t>> before, after;
+			{
+				AssetLoader loader;
+				MeasureRestore("without cache", cold, iterations, [&](Device& device) { CreateWithoutCache(loader, device); }, before);
+			}
+
+			AssetLoader loader;
+			AssetCache cache(&loader, ASSET_CACHE_BUDGET);
+			MeasureRestore("with cache", cold, iterations, [&](Device& device) { CreateWithCache(cache, device); }, after);
+
+			AssetCache::Statistics statistics = cache.GetStatistics();
+			Check(after == before, "restored resources match the uncached path");
+			Check(statistics.misses == RESOURCE_COUNT, "only the first creation reads files");
+			Check(statistics.hits == RESOURCE_COUNT * iterations, "every restore is served from the cache");
+			Check(statistics.evictions == 0 && cache.GetCount() == RESOURCE_COUNT, "the budget keeps every bundled resource");
+			std::printf("               cache: %llu hits, %llu misses, %zu assets, %zu bytes\n",
+				static_cast<unsigned long long>(statistics.hits), static_cast<unsigned long long>(statistics.misses),
+				cache.GetCount(), cache.GetSize());
+		}
+	}
+
+	// Trim関数とエラーの扱いを確かめる
+	void TestTrim()
+	{
+		AssetLoader loader(2);
+
+		// 予算を超えると、参照されていないものを使われていない順に破棄する
+		{
+			AssetCache cache(&loader, 0);
+			std::shared_ptr<const DdsFile> held = cache.Get<DdsFile>(TEXTURE_FILES[0]).get();
+			std::shared_ptr<const DdsFile> second = cache.Get<DdsFile>(TEXTURE_FILES[1]).get();
+			const size_t heldSize = held->GetSize();
+			cache.Get<DdsFile>(TEXTURE_FILES[2]).get();
+			cache.Get<DdsFile>(TEXTURE_FILES[3]).get();
+			second.reset();
+
+			// 残すのは使われた順で最後の１つと、参照されている１つ
+			cache.SetBudget(heldSize + static_cast<size_t>(cache.Get<DdsFile>(TEXTURE_FILES[3]).get()->GetSize()));
+			cache.Trim();
+			Check(cache.GetCount() == 2 && cache.GetStatistics().evictions == 2, "Trim evicts the least recently used entries");
+
+			uint64_t misses = cache.GetStatistics().misses;
+			cache.Get<DdsFile>(TEXTURE_FILES[0]).get();
+			cache.Get<DdsFile>(TEXTURE_FILES[3]).get();
+			Check(cache.GetStatistics().misses == misses, "Trim keeps the held and the most recent entry");
+
+			// 参照が無くなれば予算0で全て破棄される
+			held.reset();
+			cache.SetBudget(0);
+			cache.Trim();
+			Check(cache.GetCount() == 0 && cache.GetSize() == 0, "Trim with a zero budget empties the cache");
+		}
+
+		// 読み込みに失敗したものは予算に関係なく破棄し、次は読み直す
+		{
+			AssetCache cache(&loader);
+			auto missing = cache.Get<DdsFile>(L"Resources\\Models\\missing.dds");
+			bool threw = false;
+			try
+			{
+				missing.get();
+			}
+			catch (const std::exception&)
+			{
+				threw = true;
+			}
+			Check(threw, "a missing file rethrows from get");
+
+			cache.Trim();
+			Check(cache.GetCount() == 0, "Trim drops failed loads");
+			cache.Get<DdsFile>(L"Resources\\Models\\missing.dds").wait();
+			Check(cache.GetStatistics().misses == 2, "a failed load is retried after Trim");
+		}
+
+		// 同じファイルを違う型で取得すると例外を投げる
+		{
+			AssetCache cache(&loader);
+			cache.Get<SdkMeshFile>(MESH_FILES[0]).wait();
+			bool threw = false;
+			try
+			{
+				cache.Get<DdsFile>(MESH_FILES[0]);
+			}
+			catch (const std::runtime_error&)
+			{
+				threw = true;
+			}
+			Check(threw, "a type mismatch throws");
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int iterations = DEFAULT_ITERATIONS;
+	if (argc == 3 && std::strcmp(argv[1], "--iterations") == 0 && std::atoi(argv[2]) > 0)
+	{
+		iterations = std::atoi(argv[2]);
+	}
+	else if (argc != 1)
+	{
+		std::fprintf(stderr, "Usage: AssetCacheTest [--iterations <n>]\n");
+		return 1;
+	}
+
+	try
+	{
+		TestRestore(iterations);
+		TestTrim();
+	}
+	catch (const std::exception& e)
+	{
+		std::printf("FAILED: %s\n", e.what());
+		return 1;
+	}
+
+	if (g_failures > 0)
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}
@@ -0,0 +1,195 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// BuildBillboardVerticesをCreateBillboardの計算と比べるテスト
+//
+// Usage: BillboardGeometryTest
+//        SimpleMath::Matrix::CreateBillboard（DirectXMathの計算）を倍精度で書き直した行列で
+//        四角形の４頂点を変換し、BuildBillboardVerticesの結果と比べます。
+//        乱数で作った位置とカメラのほか、カメラがビルボードと重なる場合（前方向の逆を使う）、
+//        重なる直前の場合、上方向が傾いている場合を確認します。
+//        色、UV、インデックスも確認し、失敗した項目を表示して1を返します。
+//        D3DもDirectXTKも使わないのでLinuxでビルド・実行できます。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:BillboardGeometryTest.exe Tools\BillboardGeometryTest\Main.cpp ImaseLib\BillboardGeometry.cpp
+//          g++ -std=c++14 -O2 -o BillboardGeometryTest Tools/BillboardGeometryTest/Main.cpp ImaseLib/BillboardGeometry.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/BillboardGeometry.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 位置の許容誤差
+	const double POSITION_TOLERANCE = 1e-4;
+
+	// g_XMEpsilon
+	const double XM_EPSILON = 1.192092896e-7;
+
+	// 乱数で作るビルボードの数
+	const size_t RANDOM_COUNT = 10000;
+
+	// 失敗した数
+	int g_failures = 0;
+
+	void Check(bool condition, const char* message, size_t index)
+	{
+		if (condition) return;
+		if (g_failures < 20) std::printf("FAILED: %s (billboard %zu)\n", message, index);
+		g_failures++;
+	}
+
+	struct Vector
+	{
+		double x, y, z;
+	};
+
+	Vector Subtract(Vector a, Vector b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+	double Dot(Vector a, Vector b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+	Vector Cross(Vector a, Vector b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+	Vector Normalize(Vector v)
+	{
+		double length = std::sqrt(Dot(v, v));
+		return length > 0.0 ? Vector{ v.x / length, v.y / length, v.z / length } : v;
+	}
+	Vector ToVector(const float v[3]) { return { v[0], v[1], v[2] }; }
+
+	// Matrix::CreateBillboard（行は右、上、前、位置）
+	void CreateBillboard(Vector object, Vector cameraPosition, Vector cameraUp, Vector cameraForward, Vector rows[4])
+	{
+		Vector z = Subtract(object, cameraPosition);
+		if (Dot(z, z) < XM_EPSILON) z = { -cameraForward.x, -cameraForward.y, -cameraForward.z };
+		else z = Normalize(z);
+
+		Vector x = Normalize(Cross(cameraUp, z));
+		Vector y = Cross(z, x);
+
+		rows[0] = x;
+		rows[1] = y;
+		rows[2] = z;
+		rows[3] = object;
+	}
+
+	// 四角形の頂点（左上、右上、右下、左下）を行列で変換した位置
+	Vector TransformCorner(const Vector rows[4], int corner, double width, double height)
+	{
+		const double cornerX[4] = { -0.5, 0.5, 0.5, -0.5 };
+		const double cornerY[4] = { 0.5, 0.5, -0.5, -0.5 };
+		double x = cornerX[corner] * width;
+		double y = cornerY[corner] * height;
+		return
+		{
+			x * rows[0].x + y * rows[1].x + rows[3].x,
+			x * rows[0].y + y * rows[1].y + rows[3].y,
+			x * rows[0].z + y * rows[1].z + rows[3].z,
+		};
+	}
+
+	// ビルボードを生成してCreateBillboardの結果と比べる
+	void CompareWithCreateBillboard(const std::vector<Billboard>& billboards, const BillboardCamera& camera)
+	{
+		std::vector<BillboardVertex> vertices(billboards.size() * 4);
+		BuildBillboardVertices(billboards.data(), billboards.size(), camera, vertices.data());
+
+		for (size_t i = 0; i < billboards.size(); i++)
+		{
+			const Billboard& billboard = billboards[i];
+
+			Vector rows[4];
+			CreateBillboard(ToVector(billboard.position), ToVector(camera.position), ToVector(camera.up), ToVector(camera.forward), rows);
+
+			const float u[4] = { billboard.uv[0], billboard.uv[2], billboard.uv[2], billboard.uv[0] };
+			const float v[4] = { billboard.uv[1], billboard.uv[1], billboard.uv[3], billboard.uv[3] };
+			for (int j = 0; j < 4; j++)
+			{
+				const BillboardVertex& vertex = vertices[i * 4 + j];
+				Vector expected = TransformCorner(rows, j, billboard.size[0], billboard.size[1]);
+				Check(std::fabs(vertex.position[0] - expected.x) < POSITION_TOLERANCE
+					&& std::fabs(vertex.position[1] - expected.y) < POSITION_TOLERANCE
+					&& std::fabs(vertex.position[2] - expected.z) < POSITION_TOLERANCE, "position differs from CreateBillboard", i);
+				Check(vertex.textureCoordinate[0] == u[j] && vertex.textureCoordinate[1] == v[j], "texture coordinate", i);
+				Check(vertex.color[0] == billboard.color[0] && vertex.color[1] == billboard.color[1]
+					&& vertex.color[2] == billboard.color[2] && vertex.color[3] == billboard.color[3], "color", i);
+			}
+		}
+	}
+
+	Billboard MakeBillboard(float x, float y, float z, float width, float height)
+	{
+		return { { x, y, z }, { width, height }, { 0.0f, 0.0f, 1.0f, 1.0f }, { 1.0f, 0.5f, 0.25f, 1.0f } };
+	}
+}
+
+int main()
+{
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> coordinate(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> size(0.1f, 4.0f);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	// 乱数の位置とUV、色
+	{
+		std::vector<Billboard> billboards;
+		for (size_t i = 0; i < RANDOM_COUNT; i++)
+		{
+			Billboard billboard = MakeBillboard(coordinate(random), coordinate(random), coordinate(random), size(random), size(random));
+			billboard.uv[0] = unit(random);
+			billboard.uv[1] = unit(random);
+			billboard.uv[2] = unit(random);
+			billboard.uv[3] = unit(random);
+			for (float& c : billboard.color) c = unit(random);
+			billboards.push_back(billboard);
+		}
+
+		BillboardCamera camera = { { 3.0f, 2.0f, 10.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } };
+		CompareWithCreateBillboard(billboards, camera);
+
+		// 上方向が傾いたカメラ
+		BillboardCamera tilted = { { -7.0f, 5.0f, 1.0f }, { 0.3f, 0.9f, 0.1f }, { 0.5f, -0.2f, -0.8f } };
+		CompareWithCreateBillboard(billboards, tilted);
+	}
+
+	// カメラがビルボードと重なる場合と、重なる直前の場合
+	{
+		BillboardCamera camera = { { 1.0f, 2.0f, 3.0f }, { 0.0f, 1.0f, 0.0f }, { 0.6f, 0.0f, -0.8f } };
+		std::vector<Billboard> billboards =
+		{
+			MakeBillboard(1.0f, 2.0f, 3.0f, 1.0f, 1.0f),
+			MakeBillboard(1.0f + 1e-4f, 2.0f, 3.0f, 2.0f, 1.0f),
+			MakeBillboard(1.0f, 2.0f + 1e-3f, 3.0f, 1.0f, 2.0f),
+		};
+		CompareWithCreateBillboard(billboards, camera);
+
+		// 重なった時は前方向の逆を向く（右方向は上方向と前方向の逆の外積）
+		std::vector<BillboardVertex> vertices(4);
+		BuildBillboardVertices(billboards.data(), 1, camera, vertices.data());
+		float right[3] = { vertices[1].position[0] - vertices[0].position[0], vertices[1].position[1] - vertices[0].position[1],
+			vertices[1].position[2] - vertices[0].position[2] };
+		Check(std::fabs(right[0] - 0.8f) < 1e-5f && std::fabs(right[1]) < 1e-5f && std::fabs(right[2] - 0.6f) < 1e-5f,
+			"degenerate right axis", 0);
+	}
+
+	// インデックス
+	{
+		std::vector<uint16_t> indices(6 * 3);
+		BuildBillboardIndices(3, indices.data());
+		const uint16_t expected[] = { 0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4, 8, 9, 10, 10, 11, 8 };
+		for (size_t i = 0; i < indices.size(); i++) Check(indices[i] == expected[i], "index", i / 6);
+	}
+
+	if (g_failures > 0)
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}
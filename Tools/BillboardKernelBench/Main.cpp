@@ -0,0 +1,123 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// ExpandBillboardCornersの命令セットごとの速度を計るベンチマーク
+//
+// Usage: BillboardKernelBench [--iterations <n>]
+//        1,000枚、100,000枚、1,000,000枚のビルボードの頂点位置を、BuildBillboardVertices
+//        （CreateBillboardと同じ計算）と、ExpandBillboardCornersのスカラー、SSE2、AVX2
+//        （CPUが対応している分）で計算し、n回（既定は20回）の中央値と1枚あたりの時間を表示します。
+//        出力先はBillboardBatchと同じBillboardVertexの並びで、計る前に一度書き込んでおきます。
+//        全ての結果の位置がBuildBillboardVerticesと一致することを確認し、違えば1を返します。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:BillboardKernelBench.exe Tools\BillboardKernelBench\Main.cpp ImaseLib\BillboardKernel.cpp ImaseLib\BillboardGeometry.cpp ImaseLib\CpuFeatures.cpp
+//          g++ -std=c++14 -O2 -o BillboardKernelBench Tools/BillboardKernelBench/Main.cpp ImaseLib/BillboardKernel.cpp ImaseLib/BillboardGeometry.cpp ImaseLib/CpuFeatures.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/BillboardKernel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 計るビルボードの数
+	const size_t COUNTS[] = { 1000, 100000, 1000000 };
+
+	// 時間を計る（n回の中央値、ミリ秒）
+	template <class F>
+	double Measure(int iterations, F&& function)
+	{
+		std::vector<double> times;
+		for (int i = 0; i < iterations; i++)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			function();
+			times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		std::sort(times.begin(), times.end());
+		return times[times.size() / 2];
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int iterations = 20;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+		{
+			iterations = std::atoi(argv[++i]);
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: BillboardKernelBench [--iterations <n>]\n");
+			return 1;
+		}
+	}
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> coordinate(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> size(0.5f, 2.0f);
+	BillboardCamera camera = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } };
+
+	std::printf("%d iterations, CPU %s\n", iterations, GetSimdLevelName(GetSimdLevel()));
+	std::printf("%9s  %-10s %10s %10s\n", "count", "kernel", "ms", "ns/each");
+
+	int result = 0;
+	for (size_t count : COUNTS)
+	{
+		std::vector<float> x(count), y(count), z(count), width(count), height(count);
+		std::vector<Billboard> billboards(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			x[i] = coordinate(random);
+			y[i] = coordinate(random);
+			z[i] = coordinate(random);
+			width[i] = size(random);
+			height[i] = size(random);
+			billboards[i] = { { x[i], y[i], z[i] }, { width[i], height[i] }, { 0.0f, 0.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } };
+		}
+
+		// カメラと重なるビルボードも入れておく
+		x[0] = y[0] = z[0] = 0.0f;
+		billboards[0].position[0] = billboards[0].position[1] = billboards[0].position[2] = 0.0f;
+
+		std::vector<BillboardVertex> reference(count * 4);
+		double milliseconds = Measure(iterations, [&]() { BuildBillboardVertices(billboards.data(), count, camera, reference.data()); });
+		std::printf("%9zu  %-10s %10.3f %10.2f\n", count, "reference", milliseconds, milliseconds * 1e6 / count);
+
+		BillboardStreams streams = { x.data(), y.data(), z.data(), width.data(), height.data() };
+		std::vector<BillboardVertex> vertices(count * 4);
+		for (int level = 0; level <= static_cast<int>(GetSimdLevel()); level++)
+		{
+			SimdLevel simd = static_cast<SimdLevel>(level);
+			std::fill(vertices.begin(), vertices.end(), BillboardVertex{});
+			milliseconds = Measure(iterations, [&]()
+				{
+					ExpandBillboardCorners(streams, count, camera, vertices.data(), sizeof(BillboardVertex), simd);
+				});
+
+			size_t mismatches = 0;
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				if (std::memcmp(vertices[i].position, reference[i].position, sizeof(vertices[i].position)) != 0) mismatches++;
+			}
+
+			std::printf("%9zu  %-10s %10.3f %10.2f%s\n", count, GetSimdLevelName(simd), milliseconds, milliseconds * 1e6 / count,
+				mismatches ? "  MISMATCH" : "");
+			if (mismatches) result = 1;
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,304 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// DdsFileで同梱のテクスチャを読み込むテスト、読み込み時間のベンチマーク、壊れたファイルのテスト
+//
+// Usage: DdsFileTest [--iterations <n>] [--fuzz <n>] [<file>...]
+//        ファイルを指定しなければ Resources/Models の６つの.ddsファイルを使います。
+//        1. 全てのファイルを読み込み、サブリソースがヘッダーの直後から隙間なく並び、
+//           最後のサブリソースがファイルの終わりでちょうど終わること、各レベルの大きさと
+//           行のバイト数がフォーマットと合っていることをDdsFileとは別に確認します。
+//        2. 全てのファイルを、マップして読み込む時間と、ファイルをメモリに読み込んでから
+//           解析する時間をn回（既定は200回）計り、中央値を表示します。
+//        3. ヘッダーの数バイトを乱数で書き換えたり途中で切ったりしたファイルをn個（既定は10,000個）
+//           作って読み込み、例外で拒否されるか、受け入れた場合はサブリソースが隙間なく並んで
+//           ファイルの中に収まることを確かめます。受け入れたファイルは全てのバイトを読むので、
+//           AddressSanitizerを有効にしてビルドすると範囲外の参照も検出できます。
+//        失敗した項目を表示して1を返します。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:DdsFileTest.exe Tools\DdsFileTest\Main.cpp ImaseLib\DdsFile.cpp ImaseLib\MappedFile.cpp ImaseLib\Utf8.cpp
+//          g++ -std=c++14 -O2 -o DdsFileTest Tools/DdsFileTest/Main.cpp ImaseLib/DdsFile.cpp ImaseLib/MappedFile.cpp ImaseLib/Utf8.cpp
+//          g++ -std=c++14 -O1 -g -fsanitize=address,undefined -o DdsFileTest Tools/DdsFileTest/Main.cpp ImaseLib/DdsFile.cpp ImaseLib/MappedFile.cpp ImaseLib/Utf8.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/DdsFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 同梱のテクスチャ
+	const char* const BUNDLED_TEXTURES[] =
+	{
+		"Resources/Models/ball.dds",
+		"Resources/Models/floor.dds",
+		"Resources/Models/image1.dds",
+		"Resources/Models/image2.dds",
+		"Resources/Models/image3.dds",
+		"Resources/Models/shadow.dds",
+	};
+
+	// 先頭の"DDS "とヘッダー、DX10拡張ヘッダーの大きさ
+	const size_t HEADER_SIZE = sizeof(uint32_t) + sizeof(DdsHeader);
+	const size_t HEADER_DXT10_SIZE = sizeof(DdsHeaderDxt10);
+
+	// 失敗した数
+	int g_failures = 0;
+
+	void Check(bool condition, const char* message, const std::string& file)
+	{
+		if (condition) return;
+		if (g_failures < 20) std::printf("FAILED: %s (%s)\n", message, file.c_str());
+		g_failures++;
+	}
+
+	// 時間を計る（n回の中央値、ミリ秒）
+	template <class F>
+	double Measure(int iterations, F&& function)
+	{
+		std::vector<double> times;
+		for (int i = 0; i < iterations; i++)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			function();
+			times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		std::sort(times.begin(), times.end());
+		return times[times.size() / 2];
+	}
+
+	std::wstring Widen(const std::string& text)
+	{
+		return std::wstring(text.begin(), text.end());
+	}
+
+	// ファイルの中身（ヘッダーを直接参照するので4バイト境界に置く）
+	struct Contents
+	{
+		std::vector<uint32_t> words;
+		size_t size = 0;
+
+		const uint8_t* GetData() const { return reinterpret_cast<const uint8_t*>(words.data()); }
+		uint8_t* GetData() { return reinterpret_cast<uint8_t*>(words.data()); }
+	};
+
+	Contents ReadFile(const std::string& path)
+	{
+		std::ifstream in(path, std::ios::binary | std::ios::ate);
+		if (!in) throw std::runtime_error("Could not open the file.");
+
+		Contents contents;
+		contents.size = static_cast<size_t>(in.tellg());
+		contents.words.resize((contents.size + 3) / 4);
+		in.seekg(0);
+		if (!in.read(reinterpret_cast<char*>(contents.GetData()), contents.size)) throw std::runtime_error("Could not read the file.");
+		return contents;
+	}
+
+	// サブリソースがヘッダーの直後から隙間なく並び、大きさがフォーマットと合っているか確認し、全てのバイトを読む
+	// （DdsFileの確認とは別に書いた、CreateTextureに渡す前提の条件）。最後のサブリソースの終わりの位置を返す
+	bool Validate(const DdsFile& file, uint64_t& sink, size_t& end)
+	{
+		DdsFormatInfo info;
+		if (!GetDdsFormatInfo(file.GetFormat(), info)) return false;
+		if (file.GetSurfaceCount() != static_cast<size_t>(file.GetArraySize()) * file.GetMipLevels()) return false;
+		if (file.IsCubemap() && file.GetArraySize() % 6 != 0) return false;
+
+		const uint8_t* begin = file.GetData();
+		size_t offset = HEADER_SIZE + (file.GetHeaderDxt10() ? HEADER_DXT10_SIZE : 0);
+
+		for (size_t item = 0; item < file.GetArraySize(); item++)
+		{
+			for (uint32_t mip = 0; mip < file.GetMipLevels(); mip++)
+			{
+				const DdsSurface& surface = file.GetSurface(item, mip);
+
+				// 各レベルは前のレベルの半分（1未満にはならない）
+				uint32_t width = std::max(1u, file.GetWidth() >> mip);
+				uint32_t height = std::max(1u, file.GetHeight() >> mip);
+				uint32_t depth = std::max(1u, file.GetDepth() >> mip);
+				if (surface.width != width || surface.height != height || surface.depth != depth) return false;
+
+				// ブロック圧縮は4×4ピクセルを1つの要素として数える
+				size_t columns = info.blockCompressed ? (width + 3) / 4 : width;
+				size_t rows = info.blockCompressed ? (height + 3) / 4 : height;
+				if (surface.rowPitch != columns * info.bytesPerElement || surface.rowCount != rows
+					|| surface.slicePitch != surface.rowPitch * surface.rowCount)
+				{
+					return false;
+				}
+
+				// 前のサブリソースのすぐ後ろから始まり、ファイルの中で終わる
+				size_t size = surface.slicePitch * surface.depth;
+				if (surface.data != begin + offset || size > file.GetSize() - offset) return false;
+				for (size_t i = 0; i < size; i += 61) sink += surface.data[i];
+				if (size > 0) sink += surface.data[size - 1];
+				offset += size;
+			}
+		}
+
+		end = offset;
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int iterations = 200;
+	int fuzzCount = 10000;
+	std::vector<std::string> paths;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+		{
+			iterations = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--fuzz") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) >= 0)
+		{
+			fuzzCount = std::atoi(argv[++i]);
+		}
+		else if (argv[i][0] != '-')
+		{
+			paths.push_back(argv[i]);
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: DdsFileTest [--iterations <n>] [--fuzz <n>] [<file>...]\n");
+			return 1;
+		}
+	}
+	if (paths.empty())
+	{
+		paths.assign(std::begin(BUNDLED_TEXTURES), std::end(BUNDLED_TEXTURES));
+	}
+
+	uint64_t sink = 0;
+
+	// 1. 全てのファイルの読み込み
+	std::vector<Contents> contents;
+	for (const std::string& path : paths)
+	{
+		try
+		{
+			DdsFile file(Widen(path).c_str());
+			contents.push_back(ReadFile(path));
+
+			std::printf("%-32s %4ux%-4u format %2u, %u mips, %u items%s%s, %zu bytes\n",
+				path.c_str(), file.GetWidth(), file.GetHeight(), file.GetFormat(), file.GetMipLevels(), file.GetArraySize(),
+				file.GetHeaderDxt10() ? ", DX10 header" : "", file.IsCubemap() ? ", cubemap" : "", file.GetSize());
+
+			size_t end = 0;
+			Check(Validate(file, sink, end), "surfaces are contiguous and match the format", path);
+			Check(end == file.GetSize(), "the last surface ends at the end of the file", path);
+
+			// メモリ上の内容からも同じように読める
+			const Contents& bytes = contents.back();
+			DdsFile copy(bytes.GetData(), bytes.size);
+			Check(copy.GetSize() == file.GetSize() && std::memcmp(copy.GetData(), file.GetData(), file.GetSize()) == 0
+				&& copy.GetSurfaceCount() == file.GetSurfaceCount() && copy.GetFormat() == file.GetFormat(),
+				"memory overload matches the mapped file", path);
+		}
+		catch (const std::exception& e)
+		{
+			std::printf("FAILED: %s: %s\n", path.c_str(), e.what());
+			g_failures++;
+		}
+	}
+
+	if (contents.size() != paths.size())
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+
+	// 2. 読み込み時間
+	double mapped = Measure(iterations, [&]()
+		{
+			for (const std::string& path : paths)
+			{
+				DdsFile file(Widen(path).c_str());
+				sink += file.GetSurface(0, 0).data[0];
+			}
+		});
+	double heap = Measure(iterations, [&]()
+		{
+			for (const std::string& path : paths)
+			{
+				Contents bytes = ReadFile(path);
+				DdsFile file(bytes.GetData(), bytes.size);
+				sink += file.GetSurface(0, 0).data[0];
+			}
+		});
+	std::printf("load all %zu files: mapped %.1f us, read into memory %.1f us (median of %d)\n",
+		paths.size(), mapped * 1000.0, heap * 1000.0, iterations);
+
+	// 3. 壊れたファイル
+	std::mt19937 random(1);
+	int accepted = 0;
+	int rejected = 0;
+	for (int i = 0; i < fuzzCount; i++)
+	{
+		size_t index = i % contents.size();
+		const Contents& original = contents[index];
+
+		// 解析するのはヘッダーだけなので、書き換えはほとんどヘッダーに入れる
+		size_t size = original.size;
+		if (random() % 4 == 0)
+		{
+			size = random() % size;
+		}
+
+		// 切った後ろを読むとAddressSanitizerで検出できるように、ちょうどの大きさ（4バイト単位）の配列にコピーする
+		Contents bytes;
+		bytes.size = size;
+		bytes.words.assign(original.words.begin(), original.words.begin() + (size + 3) / 4);
+
+		int changes = random() % 4 == 0 ? 0 : 1 + static_cast<int>(random() % 4);
+		for (int j = 0; size > 0 && j < changes; j++)
+		{
+			size_t limit = random() % 8 ? std::min(size, HEADER_SIZE + HEADER_DXT10_SIZE) : size;
+			uint8_t value = static_cast<uint8_t>(random());
+
+			// 大きさやレベル数に効くように、小さい値と0も多めに入れる
+			if (random() % 2) value &= 0x0f;
+			bytes.GetData()[random() % limit] = value;
+		}
+
+		try
+		{
+			DdsFile file(bytes.GetData(), bytes.size);
+			size_t end = 0;
+			Check(Validate(file, sink, end), "accepted a corrupted file whose surfaces are not contiguous", paths[index]);
+			Check(end <= bytes.size, "accepted a corrupted file whose surfaces run past the end", paths[index]);
+			accepted++;
+		}
+		catch (const std::runtime_error&)
+		{
+			rejected++;
+		}
+	}
+	std::printf("corrupted copies: %d rejected, %d accepted and consistent (sink %llu)\n",
+		rejected, accepted, static_cast<unsigned long long>(sink & 0xff));
+
+	if (g_failures > 0)
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}
@@ -0,0 +1,184 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// FramePacerの待ち方を、手で進める時計（ManualClock）で確認するテスト
+//
+// Usage: FramePacerTest
+//        BasicFramePacer<ManualClock>で、眠りから起きるのが遅れる時間（オーバーシュート）を
+//        ManualClockで与えながらフレームを進め、次のことを確認します。
+//          ・Foregroundのスピンの時間（マージン）がオーバーシュートに合わせて広がり、
+//            オーバーシュートが無くなると下限まで縮む。マージンが足りていれば遅れずに起きる
+//          ・BackgroundとSuspendedはスピンせず、遅れはそのままジッターとして記録される
+//          ・１フレーム以上遅れたフレームの後は、遅れを取り戻そうとせず今から数え直す
+//        時計は実際には待たないので一瞬で終わります。失敗した項目を表示して1を返します。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:FramePacerTest.exe Tools\FramePacerTest\Main.cpp winmm.lib
+//          g++ -std=c++14 -O2 -o FramePacerTest Tools/FramePacerTest/Main.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../FramePacer.h"
+
+#include <cstdio>
+
+using namespace DX;
+
+namespace
+{
+	typedef BasicFramePacer<ManualClock> Pacer;
+
+	// 時計の周波数（StepTimerのティックと同じ）
+	const uint64_t FREQUENCY = StepTimer::TicksPerSecond;
+
+	// 1ミリ秒と1マイクロ秒
+	const uint64_t MILLISECOND = FREQUENCY / 1000;
+	const uint64_t MICROSECOND = FREQUENCY / 1000000;
+
+	// 1フレームの処理の時間
+	const uint64_t WORK_TIME = 5 * MILLISECOND;
+
+	// マージンの下限（FramePacerの初期値と同じ0.5ミリ秒）
+	const uint64_t MIN_SLEEP_MARGIN = FREQUENCY / 2000;
+
+	// 失敗した数
+	int g_failures = 0;
+
+	void Check(bool condition, const char* message, int line)
+	{
+		if (condition) return;
+		if (g_failures < 20) std::printf("FAILED: %s (line %d)\n", message, line);
+		g_failures++;
+	}
+
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+	// 1フレーム分の処理をして待つ
+	void RunFrames(Pacer& pacer, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			pacer.GetClock().Advance(WORK_TIME);
+			pacer.WaitForNextFrame();
+		}
+	}
+
+	// マージンがオーバーシュートに合わせて広がり、縮む
+	void TestMarginConvergence()
+	{
+		const uint64_t overshoot = 3 * MILLISECOND;
+
+		Pacer pacer;
+		pacer.SetTargetFramesPerSecond(Pacer::Policy::Foreground, 60.0);
+		pacer.GetClock().SetSleepOvershoot(overshoot);
+
+		// 最初の待ちで初期値（2ミリ秒）を超える遅れが分かり、すぐに広がる
+		RunFrames(pacer, 2);
+		CHECK(pacer.GetSleepMarginTicks() > overshoot);
+
+		// 少しずつオーバーシュートまで縮み、それより小さくはならない
+		RunFrames(pacer, 300);
+		const uint64_t margin = pacer.GetSleepMarginTicks();
+		CHECK(margin >= overshoot && margin <= overshoot + overshoot / 20);
+
+		// マージンが足りていれば、起きる遅れはスピン１回分（1マイクロ秒）以下
+		FrameTimeStatistics jitter = pacer.GetWakeJitterStatistics();
+		CHECK(jitter.sampleCount == FrameTimeHistory::Capacity);
+		CHECK(jitter.p99Ticks <= MICROSECOND);
+		CHECK(pacer.GetMissedDeadlineCount() == 0);
+
+		// オーバーシュートが無くなると下限まで縮む
+		pacer.GetClock().SetSleepOvershoot(0);
+		RunFrames(pacer, 300);
+		CHECK(pacer.GetSleepMarginTicks() == MIN_SLEEP_MARGIN);
+
+		std::printf("margin: %.3f ms with %.3f ms overshoot, %.3f ms without, jitter p99 %.4f ms\n",
+			margin / static_cast<double>(MILLISECOND), overshoot / static_cast<double>(MILLISECOND),
+			pacer.GetSleepMarginTicks() / static_cast<double>(MILLISECOND), jitter.p99Ticks / static_cast<double>(MILLISECOND));
+	}
+
+	// BackgroundとSuspendedはスピンしない
+	void TestNoSpinInBackground()
+	{
+		const uint64_t overshoot = 2 * MILLISECOND;
+		const Pacer::Policy policies[] = { Pacer::Policy::Background, Pacer::Policy::Suspended };
+
+		for (Pacer::Policy policy : policies)
+		{
+			Pacer pacer;
+			pacer.SetPolicy(policy);
+			pacer.GetClock().SetSleepOvershoot(overshoot);
+
+			const uint64_t waits = pacer.GetWaitCount();
+			RunFrames(pacer, 100);
+
+			// 毎フレーム待ち、遅れはそのまま記録される
+			CHECK(pacer.GetClock().GetSpinCount() == 0);
+			CHECK(pacer.GetWaitCount() - waits == 99);
+			FrameTimeStatistics jitter = pacer.GetWakeJitterStatistics();
+			CHECK(jitter.p50Ticks == overshoot && jitter.p99Ticks == overshoot);
+
+			// フレームの間隔は目標のフレームレートに遅れを足したもの
+			const uint64_t period = static_cast<uint64_t>(FREQUENCY / pacer.GetTargetFramesPerSecond(policy));
+			const uint64_t start = pacer.GetClock().GetCounter();
+			RunFrames(pacer, 10);
+			const uint64_t interval = (pacer.GetClock().GetCounter() - start) / 10;
+			CHECK(interval >= period && interval <= period + overshoot);
+		}
+
+		// 比較のため、Foregroundはスピンする
+		Pacer pacer;
+		pacer.SetTargetFramesPerSecond(Pacer::Policy::Foreground, 60.0);
+		RunFrames(pacer, 10);
+		CHECK(pacer.GetClock().GetSpinCount() > 0);
+
+		std::printf("background/suspended: 0 spins, foreground: %llu spins in 10 frames\n",
+			static_cast<unsigned long long>(pacer.GetClock().GetSpinCount()));
+	}
+
+	// 長いフレームの後は今から数え直す
+	void TestReanchor()
+	{
+		Pacer pacer;
+		pacer.SetTargetFramesPerSecond(Pacer::Policy::Foreground, 60.0);
+		const uint64_t period = FREQUENCY / 60;
+		RunFrames(pacer, 10);
+
+		// 1秒かかったフレームは待たずに戻り、遅れとして数える
+		const uint64_t missed = pacer.GetMissedDeadlineCount();
+		const uint64_t waits = pacer.GetWaitCount();
+		pacer.GetClock().Advance(FREQUENCY);
+		pacer.WaitForNextFrame();
+		const uint64_t anchor = pacer.GetClock().GetCounter();
+		CHECK(pacer.GetMissedDeadlineCount() == missed + 1);
+		CHECK(pacer.GetWaitCount() == waits);
+
+		// 次のフレームからは遅れを取り戻そうとせず、１フレームずつ待つ
+		RunFrames(pacer, 1);
+		CHECK(pacer.GetWaitCount() == waits + 1);
+		CHECK(pacer.GetClock().GetCounter() - anchor >= period && pacer.GetClock().GetCounter() - anchor <= period + MICROSECOND);
+
+		RunFrames(pacer, 5);
+		CHECK(pacer.GetWaitCount() == waits + 6);
+		CHECK(pacer.GetMissedDeadlineCount() == missed + 1);
+		CHECK(pacer.GetClock().GetCounter() - anchor >= 6 * period && pacer.GetClock().GetCounter() - anchor <= 6 * period + MICROSECOND);
+
+		std::printf("re-anchor: 1 missed deadline after a 1 s frame, then %llu paced waits\n",
+			static_cast<unsigned long long>(pacer.GetWaitCount() - waits));
+	}
+}
+
+int main()
+{
+	TestMarginConvergence();
+	TestNoSpinInBackground();
+	TestReanchor();
+
+	if (g_failures > 0)
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}
@@ -0,0 +1,175 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// GlyphTableの文字の検索とLayoutGlyphsの速度を計るベンチマーク
+//
+// Usage: GlyphLayoutBench [--iterations <n>] [<font>]
+//        .spritefontファイル（既定は Resources/Font/SegoeUI_18.spritefont）を読み込み、
+//        デバッグ表示に近い文字列（約10,000文字）の全ての文字を次の方法で検索する時間と、
+//        LayoutGlyphsで並べる時間を計り、n回（既定は200回）の中央値を１文字あたりで表示します。
+//          binary search : SpriteFont::FindGlyphと同じ二分探索（以前のDebugFont）
+//          unordered_map : 文字コードをキーにしたハッシュ
+//          GlyphTable    : 直接参照の表（現在のDebugFont）
+//        全ての方法で同じ文字が見つかることを確認し、違えば1を返します。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:GlyphLayoutBench.exe Tools\GlyphLayoutBench\Main.cpp ImaseLib\SpriteFontFile.cpp ImaseLib\GlyphLayout.cpp ImaseLib\MappedFile.cpp ImaseLib\Utf8.cpp
+//          g++ -std=c++14 -O2 -o GlyphLayoutBench Tools/GlyphLayoutBench/Main.cpp ImaseLib/SpriteFontFile.cpp ImaseLib/GlyphLayout.cpp ImaseLib/MappedFile.cpp ImaseLib/Utf8.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/SpriteFontFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 既定のフォント
+	const char* const DEFAULT_FONT = "Resources/Font/SegoeUI_18.spritefont";
+
+	// 計る文字列を作るために繰り返す行の数
+	const int TEXT_LINES = 200;
+
+	// 時間を計る（n回の中央値、ミリ秒）
+	template <class F>
+	double Measure(int iterations, F&& function)
+	{
+		std::vector<double> times;
+		for (int i = 0; i < iterations; i++)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			function();
+			times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		std::sort(times.begin(), times.end());
+		return times[times.size() / 2];
+	}
+
+	std::wstring Widen(const std::string& text)
+	{
+		return std::wstring(text.begin(), text.end());
+	}
+
+	// SpriteFont::FindGlyphと同じ二分探索（見つからなければ既定の文字）
+	const GlyphMetrics* BinarySearch(const GlyphMetrics* glyphs, size_t count, uint32_t character, const GlyphMetrics* defaultGlyph)
+	{
+		const GlyphMetrics* it = std::lower_bound(glyphs, glyphs + count, character,
+			[](const GlyphMetrics& glyph, uint32_t value) { return glyph.character < value; });
+		return it != glyphs + count && it->character == character ? it : defaultGlyph;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int iterations = 200;
+	std::string fontPath = DEFAULT_FONT;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+		{
+			iterations = std::atoi(argv[++i]);
+		}
+		else if (argv[i][0] != '-' && i == argc - 1)
+		{
+			fontPath = argv[i];
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: GlyphLayoutBench [--iterations <n>] [<font>]\n");
+			return 1;
+		}
+	}
+
+	try
+	{
+		SpriteFontFile font(Widen(fontPath).c_str());
+		const GlyphTable& table = font.GetGlyphTable();
+		const GlyphMetrics* glyphs = font.GetGlyphs();
+		const size_t glyphCount = font.GetGlyphCount();
+		const GlyphMetrics* defaultGlyph = table.Find(font.GetDefaultCharacter());
+
+		// フォントにない文字（既定の文字になる）も混ぜる
+		std::wstring text;
+		for (int i = 0; i < TEXT_LINES; i++)
+		{
+			text += L"FPS:60 Draws:12 States bound=34 skipped=56 Pos(1.25, -3.50, 7.75) あ\n";
+		}
+
+		std::unordered_map<uint32_t, const GlyphMetrics*> map;
+		for (size_t i = 0; i < glyphCount; i++)
+		{
+			map[glyphs[i].character] = &glyphs[i];
+		}
+
+		// 全ての方法で同じ文字が見つかるか
+		size_t mismatches = 0;
+		for (wchar_t c : text)
+		{
+			auto it = map.find(c);
+			const GlyphMetrics* expected = BinarySearch(glyphs, glyphCount, c, defaultGlyph);
+			if (table.Find(c) != expected || (it != map.end() ? it->second : defaultGlyph) != expected) mismatches++;
+		}
+
+		std::printf("%s: %zu glyphs, %zu characters, %d iterations\n", fontPath.c_str(), glyphCount, text.size(), iterations);
+		std::printf("%-14s %10s %10s\n", "method", "ms", "ns/char");
+
+		const double perCharacter = 1.0e6 / static_cast<double>(text.size());
+		volatile uintptr_t sink = 0;
+
+		double milliseconds = Measure(iterations, [&]()
+			{
+				uintptr_t sum = 0;
+				for (wchar_t c : text) sum += reinterpret_cast<uintptr_t>(BinarySearch(glyphs, glyphCount, c, defaultGlyph));
+				sink = sum;
+			});
+		std::printf("%-14s %10.4f %10.2f\n", "binary search", milliseconds, milliseconds * perCharacter);
+
+		milliseconds = Measure(iterations, [&]()
+			{
+				uintptr_t sum = 0;
+				for (wchar_t c : text)
+				{
+					auto it = map.find(c);
+					sum += reinterpret_cast<uintptr_t>(it != map.end() ? it->second : defaultGlyph);
+				}
+				sink = sum;
+			});
+		std::printf("%-14s %10.4f %10.2f\n", "unordered_map", milliseconds, milliseconds * perCharacter);
+
+		milliseconds = Measure(iterations, [&]()
+			{
+				uintptr_t sum = 0;
+				for (wchar_t c : text) sum += reinterpret_cast<uintptr_t>(table.Find(c));
+				sink = sum;
+			});
+		std::printf("%-14s %10.4f %10.2f%s\n", "GlyphTable", milliseconds, milliseconds * perCharacter, mismatches ? "  MISMATCH" : "");
+
+		// 並べる時間（確保済みの配列を再利用する）
+		std::vector<GlyphQuad> quads;
+		float textSize[2] = {};
+		milliseconds = Measure(iterations, [&]()
+			{
+				quads.clear();
+				LayoutGlyphs(table, text.c_str(), font.GetLineSpacing(), quads, textSize);
+			});
+		std::printf("%-14s %10.4f %10.2f  (%zu quads, %.0fx%.0f pixels)\n", "LayoutGlyphs", milliseconds, milliseconds * perCharacter,
+			quads.size(), textSize[0], textSize[1]);
+
+		return mismatches ? 1 : 0;
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "%s: %s\n", fontPath.c_str(), e.what());
+		return 1;
+	}
+}
@@ -0,0 +1,407 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// 文字の並べ方と頂点への展開、並べた結果のキャッシュ、視錐台カリングのテスト
+//
+// Usage: GlyphLayoutTest
+//        手で作った文字の情報で次のことを確認します。
+//          ・LayoutGlyphsがSpriteFontと同じ規則で並べる（xOffsetとxAdvanceによる詰め、
+//            行頭で左にはみ出さない、改行、\rと空白、フォントにない文字と既定の文字、大きさ）
+//          ・ExpandGlyphQuadsの４頂点が右方向と上方向に沿って並び、Yが反転し、
+//            originが文字列の中心の時は中心がpositionに来る。UVはinverseTextureSizeを掛けたもの
+//          ・TextLayoutCacheが同じ文字列で保存した結果を返し、容量を超えると一番長く
+//            使われていない結果を捨ててそのメモリを次の結果に使う。ハッシュ値が同じでも
+//            文字列が違えば並べ直す（FNV-1aで同じ値になる文字列を使う）
+//          ・IsSphereInFrustumが左右上下、近、遠の各平面のすぐ内側の球を残し、すぐ外側の球を省く
+//        失敗した項目を表示して1を返します。D3Dを使わないのでLinuxでビルド・実行できます。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:GlyphLayoutTest.exe Tools\GlyphLayoutTest\Main.cpp ImaseLib\GlyphLayout.cpp ImaseLib\TextLayoutCache.cpp ImaseLib\Frustum.cpp
+//          g++ -std=c++14 -O2 -o GlyphLayoutTest Tools/GlyphLayoutTest/Main.cpp ImaseLib/GlyphLayout.cpp ImaseLib/TextLayoutCache.cpp ImaseLib/Frustum.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/GlyphLayout.h"
+#include "../../ImaseLib/TextLayoutCache.h"
+#include "../../ImaseLib/Frustum.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cwchar>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 座標の許容誤差
+	const float TOLERANCE = 1e-4f;
+
+	// 行の高さ
+	const float LINE_SPACING = 24.0f;
+
+	// テスト用の文字（文字コード、テクスチャ内の矩形、xOffset、yOffset、xAdvance）
+	const GlyphMetrics GLYPHS[] =
+	{
+		{ L' ', { 22, 0, 23, 1 }, 0.0f, 0.0f, 5.0f },		// 空白（1×1は描画しない）
+		{ L'?', { 30, 0, 38, 18 }, 0.0f, 4.0f, 2.0f },		// 既定の文字に使う
+		{ L'A', { 0, 0, 10, 20 }, 1.0f, 2.0f, 1.0f },		// 幅10、送り11
+		{ L'V', { 10, 0, 22, 20 }, -3.0f, 2.0f, 0.0f },		// 前の文字に3ピクセル詰める
+		{ 0x1F600, { 40, 0, 60, 20 }, 0.0f, 0.0f, 0.0f },	// BMPの外（ハッシュで検索する）
+	};
+
+	// ハッシュ値（FNV-1a）が同じになる２つの文字列（BMPの文字だけなのでwchar_tが16bitでも32bitでも同じ）
+	const wchar_t COLLIDING_TEXT_A[] = { 0x68df, 0x7a91, 0x7e36, 0x8521, 0x4e00, 0 };
+	const wchar_t COLLIDING_TEXT_B[] = { 0x7858, 0x64b7, 0x63db, 0x4fe9, 0xbf68, 0 };
+
+	// 失敗した数
+	int g_failures = 0;
+
+	void Check(bool condition, const char* message, int line)
+	{
+		if (condition) return;
+		if (g_failures < 20) std::printf("FAILED: %s (line %d)\n", message, line);
+		g_failures++;
+	}
+
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+	bool Near(float a, float b) { return std::fabs(a - b) <= TOLERANCE; }
+
+	// 四角形の文字列内の矩形を確認する
+	bool IsQuad(const GlyphQuad& quad, float left, float top, float right, float bottom)
+	{
+		return Near(quad.position[0], left) && Near(quad.position[1], top)
+			&& Near(quad.position[2], right) && Near(quad.position[3], bottom);
+	}
+
+	// 文字列を並べる
+	std::vector<GlyphQuad> Layout(const GlyphTable& table, const wchar_t* text, float size[2])
+	{
+		std::vector<GlyphQuad> quads;
+		LayoutGlyphs(table, text, LINE_SPACING, quads, size);
+		return quads;
+	}
+
+	// 文字の検索
+	void TestGlyphTable()
+	{
+		GlyphTable table;
+		table.Build(GLYPHS, sizeof(GLYPHS) / sizeof(GLYPHS[0]));
+
+		CHECK(table.GetCount() == 5);
+		CHECK(table.FindExact(L'A') == &GLYPHS[2]);
+		CHECK(table.FindExact(0x1F600) == &GLYPHS[4]);
+		CHECK(table.FindExact(L'B') == nullptr);
+		CHECK(table.FindExact(0x1F601) == nullptr);
+		CHECK(table.Find(L'B') == nullptr);
+
+		// 既定の文字はフォントにある文字だけ
+		table.SetDefaultCharacter(L'?');
+		CHECK(table.Find(L'B') == &GLYPHS[1]);
+		CHECK(table.Find(0x1F601) == &GLYPHS[1]);
+		table.SetDefaultCharacter(L'Z');
+		CHECK(table.Find(L'B') == nullptr);
+	}
+
+	// SpriteFontと同じ規則で並べる
+	void TestLayoutGlyphs()
+	{
+		GlyphTable table;
+		table.Build(GLYPHS, sizeof(GLYPHS) / sizeof(GLYPHS[0]));
+		float size[2];
+
+		// xOffsetだけ右にずらし、幅＋xAdvanceだけ進める。次の文字のxOffsetが負なら詰める
+		std::vector<GlyphQuad> quads = Layout(table, L"AV", size);
+		CHECK(quads.size() == 2);
+		CHECK(IsQuad(quads[0], 1.0f, 2.0f, 11.0f, 22.0f));
+		CHECK(IsQuad(quads[1], 9.0f, 2.0f, 21.0f, 22.0f));
+		CHECK(quads[1].subrect[0] == 10.0f && quads[1].subrect[1] == 0.0f && quads[1].subrect[2] == 22.0f && quads[1].subrect[3] == 20.0f);
+
+		// 高さは行の高さと文字の下端の大きい方
+		CHECK(Near(size[0], 21.0f) && Near(size[1], LINE_SPACING));
+
+		// 行頭で左にはみ出す文字は0に揃える
+		quads = Layout(table, L"VA", size);
+		CHECK(IsQuad(quads[0], 0.0f, 2.0f, 12.0f, 22.0f));
+		CHECK(IsQuad(quads[1], 13.0f, 2.0f, 23.0f, 22.0f));
+
+		// 改行で左端に戻り行の高さだけ下がる。\rは無視する
+		quads = Layout(table, L"AV\r\nA", size);
+		CHECK(quads.size() == 3);
+		CHECK(IsQuad(quads[2], 1.0f, 2.0f + LINE_SPACING, 11.0f, 22.0f + LINE_SPACING));
+		CHECK(Near(size[0], 21.0f) && Near(size[1], 2.0f * LINE_SPACING));
+
+		// 空白は描画しないが送りは進める
+		quads = Layout(table, L"A A", size);
+		CHECK(quads.size() == 2);
+		CHECK(IsQuad(quads[1], 19.0f, 2.0f, 29.0f, 22.0f));
+		CHECK(Near(size[0], 29.0f));
+
+		// 空白だけの文字列は大きさ0
+		quads = Layout(table, L"  ", size);
+		CHECK(quads.empty() && size[0] == 0.0f && size[1] == 0.0f);
+
+		// 既定の文字がなければフォントにない文字は飛ばす（送りも進めない）
+		quads = Layout(table, L"ABA", size);
+		CHECK(quads.size() == 2);
+		CHECK(IsQuad(quads[1], 13.0f, 2.0f, 23.0f, 22.0f));
+
+		// 既定の文字があればその文字で置き換える
+		table.SetDefaultCharacter(L'?');
+		quads = Layout(table, L"ABA", size);
+		CHECK(quads.size() == 3);
+		CHECK(IsQuad(quads[1], 12.0f, 4.0f, 20.0f, 22.0f));
+		CHECK(quads[1].subrect[0] == 30.0f && quads[1].subrect[3] == 18.0f);
+		CHECK(IsQuad(quads[2], 23.0f, 2.0f, 33.0f, 22.0f));
+
+		// 並べた結果は末尾に追加する
+		std::vector<GlyphQuad> appended(1);
+		LayoutGlyphs(table, L"A", LINE_SPACING, appended, size);
+		CHECK(appended.size() == 2 && IsQuad(appended[1], 1.0f, 2.0f, 11.0f, 22.0f));
+	}
+
+	// 四角形を頂点に展開する
+	void TestExpandGlyphQuads()
+	{
+		GlyphTable table;
+		table.Build(GLYPHS, sizeof(GLYPHS) / sizeof(GLYPHS[0]));
+		float size[2];
+		std::vector<GlyphQuad> quads = Layout(table, L"VA", size);
+
+		// 斜めを向いた右方向と上方向
+		const float position[3] = { 5.0f, 6.0f, 7.0f };
+		const float right[3] = { 0.6f, 0.0f, -0.8f };
+		const float up[3] = { 0.0f, 1.0f, 0.0f };
+		const float scale = 0.5f;
+		const float origin[2] = { size[0] * 0.5f, size[1] * 0.5f };
+		const float color[4] = { 0.1f, 0.2f, 0.3f, 0.4f };
+		const float inverseTextureSize[2] = { 1.0f / 64.0f, 1.0f / 32.0f };
+
+		std::vector<BillboardVertex> vertices(quads.size() * 4);
+		ExpandGlyphQuads(quads.data(), quads.size(), position, right, up, scale, origin, color, inverseTextureSize, vertices.data());
+
+		for (size_t i = 0; i < quads.size(); i++)
+		{
+			const GlyphQuad& quad = quads[i];
+
+			// 左上、右上、右下、左下。画面のYは下向きなので上の辺ほど上方向に大きい
+			const float x[4] = { quad.position[0], quad.position[2], quad.position[2], quad.position[0] };
+			const float y[4] = { quad.position[1], quad.position[1], quad.position[3], quad.position[3] };
+			const float u[4] = { quad.subrect[0], quad.subrect[2], quad.subrect[2], quad.subrect[0] };
+			const float v[4] = { quad.subrect[1], quad.subrect[1], quad.subrect[3], quad.subrect[3] };
+
+			for (int j = 0; j < 4; j++)
+			{
+				const BillboardVertex& vertex = vertices[i * 4 + j];
+				float alongRight = (x[j] - origin[0]) * scale;
+				float alongUp = (origin[1] - y[j]) * scale;
+				for (int k = 0; k < 3; k++)
+				{
+					CHECK(Near(vertex.position[k], position[k] + right[k] * alongRight + up[k] * alongUp));
+				}
+				CHECK(vertex.color[0] == color[0] && vertex.color[1] == color[1] && vertex.color[2] == color[2] && vertex.color[3] == color[3]);
+				CHECK(Near(vertex.textureCoordinate[0], u[j] / 64.0f) && Near(vertex.textureCoordinate[1], v[j] / 32.0f));
+			}
+		}
+
+		// 最初の文字の左上：左端0、上端2の点は中心(11.5, 12)から左に11.5、上に10
+		const BillboardVertex& topLeft = vertices[0];
+		CHECK(Near(topLeft.position[0], 5.0f - 0.6f * 5.75f) && Near(topLeft.position[1], 6.0f + 5.0f) && Near(topLeft.position[2], 7.0f + 0.8f * 5.75f));
+
+		// 上方向の辺は左上から左下に向かって下がる
+		CHECK(vertices[0].position[1] > vertices[3].position[1] && Near(vertices[0].position[1] - vertices[3].position[1], 20.0f * scale));
+
+		// 文字列の中心はpositionに来る
+		float minimum[2] = { 1e9f, 1e9f };
+		float maximum[2] = { -1e9f, -1e9f };
+		for (const BillboardVertex& vertex : vertices)
+		{
+			float alongRight = (vertex.position[0] - position[0]) * right[0] + (vertex.position[2] - position[2]) * right[2];
+			float alongUp = vertex.position[1] - position[1];
+			minimum[0] = std::fmin(minimum[0], alongRight);
+			maximum[0] = std::fmax(maximum[0], alongRight);
+			minimum[1] = std::fmin(minimum[1], alongUp);
+			maximum[1] = std::fmax(maximum[1], alongUp);
+		}
+		CHECK(Near(minimum[0], -maximum[0]));
+		CHECK(Near(maximum[0] - minimum[0], size[0] * scale));
+	}
+
+	// 並べた結果が直接並べたものと同じか
+	bool IsSameLayout(const TextLayout& layout, const GlyphTable& table, float lineSpacing, const wchar_t* text)
+	{
+		std::vector<GlyphQuad> quads;
+		float size[2];
+		LayoutGlyphs(table, text, lineSpacing, quads, size);
+		if (quads.size() != layout.quads.size() || size[0] != layout.size[0] || size[1] != layout.size[1]) return false;
+		for (size_t i = 0; i < quads.size(); i++)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				if (quads[i].position[j] != layout.quads[i].position[j] || quads[i].subrect[j] != layout.quads[i].subrect[j]) return false;
+			}
+		}
+		return true;
+	}
+
+	// 並べた結果のキャッシュ
+	void TestTextLayoutCache()
+	{
+		GlyphTable table;
+		table.Build(GLYPHS, sizeof(GLYPHS) / sizeof(GLYPHS[0]));
+
+		// 同じ文字列は並べ直さずに同じ結果を返す（文字列のアドレスではなく内容で比べる）
+		{
+			TextLayoutCache cache(4);
+			const TextLayout* first = &cache.Get(table, LINE_SPACING, L"AVA", 3);
+			CHECK(IsSameLayout(*first, table, LINE_SPACING, L"AVA"));
+
+			wchar_t copy[] = L"AVA";
+			for (int i = 0; i < 10; i++)
+			{
+				CHECK(&cache.Get(table, LINE_SPACING, copy, 3) == first);
+			}
+			CHECK(cache.GetHitCount() == 10 && cache.GetMissCount() == 1 && cache.GetSize() == 1);
+
+			// 長さ、行の高さ、テーブルのどれかが違えば別の結果
+			CHECK(IsSameLayout(cache.Get(table, LINE_SPACING, L"AVA", 2), table, LINE_SPACING, L"AV"));
+			CHECK(IsSameLayout(cache.Get(table, LINE_SPACING * 2.0f, L"A\nA", 3), table, LINE_SPACING * 2.0f, L"A\nA"));
+			GlyphTable other;
+			other.Build(GLYPHS, sizeof(GLYPHS) / sizeof(GLYPHS[0]));
+			cache.Get(other, LINE_SPACING, L"AVA", 3);
+			CHECK(cache.GetMissCount() == 4 && cache.GetSize() == 4);
+		}
+
+		// 容量を超えると一番長く使われていない結果を捨て、そのメモリを使う
+		{
+			TextLayoutCache cache(2);
+			cache.Get(table, LINE_SPACING, L"AAAA", 4);
+			const TextLayout* evicted = &cache.Get(table, LINE_SPACING, L"VVVV", 4);
+			const GlyphQuad* evictedQuads = evicted->quads.data();
+
+			// AAAAを使ったので一番古いのはVVVV
+			cache.Get(table, LINE_SPACING, L"AAAA", 4);
+			const TextLayout* added = &cache.Get(table, LINE_SPACING, L"VA", 2);
+			CHECK(cache.GetEvictionCount() == 1 && cache.GetSize() == 2);
+			CHECK(added == evicted);
+			CHECK(added->quads.data() == evictedQuads);
+			CHECK(IsSameLayout(*added, table, LINE_SPACING, L"VA"));
+
+			// 残ったAAAAは使え、捨てたVVVVは並べ直す
+			uint64_t misses = cache.GetMissCount();
+			cache.Get(table, LINE_SPACING, L"AAAA", 4);
+			CHECK(cache.GetMissCount() == misses);
+			CHECK(IsSameLayout(cache.Get(table, LINE_SPACING, L"VVVV", 4), table, LINE_SPACING, L"VVVV"));
+			CHECK(cache.GetMissCount() == misses + 1 && cache.GetEvictionCount() == 2);
+		}
+
+		// ハッシュ値が同じでも文字列が違えば並べ直す
+		{
+			// 文字ごとに幅を変えて、並べた結果で区別できるようにする
+			std::vector<GlyphMetrics> glyphs;
+			for (size_t i = 0; i < 5; i++)
+			{
+				glyphs.push_back({ static_cast<uint32_t>(COLLIDING_TEXT_A[i]), { 0, 0, static_cast<int32_t>(i + 1), 10 }, 0.0f, 0.0f, 1.0f });
+				glyphs.push_back({ static_cast<uint32_t>(COLLIDING_TEXT_B[i]), { 0, 0, static_cast<int32_t>(i + 11), 10 }, 0.0f, 0.0f, 1.0f });
+			}
+			GlyphTable collidingTable;
+			collidingTable.Build(glyphs.data(), glyphs.size());
+
+			TextLayoutCache cache(4);
+			size_t length = std::wcslen(COLLIDING_TEXT_A);
+			CHECK(IsSameLayout(cache.Get(collidingTable, LINE_SPACING, COLLIDING_TEXT_A, length), collidingTable, LINE_SPACING, COLLIDING_TEXT_A));
+			CHECK(IsSameLayout(cache.Get(collidingTable, LINE_SPACING, COLLIDING_TEXT_B, length), collidingTable, LINE_SPACING, COLLIDING_TEXT_B));
+			CHECK(cache.GetHitCount() == 0 && cache.GetMissCount() == 2);
+
+			// 同じハッシュ値の結果は置き換えるので、最初の文字列も並べ直す
+			CHECK(cache.GetSize() == 1);
+			CHECK(IsSameLayout(cache.Get(collidingTable, LINE_SPACING, COLLIDING_TEXT_A, length), collidingTable, LINE_SPACING, COLLIDING_TEXT_A));
+			CHECK(cache.GetHitCount() == 0 && cache.GetMissCount() == 3);
+		}
+	}
+
+	// 右手系の透視射影（XMMatrixPerspectiveFovRHと同じ、行ベクトル）
+	void CreatePerspective(float fovY, float aspect, float nearZ, float farZ, float m[16])
+	{
+		float yScale = 1.0f / std::tan(fovY * 0.5f);
+		float xScale = yScale / aspect;
+		float range = farZ / (nearZ - farZ);
+		for (int i = 0; i < 16; i++) m[i] = 0.0f;
+		m[0] = xScale;
+		m[5] = yScale;
+		m[10] = range;
+		m[11] = -1.0f;
+		m[14] = range * nearZ;
+	}
+
+	// 視錐台カリング
+	void TestFrustum()
+	{
+		// カメラは原点から-Z方向を向く（ビュー行列は単位行列）
+		const float fovY = 1.0f;
+		const float aspect = 16.0f / 9.0f;
+		const float nearZ = 0.5f;
+		const float farZ = 100.0f;
+		float viewProjection[16];
+		CreatePerspective(fovY, aspect, nearZ, farZ, viewProjection);
+
+		float planes[FRUSTUM_PLANE_COUNT][4];
+		ExtractFrustumPlanes(viewProjection, planes);
+
+		const float radius = 1.0f;
+		const float epsilon = 0.01f;
+
+		// 中央
+		const float inside[3] = { 0.0f, 0.0f, -10.0f };
+		CHECK(IsSphereInFrustum(planes, inside, radius));
+
+		// 左右と上下：深さdでの端から、平面までの距離がちょうど半径になる位置
+		const float depth = 20.0f;
+		const float halfHeight = std::tan(fovY * 0.5f);
+		const float halfWidth = halfHeight * aspect;
+		const float sideLimit = depth * halfWidth + radius * std::sqrt(1.0f + halfWidth * halfWidth);
+		const float topLimit = depth * halfHeight + radius * std::sqrt(1.0f + halfHeight * halfHeight);
+		for (float sign : { 1.0f, -1.0f })
+		{
+			const float sideIn[3] = { sign * (sideLimit - epsilon), 0.0f, -depth };
+			const float sideOut[3] = { sign * (sideLimit + epsilon), 0.0f, -depth };
+			CHECK(IsSphereInFrustum(planes, sideIn, radius));
+			CHECK(!IsSphereInFrustum(planes, sideOut, radius));
+
+			const float topIn[3] = { 0.0f, sign * (topLimit - epsilon), -depth };
+			const float topOut[3] = { 0.0f, sign * (topLimit + epsilon), -depth };
+			CHECK(IsSphereInFrustum(planes, topIn, radius));
+			CHECK(!IsSphereInFrustum(planes, topOut, radius));
+		}
+
+		// 近い平面：カメラの後ろでも半径の分は残す
+		const float nearIn[3] = { 0.0f, 0.0f, -nearZ + radius - epsilon };
+		const float nearOut[3] = { 0.0f, 0.0f, -nearZ + radius + epsilon };
+		CHECK(IsSphereInFrustum(planes, nearIn, radius));
+		CHECK(!IsSphereInFrustum(planes, nearOut, radius));
+
+		// 遠い平面
+		const float farIn[3] = { 0.0f, 0.0f, -farZ - radius + 0.05f };
+		const float farOut[3] = { 0.0f, 0.0f, -farZ - radius - 0.05f };
+		CHECK(IsSphereInFrustum(planes, farIn, radius));
+		CHECK(!IsSphereInFrustum(planes, farOut, radius));
+	}
+}
+
+int main()
+{
+	TestGlyphTable();
+	TestLayoutGlyphs();
+	TestExpandGlyphQuads();
+	TestTextLayoutCache();
+	TestFrustum();
+
+	if (g_failures > 0)
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}
@@ -0,0 +1,364 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// JobSystemのスレッド数ごとの速度を計るベンチマーク
+//
+// Usage: JobSystemBench [--entities <n>] [--frames <n>] [--max-threads <n>] [--grain <n>] [--trace <file>]
+//        ゲームの更新処理を模した処理を、スレッドの数を1から順に増やして実行します。
+//        1フレームは次のジョブの依存関係で、メインスレッドは最後のジョブをWait関数で待ちます。
+//          AI（目標に向かう速度を求める） → 移動 → カリングとアニメーション（並列） → 集計
+//        各段階はParallelForで分け、段階の間はAddDependencyとThen関数でつなぎます。
+//        スレッドの数ごとにフレーム時間の中央値、1スレッドとの速度比、効率、
+//        1フレームあたりのジョブと盗んだジョブの数を表示します。
+//        JobSystemを使わずに同じ処理を実行した時間（serial）も表示し、
+//        全ての結果がserialと一致することを確認します。
+//        既定はentitiesが200000、framesが60、max-threadsがCPUのスレッド数です。
+//        --traceを指定すると、最後（max-threads）の計測の全フレームをTraceCaptureで
+//        Chrome Trace Event形式のJSONに書き出します（各段階のジョブが区間として記録されます）。
+//        --traceを指定しない時はCPUプロファイラの記録を無効にして計測します。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:JobSystemBench.exe Tools\JobSystemBench\Main.cpp ImaseLib\JobSystem.cpp ImaseLib\ThreadPool.cpp ImaseLib\CpuProfiler.cpp ImaseLib\CpuFeatures.cpp ImaseLib\TraceCapture.cpp ImaseLib\Utf8.cpp
+//          g++ -std=c++14 -O2 -pthread -o JobSystemBench Tools/JobSystemBench/Main.cpp ImaseLib/JobSystem.cpp ImaseLib/ThreadPool.cpp ImaseLib/CpuProfiler.cpp ImaseLib/CpuFeatures.cpp ImaseLib/TraceCapture.cpp ImaseLib/Utf8.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/JobSystem.h"
+#include "../../ImaseLib/TraceCapture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 1フレームの時間（秒）
+	const float DELTA_TIME = 1.0f / 60.0f;
+
+	// 世界の広さ（この範囲で跳ね返る）
+	const float WORLD_SIZE = 100.0f;
+
+	// AIで目標を探す時に見る近くのエンティティの数
+	const size_t NEIGHBOR_COUNT = 16;
+
+	// アニメーションの骨の数
+	const int BONE_COUNT = 8;
+
+	// 設定
+	struct Options
+	{
+		size_t entities = 200000;
+		int frames = 60;
+		uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+		size_t grain = 0;
+		const char* tracePath = nullptr;
+	};
+
+	// 更新するエンティティ（SoA）
+	struct World
+	{
+		std::vector<float> x, y, z;
+		std::vector<float> vx, vy, vz;
+		std::vector<float> phase;
+		std::vector<float> pose;
+		std::vector<uint8_t> visible;
+
+		// フレームごとの集計
+		size_t visibleCount = 0;
+		double poseSum = 0.0;
+	};
+
+	// 初期状態を作る
+	World CreateWorld(size_t count)
+	{
+		World world;
+		world.x.resize(count);
+		world.y.resize(count);
+		world.z.resize(count);
+		world.vx.assign(count, 0.0f);
+		world.vy.assign(count, 0.0f);
+		world.vz.assign(count, 0.0f);
+		world.phase.resize(count);
+		world.pose.assign(count, 0.0f);
+		world.visible.assign(count, 0);
+
+		uint32_t random = 12345;
+		auto next = [&random]()
+		{
+			random = random * 1664525u + 1013904223u;
+			return (random >> 8) / static_cast<float>(1 << 24);
+		};
+		for (size_t i = 0; i < count; i++)
+		{
+			world.x[i] = (next() - 0.5f) * WORLD_SIZE;
+			world.y[i] = (next() - 0.5f) * WORLD_SIZE;
+			world.z[i] = (next() - 0.5f) * WORLD_SIZE;
+			world.phase[i] = next() * 6.2831853f;
+		}
+		return world;
+	}
+
+	// AI：近くのエンティティの重心に向かう速度を求める（前のフレームの位置だけを読む）
+	void UpdateAI(World& world, size_t begin, size_t end)
+	{
+		size_t count = world.x.size();
+		for (size_t i = begin; i < end; i++)
+		{
+			float cx = 0.0f, cy = 0.0f, cz = 0.0f;
+			for (size_t k = 1; k <= NEIGHBOR_COUNT; k++)
+			{
+				size_t j = (i + k * 7919) % count;
+				cx += world.x[j];
+				cy += world.y[j];
+				cz += world.z[j];
+			}
+			float dx = cx / NEIGHBOR_COUNT - world.x[i];
+			float dy = cy / NEIGHBOR_COUNT - world.y[i];
+			float dz = cz / NEIGHBOR_COUNT - world.z[i];
+			float length = std::sqrt(dx * dx + dy * dy + dz * dz) + 1e-3f;
+			world.vx[i] = world.vx[i] * 0.9f + dx / length;
+			world.vy[i] = world.vy[i] * 0.9f + dy / length;
+			world.vz[i] = world.vz[i] * 0.9f + dz / length;
+		}
+	}
+
+	// 移動（範囲の外に出たら跳ね返る）
+	void UpdateMovement(World& world, size_t begin, size_t end)
+	{
+		float half = WORLD_SIZE * 0.5f;
+		for (size_t i = begin; i < end; i++)
+		{
+			world.x[i] += world.vx[i] * DELTA_TIME;
+			world.y[i] += world.vy[i] * DELTA_TIME;
+			world.z[i] += world.vz[i] * DELTA_TIME;
+			if (std::fabs(world.x[i]) > half) world.vx[i] = -world.vx[i];
+			if (std::fabs(world.y[i]) > half) world.vy[i] = -world.vy[i];
+			if (std::fabs(world.z[i]) > half) world.vz[i] = -world.vz[i];
+		}
+	}
+
+	// カリング（原点から-Z方向を向いた視錐台に入っているか）
+	void UpdateCulling(World& world, size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			float depth = -world.z[i];
+			world.visible[i] = depth > 0.1f && std::fabs(world.x[i]) < depth && std::fabs(world.y[i]) < depth * 0.5625f;
+		}
+	}
+
+	// アニメーション（骨ごとの角度を合成する）
+	void UpdateAnimation(World& world, size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			float phase = world.phase[i] += DELTA_TIME;
+			float pose = 0.0f;
+			for (int bone = 0; bone < BONE_COUNT; bone++)
+			{
+				pose += std::sin(phase * (bone + 1)) * std::cos(phase + bone);
+			}
+			world.pose[i] = pose;
+		}
+	}
+
+	// 集計
+	void Gather(World& world)
+	{
+		size_t visible = 0;
+		double poseSum = 0.0;
+		for (size_t i = 0; i < world.x.size(); i++)
+		{
+			visible += world.visible[i];
+			poseSum += world.pose[i];
+		}
+		world.visibleCount = visible;
+		world.poseSum = poseSum;
+	}
+
+	// JobSystemを使わずに1フレームを更新する
+	void UpdateSerial(World& world)
+	{
+		size_t count = world.x.size();
+		UpdateAI(world, 0, count);
+		UpdateMovement(world, 0, count);
+		UpdateCulling(world, 0, count);
+		UpdateAnimation(world, 0, count);
+		Gather(world);
+	}
+
+	// JobSystemで1フレームを更新する
+	void UpdateJobs(World& world, JobSystem& jobs, size_t grain)
+	{
+		size_t count = world.x.size();
+		JobHandle ai = jobs.CreateParallelFor(0, count, grain, [&world](size_t begin, size_t end)
+			{
+				CpuProfileScope scope(L"AI");
+				UpdateAI(world, begin, end);
+			});
+		JobHandle movement = jobs.CreateParallelFor(0, count, grain, [&world](size_t begin, size_t end)
+			{
+				CpuProfileScope scope(L"Movement");
+				UpdateMovement(world, begin, end);
+			});
+		JobHandle culling = jobs.CreateParallelFor(0, count, grain, [&world](size_t begin, size_t end)
+			{
+				CpuProfileScope scope(L"Culling");
+				UpdateCulling(world, begin, end);
+			});
+		JobHandle animation = jobs.CreateParallelFor(0, count, grain, [&world](size_t begin, size_t end)
+			{
+				CpuProfileScope scope(L"Animation");
+				UpdateAnimation(world, begin, end);
+			});
+
+		// AI → 移動 → カリングとアニメーション（アニメーションは位置を使わないので移動と並べてもよいが、段階の例として）
+		jobs.AddDependency(movement, ai);
+		jobs.AddDependency(culling, movement);
+		jobs.AddDependency(animation, movement);
+
+		JobHandle gather = jobs.Create([&world]()
+			{
+				CpuProfileScope scope(L"Gather");
+				Gather(world);
+			});
+		jobs.AddDependency(gather, culling);
+		jobs.AddDependency(gather, animation);
+
+		jobs.Run(gather);
+		jobs.Run(animation);
+		jobs.Run(culling);
+		jobs.Run(movement);
+		jobs.Run(ai);
+		jobs.Wait(gather);
+	}
+
+	// 結果が同じか
+	bool IsSame(const World& a, const World& b)
+	{
+		return a.x == b.x && a.y == b.y && a.z == b.z && a.pose == b.pose && a.visible == b.visible
+			&& a.visibleCount == b.visibleCount && a.poseSum == b.poseSum;
+	}
+
+	// 中央値
+	double GetMedian(std::vector<double> values)
+	{
+		std::sort(values.begin(), values.end());
+		return values[values.size() / 2];
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	for (int i = 1; i < argc; i++)
+	{
+		if (i + 1 >= argc)
+		{
+			std::fprintf(stderr, "Invalid option: %s\n", argv[i]);
+			return 1;
+		}
+
+		long value = std::atol(argv[i + 1]);
+		if (std::strcmp(argv[i], "--trace") == 0) options.tracePath = argv[i + 1];
+		else if (std::strcmp(argv[i], "--entities") == 0 && value > 0) options.entities = static_cast<size_t>(value);
+		else if (std::strcmp(argv[i], "--frames") == 0 && value > 0) options.frames = static_cast<int>(value);
+		else if (std::strcmp(argv[i], "--max-threads") == 0 && value > 0) options.maxThreads = static_cast<uint32_t>(value);
+		else if (std::strcmp(argv[i], "--grain") == 0 && value > 0) options.grain = static_cast<size_t>(value);
+		else
+		{
+			std::fprintf(stderr,
+				"Usage: JobSystemBench [--entities <n>] [--frames <n>] [--max-threads <n>] [--grain <n>] [--trace <file>]\n");
+			return 1;
+		}
+		i++;
+	}
+
+	std::printf("%zu entities, %d frames, %u hardware threads\n", options.entities, options.frames, std::thread::hardware_concurrency());
+
+	// トレースを出力しない時は区間の記録の分だけ遅くならないようにする
+	CpuProfiler::SetThreadName(L"Main");
+	CpuProfiler::SetEnabled(options.tracePath != nullptr);
+	TraceCapture trace;
+
+	// JobSystemを使わない場合
+	World reference = CreateWorld(options.entities);
+	std::vector<double> times;
+	for (int frame = 0; frame < options.frames; frame++)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		UpdateSerial(reference);
+		times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+	}
+	double serial = GetMedian(times);
+	std::printf("serial   %8.3f ms\n", serial);
+
+	std::printf("threads  frame ms  speedup  efficiency  jobs/frame  steals/frame\n");
+	double single = 0.0;
+	int result = 0;
+	for (uint32_t threads = 1; threads <= options.maxThreads; threads++)
+	{
+		World world = CreateWorld(options.entities);
+		JobSystem jobs(threads - 1);
+
+		// 最後の計測をトレースに記録する
+		if (options.tracePath && threads == options.maxThreads)
+		{
+			if (!trace.Start(options.tracePath, nullptr, static_cast<uint32_t>(options.frames)))
+			{
+				std::fprintf(stderr, "Cannot open %s\n", options.tracePath);
+				return 1;
+			}
+		}
+
+		times.clear();
+		uint64_t stolen = 0;
+		for (int frame = 0; frame < options.frames; frame++)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			{
+				CpuProfileScope scope(L"Frame");
+				UpdateJobs(world, jobs, options.grain);
+			}
+			times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+			CpuProfiler::EndFrame();
+			if (trace.IsCapturing())
+			{
+				trace.SetCounter("Frame ms", times.back());
+				trace.SetCounter("Steals", static_cast<double>(jobs.GetStolenCount() - stolen));
+				trace.EndFrame();
+			}
+			stolen = jobs.GetStolenCount();
+		}
+
+		double median = GetMedian(times);
+		if (threads == 1) single = median;
+		std::printf("%7u  %8.3f  %7.2f  %9.0f%%  %10.1f  %12.1f%s\n", threads, median, single / median,
+			single / median / threads * 100.0, static_cast<double>(jobs.GetExecutedCount()) / options.frames,
+			static_cast<double>(jobs.GetStolenCount()) / options.frames, IsSame(world, reference) ? "" : "  MISMATCH");
+		if (!IsSame(world, reference)) result = 1;
+	}
+
+	if (options.tracePath)
+	{
+		trace.Wait();
+		if (trace.HasError())
+		{
+			std::fprintf(stderr, "Failed to write %s\n", options.tracePath);
+			return 1;
+		}
+		std::printf("trace: %s (%d frames, %llu zones dropped)\n", options.tracePath, options.frames,
+			static_cast<unsigned long long>(CpuProfiler::GetDroppedZoneCount()));
+	}
+
+	return result;
+}
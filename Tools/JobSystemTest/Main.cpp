@@ -0,0 +1,199 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// JobSystemの使い方を一通り繰り返して結果を確かめるストレステスト
+//
+// Usage: JobSystemTest [--rounds <n>] [<worker count>...]
+//        ワーカースレッドの数（既定は0、1、3、7）ごとにJobSystemを作り直しながら、
+//        次の処理をn回（既定は20回）繰り返し、結果が正しいことを確かめます。
+//          ・ParallelFor（分けない場合と細かく分ける場合）
+//          ・AddDependencyでつないだひし形の依存関係と、Then関数の継続
+//          ・ジョブの中から呼ぶParallelForと、親子のジョブ
+//          ・ジョブが投げた例外をWait関数で受け取る
+//          ・JobSystemを作ったスレッド以外からのRun関数とWait関数
+//          ・１つのキューに入りきらない数（QUEUE_CAPACITYより多く）のジョブ
+//          ・待たずに破棄したジョブがデストラクタで実行される
+//        ThreadSanitizerを有効にしてビルドするとキューのメモリオーダーの誤りも検出できます。
+//        失敗した項目を表示して1を返します。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:JobSystemTest.exe Tools\JobSystemTest\Main.cpp ImaseLib\JobSystem.cpp ImaseLib\ThreadPool.cpp ImaseLib\CpuProfiler.cpp ImaseLib\CpuFeatures.cpp
+//          g++ -std=c++14 -O2 -pthread -o JobSystemTest Tools/JobSystemTest/Main.cpp ImaseLib/JobSystem.cpp ImaseLib/ThreadPool.cpp ImaseLib/CpuProfiler.cpp ImaseLib/CpuFeatures.cpp
+//          g++ -std=c++14 -O1 -g -fsanitize=thread -o JobSystemTest （ファイルは同じ）
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/JobSystem.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 既定の繰り返し回数とワーカースレッドの数
+	const int DEFAULT_ROUNDS = 20;
+	const uint32_t DEFAULT_WORKER_COUNTS[] = { 0, 1, 3, 7 };
+
+	// ParallelForの範囲
+	const size_t RANGE_SIZE = 100000;
+
+	// 入れ子のジョブの数と、その中のParallelForの範囲
+	const int NESTED_JOB_COUNT = 50;
+	const size_t NESTED_RANGE_SIZE = 1000;
+
+	// 失敗した数
+	int g_failures = 0;
+
+	void Check(bool condition, const char* message, uint32_t workerCount, int round)
+	{
+		if (condition) return;
+		if (g_failures < 20) std::printf("FAILED: %s (%u workers, round %d)\n", message, workerCount, round);
+		g_failures++;
+	}
+
+	// 1回分のテスト
+	void RunRound(uint32_t workerCount, int round)
+	{
+		std::atomic<int> drained(0);
+		{
+			JobSystem jobSystem(workerCount);
+
+			// ParallelFor（分けない場合と細かく分ける場合）
+			std::vector<int> values(RANGE_SIZE, 0);
+			jobSystem.ParallelFor(0, values.size(), values.size(), [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++) values[i]++;
+				});
+			jobSystem.ParallelFor(0, values.size(), 7, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++) values[i]++;
+				});
+			bool allTwo = true;
+			for (int value : values) allTwo = allTwo && value == 2;
+			Check(allTwo, "ParallelFor visits every index once", workerCount, round);
+
+			// ひし形の依存関係（a → b, c → d）と継続（逆の順にRunしても順番が守られる）
+			std::atomic<int> step(0);
+			int order[4] = {};
+			JobHandle a = jobSystem.Create([&]() { order[0] = step++; });
+			JobHandle b = jobSystem.Create([&]() { order[1] = step++; });
+			JobHandle c = jobSystem.Create([&]() { order[2] = step++; });
+			JobHandle d = jobSystem.Create([&]() { order[3] = step++; });
+			jobSystem.AddDependency(b, a);
+			jobSystem.AddDependency(c, a);
+			jobSystem.AddDependency(d, b);
+			jobSystem.AddDependency(d, c);
+			jobSystem.Run(d);
+			jobSystem.Run(c);
+			jobSystem.Run(b);
+			jobSystem.Run(a);
+			int stepInContinuation = -1;
+			JobHandle continuation = jobSystem.Then(d, [&]() { stepInContinuation = step; });
+			jobSystem.Wait(continuation);
+			Check(order[0] == 0 && order[3] == 3 && stepInContinuation == 4, "dependencies and continuations run in order", workerCount, round);
+
+			// ジョブの中から呼ぶParallelForと、親子のジョブ
+			std::atomic<size_t> total(0);
+			JobHandle root = jobSystem.Create([]() {});
+			for (int i = 0; i < NESTED_JOB_COUNT; i++)
+			{
+				jobSystem.Run(jobSystem.Create([&]()
+					{
+						jobSystem.ParallelFor(0, NESTED_RANGE_SIZE, 10, [&](size_t begin, size_t end) { total += end - begin; });
+					}, root));
+			}
+			jobSystem.Run(root);
+			jobSystem.Wait(root);
+			Check(total == NESTED_JOB_COUNT * NESTED_RANGE_SIZE, "a parent waits for nested children", workerCount, round);
+
+			// ジョブが投げた例外
+			bool caught = false;
+			try
+			{
+				jobSystem.ParallelFor(0, 100, 1, [](size_t begin, size_t) { if (begin == 37) throw std::runtime_error("job failed"); });
+			}
+			catch (const std::runtime_error&)
+			{
+				caught = true;
+			}
+			Check(caught, "an exception in a job is rethrown by Wait", workerCount, round);
+
+			// 作ったスレッド以外から実行して待つ
+			std::atomic<int> foreign(0);
+			std::thread thread([&]()
+				{
+					JobHandle job = jobSystem.Create([&]() { foreign++; });
+					jobSystem.Run(job);
+					jobSystem.Wait(job);
+				});
+			thread.join();
+			Check(foreign == 1, "a foreign thread can run and wait", workerCount, round);
+
+			// １つのキューに入りきらない数のジョブ
+			const int manyCount = static_cast<int>(JobSystem::QUEUE_CAPACITY) * 2 + 1;
+			std::atomic<int> many(0);
+			JobHandle manyRoot = jobSystem.Create([]() {});
+			for (int i = 0; i < manyCount; i++)
+			{
+				jobSystem.Run(jobSystem.Create([&]() { many++; }, manyRoot));
+			}
+			jobSystem.Run(manyRoot);
+			jobSystem.Wait(manyRoot);
+			Check(many == manyCount, "more jobs than one queue holds all run", workerCount, round);
+
+			// 待たずに破棄する
+			jobSystem.Run(jobSystem.Create([&]() { drained++; }));
+		}
+		Check(drained == 1, "the destructor runs queued jobs", workerCount, round);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int rounds = DEFAULT_ROUNDS;
+	std::vector<uint32_t> workerCounts;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--rounds") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+		{
+			rounds = std::atoi(argv[++i]);
+		}
+		else if (argv[i][0] >= '0' && argv[i][0] <= '9')
+		{
+			workerCounts.push_back(static_cast<uint32_t>(std::atoi(argv[i])));
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: JobSystemTest [--rounds <n>] [<worker count>...]\n");
+			return 1;
+		}
+	}
+	if (workerCounts.empty())
+	{
+		workerCounts.assign(std::begin(DEFAULT_WORKER_COUNTS), std::end(DEFAULT_WORKER_COUNTS));
+	}
+
+	for (uint32_t workerCount : workerCounts)
+	{
+		for (int round = 0; round < rounds; round++)
+		{
+			RunRound(workerCount, round);
+		}
+		std::printf("%u workers: %d rounds\n", workerCount, rounds);
+	}
+
+	if (g_failures > 0)
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}
@@ -0,0 +1,480 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// SDKMESHファイルの頂点とインデックスの並びを最適化するコマンドラインツール
+//
+// Usage: MeshOptimizer [--dry-run] <file.sdkmesh>...
+//        同じ内容の頂点をまとめ、頂点キャッシュとオーバードローのために三角形を並べ替え、
+//        頂点を使われる順に並べ替えてファイルを上書きします。
+//        ファイルごとに最適化前後のACMRとATVRを表示します（--dry-runは表示のみ）。
+//        書き出す前に、読み直して三角形の内容が変わっていないことを確認します。
+//        対応していない構成（複数の頂点ストリーム、三角形リスト以外など）のファイルはそのままです。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:MeshOptimizer.exe Tools\MeshOptimizer\*.cpp ImaseLib\SdkMeshFile.cpp ImaseLib\MappedFile.cpp
+//          g++ -std=c++14 -O2 -o MeshOptimizer Tools/MeshOptimizer/*.cpp ImaseLib/SdkMeshFile.cpp ImaseLib/MappedFile.cpp ImaseLib/Utf8.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "MeshOptimizer.h"
+#include "../../ImaseLib/SdkMeshFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// オーバードローの並べ替えで許容するACMRの悪化の割合
+	const float OVERDRAW_THRESHOLD = 1.05f;
+
+	// 書き出すバッファの境界
+	const size_t BUFFER_ALIGNMENT = 16;
+
+	// 三角形リスト
+	const uint32_t PRIMITIVE_TRIANGLE_LIST = 0;
+
+	// 最適化した１つのメッシュ
+	struct OptimizedMesh
+	{
+		uint32_t vertexBuffer;
+		uint32_t indexBuffer;
+
+		std::vector<uint8_t> vertices;
+		size_t vertexCount;
+		std::vector<uint32_t> indices;
+
+		// サブセットの番号と新しい描画範囲
+		std::vector<uint32_t> subsets;
+		std::vector<uint64_t> indexStarts;
+		std::vector<uint64_t> indexCounts;
+
+		// 最適化前後の統計
+		size_t triangleCount;
+		size_t vertexCountBefore;
+		VertexCacheStatistics before;
+		VertexCacheStatistics after;
+	};
+
+	// ファイルを読み込む
+	std::vector<uint8_t> ReadFile(const char* fileName)
+	{
+		std::ifstream file(fileName, std::ios::binary);
+		if (!file) throw std::runtime_error("Failed to open file.");
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	// ファイルを書き出す
+	void WriteFile(const char* fileName, const std::vector<uint8_t>& data)
+	{
+		std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!file) throw std::runtime_error("Failed to write file.");
+	}
+
+	// 構造体をバイト列の指定位置に書き込む
+	template <class T>
+	void WriteAt(std::vector<uint8_t>& data, uint64_t offset, const T& value)
+	{
+		std::memcpy(data.data() + offset, &value, sizeof(T));
+	}
+
+	// インデックスバッファを32bitのインデックスとして読み込む
+	std::vector<uint32_t> LoadIndices(const SdkMeshFile& mesh, uint32_t indexBuffer)
+	{
+		const SdkMeshIndexBufferHeader& header = mesh.GetIndexBuffers()[indexBuffer];
+		const uint8_t* data = mesh.GetIndexData(indexBuffer).data;
+
+		std::vector<uint32_t> indices(static_cast<size_t>(header.numIndices));
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			if (header.indexType == SDKMESH_INDEX_16)
+			{
+				uint16_t index;
+				std::memcpy(&index, data + i * 2, 2);
+				indices[i] = index;
+			}
+			else
+			{
+				std::memcpy(&indices[i], data + i * 4, 4);
+			}
+		}
+		return indices;
+	}
+
+	// 頂点の位置（float3）の要素の位置を探す（なければ -1）
+	int FindPositionOffset(const SdkMeshVertexBufferHeader& header)
+	{
+		for (const SdkMeshVertexElement& element : header.decl)
+		{
+			if (element.stream == SDKMESH_DECL_END_STREAM) break;
+			if (element.usage == SDKMESH_DECLUSAGE_POSITION && element.usageIndex == 0 && element.type == SDKMESH_DECLTYPE_FLOAT3)
+			{
+				return element.offset;
+			}
+		}
+		return -1;
+	}
+
+	// 三角形の頂点の内容（比較用、先頭が最小になるように回転して向きは保つ）
+	std::vector<uint8_t> GetTriangleKey(const uint8_t* vertices, size_t stride, const uint32_t* triangle)
+	{
+		const uint8_t* v[3] = { vertices + triangle[0] * stride, vertices + triangle[1] * stride, vertices + triangle[2] * stride };
+
+		int first = 0;
+		for (int k = 1; k < 3; k++)
+		{
+			if (std::memcmp(v[k], v[first], stride) < 0) first = k;
+		}
+
+		std::vector<uint8_t> key;
+		key.reserve(stride * 3);
+		for (int k = 0; k < 3; k++)
+		{
+			const uint8_t* vertex = v[(first + k) % 3];
+			key.insert(key.end(), vertex, vertex + stride);
+		}
+		return key;
+	}
+
+	// 三角形の内容を並べ替えて取り出す（退化した三角形は除く）
+	std::vector<std::vector<uint8_t>> GetTriangleSet(const uint8_t* vertices, size_t stride, const uint32_t* indices, size_t indexCount)
+	{
+		std::vector<std::vector<uint8_t>> triangles;
+		for (size_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			const uint32_t* t = indices + i;
+			if (t[0] == t[1] || t[1] == t[2] || t[2] == t[0]) continue;
+			triangles.push_back(GetTriangleKey(vertices, stride, t));
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	// メッシュを最適化する（対応していない構成なら false を返す）
+	bool OptimizeMesh(const SdkMeshFile& file, uint32_t meshIndex, OptimizedMesh& result, std::string& reason)
+	{
+		const SdkMeshMesh& mesh = file.GetMeshes()[meshIndex];
+		if (mesh.numVertexBuffers != 1)
+		{
+			reason = "multiple vertex streams";
+			return false;
+		}
+
+		result.vertexBuffer = mesh.vertexBuffers[0];
+		result.indexBuffer = mesh.indexBuffer;
+
+		const SdkMeshVertexBufferHeader& vertexHeader = file.GetVertexBuffers()[result.vertexBuffer];
+		const size_t stride = static_cast<size_t>(vertexHeader.strideBytes);
+		const size_t vertexCount = static_cast<size_t>(vertexHeader.numVertices);
+		const uint8_t* vertices = file.GetVertexData(result.vertexBuffer).data;
+
+		// サブセットはインデックスの順に並べ、重なっていないこと
+		const uint32_t* subsets = file.GetMeshSubsets(meshIndex);
+		result.subsets.assign(subsets, subsets + mesh.numSubsets);
+		std::sort(result.subsets.begin(), result.subsets.end(), [&](uint32_t a, uint32_t b)
+			{
+				return file.GetSubsets()[a].indexStart < file.GetSubsets()[b].indexStart;
+			});
+
+		uint64_t previousEnd = 0;
+		for (uint32_t index : result.subsets)
+		{
+			const SdkMeshSubset& subset = file.GetSubsets()[index];
+			if (subset.primitiveType != PRIMITIVE_TRIANGLE_LIST || subset.vertexStart != 0
+				|| subset.indexCount % 3 != 0 || subset.indexStart < previousEnd)
+			{
+				reason = "unsupported subset layout";
+				return false;
+			}
+			previousEnd = subset.indexStart + subset.indexCount;
+		}
+
+		std::vector<uint32_t> indices = LoadIndices(file, result.indexBuffer);
+		for (uint32_t index : indices)
+		{
+			if (index >= vertexCount)
+			{
+				reason = "index out of range";
+				return false;
+			}
+		}
+
+		// 最適化前の統計（描画されるサブセットの範囲だけを順に数える）
+		std::vector<uint32_t> drawn;
+		for (uint32_t index : result.subsets)
+		{
+			const SdkMeshSubset& subset = file.GetSubsets()[index];
+			drawn.insert(drawn.end(), indices.begin() + subset.indexStart, indices.begin() + subset.indexStart + subset.indexCount);
+		}
+		result.vertexCountBefore = vertexCount;
+		result.before = AnalyzeVertexCache(drawn.data(), drawn.size(), vertexCount);
+
+		// 同じ内容の頂点をまとめる
+		std::vector<uint32_t> remap(vertexCount);
+		size_t weldedCount = WeldVertices(remap.data(), vertices, vertexCount, stride);
+
+		std::vector<uint8_t> welded(weldedCount * stride);
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			std::memcpy(&welded[remap[i] * stride], vertices + i * stride, stride);
+		}
+
+		// サブセットごとに三角形を並べ替える
+		const int positionOffset = FindPositionOffset(vertexHeader);
+		std::vector<uint32_t> optimized;
+		for (uint32_t index : result.subsets)
+		{
+			const SdkMeshSubset& subset = file.GetSubsets()[index];
+
+			// まとめた頂点の番号に置き換え、退化した三角形は除く
+			std::vector<uint32_t> subsetIndices;
+			for (uint64_t i = subset.indexStart; i < subset.indexStart + subset.indexCount; i += 3)
+			{
+				uint32_t t[3] = { remap[indices[i]], remap[indices[i + 1]], remap[indices[i + 2]] };
+				if (t[0] == t[1] || t[1] == t[2] || t[2] == t[0]) continue;
+				subsetIndices.insert(subsetIndices.end(), t, t + 3);
+			}
+
+			std::vector<uint32_t> ordered(subsetIndices.size());
+			OptimizeVertexCache(ordered.data(), subsetIndices.data(), subsetIndices.size(), weldedCount);
+
+			if (positionOffset >= 0)
+			{
+				OptimizeOverdraw(ordered.data(), ordered.data(), ordered.size(),
+					welded.data() + positionOffset, stride, weldedCount, OVERDRAW_THRESHOLD);
+			}
+
+			// 元の並びよりミスが増えるなら元の並びを使う（既に最適化されているファイルもあり、
+			// 何度実行しても悪くならないようにする）
+			if (AnalyzeVertexCache(subsetIndices.data(), subsetIndices.size(), weldedCount).misses
+				<= AnalyzeVertexCache(ordered.data(), ordered.size(), weldedCount).misses)
+			{
+				ordered = subsetIndices;
+			}
+
+			result.indexStarts.push_back(optimized.size());
+			result.indexCounts.push_back(ordered.size());
+			optimized.insert(optimized.end(), ordered.begin(), ordered.end());
+		}
+
+		// 頂点を使われる順に並べ替える
+		std::vector<uint32_t> fetchRemap(weldedCount);
+		result.vertexCount = OptimizeVertexFetch(fetchRemap.data(), optimized.data(), optimized.size(), weldedCount);
+
+		result.vertices.assign(result.vertexCount * stride, 0);
+		for (size_t i = 0; i < weldedCount; i++)
+		{
+			if (fetchRemap[i] < result.vertexCount)
+			{
+				std::memcpy(&result.vertices[fetchRemap[i] * stride], &welded[i * stride], stride);
+			}
+		}
+
+		result.indices.resize(optimized.size());
+		for (size_t i = 0; i < optimized.size(); i++)
+		{
+			result.indices[i] = fetchRemap[optimized[i]];
+		}
+
+		result.triangleCount = result.indices.size() / 3;
+		result.after = AnalyzeVertexCache(result.indices.data(), result.indices.size(), result.vertexCount);
+
+		// 三角形の内容が変わっていないか確認する
+		if (GetTriangleSet(vertices, stride, drawn.data(), drawn.size())
+			!= GetTriangleSet(result.vertices.data(), stride, result.indices.data(), result.indices.size()))
+		{
+			throw std::runtime_error("Optimized mesh does not match the source triangles.");
+		}
+
+		return true;
+	}
+
+	// バッファのデータを末尾に追加して位置を返す
+	uint64_t AppendBuffer(std::vector<uint8_t>& output, const uint8_t* data, size_t size)
+	{
+		while (output.size() % BUFFER_ALIGNMENT) output.push_back(0);
+
+		uint64_t offset = output.size();
+		output.insert(output.end(), data, data + size);
+		return offset;
+	}
+
+	// ファイルを最適化する
+	void ProcessFile(const char* fileName, bool dryRun)
+	{
+		std::vector<uint8_t> source = ReadFile(fileName);
+		SdkMeshFile file(source.data(), source.size());
+		const SdkMeshHeader& header = file.GetHeader();
+
+		// 頂点バッファとインデックスバッファを１つのメッシュだけが使っていること
+		std::vector<uint32_t> vertexBufferUsers(file.GetVertexBufferCount(), 0);
+		std::vector<uint32_t> indexBufferUsers(file.GetIndexBufferCount(), 0);
+		for (size_t i = 0; i < file.GetMeshCount(); i++)
+		{
+			const SdkMeshMesh& mesh = file.GetMeshes()[i];
+			for (uint32_t j = 0; j < mesh.numVertexBuffers; j++) vertexBufferUsers[mesh.vertexBuffers[j]]++;
+			indexBufferUsers[mesh.indexBuffer]++;
+		}
+
+		std::vector<OptimizedMesh> meshes;
+		for (uint32_t i = 0; i < file.GetMeshCount(); i++)
+		{
+			const SdkMeshMesh& mesh = file.GetMeshes()[i];
+			std::string reason;
+			if (vertexBufferUsers[mesh.vertexBuffers[0]] != 1 || indexBufferUsers[mesh.indexBuffer] != 1)
+			{
+				reason = "shared buffers";
+			}
+			else
+			{
+				meshes.emplace_back();
+				if (OptimizeMesh(file, i, meshes.back(), reason)) continue;
+				meshes.pop_back();
+			}
+
+			std::printf("%s: skipped (%s)\n", fileName, reason.c_str());
+			return;
+		}
+
+		// 統計の表示
+		size_t triangles = 0, verticesBefore = 0, verticesAfter = 0, missesBefore = 0, missesAfter = 0;
+		for (const OptimizedMesh& mesh : meshes)
+		{
+			triangles += mesh.triangleCount;
+			verticesBefore += mesh.vertexCountBefore;
+			verticesAfter += mesh.vertexCount;
+			missesBefore += mesh.before.misses;
+			missesAfter += mesh.after.misses;
+		}
+
+		auto ratio = [](size_t a, size_t b) { return b ? static_cast<float>(a) / static_cast<float>(b) : 0.0f; };
+		std::printf("%s: %zu tris, verts %zu -> %zu, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+			fileName, triangles, verticesBefore, verticesAfter,
+			ratio(missesBefore, triangles), ratio(missesAfter, triangles),
+			ratio(missesBefore, verticesBefore), ratio(missesAfter, verticesAfter));
+
+		if (dryRun) return;
+
+		// バッファ以外はそのまま使い、ヘッダーとサブセットの値だけ書き換える
+		const uint64_t bufferDataOffset = header.headerSize + header.nonBufferDataSize;
+		std::vector<uint8_t> output(source.begin(), source.begin() + static_cast<size_t>(bufferDataOffset));
+
+		for (uint32_t i = 0; i < file.GetVertexBufferCount(); i++)
+		{
+			SdkMeshVertexBufferHeader vertexHeader = file.GetVertexBuffers()[i];
+			auto it = std::find_if(meshes.begin(), meshes.end(), [&](const OptimizedMesh& m) { return m.vertexBuffer == i; });
+			if (it != meshes.end())
+			{
+				vertexHeader.numVertices = it->vertexCount;
+				vertexHeader.sizeBytes = it->vertices.size();
+				vertexHeader.dataOffset = AppendBuffer(output, it->vertices.data(), it->vertices.size());
+			}
+			else
+			{
+				SdkMeshBufferData data = file.GetVertexData(i);
+				vertexHeader.dataOffset = AppendBuffer(output, data.data, data.size);
+			}
+			WriteAt(output, header.vertexStreamHeadersOffset + i * sizeof(SdkMeshVertexBufferHeader), vertexHeader);
+		}
+
+		for (uint32_t i = 0; i < file.GetIndexBufferCount(); i++)
+		{
+			SdkMeshIndexBufferHeader indexHeader = file.GetIndexBuffers()[i];
+			auto it = std::find_if(meshes.begin(), meshes.end(), [&](const OptimizedMesh& m) { return m.indexBuffer == i; });
+			if (it != meshes.end())
+			{
+				std::vector<uint8_t> data;
+				for (uint32_t index : it->indices)
+				{
+					if (indexHeader.indexType == SDKMESH_INDEX_16)
+					{
+						uint16_t value = static_cast<uint16_t>(index);
+						data.insert(data.end(), reinterpret_cast<uint8_t*>(&value), reinterpret_cast<uint8_t*>(&value) + 2);
+					}
+					else
+					{
+						data.insert(data.end(), reinterpret_cast<uint8_t*>(&index), reinterpret_cast<uint8_t*>(&index) + 4);
+					}
+				}
+				indexHeader.numIndices = it->indices.size();
+				indexHeader.sizeBytes = data.size();
+				indexHeader.dataOffset = AppendBuffer(output, data.data(), data.size());
+			}
+			else
+			{
+				SdkMeshBufferData data = file.GetIndexData(i);
+				indexHeader.dataOffset = AppendBuffer(output, data.data, data.size);
+			}
+			WriteAt(output, header.indexStreamHeadersOffset + i * sizeof(SdkMeshIndexBufferHeader), indexHeader);
+		}
+
+		for (const OptimizedMesh& mesh : meshes)
+		{
+			for (size_t j = 0; j < mesh.subsets.size(); j++)
+			{
+				SdkMeshSubset subset = file.GetSubsets()[mesh.subsets[j]];
+				subset.indexStart = mesh.indexStarts[j];
+				subset.indexCount = mesh.indexCounts[j];
+				subset.vertexCount = mesh.vertexCount;
+				WriteAt(output, header.subsetDataOffset + mesh.subsets[j] * sizeof(SdkMeshSubset), subset);
+			}
+		}
+
+		SdkMeshHeader newHeader = header;
+		newHeader.bufferDataSize = output.size() - bufferDataOffset;
+		WriteAt(output, 0, newHeader);
+
+		// 書き出す前に読み直して確認する
+		SdkMeshFile check(output.data(), output.size());
+		(void)check;
+
+		WriteFile(fileName, output);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	bool dryRun = false;
+	std::vector<const char*> files;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--dry-run") == 0)
+		{
+			dryRun = true;
+		}
+		else
+		{
+			files.push_back(argv[i]);
+		}
+	}
+
+	if (files.empty())
+	{
+		std::fprintf(stderr, "Usage: MeshOptimizer [--dry-run] <file.sdkmesh>...\n");
+		return 1;
+	}
+
+	int result = 0;
+	for (const char* fileName : files)
+	{
+		try
+		{
+			ProcessFile(fileName, dryRun);
+		}
+		catch (const std::exception& e)
+		{
+			std::fprintf(stderr, "%s: %s\n", fileName, e.what());
+			result = 1;
+		}
+	}
+
+	return result;
+}
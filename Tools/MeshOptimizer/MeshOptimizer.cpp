@@ -0,0 +1,481 @@
+﻿//--------------------------------------------------------------------------------------
+// File: MeshOptimizer.cpp
+//
+// メッシュの頂点とインデックスの並びを最適化する関数群
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 番号がないことを表す値
+	const uint32_t INVALID_INDEX = 0xffffffff;
+
+	// Forsythの方法で使うキャッシュの大きさと点数の係数
+	const size_t FORSYTH_CACHE_SIZE = 32;
+	const float CACHE_DECAY_POWER = 1.5f;
+	const float LAST_TRIANGLE_SCORE = 0.75f;
+	const float VALENCE_BOOST_SCALE = 2.0f;
+	const float VALENCE_BOOST_POWER = 0.5f;
+
+	// 塊の並べ替えで使うFIFOキャッシュの大きさ
+	const size_t OVERDRAW_CACHE_SIZE = 16;
+
+	// FIFOの頂点キャッシュ（頂点ごとに入った時刻を覚えておく）
+	class FifoCache
+	{
+	private:
+
+		std::vector<uint32_t> m_time;
+		uint32_t m_now;
+		uint32_t m_size;
+
+	public:
+
+		FifoCache(size_t vertexCount, size_t cacheSize)
+			: m_time(vertexCount, 0)
+			, m_now(static_cast<uint32_t>(cacheSize) + 1)
+			, m_size(static_cast<uint32_t>(cacheSize))
+		{
+		}
+
+		// 頂点を参照してミスなら true を返す
+		bool Access(uint32_t vertex)
+		{
+			if (m_now - m_time[vertex] > m_size)
+			{
+				m_time[vertex] = m_now++;
+				return true;
+			}
+			return false;
+		}
+
+		// 三角形を参照してミスの数を返す
+		uint32_t AccessTriangle(const uint32_t* triangle)
+		{
+			return static_cast<uint32_t>(Access(triangle[0])) + Access(triangle[1]) + Access(triangle[2]);
+		}
+
+		// キャッシュを空にする
+		void Flush() { m_now += m_size + 1; }
+	};
+
+	// 頂点の点数（Forsythの方法）
+	float GetVertexScore(int cachePosition, uint32_t remainingTriangles)
+	{
+		if (remainingTriangles == 0) return -1.0f;
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			// 直前の三角形の頂点は少し下げて、同じ辺ばかり使わないようにする
+			if (cachePosition < 3)
+			{
+				score = LAST_TRIANGLE_SCORE;
+			}
+			else
+			{
+				float scale = 1.0f / static_cast<float>(FORSYTH_CACHE_SIZE - 3);
+				score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scale, CACHE_DECAY_POWER);
+			}
+		}
+
+		// 残りの三角形が少ない頂点を優先して、取り残される頂点を減らす
+		score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+
+		return score;
+	}
+
+	// 頂点の内容のハッシュ値
+	uint64_t HashVertex(const uint8_t* vertex, size_t stride)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < stride; i++)
+		{
+			hash ^= vertex[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// 頂点の位置を取得する
+	void GetPosition(const uint8_t* positions, size_t stride, uint32_t vertex, float position[3])
+	{
+		std::memcpy(position, positions + vertex * stride, sizeof(float) * 3);
+	}
+}
+
+// 頂点キャッシュのミス数を調べる関数
+VertexCacheStatistics Imase::AnalyzeVertexCache(
+	const uint32_t* indices,
+	size_t indexCount,
+	size_t vertexCount,
+	size_t cacheSize)
+{
+	FifoCache cache(vertexCount, cacheSize);
+
+	VertexCacheStatistics statistics = {};
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		statistics.misses += cache.AccessTriangle(indices + i);
+	}
+
+	size_t triangleCount = indexCount / 3;
+	statistics.acmr = triangleCount ? static_cast<float>(statistics.misses) / static_cast<float>(triangleCount) : 0.0f;
+	statistics.atvr = vertexCount ? static_cast<float>(statistics.misses) / static_cast<float>(vertexCount) : 0.0f;
+
+	return statistics;
+}
+
+// 同じ内容の頂点をまとめる関数
+size_t Imase::WeldVertices(
+	uint32_t* remap,
+	const uint8_t* vertices,
+	size_t vertexCount,
+	size_t vertexStride)
+{
+	// オープンアドレス法のハッシュテーブル（要素は元の頂点の番号）
+	size_t tableSize = 1;
+	while (tableSize < vertexCount * 2) tableSize *= 2;
+	std::vector<uint32_t> table(tableSize, INVALID_INDEX);
+
+	size_t uniqueCount = 0;
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		const uint8_t* vertex = vertices + i * vertexStride;
+		size_t slot = static_cast<size_t>(HashVertex(vertex, vertexStride)) & (tableSize - 1);
+
+		for (;;)
+		{
+			uint32_t other = table[slot];
+			if (other == INVALID_INDEX)
+			{
+				table[slot] = static_cast<uint32_t>(i);
+				remap[i] = static_cast<uint32_t>(uniqueCount++);
+				break;
+			}
+
+			if (std::memcmp(vertex, vertices + other * vertexStride, vertexStride) == 0)
+			{
+				remap[i] = remap[other];
+				break;
+			}
+
+			slot = (slot + 1) & (tableSize - 1);
+		}
+	}
+
+	return uniqueCount;
+}
+
+// 頂点キャッシュに当たりやすい順に三角形を並べ替える関数
+void Imase::OptimizeVertexCache(
+	uint32_t* destination,
+	const uint32_t* indices,
+	size_t indexCount,
+	size_t vertexCount)
+{
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0) return;
+
+	// 頂点ごとに使っている三角形の一覧を作る
+	std::vector<uint32_t> remaining(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+	{
+		remaining[indices[i]]++;
+	}
+
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		adjacencyOffsets[i + 1] = adjacencyOffsets[i] + remaining[i];
+	}
+
+	std::vector<uint32_t> adjacency(triangleCount * 3);
+	std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+	{
+		adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+	}
+
+	// 点数の初期値
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		vertexScore[i] = GetVertexScore(-1, remaining[i]);
+	}
+
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<char> emitted(triangleCount, 0);
+	for (size_t i = 0; i < triangleCount; i++)
+	{
+		const uint32_t* triangle = indices + i * 3;
+		triangleScore[i] = vertexScore[triangle[0]] + vertexScore[triangle[1]] + vertexScore[triangle[2]];
+	}
+
+	uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+	size_t cacheCount = 0;
+
+	uint32_t bestTriangle = static_cast<uint32_t>(
+		std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin());
+	size_t searchCursor = 0;
+
+	for (size_t output = 0; output < triangleCount; output++)
+	{
+		// キャッシュに関係する三角形がなければ、まだ出力していない先頭の三角形から再開する
+		if (bestTriangle == INVALID_INDEX)
+		{
+			while (emitted[searchCursor]) searchCursor++;
+			bestTriangle = static_cast<uint32_t>(searchCursor);
+		}
+
+		const uint32_t* triangle = indices + bestTriangle * 3;
+		std::copy(triangle, triangle + 3, destination + output * 3);
+		emitted[bestTriangle] = 1;
+
+		// 頂点の三角形の一覧から出力した三角形を外す
+		for (int k = 0; k < 3; k++)
+		{
+			uint32_t vertex = triangle[k];
+			uint32_t* begin = adjacency.data() + adjacencyOffsets[vertex];
+			uint32_t* end = begin + remaining[vertex];
+			uint32_t* found = std::find(begin, end, bestTriangle);
+			if (found != end)
+			{
+				*found = *(end - 1);
+				remaining[vertex]--;
+			}
+		}
+
+		// 出力した三角形の頂点をキャッシュの先頭に入れる
+		uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+		size_t newCount = 0;
+		for (int k = 0; k < 3; k++)
+		{
+			newCache[newCount++] = triangle[k];
+		}
+		for (size_t i = 0; i < cacheCount; i++)
+		{
+			uint32_t vertex = cache[i];
+			if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+			{
+				newCache[newCount++] = vertex;
+			}
+		}
+
+		// 追い出された頂点はキャッシュの外
+		for (size_t i = FORSYTH_CACHE_SIZE; i < newCount; i++)
+		{
+			cachePosition[newCache[i]] = -1;
+			vertexScore[newCache[i]] = GetVertexScore(-1, remaining[newCache[i]]);
+		}
+
+		cacheCount = std::min(newCount, FORSYTH_CACHE_SIZE);
+		std::copy(newCache, newCache + cacheCount, cache);
+
+		for (size_t i = 0; i < cacheCount; i++)
+		{
+			cachePosition[cache[i]] = static_cast<int>(i);
+			vertexScore[cache[i]] = GetVertexScore(static_cast<int>(i), remaining[cache[i]]);
+		}
+
+		// 点数が変わった頂点の三角形の点数を更新して、次の三角形を選ぶ
+		bestTriangle = INVALID_INDEX;
+		float bestScore = -1.0f;
+		for (size_t i = 0; i < newCount; i++)
+		{
+			uint32_t vertex = newCache[i];
+			const uint32_t* begin = adjacency.data() + adjacencyOffsets[vertex];
+			for (uint32_t j = 0; j < remaining[vertex]; j++)
+			{
+				uint32_t candidate = begin[j];
+				const uint32_t* t = indices + candidate * 3;
+				float score = vertexScore[t[0]] + vertexScore[t[1]] + vertexScore[t[2]];
+				triangleScore[candidate] = score;
+
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = candidate;
+				}
+			}
+		}
+	}
+}
+
+// 外側を向いた三角形の塊が先に描画されるように並べ替える関数
+void Imase::OptimizeOverdraw(
+	uint32_t* destination,
+	const uint32_t* indices,
+	size_t indexCount,
+	const uint8_t* positions,
+	size_t positionStride,
+	size_t vertexCount,
+	float threshold)
+{
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0) return;
+
+	// ３頂点ともミスする三角形でキャッシュが途切れるので、そこで大きな塊に分ける
+	std::vector<size_t> hardBoundaries;
+	{
+		FifoCache cache(vertexCount, OVERDRAW_CACHE_SIZE);
+		for (size_t i = 0; i < triangleCount; i++)
+		{
+			if (cache.AccessTriangle(indices + i * 3) == 3) hardBoundaries.push_back(i);
+		}
+	}
+	hardBoundaries.push_back(triangleCount);
+
+	// 大きな塊の中も、キャッシュを空にしてもACMRが許容範囲に収まる所で分ける
+	std::vector<size_t> clusters;
+	{
+		FifoCache cache(vertexCount, OVERDRAW_CACHE_SIZE);
+		for (size_t c = 0; c + 1 < hardBoundaries.size(); c++)
+		{
+			size_t start = hardBoundaries[c];
+			size_t end = hardBoundaries[c + 1];
+
+			cache.Flush();
+			size_t clusterMisses = 0;
+			for (size_t i = start; i < end; i++)
+			{
+				clusterMisses += cache.AccessTriangle(indices + i * 3);
+			}
+			float target = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+			clusters.push_back(start);
+			cache.Flush();
+			size_t misses = 0;
+			size_t softStart = start;
+			for (size_t i = start; i < end; i++)
+			{
+				misses += cache.AccessTriangle(indices + i * 3);
+				float acmr = static_cast<float>(misses) / static_cast<float>(i - softStart + 1);
+				if (acmr <= target && i + 1 < end)
+				{
+					clusters.push_back(i + 1);
+					cache.Flush();
+					misses = 0;
+					softStart = i + 1;
+				}
+			}
+		}
+	}
+	clusters.push_back(triangleCount);
+
+	// 塊ごとの重心と向き（面積で重み付け）
+	const size_t clusterCount = clusters.size() - 1;
+	std::vector<float> clusterData(clusterCount * 7, 0.0f);
+	float meshCentroid[3] = {};
+	float meshArea = 0.0f;
+
+	for (size_t c = 0; c < clusterCount; c++)
+	{
+		float* data = &clusterData[c * 7];
+		float area = 0.0f;
+		for (size_t i = clusters[c]; i < clusters[c + 1]; i++)
+		{
+			float p0[3], p1[3], p2[3];
+			GetPosition(positions, positionStride, indices[i * 3 + 0], p0);
+			GetPosition(positions, positionStride, indices[i * 3 + 1], p1);
+			GetPosition(positions, positionStride, indices[i * 3 + 2], p2);
+
+			float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			float normal[3] = {
+				e1[1] * e2[2] - e1[2] * e2[1],
+				e1[2] * e2[0] - e1[0] * e2[2],
+				e1[0] * e2[1] - e1[1] * e2[0] };
+			float triangleArea = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+			for (int k = 0; k < 3; k++)
+			{
+				data[k] += (p0[k] + p1[k] + p2[k]) / 3.0f * triangleArea;
+				data[3 + k] += normal[k];
+			}
+			area += triangleArea;
+		}
+
+		for (int k = 0; k < 3; k++)
+		{
+			meshCentroid[k] += data[k];
+			if (area > 0.0f) data[k] /= area;
+		}
+		meshArea += area;
+	}
+
+	if (meshArea > 0.0f)
+	{
+		for (int k = 0; k < 3; k++) meshCentroid[k] /= meshArea;
+	}
+
+	// メッシュの中心から外に向いている塊ほど先に描画する
+	std::vector<uint32_t> order(clusterCount);
+	for (size_t c = 0; c < clusterCount; c++)
+	{
+		float* data = &clusterData[c * 7];
+		float length = std::sqrt(data[3] * data[3] + data[4] * data[4] + data[5] * data[5]);
+		float key = 0.0f;
+		if (length > 0.0f)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				key += (data[k] - meshCentroid[k]) * data[3 + k] / length;
+			}
+		}
+		data[6] = key;
+		order[c] = static_cast<uint32_t>(c);
+	}
+
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+		{
+			return clusterData[a * 7 + 6] > clusterData[b * 7 + 6];
+		});
+
+	std::vector<uint32_t> result;
+	result.reserve(triangleCount * 3);
+	for (uint32_t c : order)
+	{
+		result.insert(result.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+	}
+
+	// ACMRが許容範囲を超えたら並べ替えない
+	float before = AnalyzeVertexCache(indices, triangleCount * 3, vertexCount, OVERDRAW_CACHE_SIZE).acmr;
+	float after = AnalyzeVertexCache(result.data(), result.size(), vertexCount, OVERDRAW_CACHE_SIZE).acmr;
+	if (after > before * threshold)
+	{
+		std::copy(indices, indices + triangleCount * 3, destination);
+		return;
+	}
+
+	std::copy(result.begin(), result.end(), destination);
+}
+
+// 頂点を使われる順に並べ替える番号を作る関数
+size_t Imase::OptimizeVertexFetch(
+	uint32_t* remap,
+	const uint32_t* indices,
+	size_t indexCount,
+	size_t vertexCount)
+{
+	std::fill(remap, remap + vertexCount, INVALID_INDEX);
+
+	uint32_t next = 0;
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		uint32_t& slot = remap[indices[i]];
+		if (slot == INVALID_INDEX) slot = next++;
+	}
+
+	return next;
+}
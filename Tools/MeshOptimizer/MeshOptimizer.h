@@ -0,0 +1,79 @@
+﻿//--------------------------------------------------------------------------------------
+// File: MeshOptimizer.h
+//
+// メッシュの頂点とインデックスの並びを最適化する関数群
+//
+// Usage: インデックスは三角形リスト（３つで１つの三角形）です。
+//        WeldVertices関数で同じ内容の頂点をまとめ、OptimizeVertexCache関数で
+//        頂点キャッシュに当たりやすい三角形の順番に並べ替えます。
+//        OptimizeOverdraw関数は頂点キャッシュの効率をあまり落とさない範囲で、
+//        外側を向いた三角形の塊が先に描画されるように並べ替えます。
+//        最後にOptimizeVertexFetch関数で頂点を使われる順に並べ替えてください。
+//        destinationとindicesに同じ配列は渡せません（OptimizeOverdraw関数は可）。
+//        AnalyzeVertexCache関数でACMR（三角形あたり）とATVR（頂点あたり）の
+//        頂点キャッシュのミス数を調べられます。
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Imase
+{
+	// 頂点キャッシュの統計
+	struct VertexCacheStatistics
+	{
+		// キャッシュのミス数（頂点シェーダーの実行回数）
+		size_t misses;
+
+		// 三角形あたりのミス数（Average Cache Miss Ratio）
+		float acmr;
+
+		// 頂点あたりのミス数（Average Transform to Vertex Ratio、1.0が最良）
+		float atvr;
+	};
+
+	// 頂点キャッシュのミス数を調べる関数（FIFOのキャッシュで計算する）
+	VertexCacheStatistics AnalyzeVertexCache(
+		const uint32_t* indices,
+		size_t indexCount,
+		size_t vertexCount,
+		size_t cacheSize = 16);
+
+	// 同じ内容の頂点をまとめる関数（remapに新しい頂点の番号を返し、頂点の数を返す）
+	size_t WeldVertices(
+		uint32_t* remap,
+		const uint8_t* vertices,
+		size_t vertexCount,
+		size_t vertexStride);
+
+	// 頂点キャッシュに当たりやすい順に三角形を並べ替える関数（Forsythの方法）
+	void OptimizeVertexCache(
+		uint32_t* destination,
+		const uint32_t* indices,
+		size_t indexCount,
+		size_t vertexCount);
+
+	// 外側を向いた三角形の塊が先に描画されるように並べ替える関数
+	//   indices   : OptimizeVertexCache関数で並べ替えたインデックス
+	//   positions : 頂点の位置（float3）の先頭
+	//   threshold : 許容するACMRの悪化の割合（1.05なら５％まで）
+	void OptimizeOverdraw(
+		uint32_t* destination,
+		const uint32_t* indices,
+		size_t indexCount,
+		const uint8_t* positions,
+		size_t positionStride,
+		size_t vertexCount,
+		float threshold);
+
+	// 頂点を使われる順に並べ替える番号を作る関数（remapに新しい番号を返し、使われている頂点の数を返す）
+	//   使われていない頂点の番号は 0xffffffff になります。
+	size_t OptimizeVertexFetch(
+		uint32_t* remap,
+		const uint32_t* indices,
+		size_t indexCount,
+		size_t vertexCount);
+}
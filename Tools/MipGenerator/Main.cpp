@@ -0,0 +1,801 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// DDSテクスチャのミップマップを作り直すコマンドラインツール
+//
+// Usage: MipGenerator [options] <file.dds | directory>...
+//          --filter box|kaiser         縮小のフィルター（既定はbox）
+//          --alpha-reference <n|none>  カバレッジを保つアルファテストの基準値（既定は200）
+//          --linear                    色をsRGBとして扱わない（法線マップなどのデータ用）
+//          --wrap                      端を繰り返す（タイル状に並べるテクスチャ用）
+//          --force                     全てのミップマップがそろったファイルも作り直す
+//          --threads <n>               スレッドの数（既定はCPUのスレッド数 - 1）
+//          --simd scalar|sse2|avx2     使う命令セットの上限（速度の比較用）
+//          --output <directory>        書き出すフォルダー（指定しなければ結果の表示だけ）
+//          --benchmark <n>             フィルターと命令セットの組み合わせごとにn回ずつ計測する
+//        フォルダーを指定すると、その中の全ての.ddsファイルを処理します。ファイルは
+//        スレッドプールで並列に処理し、結果は指定した順に表示します。
+//        元の形式はRGBA8、BGRA8、BGRX8（sRGBを含む）、R8、A8とBC1、BC3、BC4に対応し、
+//        最も詳細なミップマップから1x1までを作って同じ形式で書き出します（BCは展開してから
+//        縮小し、圧縮し直します）。配列の要素とキューブマップの面はそれぞれ作ります。
+//        R8、A8、BC4は既定でリニアとして扱います。アルファが全て255のテクスチャは
+//        カバレッジを保ちません。
+//        ファイルごとに、カバレッジの誤差（8x8以上のレベルの元の画像との差の平均と最大。
+//        ファイルに入っていたミップマップと作り直したミップマップ）と時間を表示します。
+//        書き出したファイルは読み直して確認します。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:MipGenerator.exe Tools\MipGenerator\Main.cpp ImaseLib\MipGenerator.cpp ImaseLib\BlockCompression.cpp ImaseLib\CpuFeatures.cpp ImaseLib\DdsFile.cpp ImaseLib\MappedFile.cpp ImaseLib\ThreadPool.cpp
+//          g++ -std=c++14 -O2 -pthread -o MipGenerator Tools/MipGenerator/Main.cpp ImaseLib/MipGenerator.cpp ImaseLib/BlockCompression.cpp ImaseLib/CpuFeatures.cpp ImaseLib/DdsFile.cpp ImaseLib/MappedFile.cpp ImaseLib/ThreadPool.cpp ImaseLib/Utf8.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/BlockCompression.h"
+#include "../../ImaseLib/DdsFile.h"
+#include "../../ImaseLib/MipGenerator.h"
+#include "../../ImaseLib/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+using namespace Imase;
+
+namespace
+{
+	// DXGI_FORMATの値
+	const uint32_t FORMAT_R8G8B8A8_UNORM = 28;
+	const uint32_t FORMAT_R8G8B8A8_UNORM_SRGB = 29;
+	const uint32_t FORMAT_R8_UNORM = 61;
+	const uint32_t FORMAT_A8_UNORM = 65;
+	const uint32_t FORMAT_BC1_UNORM = 71;
+	const uint32_t FORMAT_BC1_UNORM_SRGB = 72;
+	const uint32_t FORMAT_BC3_UNORM = 77;
+	const uint32_t FORMAT_BC3_UNORM_SRGB = 78;
+	const uint32_t FORMAT_BC4_UNORM = 80;
+	const uint32_t FORMAT_B8G8R8A8_UNORM = 87;
+	const uint32_t FORMAT_B8G8R8X8_UNORM = 88;
+	const uint32_t FORMAT_B8G8R8A8_UNORM_SRGB = 91;
+	const uint32_t FORMAT_B8G8R8X8_UNORM_SRGB = 93;
+
+	// DDSのヘッダーの値
+	const uint32_t DDS_MAGIC = 0x20534444;
+	const uint32_t DDS_FOURCC_DX10 = 0x30315844;
+	const uint32_t DDS_HEADER_FLAGS = 0x00001007;		// CAPS | HEIGHT | WIDTH | PIXELFORMAT
+	const uint32_t DDS_HEADER_FLAGS_PITCH = 0x00000008;
+	const uint32_t DDS_HEADER_FLAGS_MIPMAP = 0x00020000;
+	const uint32_t DDS_HEADER_FLAGS_LINEARSIZE = 0x00080000;
+	const uint32_t DDS_PF_FOURCC = 0x00000004;
+	const uint32_t DDS_CAPS_COMPLEX = 0x00000008;
+	const uint32_t DDS_CAPS_TEXTURE = 0x00001000;
+	const uint32_t DDS_CAPS_MIPMAP = 0x00400000;
+	const uint32_t DDS_CAPS2_CUBEMAP_ALLFACES = 0x0000fe00;
+	const uint32_t DDS_MISC_TEXTURECUBE = 0x00000004;
+	const uint32_t DDS_CUBEMAP_FACES = 6;
+
+	// 既定のアルファテストの基準値（BillboardBatchのAlphaTestEffectと同じ）
+	const int DEFAULT_ALPHA_REFERENCE = 200;
+
+	// カバレッジの誤差を数える最も小さいレベルの幅と高さ（これより小さいと割合を表せない）
+	const uint32_t MIN_COVERAGE_SIZE = 8;
+
+	// 設定
+	struct Options
+	{
+		MipOptions mip;
+		bool linear = false;
+		bool force = false;
+		uint32_t threads = ThreadPool::GetDefaultThreadCount();
+		std::string output;
+		int benchmark = 0;
+	};
+
+	// RGBA8に変換したサーフェス
+	struct Image
+	{
+		uint32_t width;
+		uint32_t height;
+		std::vector<uint8_t> rgba;
+	};
+
+	// ファイルごとの結果
+	struct Result
+	{
+		std::string message;
+		bool failed = false;
+		uint64_t pixels = 0;
+		double seconds = 0.0;
+	};
+
+	// カバレッジの誤差（レベルごとの元の画像との差の平均と最大）
+	struct CoverageError
+	{
+		double sum = 0.0;
+		float max = 0.0f;
+		int count = 0;
+
+		void Add(uint32_t width, uint32_t height, float coverage, float target)
+		{
+			if (width < MIN_COVERAGE_SIZE || height < MIN_COVERAGE_SIZE) return;
+			float error = std::fabs(coverage - target);
+			sum += error;
+			max = std::max(max, error);
+			count++;
+		}
+
+		double GetMean() const { return count > 0 ? sum / count : 0.0; }
+	};
+
+	// sRGBのフォーマットか
+	bool IsSrgb(uint32_t format)
+	{
+		return format == FORMAT_R8G8B8A8_UNORM_SRGB || format == FORMAT_B8G8R8A8_UNORM_SRGB || format == FORMAT_B8G8R8X8_UNORM_SRGB
+			|| format == FORMAT_BC1_UNORM_SRGB || format == FORMAT_BC3_UNORM_SRGB;
+	}
+
+	// １チャンネルのフォーマットか
+	bool IsSingleChannel(uint32_t format)
+	{
+		return format == FORMAT_R8_UNORM || format == FORMAT_A8_UNORM || format == FORMAT_BC4_UNORM;
+	}
+
+	// ブロック圧縮のフォーマットか
+	bool IsBlockCompressed(uint32_t format)
+	{
+		return format == FORMAT_BC1_UNORM || format == FORMAT_BC1_UNORM_SRGB || format == FORMAT_BC3_UNORM
+			|| format == FORMAT_BC3_UNORM_SRGB || format == FORMAT_BC4_UNORM;
+	}
+
+	// ブロックの数
+	uint32_t GetBlockCount(uint32_t size)
+	{
+		return std::max(1u, (size + 3) / 4);
+	}
+
+	// ブロックのバイト数
+	size_t GetBlockSize(uint32_t format)
+	{
+		return (format == FORMAT_BC3_UNORM || format == FORMAT_BC3_UNORM_SRGB) ? BC3_BLOCK_SIZE : BC1_BLOCK_SIZE;
+	}
+
+	// 1ピクセルのバイト数（ブロック圧縮以外）
+	size_t GetPixelSize(uint32_t format)
+	{
+		return (format == FORMAT_R8_UNORM || format == FORMAT_A8_UNORM) ? 1 : 4;
+	}
+
+	// ブロック圧縮のサーフェスを展開する
+	void DecodeBlocks(const DdsSurface& surface, uint32_t format, Image& image)
+	{
+		uint32_t blocksWide = GetBlockCount(surface.width);
+		uint32_t blocksHigh = GetBlockCount(surface.height);
+		size_t blockSize = GetBlockSize(format);
+
+		uint8_t decoded[16 * 4];
+		uint8_t values[16];
+		for (uint32_t blockY = 0; blockY < blocksHigh; blockY++)
+		{
+			for (uint32_t blockX = 0; blockX < blocksWide; blockX++)
+			{
+				const uint8_t* block = surface.data + blockY * surface.rowPitch + blockX * blockSize;
+				if (format == FORMAT_BC4_UNORM)
+				{
+					DecodeBC4Block(block, values);
+					for (int i = 0; i < 16; i++)
+					{
+						decoded[i * 4 + 0] = decoded[i * 4 + 1] = decoded[i * 4 + 2] = values[i];
+						decoded[i * 4 + 3] = 255;
+					}
+				}
+				else if (format == FORMAT_BC3_UNORM || format == FORMAT_BC3_UNORM_SRGB) DecodeBC3Block(block, decoded);
+				else DecodeBC1Block(block, decoded);
+
+				for (uint32_t y = 0; y < 4 && blockY * 4 + y < surface.height; y++)
+				{
+					for (uint32_t x = 0; x < 4 && blockX * 4 + x < surface.width; x++)
+					{
+						std::memcpy(image.rgba.data() + ((static_cast<size_t>(blockY) * 4 + y) * surface.width + blockX * 4 + x) * 4,
+							decoded + (y * 4 + x) * 4, 4);
+					}
+				}
+			}
+		}
+	}
+
+	// サーフェスをRGBA8に変換する（対応していないフォーマットは例外を投げる）
+	Image ConvertSurface(const DdsSurface& surface, uint32_t format)
+	{
+		Image image;
+		image.width = surface.width;
+		image.height = surface.height;
+		image.rgba.resize(static_cast<size_t>(surface.width) * surface.height * 4);
+
+		if (IsBlockCompressed(format))
+		{
+			DecodeBlocks(surface, format, image);
+			return image;
+		}
+
+		for (uint32_t y = 0; y < surface.height; y++)
+		{
+			const uint8_t* row = surface.data + y * surface.rowPitch;
+			uint8_t* output = image.rgba.data() + static_cast<size_t>(y) * surface.width * 4;
+			for (uint32_t x = 0; x < surface.width; x++, output += 4)
+			{
+				switch (format)
+				{
+				case FORMAT_R8G8B8A8_UNORM:
+				case FORMAT_R8G8B8A8_UNORM_SRGB:
+					std::memcpy(output, row + x * 4, 4);
+					break;
+				case FORMAT_B8G8R8A8_UNORM:
+				case FORMAT_B8G8R8A8_UNORM_SRGB:
+				case FORMAT_B8G8R8X8_UNORM:
+				case FORMAT_B8G8R8X8_UNORM_SRGB:
+					output[0] = row[x * 4 + 2];
+					output[1] = row[x * 4 + 1];
+					output[2] = row[x * 4 + 0];
+					output[3] = (format == FORMAT_B8G8R8X8_UNORM || format == FORMAT_B8G8R8X8_UNORM_SRGB) ? 255 : row[x * 4 + 3];
+					break;
+				case FORMAT_R8_UNORM:
+					output[0] = output[1] = output[2] = row[x];
+					output[3] = 255;
+					break;
+				case FORMAT_A8_UNORM:
+					output[0] = output[1] = output[2] = row[x];
+					output[3] = row[x];
+					break;
+				default:
+					throw std::runtime_error("Unsupported source format (RGBA8, BGRA8, BGRX8, R8, A8, BC1, BC3 and BC4 only).");
+				}
+			}
+		}
+		return image;
+	}
+
+	// RGBA8を元のフォーマットのサーフェスにする（行の間は詰める）
+	std::vector<uint8_t> ConvertBack(const Image& image, uint32_t format)
+	{
+		std::vector<uint8_t> surface;
+		if (IsBlockCompressed(format))
+		{
+			uint32_t blocksWide = GetBlockCount(image.width);
+			uint32_t blocksHigh = GetBlockCount(image.height);
+			size_t blockSize = GetBlockSize(format);
+			surface.resize(blocksWide * blocksHigh * blockSize);
+
+			// ブロックのピクセルを取り出す（端は最後のピクセルを繰り返す）
+			uint8_t rgba[16 * 4];
+			uint8_t values[16];
+			for (uint32_t blockY = 0; blockY < blocksHigh; blockY++)
+			{
+				for (uint32_t blockX = 0; blockX < blocksWide; blockX++)
+				{
+					for (uint32_t i = 0; i < 16; i++)
+					{
+						uint32_t x = std::min(blockX * 4 + i % 4, image.width - 1);
+						uint32_t y = std::min(blockY * 4 + i / 4, image.height - 1);
+						std::memcpy(rgba + i * 4, image.rgba.data() + (static_cast<size_t>(y) * image.width + x) * 4, 4);
+						values[i] = rgba[i * 4];
+					}
+
+					uint8_t* block = surface.data() + (static_cast<size_t>(blockY) * blocksWide + blockX) * blockSize;
+					if (format == FORMAT_BC4_UNORM) EncodeBC4Block(values, block, BcQuality::Normal);
+					else if (blockSize == BC3_BLOCK_SIZE) EncodeBC3Block(rgba, block, BcQuality::Normal);
+					else EncodeBC1Block(rgba, block, BcQuality::Normal);
+				}
+			}
+			return surface;
+		}
+
+		size_t pixelSize = GetPixelSize(format);
+		size_t count = static_cast<size_t>(image.width) * image.height;
+		surface.resize(count * pixelSize);
+		for (size_t i = 0; i < count; i++)
+		{
+			const uint8_t* p = image.rgba.data() + i * 4;
+			uint8_t* output = surface.data() + i * pixelSize;
+			switch (format)
+			{
+			case FORMAT_R8G8B8A8_UNORM:
+			case FORMAT_R8G8B8A8_UNORM_SRGB:
+				std::memcpy(output, p, 4);
+				break;
+			case FORMAT_B8G8R8X8_UNORM:
+			case FORMAT_B8G8R8X8_UNORM_SRGB:
+				output[0] = p[2];
+				output[1] = p[1];
+				output[2] = p[0];
+				output[3] = 255;
+				break;
+			case FORMAT_R8_UNORM:
+				output[0] = p[0];
+				break;
+			case FORMAT_A8_UNORM:
+				output[0] = p[3];
+				break;
+			default:
+				output[0] = p[2];
+				output[1] = p[1];
+				output[2] = p[0];
+				output[3] = p[3];
+				break;
+			}
+		}
+		return surface;
+	}
+
+	// アルファが基準値より大きいピクセルの割合
+	float GetCoverage(const Image& image, int alphaReference)
+	{
+		size_t passed = 0;
+		for (size_t i = 3; i < image.rgba.size(); i += 4)
+		{
+			if (image.rgba[i] > alphaReference) passed++;
+		}
+		return static_cast<float>(passed) / (static_cast<size_t>(image.width) * image.height);
+	}
+
+	// アルファが全て255か
+	bool IsOpaque(const Image& image)
+	{
+		for (size_t i = 3; i < image.rgba.size(); i += 4)
+		{
+			if (image.rgba[i] != 255) return false;
+		}
+		return true;
+	}
+
+	// ファイルを書き出す
+	void WriteFile(const std::string& fileName, const std::vector<uint8_t>& data)
+	{
+		std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!file) throw std::runtime_error("Failed to write file.");
+	}
+
+	// DDSファイルを作る（DX10拡張ヘッダーで書き出す）
+	std::vector<uint8_t> BuildDds(const DdsFile& source, uint32_t mipLevels, const std::vector<std::vector<uint8_t>>& surfaces)
+	{
+		uint32_t format = source.GetFormat();
+		bool blockCompressed = IsBlockCompressed(format);
+
+		DdsHeader header = {};
+		header.size = sizeof(DdsHeader);
+		header.flags = DDS_HEADER_FLAGS | (blockCompressed ? DDS_HEADER_FLAGS_LINEARSIZE : DDS_HEADER_FLAGS_PITCH)
+			| (mipLevels > 1 ? DDS_HEADER_FLAGS_MIPMAP : 0);
+		header.width = source.GetWidth();
+		header.height = source.GetHeight();
+		header.depth = 1;
+		header.pitchOrLinearSize = blockCompressed ? static_cast<uint32_t>(surfaces[0].size())
+			: static_cast<uint32_t>(source.GetWidth() * GetPixelSize(format));
+		header.mipMapCount = mipLevels;
+		header.pixelFormat.size = sizeof(DdsPixelFormat);
+		header.pixelFormat.flags = DDS_PF_FOURCC;
+		header.pixelFormat.fourCC = DDS_FOURCC_DX10;
+		header.caps = DDS_CAPS_TEXTURE | (mipLevels > 1 ? DDS_CAPS_COMPLEX | DDS_CAPS_MIPMAP : 0);
+		if (source.IsCubemap())
+		{
+			header.caps |= DDS_CAPS_COMPLEX;
+			header.caps2 = DDS_CAPS2_CUBEMAP_ALLFACES;
+		}
+
+		DdsHeaderDxt10 headerDxt10 = {};
+		headerDxt10.dxgiFormat = format;
+		headerDxt10.resourceDimension = source.GetDimension();
+		headerDxt10.miscFlag = source.IsCubemap() ? DDS_MISC_TEXTURECUBE : 0;
+		headerDxt10.arraySize = source.IsCubemap() ? source.GetArraySize() / DDS_CUBEMAP_FACES : source.GetArraySize();
+
+		std::vector<uint8_t> output(sizeof(uint32_t) + sizeof(DdsHeader) + sizeof(DdsHeaderDxt10));
+		std::memcpy(output.data(), &DDS_MAGIC, sizeof(uint32_t));
+		std::memcpy(output.data() + sizeof(uint32_t), &header, sizeof(header));
+		std::memcpy(output.data() + sizeof(uint32_t) + sizeof(header), &headerDxt10, sizeof(headerDxt10));
+
+		// サーフェスは配列の要素ごとにミップマップの順
+		for (const std::vector<uint8_t>& surface : surfaces) output.insert(output.end(), surface.begin(), surface.end());
+		return output;
+	}
+
+	// ファイル名の部分
+	std::string GetFileName(const std::string& path)
+	{
+		size_t separator = path.find_last_of("/\\");
+		return separator == std::string::npos ? path : path.substr(separator + 1);
+	}
+
+	// 拡張子が.ddsか
+	bool HasDdsExtension(const std::string& path)
+	{
+		if (path.size() < 4) return false;
+		std::string extension = path.substr(path.size() - 4);
+		for (char& c : extension) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		return extension == ".dds";
+	}
+
+	// フォルダーの中の.ddsファイルを追加する（フォルダーでなければfalse）
+	bool ListDirectory(const std::string& path, std::vector<std::string>& files)
+	{
+		std::vector<std::string> found;
+#ifdef _WIN32
+		DWORD attributes = GetFileAttributesA(path.c_str());
+		if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY)) return false;
+
+		WIN32_FIND_DATAA data;
+		HANDLE find = FindFirstFileA((path + "\\*").c_str(), &data);
+		if (find != INVALID_HANDLE_VALUE)
+		{
+			do
+			{
+				if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && HasDdsExtension(data.cFileName))
+				{
+					found.push_back(path + "\\" + data.cFileName);
+				}
+			} while (FindNextFileA(find, &data));
+			FindClose(find);
+		}
+#else
+		struct stat status = {};
+		if (stat(path.c_str(), &status) != 0 || !S_ISDIR(status.st_mode)) return false;
+
+		DIR* directory = opendir(path.c_str());
+		if (!directory) throw std::runtime_error("Failed to open directory: " + path);
+		while (dirent* entry = readdir(directory))
+		{
+			std::string file = path + "/" + entry->d_name;
+			if (HasDdsExtension(file) && stat(file.c_str(), &status) == 0 && S_ISREG(status.st_mode)) found.push_back(file);
+		}
+		closedir(directory);
+#endif
+		std::sort(found.begin(), found.end());
+		files.insert(files.end(), found.begin(), found.end());
+		return true;
+	}
+
+	// 文字列に書式を付けて追加する
+	template <class... Args>
+	void Append(std::string& message, const char* format, const Args& ... args)
+	{
+		char buffer[256];
+		std::snprintf(buffer, sizeof(buffer), format, args ...);
+		message += buffer;
+	}
+
+	// ファイルのミップマップを作り直す
+	Result ProcessFile(const std::string& path, const Options& options)
+	{
+		Result result;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		DdsFile source(std::wstring(path.begin(), path.end()).c_str());
+		uint32_t format = source.GetFormat();
+		if (source.GetDimension() == DDS_DIMENSION_TEXTURE3D) throw std::runtime_error("Volume textures are not supported.");
+
+		uint32_t mipLevels = CountMipLevels(source.GetWidth(), source.GetHeight());
+		if (source.GetMipLevels() == mipLevels && !options.force)
+		{
+			Append(result.message, "%s: %u levels already, skipped\n", path.c_str(), mipLevels);
+			return result;
+		}
+
+		bool srgb = IsSrgb(format) || (!options.linear && !IsSingleChannel(format));
+		std::vector<std::vector<uint8_t>> surfaces;
+		CoverageError oldError;
+		CoverageError newError;
+		bool coverage = false;
+		for (uint32_t item = 0; item < source.GetArraySize(); item++)
+		{
+			Image top = ConvertSurface(source.GetSurface(item, 0), format);
+
+			MipOptions mipOptions = options.mip;
+			if (IsOpaque(top)) mipOptions.alphaReference = -1;
+			coverage |= mipOptions.alphaReference >= 0;
+
+			// ファイルに入っていたミップマップのカバレッジの誤差
+			if (mipOptions.alphaReference >= 0)
+			{
+				float target = GetCoverage(top, mipOptions.alphaReference);
+				for (uint32_t mip = 1; mip < source.GetMipLevels(); mip++)
+				{
+					Image image = ConvertSurface(source.GetSurface(item, mip), format);
+					oldError.Add(image.width, image.height, GetCoverage(image, mipOptions.alphaReference), target);
+				}
+			}
+
+			std::vector<MipImage> levels(1);
+			LoadMipImage(top.rgba.data(), top.width, top.height, static_cast<size_t>(top.width) * 4, srgb, levels[0]);
+
+			std::vector<MipLevelStatistics> statistics;
+			GenerateMipChain(levels, mipOptions, &statistics);
+
+			for (uint32_t mip = 0; mip < mipLevels; mip++)
+			{
+				if (mip > 0 && mipOptions.alphaReference >= 0)
+				{
+					newError.Add(levels[mip].width, levels[mip].height, statistics[mip].coverageAfter, statistics[0].coverageAfter);
+				}
+
+				// 最も詳細なレベルは元のデータをそのまま使う
+				if (mip == 0 && !IsBlockCompressed(format))
+				{
+					surfaces.push_back(ConvertBack(top, format));
+					continue;
+				}
+				if (mip == 0)
+				{
+					const DdsSurface& surface = source.GetSurface(item, 0);
+					surfaces.emplace_back(surface.data, surface.data + surface.slicePitch);
+					continue;
+				}
+
+				Image image;
+				image.width = levels[mip].width;
+				image.height = levels[mip].height;
+				image.rgba.resize(static_cast<size_t>(image.width) * image.height * 4);
+				StoreMipImage(levels[mip], srgb, image.rgba.data());
+				surfaces.push_back(ConvertBack(image, format));
+			}
+
+			result.pixels += static_cast<uint64_t>(top.width) * top.height;
+		}
+
+		std::vector<uint8_t> output = BuildDds(source, mipLevels, surfaces);
+
+		// 書き出す前に読み直して確認する
+		DdsFile check(output.data(), output.size());
+		if (check.GetFormat() != format || check.GetMipLevels() != mipLevels || check.GetSurfaceCount() != surfaces.size())
+		{
+			throw std::runtime_error("Verification failed.");
+		}
+
+		if (!options.output.empty()) WriteFile(options.output + "/" + GetFileName(path), output);
+
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		Append(result.message, "%s: %u -> %u levels, %s%s", path.c_str(), source.GetMipLevels(), mipLevels,
+			options.mip.filter == MipFilter::Box ? "box" : "kaiser", srgb ? " sRGB" : "");
+		if (coverage)
+		{
+			Append(result.message, ", coverage error mean %.4f max %.4f", newError.GetMean(), newError.max);
+			if (source.GetMipLevels() > 1) Append(result.message, " (was mean %.4f max %.4f)", oldError.GetMean(), oldError.max);
+		}
+		Append(result.message, ", %.1f ms\n", result.seconds * 1000.0);
+		return result;
+	}
+
+	// フィルターと命令セットの組み合わせごとに速度を計測する
+	void BenchmarkFile(const std::string& path, const Options& options)
+	{
+		DdsFile source(std::wstring(path.begin(), path.end()).c_str());
+		uint32_t format = source.GetFormat();
+		Image top = ConvertSurface(source.GetSurface(0, 0), format);
+		bool srgb = IsSrgb(format) || (!options.linear && !IsSingleChannel(format));
+		int alphaReference = IsOpaque(top) ? -1 : options.mip.alphaReference;
+
+		std::vector<MipImage> input(1);
+		LoadMipImage(top.rgba.data(), top.width, top.height, static_cast<size_t>(top.width) * 4, srgb, input[0]);
+
+		std::printf("%s: %ux%u\n", path.c_str(), top.width, top.height);
+		for (MipFilter filter : { MipFilter::Box, MipFilter::Kaiser })
+		{
+			std::vector<MipImage> reference;
+			for (int simd = 0; simd <= static_cast<int>(GetSimdLevel()); simd++)
+			{
+				MipOptions mipOptions = options.mip;
+				mipOptions.filter = filter;
+				mipOptions.level = static_cast<SimdLevel>(simd);
+				mipOptions.alphaReference = alphaReference;
+
+				std::vector<MipImage> levels;
+				std::vector<MipLevelStatistics> statistics;
+				std::vector<double> times;
+				for (int i = 0; i < options.benchmark; i++)
+				{
+					levels = input;
+					std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+					GenerateMipChain(levels, mipOptions, &statistics);
+					times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+				}
+				std::sort(times.begin(), times.end());
+				double median = times[times.size() / 2];
+
+				// 命令セットが違っても結果は同じはず
+				bool same = true;
+				if (reference.empty()) reference = levels;
+				for (size_t mip = 0; mip < levels.size(); mip++) same &= levels[mip].rgba == reference[mip].rgba;
+
+				CoverageError error;
+				CoverageError unscaledError;
+				for (size_t mip = 1; mip < levels.size(); mip++)
+				{
+					error.Add(levels[mip].width, levels[mip].height, statistics[mip].coverageAfter, statistics[0].coverageAfter);
+					unscaledError.Add(levels[mip].width, levels[mip].height, statistics[mip].coverageBefore, statistics[0].coverageBefore);
+				}
+
+				std::printf("  %-6s %-6s %8.3f ms %8.1f Mpixel/s", filter == MipFilter::Box ? "box" : "kaiser",
+					GetSimdLevelName(mipOptions.level), median * 1000.0, static_cast<double>(top.width) * top.height / median / 1e6);
+				if (alphaReference >= 0)
+				{
+					std::printf("  coverage error mean %.4f max %.4f (unscaled mean %.4f max %.4f)",
+						error.GetMean(), error.max, unscaledError.GetMean(), unscaledError.max);
+				}
+				std::printf("%s\n", same ? "" : "  MISMATCH");
+			}
+		}
+	}
+
+	// オプションの値を読む
+	bool ParseOption(const char* name, const char* value, Options& options)
+	{
+		std::string v(value);
+		if (std::strcmp(name, "--filter") == 0)
+		{
+			if (v == "box") options.mip.filter = MipFilter::Box;
+			else if (v == "kaiser") options.mip.filter = MipFilter::Kaiser;
+			else return false;
+		}
+		else if (std::strcmp(name, "--alpha-reference") == 0)
+		{
+			if (v == "none")
+			{
+				options.mip.alphaReference = -1;
+				return true;
+			}
+			int reference = std::atoi(value);
+			if (reference < 0 || reference > 255 || v.find_first_not_of("0123456789") != std::string::npos) return false;
+			options.mip.alphaReference = reference;
+		}
+		else if (std::strcmp(name, "--threads") == 0)
+		{
+			int threads = std::atoi(value);
+			if (threads <= 0) return false;
+			options.threads = static_cast<uint32_t>(threads);
+		}
+		else if (std::strcmp(name, "--simd") == 0)
+		{
+			if (v == "scalar") options.mip.level = SimdLevel::Scalar;
+			else if (v == "sse2") options.mip.level = SimdLevel::SSE2;
+			else if (v == "avx2") options.mip.level = SimdLevel::AVX2;
+			else return false;
+			if (options.mip.level > GetSimdLevel()) options.mip.level = GetSimdLevel();
+		}
+		else if (std::strcmp(name, "--output") == 0)
+		{
+			options.output = v;
+		}
+		else if (std::strcmp(name, "--benchmark") == 0)
+		{
+			options.benchmark = std::atoi(value);
+			if (options.benchmark <= 0) return false;
+		}
+		else
+		{
+			return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	options.mip.alphaReference = DEFAULT_ALPHA_REFERENCE;
+
+	std::vector<std::string> inputs;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--linear") == 0) options.linear = true;
+		else if (std::strcmp(argv[i], "--wrap") == 0) options.mip.wrap = true;
+		else if (std::strcmp(argv[i], "--force") == 0) options.force = true;
+		else if (std::strncmp(argv[i], "--", 2) == 0)
+		{
+			if (i + 1 >= argc || !ParseOption(argv[i], argv[i + 1], options))
+			{
+				std::fprintf(stderr, "Invalid option: %s\n", argv[i]);
+				return 1;
+			}
+			i++;
+		}
+		else
+		{
+			inputs.push_back(argv[i]);
+		}
+	}
+
+	if (inputs.empty())
+	{
+		std::fprintf(stderr,
+			"Usage: MipGenerator [--filter box|kaiser] [--alpha-reference <n|none>] [--linear] [--wrap] [--force]\n"
+			"                    [--threads <n>] [--simd scalar|sse2|avx2] [--output <directory>] [--benchmark <n>]\n"
+			"                    <file.dds | directory>...\n");
+		return 1;
+	}
+
+	std::vector<std::string> files;
+	try
+	{
+		for (const std::string& input : inputs)
+		{
+			if (!ListDirectory(input, files)) files.push_back(input);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+
+	int result = 0;
+	if (options.benchmark > 0)
+	{
+		for (const std::string& file : files)
+		{
+			try
+			{
+				BenchmarkFile(file, options);
+			}
+			catch (const std::exception& e)
+			{
+				std::fprintf(stderr, "%s: %s\n", file.c_str(), e.what());
+				result = 1;
+			}
+		}
+		return result;
+	}
+
+	// ファイルごとにスレッドプールで処理する
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	ThreadPool pool(options.threads);
+	std::vector<std::future<Result>> jobs;
+	for (const std::string& file : files)
+	{
+		jobs.push_back(pool.Submit([&file, &options]()
+			{
+				try
+				{
+					return ProcessFile(file, options);
+				}
+				catch (const std::exception& e)
+				{
+					Result failed;
+					failed.message = file + ": " + e.what() + "\n";
+					failed.failed = true;
+					return failed;
+				}
+			}));
+	}
+
+	uint64_t pixels = 0;
+	for (std::future<Result>& job : jobs)
+	{
+		Result done = job.get();
+		std::fputs(done.message.c_str(), done.failed ? stderr : stdout);
+		if (done.failed) result = 1;
+		pixels += done.pixels;
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::printf("%zu files, %.1f Mpixel/s (%zu threads, %s)\n", files.size(), seconds > 0.0 ? pixels / seconds / 1e6 : 0.0,
+		pool.GetThreadCount(), GetSimdLevelName(options.mip.level));
+
+	return result;
+}
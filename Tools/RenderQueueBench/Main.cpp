@@ -0,0 +1,146 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// RadixSortRenderItemsとstd::sort、std::stable_sortの速度を比べるベンチマーク
+//
+// Usage: RenderQueueBench [--iterations <n>]
+//        16個から1,000,000個の描画を、MakeOpaqueRenderKey/MakeTransparentRenderKeyで作った
+//        キー（レイヤー４つ、マテリアル64種類、テクスチャ256種類、半透明は１割）と、
+//        全ビットが乱数のキーの２種類で並べ替え、n回（既定は20回）の中央値と
+//        １個あたりの時間を表示します。並べ替える前の配列のコピーは時間に含めません。
+//        基数ソートの結果がstd::stable_sort（キーだけで比較）と一致することを確認し、
+//        違えば1を返します。（64個以下はRadixSortRenderItemsの中で挿入ソートになります）
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:RenderQueueBench.exe Tools\RenderQueueBench\Main.cpp ImaseLib\RenderQueue.cpp
+//          g++ -std=c++14 -O2 -o RenderQueueBench Tools/RenderQueueBench/Main.cpp ImaseLib/RenderQueue.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/RenderQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 計る描画の数
+	const size_t COUNTS[] = { 16, 64, 256, 1000, 10000, 100000, 1000000 };
+
+	// 時間を計る（n回の中央値、ミリ秒、prepareの時間は含めない）
+	template <class P, class F>
+	double Measure(int iterations, P&& prepare, F&& function)
+	{
+		std::vector<double> times;
+		for (int i = 0; i < iterations; i++)
+		{
+			prepare();
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			function();
+			times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		std::sort(times.begin(), times.end());
+		return times[times.size() / 2];
+	}
+
+	bool LessKey(const RenderItem& a, const RenderItem& b)
+	{
+		return a.key < b.key;
+	}
+
+	// ゲームの描画に近いキー
+	std::vector<RenderItem> MakeSceneItems(size_t count, std::mt19937& random)
+	{
+		std::uniform_int_distribution<uint32_t> layer(0, 3);
+		std::uniform_int_distribution<uint32_t> material(0, 63);
+		std::uniform_int_distribution<uint32_t> texture(0, 255);
+		std::uniform_real_distribution<float> distance(0.1f, 100.0f);
+		std::uniform_int_distribution<int> percent(0, 99);
+
+		std::vector<RenderItem> items(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			uint32_t depth = QuantizeRenderDepth(distance(random), 0.1f, 100.0f);
+			uint64_t key = percent(random) < 10
+				? MakeTransparentRenderKey(layer(random), depth, material(random), texture(random))
+				: MakeOpaqueRenderKey(layer(random), material(random), texture(random), depth);
+			items[i] = { key, static_cast<uint32_t>(i) };
+		}
+		return items;
+	}
+
+	// 全ビットが乱数のキー
+	std::vector<RenderItem> MakeRandomItems(size_t count, std::mt19937& random)
+	{
+		std::vector<RenderItem> items(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			uint64_t key = (static_cast<uint64_t>(random()) << 32) | random();
+			items[i] = { key, static_cast<uint32_t>(i) };
+		}
+		return items;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int iterations = 20;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+		{
+			iterations = std::atoi(argv[++i]);
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: RenderQueueBench [--iterations <n>]\n");
+			return 1;
+		}
+	}
+
+	std::mt19937 random(1);
+
+	std::printf("%d iterations\n", iterations);
+	std::printf("%-7s %9s  %-12s %10s %10s\n", "keys", "count", "sort", "ms", "ns/each");
+
+	int result = 0;
+	for (int distribution = 0; distribution < 2; distribution++)
+	{
+		const char* name = distribution == 0 ? "scene" : "random";
+		for (size_t count : COUNTS)
+		{
+			const std::vector<RenderItem> source = distribution == 0 ? MakeSceneItems(count, random) : MakeRandomItems(count, random);
+			std::vector<RenderItem> items(count);
+			std::vector<RenderItem> temp(count);
+			auto prepare = [&]() { std::copy(source.begin(), source.end(), items.begin()); };
+
+			double milliseconds = Measure(iterations, prepare, [&]() { RadixSortRenderItems(items.data(), temp.data(), count); });
+			std::vector<RenderItem> radix = items;
+			std::printf("%-7s %9zu  %-12s %10.3f %10.2f\n", name, count, "radix", milliseconds, milliseconds * 1e6 / count);
+
+			milliseconds = Measure(iterations, prepare, [&]() { std::sort(items.begin(), items.end(), LessKey); });
+			std::printf("%-7s %9zu  %-12s %10.3f %10.2f\n", name, count, "std::sort", milliseconds, milliseconds * 1e6 / count);
+
+			milliseconds = Measure(iterations, prepare, [&]() { std::stable_sort(items.begin(), items.end(), LessKey); });
+
+			// 基数ソートは安定なのでペイロードの順番まで一致する
+			size_t mismatches = 0;
+			for (size_t i = 0; i < count; i++)
+			{
+				if (radix[i].key != items[i].key || radix[i].payload != items[i].payload) mismatches++;
+			}
+			std::printf("%-7s %9zu  %-12s %10.3f %10.2f%s\n", name, count, "stable_sort", milliseconds, milliseconds * 1e6 / count,
+				mismatches ? "  MISMATCH" : "");
+			if (mismatches) result = 1;
+		}
+	}
+
+	return result;
+}
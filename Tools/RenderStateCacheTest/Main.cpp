@@ -0,0 +1,277 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// RenderStateCacheが設定先に渡す呼び出しと、設定回数・省略回数の統計を確認するテスト
+//
+// Usage: RenderStateCacheTest
+//        呼び出しを記録するIRenderStateTargetを設定先にして、同じステートの再設定、
+//        Invalidate、BeginFrame、サンプラーのスロット範囲（一部だけ変更、範囲外）を確認します。
+//        ステートのポインタはダミーの値を使うのでデバイスは作りません。
+//        失敗した項目を表示して1を返します。
+//        D3DもDirectXTKも使わないのでLinuxでビルド・実行できます。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:RenderStateCacheTest.exe Tools\RenderStateCacheTest\Main.cpp ImaseLib\RenderStateCache.cpp
+//          g++ -std=c++14 -O2 -o RenderStateCacheTest Tools/RenderStateCacheTest/Main.cpp ImaseLib/RenderStateCache.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/RenderStateCache.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 失敗した数
+	int g_failures = 0;
+
+	void Check(bool condition, const char* message, int line)
+	{
+		if (condition) return;
+		if (g_failures < 20) std::printf("FAILED: %s (line %d)\n", message, line);
+		g_failures++;
+	}
+
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+	// 設定先に渡された呼び出し
+	struct Call
+	{
+		enum Kind { DepthStencil, Blend, Rasterizer, Samplers };
+
+		Kind kind;
+		const void* state;
+		uint32_t value;
+		bool defaultBlendFactor;
+		uint32_t startSlot;
+		std::vector<ID3D11SamplerState*> samplers;
+	};
+
+	// 呼び出しを記録する設定先
+	class RecordingTarget : public IRenderStateTarget
+	{
+	public:
+
+		std::vector<Call> calls;
+
+		void SetDepthStencilState(ID3D11DepthStencilState* state, uint32_t stencilRef) override
+		{
+			calls.push_back({ Call::DepthStencil, state, stencilRef, false, 0, {} });
+		}
+
+		void SetBlendState(ID3D11BlendState* state, const float blendFactor[4], uint32_t sampleMask) override
+		{
+			calls.push_back({ Call::Blend, state, sampleMask, blendFactor == nullptr, 0, {} });
+		}
+
+		void SetRasterizerState(ID3D11RasterizerState* state) override
+		{
+			calls.push_back({ Call::Rasterizer, state, 0, false, 0, {} });
+		}
+
+		void SetPSSamplers(uint32_t startSlot, uint32_t count, ID3D11SamplerState* const* samplers) override
+		{
+			calls.push_back({ Call::Samplers, nullptr, count, false, startSlot, std::vector<ID3D11SamplerState*>(samplers, samplers + count) });
+		}
+	};
+
+	// ダミーのステート（比べるだけで参照はしない）
+	template <typename T>
+	T* Dummy(uintptr_t id)
+	{
+		return reinterpret_cast<T*>(id * 0x10);
+	}
+
+	bool IsStatistics(const RenderStateCache::Statistics& statistics, uint32_t bound, uint32_t skipped)
+	{
+		return statistics.bound == bound && statistics.skipped == skipped;
+	}
+
+	bool IsSamplerCall(const Call& call, uint32_t startSlot, std::vector<ID3D11SamplerState*> samplers)
+	{
+		return call.kind == Call::Samplers && call.startSlot == startSlot && call.samplers == samplers;
+	}
+
+	// 同じステートの再設定は省く
+	void TestRedundantBinds()
+	{
+		RecordingTarget target;
+		RenderStateCache cache(&target);
+
+		auto* depth = Dummy<ID3D11DepthStencilState>(1);
+		auto* blend = Dummy<ID3D11BlendState>(2);
+		auto* rasterizer = Dummy<ID3D11RasterizerState>(3);
+		ID3D11SamplerState* sampler = Dummy<ID3D11SamplerState>(4);
+
+		for (int i = 0; i < 3; i++)
+		{
+			cache.SetDepthStencilState(depth, 0);
+			cache.SetBlendState(blend, nullptr, 0xffffffff);
+			cache.SetRasterizerState(rasterizer);
+			cache.SetPSSamplers(0, 1, &sampler);
+		}
+		CHECK(target.calls.size() == 4);
+		CHECK(IsStatistics(cache.GetStatistics(), 4, 8));
+
+		// nullptrのブレンド係数と{1,1,1,1}は同じ
+		const float one[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		cache.SetBlendState(blend, one, 0xffffffff);
+		CHECK(target.calls.size() == 4);
+
+		// 値が一つでも違えば設定する（nullptrのブレンド係数はそのまま渡す）
+		const float half[4] = { 0.5f, 0.5f, 0.5f, 0.5f };
+		cache.SetDepthStencilState(depth, 1);
+		cache.SetDepthStencilState(nullptr, 1);
+		cache.SetBlendState(blend, half, 0xffffffff);
+		cache.SetBlendState(blend, half, 0x0000ffff);
+		cache.SetBlendState(blend, nullptr, 0x0000ffff);
+		cache.SetRasterizerState(nullptr);
+		CHECK(target.calls.size() == 10);
+		CHECK(target.calls[4].kind == Call::DepthStencil && target.calls[4].state == depth && target.calls[4].value == 1);
+		CHECK(target.calls[5].kind == Call::DepthStencil && target.calls[5].state == nullptr);
+		CHECK(target.calls[6].kind == Call::Blend && !target.calls[6].defaultBlendFactor);
+		CHECK(target.calls[7].kind == Call::Blend && target.calls[7].value == 0x0000ffff);
+		CHECK(target.calls[8].kind == Call::Blend && target.calls[8].defaultBlendFactor);
+		CHECK(target.calls[9].kind == Call::Rasterizer && target.calls[9].state == nullptr);
+		CHECK(IsStatistics(cache.GetStatistics(), 10, 9));
+	}
+
+	// Invalidateの後は同じステートでも設定し、統計はそのまま
+	void TestInvalidate()
+	{
+		RecordingTarget target;
+		RenderStateCache cache(&target);
+
+		auto* depth = Dummy<ID3D11DepthStencilState>(1);
+		auto* blend = Dummy<ID3D11BlendState>(2);
+		auto* rasterizer = Dummy<ID3D11RasterizerState>(3);
+		ID3D11SamplerState* samplers[2] = { Dummy<ID3D11SamplerState>(4), Dummy<ID3D11SamplerState>(5) };
+
+		cache.SetDepthStencilState(depth, 0);
+		cache.SetBlendState(blend, nullptr, 0xffffffff);
+		cache.SetRasterizerState(rasterizer);
+		cache.SetPSSamplers(0, 2, samplers);
+
+		cache.Invalidate();
+
+		cache.SetDepthStencilState(depth, 0);
+		cache.SetBlendState(blend, nullptr, 0xffffffff);
+		cache.SetRasterizerState(rasterizer);
+		cache.SetPSSamplers(0, 2, samplers);
+		CHECK(target.calls.size() == 8);
+		CHECK(IsSamplerCall(target.calls[7], 0, { samplers[0], samplers[1] }));
+		CHECK(IsStatistics(cache.GetStatistics(), 8, 0));
+		CHECK(IsStatistics(cache.GetLastFrameStatistics(), 0, 0));
+
+		// 設定し直した後はまた省く
+		cache.SetRasterizerState(rasterizer);
+		CHECK(target.calls.size() == 8);
+		CHECK(IsStatistics(cache.GetStatistics(), 8, 1));
+	}
+
+	// BeginFrameで統計を切り替え、ステートは設定し直す
+	void TestBeginFrame()
+	{
+		RecordingTarget target;
+		RenderStateCache cache(&target);
+
+		auto* rasterizer = Dummy<ID3D11RasterizerState>(3);
+
+		cache.BeginFrame();
+		cache.SetRasterizerState(rasterizer);
+		cache.SetRasterizerState(rasterizer);
+		cache.SetRasterizerState(rasterizer);
+		CHECK(IsStatistics(cache.GetStatistics(), 1, 2));
+		CHECK(IsStatistics(cache.GetLastFrameStatistics(), 0, 0));
+
+		cache.BeginFrame();
+		CHECK(IsStatistics(cache.GetStatistics(), 0, 0));
+		CHECK(IsStatistics(cache.GetLastFrameStatistics(), 1, 2));
+
+		cache.SetRasterizerState(rasterizer);
+		CHECK(target.calls.size() == 2);
+		CHECK(IsStatistics(cache.GetStatistics(), 1, 0));
+
+		cache.BeginFrame();
+		CHECK(IsStatistics(cache.GetLastFrameStatistics(), 1, 0));
+	}
+
+	// サンプラーは変更があるスロットの範囲だけ設定する
+	void TestSamplerRanges()
+	{
+		RecordingTarget target;
+		RenderStateCache cache(&target);
+
+		ID3D11SamplerState* a = Dummy<ID3D11SamplerState>(1);
+		ID3D11SamplerState* b = Dummy<ID3D11SamplerState>(2);
+		ID3D11SamplerState* c = Dummy<ID3D11SamplerState>(3);
+		ID3D11SamplerState* d = Dummy<ID3D11SamplerState>(4);
+
+		// 未設定のスロットはnullptrでも設定する
+		ID3D11SamplerState* none = nullptr;
+		cache.SetPSSamplers(5, 1, &none);
+		CHECK(target.calls.size() == 1 && IsSamplerCall(target.calls[0], 5, { nullptr }));
+
+		ID3D11SamplerState* abc[3] = { a, b, c };
+		cache.SetPSSamplers(0, 3, abc);
+		CHECK(target.calls.size() == 2 && IsSamplerCall(target.calls[1], 0, { a, b, c }));
+
+		// 真ん中だけ変更
+		ID3D11SamplerState* adc[3] = { a, d, c };
+		cache.SetPSSamplers(0, 3, adc);
+		CHECK(target.calls.size() == 3 && IsSamplerCall(target.calls[2], 1, { d }));
+
+		// 両端を変更すると間の変更のないスロットも含めて設定する
+		ID3D11SamplerState* ddd[3] = { d, d, d };
+		cache.SetPSSamplers(0, 3, ddd);
+		CHECK(target.calls.size() == 4 && IsSamplerCall(target.calls[3], 0, { d, d, d }));
+
+		// 設定済みの範囲の一部は省く
+		cache.SetPSSamplers(1, 2, ddd);
+		CHECK(target.calls.size() == 4);
+
+		// 設定済みと未設定にまたがる範囲は未設定のスロットから設定する
+		cache.SetPSSamplers(2, 3, ddd);
+		CHECK(target.calls.size() == 5 && IsSamplerCall(target.calls[4], 3, { d, d }));
+
+		// 最後のスロット
+		cache.SetPSSamplers(RenderStateCache::SAMPLER_SLOT_COUNT - 1, 1, &a);
+		cache.SetPSSamplers(RenderStateCache::SAMPLER_SLOT_COUNT - 1, 1, &a);
+		CHECK(target.calls.size() == 6 && IsSamplerCall(target.calls[5], RenderStateCache::SAMPLER_SLOT_COUNT - 1, { a }));
+
+		// 範囲外はそのまま設定先に渡し、覚えているスロットは変えない
+		cache.SetPSSamplers(RenderStateCache::SAMPLER_SLOT_COUNT, 1, &b);
+		cache.SetPSSamplers(RenderStateCache::SAMPLER_SLOT_COUNT - 1, 2, abc);
+		CHECK(target.calls.size() == 8);
+		CHECK(IsSamplerCall(target.calls[6], RenderStateCache::SAMPLER_SLOT_COUNT, { b }));
+		CHECK(IsSamplerCall(target.calls[7], RenderStateCache::SAMPLER_SLOT_COUNT - 1, { a, b }));
+		cache.SetPSSamplers(RenderStateCache::SAMPLER_SLOT_COUNT - 1, 1, &a);
+		CHECK(target.calls.size() == 8);
+
+		CHECK(IsStatistics(cache.GetStatistics(), 8, 3));
+
+		// Invalidateの後は全スロットを設定し直す
+		cache.Invalidate();
+		cache.SetPSSamplers(1, 2, ddd);
+		CHECK(target.calls.size() == 9 && IsSamplerCall(target.calls[8], 1, { d, d }));
+	}
+}
+
+int main()
+{
+	TestRedundantBinds();
+	TestInvalidate();
+	TestBeginFrame();
+	TestSamplerRanges();
+
+	if (g_failures > 0)
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}
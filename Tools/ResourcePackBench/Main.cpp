@@ -0,0 +1,203 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// 個別のファイルとパックファイルの読み込み時間を比べるベンチマーク
+//
+// Usage: ResourcePackBench [--iterations <n>] <pack> <file>...
+//        指定したファイルを個別にマップして全てのページを読み込む時間と、
+//        パックファイルをマップして同じファイルを探して読み込む（圧縮されていれば展開する）
+//        時間を比べます。ファイルはパックを作った時と同じパスで指定してください。
+//        ファイルキャッシュを捨ててから読み込む場合（cold）と、捨てずに続けて読み込む場合（warm）を
+//        それぞれn回（既定は10回）計り、中央値を表示します。
+//        coldはPOSIXのposix_fadviseでキャッシュを捨てます。捨てた後にまだメモリにあった割合（resident）も
+//        表示するので、0%でなければキャッシュを捨てられていません。Windowsではwarmだけを計ります。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          g++ -std=c++14 -O2 -o ResourcePackBench Tools/ResourcePackBench/Main.cpp ImaseLib/ResourcePack.cpp ImaseLib/LzCodec.cpp ImaseLib/MappedFile.cpp ImaseLib/Utf8.cpp
+//
+//        実行例
+//          ResourcePackBench Resources.pak Resources/Font/* Resources/Models/*
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/MappedFile.h"
+#include "../../ImaseLib/ResourcePack.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Imase;
+
+namespace
+{
+	// 既定の計測回数
+	const int DEFAULT_ITERATIONS = 10;
+
+	// 時間の計測
+	typedef std::chrono::steady_clock Clock;
+
+	// ASCIIのパスをワイド文字列にする
+	std::wstring Widen(const std::string& text)
+	{
+		return std::wstring(text.begin(), text.end());
+	}
+
+#ifndef _WIN32
+	// ファイルキャッシュを捨てる
+	void DropFileCache(const std::string& path)
+	{
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) throw std::runtime_error("Failed to open file: " + path);
+		fdatasync(fd);
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		close(fd);
+	}
+
+	// ファイルのページがメモリにある割合を調べる
+	void CountResidentPages(const std::string& path, size_t& resident, size_t& total)
+	{
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) throw std::runtime_error("Failed to open file: " + path);
+
+		struct stat status = {};
+		fstat(fd, &status);
+		size_t size = static_cast<size_t>(status.st_size);
+		if (size > 0)
+		{
+			void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+			if (view != MAP_FAILED)
+			{
+				size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+				std::vector<unsigned char> pages((size + pageSize - 1) / pageSize);
+				if (mincore(view, size, pages.data()) == 0)
+				{
+					for (unsigned char page : pages) resident += page & 1;
+					total += pages.size();
+				}
+				munmap(view, size);
+			}
+		}
+		close(fd);
+	}
+#endif
+
+	// 個別のファイルを読み込む
+	void LoadFiles(const std::vector<std::string>& paths)
+	{
+		for (const std::string& path : paths)
+		{
+			MappedFile file(Widen(path).c_str());
+			TouchPages(file.GetData(), file.GetSize());
+		}
+	}
+
+	// パックから読み込む
+	void LoadPack(const std::string& packPath, const std::vector<std::string>& paths)
+	{
+		ResourcePack pack(Widen(packPath).c_str());
+
+		std::vector<uint8_t> buffer;
+		for (const std::string& path : paths)
+		{
+			const ResourcePackEntry* entry = pack.Find(Widen(path).c_str());
+			if (!entry) throw std::runtime_error("Not in the pack: " + path);
+
+			if (ResourcePack::IsCompressed(*entry))
+			{
+				buffer.resize(static_cast<size_t>(entry->size));
+				pack.Decompress(*entry, buffer.data());
+			}
+			else
+			{
+				TouchPages(pack.GetStoredData(*entry), static_cast<size_t>(entry->size));
+			}
+		}
+	}
+
+	// 読み込みを計測して中央値（ミリ秒）を表示する
+	template <class Load>
+	void Measure(const char* label, const std::vector<std::string>& files, bool cold, int iterations, Load load)
+	{
+		std::vector<double> times;
+		size_t resident = 0;
+		size_t total = 0;
+
+		// warmは一度読み込んでから計る
+		if (!cold) load();
+
+		for (int i = 0; i < iterations; i++)
+		{
+#ifndef _WIN32
+			if (cold)
+			{
+				for (const std::string& file : files) DropFileCache(file);
+				for (const std::string& file : files) CountResidentPages(file, resident, total);
+			}
+#endif
+			Clock::time_point start = Clock::now();
+			load();
+			times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+		}
+
+		std::sort(times.begin(), times.end());
+		std::printf("%-6s %-5s median %8.3f ms  min %8.3f ms  max %8.3f ms", label, cold ? "cold" : "warm",
+			times[times.size() / 2], times.front(), times.back());
+		if (cold && total) std::printf("  resident %.1f%%", 100.0 * resident / total);
+		std::printf("\n");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int first = 1;
+	int iterations = DEFAULT_ITERATIONS;
+	if (first + 1 < argc && std::strcmp(argv[first], "--iterations") == 0)
+	{
+		iterations = std::max(1, std::atoi(argv[first + 1]));
+		first += 2;
+	}
+
+	if (argc - first < 2)
+	{
+		std::fprintf(stderr, "Usage: ResourcePackBench [--iterations <n>] <pack> <file>...\n");
+		return 1;
+	}
+
+	try
+	{
+		std::string packPath = argv[first];
+		std::vector<std::string> paths(argv + first + 1, argv + argc);
+		std::vector<std::string> packFiles(1, packPath);
+
+		std::printf("%zu files, %d iterations\n", paths.size(), iterations);
+
+		auto loose = [&]() { LoadFiles(paths); };
+		auto pack = [&]() { LoadPack(packPath, paths); };
+#ifndef _WIN32
+		Measure("files", paths, true, iterations, loose);
+		Measure("pack", packFiles, true, iterations, pack);
+#endif
+		Measure("files", paths, false, iterations, loose);
+		Measure("pack", packFiles, false, iterations, pack);
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "%s: %s\n", argv[first], e.what());
+		return 1;
+	}
+
+	return 0;
+}
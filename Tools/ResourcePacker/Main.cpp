@@ -0,0 +1,315 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// リソースファイルを一つのパックファイルにまとめるコマンドラインツール
+//
+// Usage: ResourcePacker [--compress] <output.pak> <file | @list>...
+//        指定したファイルをパックファイル（ResourcePack.h）にまとめます。
+//        パスは指定したまま（正規化して）記録するので、ゲームと同じ作業フォルダーで
+//        "Resources/Models/ball.dds" のように相対パスで指定してください。
+//        @listを指定すると、そのファイルの各行をパスとして読み込みます。
+//        --compressを指定すると64KBのブロックごとにLZで圧縮し、1/8以上小さくならない
+//        ファイルは圧縮せずに入れます。書き出した後に読み直し、全てのファイルの中身を確認します。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:ResourcePacker.exe Tools\ResourcePacker\Main.cpp ImaseLib\ResourcePack.cpp ImaseLib\LzCodec.cpp ImaseLib\MappedFile.cpp ImaseLib\Utf8.cpp
+//          g++ -std=c++14 -O2 -o ResourcePacker Tools/ResourcePacker/Main.cpp ImaseLib/ResourcePack.cpp ImaseLib/LzCodec.cpp ImaseLib/MappedFile.cpp ImaseLib/Utf8.cpp
+//
+//        作成例
+//          ResourcePacker --compress Resources.pak Resources/Font/* Resources/Models/*
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/LzCodec.h"
+#include "../../ImaseLib/ResourcePack.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 圧縮するブロックのサイズ
+	const uint32_t BLOCK_SIZE = 64 * 1024;
+
+	// 圧縮後のサイズがこの割合（1/8単位）以上なら圧縮しない
+	const uint64_t MIN_SAVING_EIGHTHS = 7;
+
+	// 入れるファイル
+	struct InputFile
+	{
+		// 指定されたパスと正規化したパス
+		std::string path;
+		std::string name;
+		uint64_t hash;
+
+		// 元の中身とパックに入れる中身
+		std::vector<uint8_t> data;
+		std::vector<uint8_t> stored;
+		ResourceCodec codec;
+	};
+
+	// ファイルを読み込む
+	std::vector<uint8_t> ReadFile(const char* fileName)
+	{
+		std::ifstream file(fileName, std::ios::binary);
+		if (!file) throw std::runtime_error(std::string("Failed to open file: ") + fileName);
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	// ファイルを書き出す
+	void WriteFile(const char* fileName, const std::vector<uint8_t>& data)
+	{
+		std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!file) throw std::runtime_error("Failed to write file.");
+	}
+
+	// 構造体をバイト列の指定位置に書き込む
+	template <class T>
+	void WriteAt(std::vector<uint8_t>& data, uint64_t offset, const T& value)
+	{
+		std::memcpy(data.data() + offset, &value, sizeof(T));
+	}
+
+	// 境界まで0で埋める
+	void Align(std::vector<uint8_t>& data, uint64_t alignment)
+	{
+		data.resize(static_cast<size_t>((data.size() + alignment - 1) / alignment * alignment), 0);
+	}
+
+	// リストファイルのパスを追加する
+	void ReadList(const char* fileName, std::vector<std::string>& paths)
+	{
+		std::ifstream file(fileName);
+		if (!file) throw std::runtime_error(std::string("Failed to open list: ") + fileName);
+
+		std::string line;
+		while (std::getline(file, line))
+		{
+			while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+			if (!line.empty()) paths.push_back(line);
+		}
+	}
+
+	// ブロックごとに圧縮する（小さくならなければfalse）
+	bool Compress(InputFile& file)
+	{
+		size_t size = file.data.size();
+		size_t blockCount = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+		std::vector<uint8_t> stored(blockCount * sizeof(uint32_t));
+		std::vector<uint8_t> block(LzCompressBound(BLOCK_SIZE));
+		for (size_t i = 0; i < blockCount; i++)
+		{
+			const uint8_t* source = file.data.data() + i * BLOCK_SIZE;
+			size_t sourceSize = std::min(static_cast<size_t>(BLOCK_SIZE), size - i * BLOCK_SIZE);
+
+			// 元より小さくならないブロックはそのまま入れる
+			size_t compressedSize = LzCompress(source, sourceSize, block.data(), sourceSize - 1);
+			uint32_t blockStoredSize;
+			if (compressedSize)
+			{
+				blockStoredSize = static_cast<uint32_t>(compressedSize);
+				stored.insert(stored.end(), block.data(), block.data() + compressedSize);
+			}
+			else
+			{
+				blockStoredSize = static_cast<uint32_t>(sourceSize) | RESOURCE_BLOCK_UNCOMPRESSED;
+				stored.insert(stored.end(), source, source + sourceSize);
+			}
+			WriteAt(stored, i * sizeof(uint32_t), blockStoredSize);
+		}
+
+		if (stored.size() * 8 >= size * MIN_SAVING_EIGHTHS) return false;
+
+		file.stored = std::move(stored);
+		file.codec = RESOURCE_CODEC_LZ;
+		return true;
+	}
+
+	// バケットのビット数（バケットの数がエントリの数以上になるようにする）
+	uint32_t GetBucketBits(size_t entryCount)
+	{
+		uint32_t bits = 0;
+		while ((static_cast<size_t>(1) << bits) < entryCount) bits++;
+		return bits;
+	}
+
+	// ハッシュが入るバケット（ハッシュの上位ビット）
+	uint64_t GetBucket(uint64_t hash, uint32_t bucketBits)
+	{
+		return bucketBits ? hash >> (64 - bucketBits) : 0;
+	}
+
+	// パックファイルを作る
+	std::vector<uint8_t> BuildPack(std::vector<InputFile>& files)
+	{
+		// ハッシュの順に並べる（同じハッシュは名前の順）
+		std::sort(files.begin(), files.end(), [](const InputFile& a, const InputFile& b)
+			{
+				return a.hash != b.hash ? a.hash < b.hash : a.name < b.name;
+			});
+		for (size_t i = 1; i < files.size(); i++)
+		{
+			if (files[i].name == files[i - 1].name)
+			{
+				throw std::runtime_error("Duplicate path: " + files[i].path);
+			}
+		}
+
+		ResourcePackHeader header = {};
+		header.magic = RESOURCE_PACK_MAGIC;
+		header.version = RESOURCE_PACK_VERSION;
+		header.entryCount = static_cast<uint32_t>(files.size());
+		header.bucketBits = GetBucketBits(files.size());
+
+		// バケットの表（各バケットの最初のエントリの番号）
+		size_t bucketCount = (static_cast<size_t>(1) << header.bucketBits) + 1;
+		std::vector<uint32_t> buckets(bucketCount, 0);
+		size_t first = 0;
+		for (size_t bucket = 0; bucket < bucketCount; bucket++)
+		{
+			while (first < files.size() && GetBucket(files[first].hash, header.bucketBits) < bucket) first++;
+			buckets[bucket] = static_cast<uint32_t>(first);
+		}
+
+		// パスの文字列
+		std::string names;
+		std::vector<ResourcePackEntry> entries(files.size());
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			entries[i].hash = files[i].hash;
+			entries[i].codec = files[i].codec;
+			entries[i].blockSize = files[i].codec == RESOURCE_CODEC_LZ ? BLOCK_SIZE : 0;
+			entries[i].size = files[i].data.size();
+			entries[i].storedSize = files[i].stored.size();
+			entries[i].nameOffset = static_cast<uint32_t>(names.size());
+			entries[i].nameLength = static_cast<uint32_t>(files[i].name.size());
+			names += files[i].name;
+		}
+
+		// 索引
+		std::vector<uint8_t> output(sizeof(ResourcePackHeader));
+		header.bucketOffset = output.size();
+		output.resize(output.size() + buckets.size() * sizeof(uint32_t));
+		std::memcpy(output.data() + header.bucketOffset, buckets.data(), buckets.size() * sizeof(uint32_t));
+
+		Align(output, alignof(ResourcePackEntry));
+		header.entryOffset = output.size();
+		output.resize(output.size() + entries.size() * sizeof(ResourcePackEntry));
+
+		header.nameOffset = output.size();
+		header.nameSize = names.size();
+		output.insert(output.end(), names.begin(), names.end());
+
+		// 中身（4096バイト境界）
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			Align(output, RESOURCE_PACK_ALIGNMENT);
+			entries[i].offset = output.size();
+			output.insert(output.end(), files[i].stored.begin(), files[i].stored.end());
+		}
+
+		WriteAt(output, 0, header);
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			WriteAt(output, header.entryOffset + i * sizeof(ResourcePackEntry), entries[i]);
+		}
+
+		return output;
+	}
+
+	// 書き出したパックを読み直して中身を確認する
+	void Verify(const std::vector<uint8_t>& output, const std::vector<InputFile>& files)
+	{
+		ResourcePack pack(output.data(), output.size());
+
+		std::vector<uint8_t> data;
+		for (const InputFile& file : files)
+		{
+			const ResourcePackEntry* entry = pack.Find(file.name, HashResourcePath(file.name));
+			if (!entry) throw std::runtime_error("Verification failed, missing: " + file.path);
+
+			data.assign(static_cast<size_t>(entry->size), 0);
+			pack.Decompress(*entry, data.data());
+			if (data != file.data) throw std::runtime_error("Verification failed, content differs: " + file.path);
+		}
+	}
+
+	// パックファイルを作る
+	void Pack(const char* outputName, const std::vector<std::string>& paths, bool compress)
+	{
+		std::vector<InputFile> files;
+		for (const std::string& path : paths)
+		{
+			InputFile file;
+			file.path = path;
+			file.name = NormalizeResourcePath(path.c_str());
+			file.hash = HashResourcePath(file.name);
+			file.data = ReadFile(path.c_str());
+			file.codec = RESOURCE_CODEC_NONE;
+			if (!compress || file.data.empty() || !Compress(file)) file.stored = file.data;
+			files.push_back(std::move(file));
+		}
+
+		std::vector<uint8_t> output = BuildPack(files);
+		Verify(output, files);
+		WriteFile(outputName, output);
+
+		uint64_t total = 0;
+		uint64_t stored = 0;
+		for (const InputFile& file : files)
+		{
+			std::printf("%-40s %10zu -> %10zu %s\n", file.name.c_str(), file.data.size(), file.stored.size(),
+				file.codec == RESOURCE_CODEC_LZ ? "lz" : "none");
+			total += file.data.size();
+			stored += file.stored.size();
+		}
+		std::printf("%s: %zu files, %llu -> %llu bytes, pack %zu bytes\n", outputName, files.size(),
+			static_cast<unsigned long long>(total), static_cast<unsigned long long>(stored), output.size());
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int first = 1;
+	bool compress = false;
+	if (first < argc && std::strcmp(argv[first], "--compress") == 0)
+	{
+		compress = true;
+		first++;
+	}
+
+	if (argc - first < 2)
+	{
+		std::fprintf(stderr, "Usage: ResourcePacker [--compress] <output.pak> <file | @list>...\n");
+		return 1;
+	}
+
+	try
+	{
+		std::vector<std::string> paths;
+		for (int i = first + 1; i < argc; i++)
+		{
+			if (argv[i][0] == '@') ReadList(argv[i] + 1, paths);
+			else paths.push_back(argv[i]);
+		}
+
+		Pack(argv[first], paths, compress);
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "%s: %s\n", argv[first], e.what());
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,329 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// SdkMeshFileで同梱のモデルを読み込むテスト、読み込み時間のベンチマーク、壊れたファイルのテスト
+//
+// Usage: SdkMeshFileTest [--iterations <n>] [--fuzz <n>] [<file>...]
+//        ファイルを指定しなければ Resources/Models の７つの.sdkmeshファイルを使います。
+//        1. 全てのファイルを読み込み、読み込んだテーブルがお互いの範囲に収まっていること
+//           （バッファのデータがファイル内、メッシュからバッファとサブセット、サブセットの描画範囲、
+//           フレームのつながり、名前の終端文字）をSdkMeshFileとは別に確認します。
+//        2. 全てのファイルを、マップして読み込む時間と、ファイルをメモリに読み込んでから
+//           解析する時間（以前のModel::CreateFromSDKMESHと同じ流れ）をn回（既定は200回）計り、
+//           中央値を表示します。
+//        3. 数バイトを乱数で書き換えたり途中で切ったりしたファイルをn個（既定は20,000個）作って
+//           読み込み、例外で拒否されるか、受け入れた場合は1と同じ確認に通ることを確かめます。
+//           全てのバイトを読むので、AddressSanitizerを有効にしてビルドすると範囲外の参照も検出できます。
+//        失敗した項目を表示して1を返します。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:SdkMeshFileTest.exe Tools\SdkMeshFileTest\Main.cpp ImaseLib\SdkMeshFile.cpp ImaseLib\MappedFile.cpp ImaseLib\Utf8.cpp
+//          g++ -std=c++14 -O2 -o SdkMeshFileTest Tools/SdkMeshFileTest/Main.cpp ImaseLib/SdkMeshFile.cpp ImaseLib/MappedFile.cpp ImaseLib/Utf8.cpp
+//          g++ -std=c++14 -O1 -g -fsanitize=address,undefined -o SdkMeshFileTest Tools/SdkMeshFileTest/Main.cpp ImaseLib/SdkMeshFile.cpp ImaseLib/MappedFile.cpp ImaseLib/Utf8.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/SdkMeshFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 同梱のモデル
+	const char* const BUNDLED_MODELS[] =
+	{
+		"Resources/Models/Dice.sdkmesh",
+		"Resources/Models/RingX.sdkmesh",
+		"Resources/Models/RingY.sdkmesh",
+		"Resources/Models/RingZ.sdkmesh",
+		"Resources/Models/ball.sdkmesh",
+		"Resources/Models/floor.sdkmesh",
+		"Resources/Models/player.sdkmesh",
+	};
+
+	// 失敗した数
+	int g_failures = 0;
+
+	void Check(bool condition, const char* message, const std::string& file)
+	{
+		if (condition) return;
+		if (g_failures < 20) std::printf("FAILED: %s (%s)\n", message, file.c_str());
+		g_failures++;
+	}
+
+	// 時間を計る（n回の中央値、ミリ秒）
+	template <class F>
+	double Measure(int iterations, F&& function)
+	{
+		std::vector<double> times;
+		for (int i = 0; i < iterations; i++)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			function();
+			times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		std::sort(times.begin(), times.end());
+		return times[times.size() / 2];
+	}
+
+	std::wstring Widen(const std::string& text)
+	{
+		return std::wstring(text.begin(), text.end());
+	}
+
+	std::vector<uint8_t> ReadFile(const std::string& path)
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (!in) throw std::runtime_error("Could not open the file.");
+		return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	}
+
+	bool IsInside(uint64_t start, uint64_t count, uint64_t limit)
+	{
+		return start <= limit && count <= limit - start;
+	}
+
+	bool IsTerminated(const char* name, size_t size)
+	{
+		return std::memchr(name, '\0', size) != nullptr;
+	}
+
+	// 読み込んだ内容がお互いの範囲に収まっているか確認し、全てのバイトを読む
+	// （SdkMeshFileの確認とは別に書いた、Model::CreateFromSDKMESHが前提にしている条件）
+	bool Validate(const SdkMeshFile& file, uint64_t& sink)
+	{
+		const uint8_t* begin = file.GetData();
+		const uint8_t* end = begin + file.GetSize();
+		bool valid = true;
+
+		for (size_t i = 0; i < file.GetVertexBufferCount(); i++)
+		{
+			const SdkMeshVertexBufferHeader& vertexBuffer = file.GetVertexBuffers()[i];
+			SdkMeshBufferData data = file.GetVertexData(i);
+			valid = valid && data.data >= begin && data.size <= static_cast<size_t>(end - data.data)
+				&& vertexBuffer.strideBytes != 0 && vertexBuffer.numVertices <= data.size / vertexBuffer.strideBytes;
+			if (!valid) return false;
+			for (size_t j = 0; j < data.size; j++) sink += data.data[j];
+		}
+
+		for (size_t i = 0; i < file.GetIndexBufferCount(); i++)
+		{
+			const SdkMeshIndexBufferHeader& indexBuffer = file.GetIndexBuffers()[i];
+			SdkMeshBufferData data = file.GetIndexData(i);
+			uint64_t indexSize = indexBuffer.indexType == SDKMESH_INDEX_32 ? 4 : 2;
+			valid = valid && data.data >= begin && data.size <= static_cast<size_t>(end - data.data)
+				&& indexBuffer.indexType <= SDKMESH_INDEX_32 && indexBuffer.numIndices <= data.size / indexSize;
+			if (!valid) return false;
+			for (size_t j = 0; j < data.size; j++) sink += data.data[j];
+		}
+
+		for (size_t i = 0; i < file.GetSubsetCount(); i++)
+		{
+			const SdkMeshSubset& subset = file.GetSubsets()[i];
+			valid = valid && IsTerminated(subset.name, sizeof(subset.name)) && subset.materialId < file.GetMaterialCount();
+		}
+
+		for (size_t i = 0; i < file.GetMeshCount() && valid; i++)
+		{
+			const SdkMeshMesh& mesh = file.GetMeshes()[i];
+			valid = IsTerminated(mesh.name, sizeof(mesh.name))
+				&& mesh.numVertexBuffers > 0 && mesh.numVertexBuffers <= SDKMESH_MAX_VERTEX_STREAMS
+				&& mesh.indexBuffer < file.GetIndexBufferCount();
+			for (uint32_t j = 0; j < mesh.numVertexBuffers && valid; j++)
+			{
+				valid = mesh.vertexBuffers[j] < file.GetVertexBufferCount();
+			}
+			if (!valid) return false;
+
+			const uint64_t numIndices = file.GetIndexBuffers()[mesh.indexBuffer].numIndices;
+			const uint64_t numVertices = file.GetVertexBuffers()[mesh.vertexBuffers[0]].numVertices;
+			const uint32_t* subsets = file.GetMeshSubsets(i);
+			for (uint32_t j = 0; j < mesh.numSubsets && valid; j++)
+			{
+				valid = subsets[j] < file.GetSubsetCount();
+				if (!valid) break;
+
+				const SdkMeshSubset& subset = file.GetSubsets()[subsets[j]];
+				valid = IsInside(subset.indexStart, subset.indexCount, numIndices) && IsInside(subset.vertexStart, subset.vertexCount, numVertices);
+			}
+
+			const uint32_t* influences = file.GetMeshFrameInfluences(i);
+			for (uint32_t j = 0; j < mesh.numFrameInfluences; j++) sink += influences[j];
+		}
+
+		for (size_t i = 0; i < file.GetFrameCount() && valid; i++)
+		{
+			const SdkMeshFrame& frame = file.GetFrames()[i];
+			auto isLink = [&](uint32_t link) { return link == SDKMESH_INVALID_FRAME || link < file.GetFrameCount(); };
+			valid = IsTerminated(frame.name, sizeof(frame.name))
+				&& (frame.mesh == SDKMESH_INVALID_FRAME || frame.mesh < file.GetMeshCount())
+				&& isLink(frame.parentFrame) && isLink(frame.childFrame) && isLink(frame.siblingFrame);
+		}
+
+		for (size_t i = 0; i < file.GetMaterialCount() && valid; i++)
+		{
+			const SdkMeshMaterial& material = file.GetMaterials()[i];
+			valid = IsTerminated(material.name, sizeof(material.name));
+			if (valid && file.GetHeader().version == SDKMESH_FILE_VERSION)
+			{
+				valid = IsTerminated(material.diffuseTexture, sizeof(material.diffuseTexture))
+					&& IsTerminated(material.normalTexture, sizeof(material.normalTexture))
+					&& IsTerminated(material.specularTexture, sizeof(material.specularTexture));
+				if (valid) sink += std::strlen(material.diffuseTexture);
+			}
+		}
+
+		return valid;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int iterations = 200;
+	int fuzzCount = 20000;
+	std::vector<std::string> paths;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+		{
+			iterations = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--fuzz") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) >= 0)
+		{
+			fuzzCount = std::atoi(argv[++i]);
+		}
+		else if (argv[i][0] != '-')
+		{
+			paths.push_back(argv[i]);
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: SdkMeshFileTest [--iterations <n>] [--fuzz <n>] [<file>...]\n");
+			return 1;
+		}
+	}
+	if (paths.empty())
+	{
+		paths.assign(std::begin(BUNDLED_MODELS), std::end(BUNDLED_MODELS));
+	}
+
+	uint64_t sink = 0;
+
+	// 1. 全てのファイルの読み込み
+	std::vector<std::vector<uint8_t>> contents;
+	for (const std::string& path : paths)
+	{
+		try
+		{
+			SdkMeshFile file(Widen(path).c_str());
+			contents.push_back(ReadFile(path));
+
+			size_t vertices = 0;
+			size_t indices = 0;
+			for (size_t i = 0; i < file.GetVertexBufferCount(); i++) vertices += static_cast<size_t>(file.GetVertexBuffers()[i].numVertices);
+			for (size_t i = 0; i < file.GetIndexBufferCount(); i++) indices += static_cast<size_t>(file.GetIndexBuffers()[i].numIndices);
+			std::printf("%-32s v%u  %zu meshes, %zu subsets, %zu frames, %zu materials, %zu vertices, %zu indices\n",
+				path.c_str(), file.GetHeader().version, file.GetMeshCount(), file.GetSubsetCount(), file.GetFrameCount(),
+				file.GetMaterialCount(), vertices, indices);
+
+			Check(file.GetMeshCount() > 0 && file.GetVertexBufferCount() > 0 && file.GetIndexBufferCount() > 0, "has geometry", path);
+			Check(Validate(file, sink), "tables are consistent", path);
+
+			// メモリ上の内容からも同じように読める
+			const std::vector<uint8_t>& bytes = contents.back();
+			SdkMeshFile copy(bytes.data(), bytes.size());
+			Check(copy.GetSize() == file.GetSize() && std::memcmp(copy.GetData(), file.GetData(), file.GetSize()) == 0
+				&& copy.GetSubsetCount() == file.GetSubsetCount(), "memory overload matches the mapped file", path);
+		}
+		catch (const std::exception& e)
+		{
+			std::printf("FAILED: %s: %s\n", path.c_str(), e.what());
+			g_failures++;
+		}
+	}
+
+	if (contents.size() != paths.size())
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+
+	// 2. 読み込み時間
+	double mapped = Measure(iterations, [&]()
+		{
+			for (const std::string& path : paths)
+			{
+				SdkMeshFile file(Widen(path).c_str());
+				sink += file.GetVertexData(0).data[0];
+			}
+		});
+	double heap = Measure(iterations, [&]()
+		{
+			for (const std::string& path : paths)
+			{
+				std::vector<uint8_t> bytes = ReadFile(path);
+				SdkMeshFile file(bytes.data(), bytes.size());
+				sink += file.GetVertexData(0).data[0];
+			}
+		});
+	std::printf("load all %zu files: mapped %.1f us, read into memory %.1f us (median of %d)\n",
+		paths.size(), mapped * 1000.0, heap * 1000.0, iterations);
+
+	// 3. 壊れたファイル
+	std::mt19937 random(1);
+	int accepted = 0;
+	int rejected = 0;
+	for (int i = 0; i < fuzzCount; i++)
+	{
+		size_t index = i % contents.size();
+		std::vector<uint8_t> bytes = contents[index];
+
+		// 数バイトを書き換え、たまに途中で切る（ヘッダーとテーブルを狙って前半を多めに）
+		int changes = 1 + static_cast<int>(random() % 4);
+		for (int j = 0; j < changes; j++)
+		{
+			size_t limit = random() % 2 ? bytes.size() : std::min<size_t>(bytes.size(), 4096);
+			bytes[random() % limit] = static_cast<uint8_t>(random());
+		}
+		if (random() % 8 == 0)
+		{
+			bytes.resize(random() % bytes.size());
+		}
+
+		// 切った後ろを読むとAddressSanitizerで検出できるように、ちょうどの大きさの配列にコピーする
+		std::vector<uint8_t> exact(bytes.begin(), bytes.end());
+
+		try
+		{
+			SdkMeshFile file(exact.data(), exact.size());
+			Check(Validate(file, sink), "accepted a corrupted file that is not consistent", paths[index]);
+			accepted++;
+		}
+		catch (const std::runtime_error&)
+		{
+			rejected++;
+		}
+	}
+	std::printf("corrupted copies: %d rejected, %d accepted and consistent (sink %llu)\n",
+		rejected, accepted, static_cast<unsigned long long>(sink & 0xff));
+
+	if (g_failures > 0)
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}
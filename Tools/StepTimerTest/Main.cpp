@@ -0,0 +1,391 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// StepTimerのテスト
+//
+// Usage: StepTimerTest
+//        次のことを確認します。
+//          ・BasicStepTimer<SteadyClock>を実際に眠りながら動かし、同じカウンタの値の並びを
+//            BasicStepTimer<ManualClock>で再生すると、各Tickの更新回数、経過時間、合計時間、
+//            補間の値、統計が全て一致する（時間の計算は全て整数なので時計によらない）
+//          ・FrameTimeHistoryのパーセンタイル（最近傍順位）、最小、最大、平均、予算超えの数、
+//            リングバッファが一周した時に古い値を捨てること
+//          ・Tickと統計の取得がメモリを確保しないこと（operator newを数える）
+//          ・SetMaxUpdatesPerTickで１回のTickの更新回数が制限され、残りの時間が次のTickに
+//            持ち越されること。SetDropExcessTimeでは捨てた時間が記録されること
+//          ・大きすぎる経過時間が0.1秒に切り詰められ、切り詰めた時間が記録されること
+//          ・GetInterpolationAlphaが次の更新までの割合を返すこと
+//        実際に眠るのは最初の確認だけで、約２秒かかります。失敗した項目を表示して1を返します。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:StepTimerTest.exe Tools\StepTimerTest\Main.cpp winmm.lib
+//          g++ -std=c++14 -O2 -o StepTimerTest Tools/StepTimerTest/Main.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../StepTimer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace DX;
+
+namespace
+{
+	// operator newが呼ばれた回数
+	uint64_t g_allocationCount = 0;
+}
+
+void* operator new(std::size_t size)
+{
+	g_allocationCount++;
+	void* memory = std::malloc(size ? size : 1);
+	if (!memory) throw std::bad_alloc();
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+namespace
+{
+	typedef BasicStepTimer<ManualClock> ManualTimer;
+
+	// 1ステップ（60Hz）のティック数
+	const uint64_t STEP = StepTimer::TicksPerSecond / 60;
+
+	// 失敗した数
+	int g_failures = 0;
+
+	void Check(bool condition, const char* message, int line)
+	{
+		if (condition) return;
+		if (g_failures < 20) std::printf("FAILED: %s (line %d)\n", message, line);
+		g_failures++;
+	}
+
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+	bool IsSame(const FrameTimeStatistics& a, const FrameTimeStatistics& b)
+	{
+		return a.sampleCount == b.sampleCount && a.minTicks == b.minTicks && a.averageTicks == b.averageTicks
+			&& a.p50Ticks == b.p50Ticks && a.p95Ticks == b.p95Ticks && a.p99Ticks == b.p99Ticks
+			&& a.maxTicks == b.maxTicks && a.overBudgetCount == b.overBudgetCount;
+	}
+
+	// 読んだカウンタの値を記録するSteadyClock
+	class RecordingSteadyClock : public SteadyClock
+	{
+	public:
+
+		explicit RecordingSteadyClock(std::vector<uint64_t>* counters = nullptr) : m_counters(counters) {}
+
+		uint64_t GetCounter() const
+		{
+			uint64_t counter = SteadyClock::GetCounter();
+			if (m_counters) m_counters->push_back(counter);
+			return counter;
+		}
+
+	private:
+
+		std::vector<uint64_t>* m_counters;
+	};
+
+	// １回のTickの結果
+	struct TickResult
+	{
+		uint32_t updates;
+		uint64_t elapsedTicks;
+		uint64_t totalTicks;
+		uint32_t frameCount;
+		uint64_t droppedTicks;
+		uint64_t deltaClampCount;
+		uint64_t updateLimitHitCount;
+		double alpha;
+
+		bool operator==(const TickResult& other) const
+		{
+			return updates == other.updates && elapsedTicks == other.elapsedTicks && totalTicks == other.totalTicks
+				&& frameCount == other.frameCount && droppedTicks == other.droppedTicks && deltaClampCount == other.deltaClampCount
+				&& updateLimitHitCount == other.updateLimitHitCount && alpha == other.alpha;
+		}
+	};
+
+	template <class TTimer>
+	TickResult GetResult(const TTimer& timer, uint32_t updates)
+	{
+		return { updates, timer.GetElapsedTicks(), timer.GetTotalTicks(), timer.GetFrameCount(), timer.GetDroppedTicks(),
+			timer.GetDeltaClampCount(), timer.GetUpdateLimitHitCount(), timer.GetInterpolationAlpha() };
+	}
+
+	template <class TTimer>
+	void Configure(TTimer& timer, bool fixedTimeStep)
+	{
+		timer.SetFixedTimeStep(fixedTimeStep);
+		timer.SetMaxUpdatesPerTick(4);
+		timer.SetDropExcessTime(true);
+	}
+
+	// SteadyClockで動かした結果を、同じカウンタの値でManualClockで再生して比べる
+	void TestSteadyClockReplay(bool fixedTimeStep)
+	{
+		// 眠る時間（ミリ秒）。切り詰めと更新回数の制限に掛かる長いフレームも入れる
+		const int sleeps[] = { 3, 16, 17, 5, 40, 150, 1, 33, 70, 16 };
+		const int tickCount = 40;
+
+		std::vector<uint64_t> counters;
+		BasicStepTimer<RecordingSteadyClock> steadyTimer{ RecordingSteadyClock(&counters) };
+		Configure(steadyTimer, fixedTimeStep);
+
+		// Tickごとに読んだカウンタの値（最初は開始時刻、２つ目があれば更新の終わり）
+		std::vector<std::vector<uint64_t>> tickCounters;
+		std::vector<TickResult> steadyResults;
+		uint64_t start = counters.front();
+		for (int i = 0; i < tickCount; i++)
+		{
+			steadyTimer.GetClock().SleepFor(static_cast<uint64_t>(sleeps[i % 10]) * steadyTimer.GetClock().GetFrequency() / 1000);
+
+			size_t first = counters.size();
+			uint32_t updates = 0;
+			steadyTimer.Tick([&]() { updates++; });
+			tickCounters.emplace_back(counters.begin() + first, counters.end());
+			steadyResults.push_back(GetResult(steadyTimer, updates));
+		}
+		const uint64_t wallTicks = (tickCounters.back().front() - start) * StepTimer::TicksPerSecond / SteadyClock().GetFrequency();
+
+		// 同じ値をManualClockで再生する
+		BasicStepTimer<ManualClock> manualTimer{ ManualClock(SteadyClock().GetFrequency()) };
+		manualTimer.GetClock().SetCounter(start);
+		manualTimer.ResetElapsedTime();
+		Configure(manualTimer, fixedTimeStep);
+
+		bool same = true;
+		for (int i = 0; i < tickCount; i++)
+		{
+			const std::vector<uint64_t>& values = tickCounters[i];
+			manualTimer.GetClock().SetCounter(values[0]);
+
+			uint32_t updates = 0;
+			manualTimer.Tick([&]()
+				{
+					updates++;
+					if (values.size() > 1) manualTimer.GetClock().SetCounter(values[1]);
+				});
+			same = same && GetResult(manualTimer, updates) == steadyResults[i];
+		}
+		CHECK(same);
+		CHECK(IsSame(manualTimer.GetFrameStatistics(), steadyTimer.GetFrameStatistics()));
+		CHECK(IsSame(manualTimer.GetUpdateStatistics(), steadyTimer.GetUpdateStatistics()));
+		CHECK(manualTimer.GetFramesPerSecond() == steadyTimer.GetFramesPerSecond());
+		CHECK(manualTimer.GetTotalFramesOverBudget() == steadyTimer.GetTotalFramesOverBudget());
+
+		// 150ミリ秒のフレームは切り詰められ、経過時間の合計は切り詰めた分だけ短い
+		CHECK(steadyTimer.GetDeltaClampCount() >= static_cast<uint64_t>(tickCount / 10));
+		if (fixedTimeStep)
+		{
+			// 目標に近い経過時間は目標に揃えるので、その分（Tickごとに1/4ミリ秒未満）はずれる
+			const int64_t leftOver = static_cast<int64_t>(steadyTimer.GetInterpolationAlpha() * STEP + 0.5);
+			const int64_t accounted = static_cast<int64_t>(steadyTimer.GetTotalTicks() + steadyTimer.GetDroppedTicks()) + leftOver;
+			CHECK(std::abs(accounted - static_cast<int64_t>(wallTicks)) <= tickCount * static_cast<int64_t>(StepTimer::TicksPerSecond / 4000 + 1));
+			CHECK(steadyTimer.GetTotalTicks() == static_cast<uint64_t>(steadyTimer.GetFrameCount()) * STEP);
+		}
+		else
+		{
+			CHECK(steadyTimer.GetFrameCount() == static_cast<uint32_t>(tickCount));
+			CHECK(steadyTimer.GetTotalTicks() + steadyTimer.GetDroppedTicks() <= wallTicks
+				&& steadyTimer.GetTotalTicks() + steadyTimer.GetDroppedTicks() + tickCount >= wallTicks);
+		}
+
+		std::printf("%s replay: %d ticks, %u updates, %.3f s total, %.3f s dropped, %llu clamps\n",
+			fixedTimeStep ? "fixed   " : "variable", tickCount, steadyTimer.GetFrameCount(), steadyTimer.GetTotalSeconds(),
+			StepTimer::TicksToSeconds(steadyTimer.GetDroppedTicks()), static_cast<unsigned long long>(steadyTimer.GetDeltaClampCount()));
+	}
+
+	// パーセンタイル
+	void TestFrameTimeHistory()
+	{
+		FrameTimeHistory history;
+		CHECK(history.Compute(0).sampleCount == 0);
+
+		// 1～100を順番を崩して入れる
+		for (uint64_t i = 0; i < 100; i++)
+		{
+			history.Record((i * 37) % 100 + 1);
+		}
+		FrameTimeStatistics stats = history.Compute(90);
+		CHECK(stats.sampleCount == 100);
+		CHECK(stats.minTicks == 1 && stats.maxTicks == 100 && stats.averageTicks == 50);
+		CHECK(stats.p50Ticks == 50 && stats.p95Ticks == 95 && stats.p99Ticks == 99);
+		CHECK(stats.overBudgetCount == 10);
+		CHECK(history.Compute(0).overBudgetCount == 0);
+
+		// 最近傍順位：３つの値の50パーセンタイルは２番目、99パーセンタイルは最大
+		FrameTimeHistory small;
+		small.Record(30);
+		small.Record(10);
+		small.Record(20);
+		stats = small.Compute(0);
+		CHECK(stats.p50Ticks == 20 && stats.p95Ticks == 30 && stats.p99Ticks == 30);
+
+		// 一周すると古い値を捨てる（最後の256個だけが残る）
+		FrameTimeHistory ring;
+		for (uint64_t i = 0; i < FrameTimeHistory::Capacity; i++) ring.Record(1000);
+		for (uint64_t i = 0; i < FrameTimeHistory::Capacity; i++) ring.Record(i + 1);
+		stats = ring.Compute(0);
+		CHECK(stats.sampleCount == FrameTimeHistory::Capacity);
+		CHECK(stats.minTicks == 1 && stats.maxTicks == FrameTimeHistory::Capacity);
+		CHECK(stats.p50Ticks == FrameTimeHistory::Capacity / 2);
+
+		ring.Clear();
+		CHECK(ring.Compute(0).sampleCount == 0);
+	}
+
+	// Tickと統計の取得はメモリを確保しない
+	void TestNoAllocation()
+	{
+		ManualTimer timer;
+		timer.SetFixedTimeStep(true);
+		timer.SetMaxUpdatesPerTick(3);
+
+		uint64_t updates = 0;
+		const uint64_t before = g_allocationCount;
+		for (int i = 0; i < 1000; i++)
+		{
+			timer.GetClock().Advance(STEP / 2 + (i % 7) * STEP);
+			timer.Tick([&]()
+				{
+					updates++;
+					timer.GetClock().Advance(STEP / 10);
+				});
+			FrameTimeStatistics frame = timer.GetFrameStatistics();
+			FrameTimeStatistics update = timer.GetUpdateStatistics();
+			updates += frame.p99Ticks == 0 || update.p99Ticks == 0;
+		}
+		CHECK(g_allocationCount == before);
+		CHECK(updates > 1000);
+
+		std::printf("no allocation: %llu allocations in 1000 ticks\n", static_cast<unsigned long long>(g_allocationCount - before));
+	}
+
+	// 更新回数の制限
+	void TestCatchUpLimit()
+	{
+		// 持ち越す場合
+		{
+			ManualTimer timer;
+			timer.SetFixedTimeStep(true);
+			timer.SetMaxUpdatesPerTick(3);
+
+			uint32_t updates = 0;
+			timer.GetClock().Advance(5 * STEP);
+			timer.Tick([&]() { updates++; });
+			CHECK(updates == 3 && timer.GetLastUpdateCount() == 3);
+			CHECK(timer.GetUpdateLimitHitCount() == 1 && timer.GetDroppedTicks() == 0);
+
+			// 持ち越した２ステップ分は１を超えるので補間の値は1
+			CHECK(timer.GetInterpolationAlpha() == 1.0);
+
+			updates = 0;
+			timer.Tick([&]() { updates++; });
+			CHECK(updates == 2 && timer.GetUpdateLimitHitCount() == 1);
+			CHECK(timer.GetTotalTicks() == 5 * STEP);
+		}
+
+		// 捨てる場合
+		{
+			ManualTimer timer;
+			timer.SetFixedTimeStep(true);
+			timer.SetMaxUpdatesPerTick(3);
+			timer.SetDropExcessTime(true);
+
+			uint32_t updates = 0;
+			timer.GetClock().Advance(5 * STEP + STEP / 4);
+			timer.Tick([&]() { updates++; });
+			CHECK(updates == 3 && timer.GetUpdateLimitHitCount() == 1);
+			CHECK(timer.GetDroppedTicks() == 2 * STEP);
+
+			// ステップの途中の分は残るので補間に使える
+			CHECK(std::fabs(timer.GetInterpolationAlpha() - 0.25) < 1e-3);
+
+			updates = 0;
+			timer.Tick([&]() { updates++; });
+			CHECK(updates == 0 && timer.GetTotalTicks() == 3 * STEP);
+		}
+
+		// 大きすぎる経過時間は0.1秒に切り詰める
+		{
+			ManualTimer timer;
+			timer.GetClock().AdvanceSeconds(2.0);
+			timer.Tick([]() {});
+			CHECK(timer.GetDeltaClampCount() == 1);
+			CHECK(timer.GetElapsedTicks() == StepTimer::TicksPerSecond / 10);
+			CHECK(timer.GetDroppedTicks() == StepTimer::TicksPerSecond * 19 / 10);
+
+			// フレーム時間の統計には切り詰める前の時間が入る
+			CHECK(timer.GetFrameStatistics().maxTicks == 2 * StepTimer::TicksPerSecond);
+			CHECK(timer.GetTotalFramesOverBudget() == 1);
+		}
+	}
+
+	// 補間の値
+	void TestInterpolationAlpha()
+	{
+		ManualTimer timer;
+		CHECK(timer.GetInterpolationAlpha() == 1.0);
+
+		timer.SetFixedTimeStep(true);
+		timer.GetClock().Advance(STEP + STEP / 2);
+		uint32_t updates = 0;
+		timer.Tick([&]() { updates++; });
+		CHECK(updates == 1);
+		CHECK(std::fabs(timer.GetInterpolationAlpha() - 0.5) < 1e-3);
+
+		// 残りと合わせて１ステップになれば更新して0に戻る
+		timer.GetClock().Advance(STEP / 2);
+		timer.Tick([&]() { updates++; });
+		CHECK(updates == 2 && timer.GetInterpolationAlpha() < 1e-3);
+
+		timer.GetClock().Advance(STEP / 4);
+		timer.Tick([&]() { updates++; });
+		CHECK(updates == 2 && std::fabs(timer.GetInterpolationAlpha() - 0.25) < 1e-3);
+
+		// ResetElapsedTimeで持ち越しを捨てる
+		timer.ResetElapsedTime();
+		CHECK(timer.GetInterpolationAlpha() == 0.0);
+
+		// 可変ステップでは常に1
+		timer.SetFixedTimeStep(false);
+		timer.GetClock().Advance(STEP / 3);
+		timer.Tick([]() {});
+		CHECK(timer.GetInterpolationAlpha() == 1.0);
+	}
+}
+
+int main()
+{
+	TestFrameTimeHistory();
+	TestNoAllocation();
+	TestCatchUpLimit();
+	TestInterpolationAlpha();
+	TestSteadyClockReplay(false);
+	TestSteadyClockReplay(true);
+
+	if (g_failures > 0)
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}
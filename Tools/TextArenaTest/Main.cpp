@@ -0,0 +1,290 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// TextArenaのテストと、DebugFont::AddStringの以前の方法との速度の比較
+//
+// Usage: TextArenaTest [--frames <n>]
+//        operator newを数える版に置き換えて、DebugFontと同じ使い方（1フレームに1,000個の
+//        文字列をFormat関数で追加し、描画後にReset関数と配列のclear）をnフレーム（既定は200）
+//        繰り返し、最初の数フレームの後はメモリの確保が１回も発生しないことを確認します。
+//        以前のAddString（長さを求めるswprintf、unique_ptrのバッファ、std::wstringへのコピー）と
+//        １フレームあたりの時間とメモリの確保回数を比べて表示します。
+//        格納位置が拡張の後も有効なこと、長すぎる書式の展開が例外になることも確認し、
+//        失敗した項目を表示して1を返します。
+//        ※Linux（glibc）のswprintfは長さだけを求められないので、以前の方法は一時バッファに
+//          書き込んで長さを求めます。MSVCでは_scwprintfを使います。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:TextArenaTest.exe Tools\TextArenaTest\Main.cpp ImaseLib\TextArena.cpp
+//          g++ -std=c++14 -O2 -o TextArenaTest Tools/TextArenaTest/Main.cpp ImaseLib/TextArena.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/TextArena.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// １フレームに追加する文字列の数
+	const int STRINGS_PER_FRAME = 1000;
+
+	// メモリの確保を数え始めるまでのフレーム数（容量が安定するまで）
+	const int WARM_UP_FRAMES = 3;
+
+	// operator newが呼ばれた回数
+	size_t g_allocations = 0;
+
+	// 失敗した数
+	int g_failures = 0;
+
+	void Check(bool condition, const char* message)
+	{
+		if (condition) return;
+		if (g_failures < 20) std::printf("FAILED: %s\n", message);
+		g_failures++;
+	}
+
+	// DebugFontの文字列情報（位置、色、スケールは同じ）
+	struct OldString
+	{
+		float pos[2];
+		std::wstring string;
+		float color[4];
+		float scale;
+	};
+
+	struct NewString
+	{
+		float pos[2];
+		TextSpan string;
+		float color[4];
+		float scale;
+	};
+
+	// 以前のDebugFont::AddString
+	template <class... Args>
+	void OldAddString(std::vector<OldString>& strings, int x, int y, const wchar_t* format, const Args& ... args)
+	{
+#ifdef _MSC_VER
+		int textLength = _scwprintf(format, args ...);
+#else
+		wchar_t measure[1024];
+		int textLength = std::swprintf(measure, 1024, format, args ...);
+#endif
+		if (textLength < 0)
+		{
+			throw std::runtime_error("String Formatting Error.");
+		}
+
+		size_t bufferSize = textLength + sizeof(L'\0');
+		std::unique_ptr<wchar_t[]> buffer = std::make_unique<wchar_t[]>(bufferSize);
+		std::swprintf(buffer.get(), bufferSize, format, args ...);
+
+		OldString str;
+		str.string = buffer.get();
+		str.pos[0] = static_cast<float>(x);
+		str.pos[1] = static_cast<float>(y);
+		str.scale = 1.0f;
+		strings.push_back(str);
+	}
+
+	// 現在のDebugFont::AddString
+	template <class... Args>
+	void NewAddString(TextArena& arena, std::vector<NewString>& strings, int x, int y, const wchar_t* format, const Args& ... args)
+	{
+		NewString str;
+		str.string = arena.Format(format, args ...);
+		str.pos[0] = static_cast<float>(x);
+		str.pos[1] = static_cast<float>(y);
+		str.scale = 1.0f;
+		strings.push_back(str);
+	}
+
+	// Game::Renderのプロファイラの表示に近い文字列
+	template <class AddFunction>
+	void AddFrameStrings(AddFunction&& add, unsigned int frame)
+	{
+		for (int i = 0; i < STRINGS_PER_FRAME; i++)
+		{
+			add(i, i * 16, L"%ls %.3fms self=%.3fms x%u", L"Render", i * 0.013, i * 0.007, frame);
+		}
+	}
+}
+
+// メモリの確保を数える
+void* operator new(size_t size)
+{
+	g_allocations++;
+	void* p = std::malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+int main(int argc, char* argv[])
+{
+	int frames = 200;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > WARM_UP_FRAMES)
+		{
+			frames = std::atoi(argv[++i]);
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: TextArenaTest [--frames <n>]\n");
+			return 1;
+		}
+	}
+
+	// 格納位置は拡張の後も有効
+	{
+		TextArena arena(16);
+		std::vector<TextSpan> spans;
+		for (int i = 0; i < 500; i++)
+		{
+			spans.push_back(i % 2 ? arena.Format(L"line %d of %ls", i, L"test") : arena.Append(L"appended"));
+		}
+		Check(arena.GetCapacity() >= arena.GetUsed(), "capacity covers the used characters");
+
+		bool same = true;
+		for (int i = 0; i < 500; i++)
+		{
+			wchar_t expected[64];
+			std::swprintf(expected, 64, i % 2 ? L"line %d of %ls" : L"appended", i, L"test");
+			same = same && std::wcscmp(arena.GetText(spans[i]), expected) == 0 && spans[i].length == std::wcslen(expected);
+		}
+		Check(same, "texts survive growth");
+
+		arena.Reset();
+		Check(arena.GetUsed() == 0, "Reset empties the arena");
+		Check(std::wcscmp(arena.GetText(arena.Append(L"")), L"") == 0, "empty string");
+	}
+
+	// 長すぎる書式の展開は例外
+	{
+		TextArena arena;
+		bool thrown = false;
+		try
+		{
+			arena.Format(L"%*d", static_cast<int>(TextArena::MAX_STRING_LENGTH) + 100, 1);
+		}
+		catch (const std::runtime_error&)
+		{
+			thrown = true;
+		}
+		Check(thrown, "formatting past MAX_STRING_LENGTH throws");
+	}
+
+	std::printf("%d strings per frame, %d frames\n", STRINGS_PER_FRAME, frames);
+
+	// 以前の方法
+	double oldMilliseconds = 0.0;
+	size_t oldAllocations = 0;
+	{
+		std::vector<OldString> strings;
+		for (int frame = 0; frame < frames; frame++)
+		{
+			size_t allocations = g_allocations;
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			AddFrameStrings([&](int x, int y, const wchar_t* format, const wchar_t* name, double a, double b, unsigned int c)
+				{
+					OldAddString(strings, x, y, format, name, a, b, c);
+				}, static_cast<unsigned int>(frame));
+			strings.clear();
+			if (frame >= WARM_UP_FRAMES)
+			{
+				oldMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+				oldAllocations += g_allocations - allocations;
+			}
+		}
+	}
+
+	// TextArena
+	double newMilliseconds = 0.0;
+	size_t newAllocations = 0;
+	size_t warmUpAllocations = 0;
+	{
+		TextArena arena;
+		std::vector<NewString> strings;
+		std::wstring first;
+		bool firstSame = true;
+		for (int frame = 0; frame < frames; frame++)
+		{
+			size_t allocations = g_allocations;
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			AddFrameStrings([&](int x, int y, const wchar_t* format, const wchar_t* name, double a, double b, unsigned int c)
+				{
+					NewAddString(arena, strings, x, y, format, name, a, b, c);
+				}, 0);
+			double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			// 描画の代わりに文字列を確認する
+			if (frame == 0) first = arena.GetText(strings[STRINGS_PER_FRAME - 1].string);
+			else firstSame = firstSame && first == arena.GetText(strings[STRINGS_PER_FRAME - 1].string);
+
+			strings.clear();
+			arena.Reset();
+
+			if (frame >= WARM_UP_FRAMES)
+			{
+				newMilliseconds += milliseconds;
+				newAllocations += g_allocations - allocations;
+			}
+			else
+			{
+				warmUpAllocations += g_allocations - allocations;
+			}
+		}
+		Check(firstSame, "the same strings every frame");
+	}
+
+	int measured = frames - WARM_UP_FRAMES;
+	std::printf("old path  %8.3f ms/frame %8.1f allocations/frame\n", oldMilliseconds / measured, static_cast<double>(oldAllocations) / measured);
+	std::printf("TextArena %8.3f ms/frame %8.1f allocations/frame (%zu during the first %d frames)\n",
+		newMilliseconds / measured, static_cast<double>(newAllocations) / measured, warmUpAllocations, WARM_UP_FRAMES);
+
+	Check(newAllocations == 0, "no allocations after warm-up");
+
+	if (g_failures > 0)
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}
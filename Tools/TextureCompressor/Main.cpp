@@ -0,0 +1,624 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// DDSテクスチャをBC1、BC3、BC4形式に圧縮するコマンドラインツール
+//
+// Usage: TextureCompressor [options] <file.dds | directory>...
+//          --format auto|bc1|bc3|bc4   圧縮形式（既定はauto）
+//          --quality fast|normal|high  品質（既定はnormal）
+//          --threads <n>               スレッドの数（既定はCPUのスレッド数 - 1）
+//          --simd scalar|sse2|avx2     使う命令セットの上限（速度の比較用）
+//          --output <directory>        書き出すフォルダー（指定しなければ結果の表示だけ）
+//        フォルダーを指定すると、その中の全ての.ddsファイルを圧縮します。
+//        元の形式はRGBA8、BGRA8、BGRX8（sRGBを含む）とR8、A8に対応し、全てのミップマップと
+//        配列の要素を圧縮します。autoは次のように形式を選びます。
+//          R8、A8、またはグレースケールで不透明 → BC4（値は赤のチャンネルとして読まれます）
+//          不透明、またはアルファが0と255だけ  → BC1（アルファが128未満のピクセルは透明）
+//          それ以外                            → BC3
+//        ファイルごとに最も詳細なミップマップのPSNR（RGBとアルファ）、サイズ、時間を表示します。
+//        書き出したファイルは読み直して確認します。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:TextureCompressor.exe Tools\TextureCompressor\Main.cpp ImaseLib\BlockCompression.cpp ImaseLib\CpuFeatures.cpp ImaseLib\DdsFile.cpp ImaseLib\MappedFile.cpp ImaseLib\ThreadPool.cpp
+//          g++ -std=c++14 -O2 -pthread -o TextureCompressor Tools/TextureCompressor/Main.cpp ImaseLib/BlockCompression.cpp ImaseLib/CpuFeatures.cpp ImaseLib/DdsFile.cpp ImaseLib/MappedFile.cpp ImaseLib/ThreadPool.cpp ImaseLib/Utf8.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/BlockCompression.h"
+#include "../../ImaseLib/DdsFile.h"
+#include "../../ImaseLib/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+using namespace Imase;
+
+namespace
+{
+	// DXGI_FORMATの値
+	const uint32_t FORMAT_R8G8B8A8_UNORM = 28;
+	const uint32_t FORMAT_R8G8B8A8_UNORM_SRGB = 29;
+	const uint32_t FORMAT_R8_UNORM = 61;
+	const uint32_t FORMAT_A8_UNORM = 65;
+	const uint32_t FORMAT_BC1_UNORM = 71;
+	const uint32_t FORMAT_BC1_UNORM_SRGB = 72;
+	const uint32_t FORMAT_BC3_UNORM = 77;
+	const uint32_t FORMAT_BC3_UNORM_SRGB = 78;
+	const uint32_t FORMAT_BC4_UNORM = 80;
+	const uint32_t FORMAT_B8G8R8A8_UNORM = 87;
+	const uint32_t FORMAT_B8G8R8X8_UNORM = 88;
+	const uint32_t FORMAT_B8G8R8A8_UNORM_SRGB = 91;
+	const uint32_t FORMAT_B8G8R8X8_UNORM_SRGB = 93;
+
+	// DDSのヘッダーの値
+	const uint32_t DDS_MAGIC = 0x20534444;
+	const uint32_t DDS_FOURCC_DX10 = 0x30315844;
+	const uint32_t DDS_HEADER_FLAGS = 0x00001007;		// CAPS | HEIGHT | WIDTH | PIXELFORMAT
+	const uint32_t DDS_HEADER_FLAGS_MIPMAP = 0x00020000;
+	const uint32_t DDS_HEADER_FLAGS_LINEARSIZE = 0x00080000;
+	const uint32_t DDS_PF_FOURCC = 0x00000004;
+	const uint32_t DDS_CAPS_COMPLEX = 0x00000008;
+	const uint32_t DDS_CAPS_TEXTURE = 0x00001000;
+	const uint32_t DDS_CAPS_MIPMAP = 0x00400000;
+	const uint32_t DDS_CAPS2_CUBEMAP_ALLFACES = 0x0000fe00;
+	const uint32_t DDS_MISC_TEXTURECUBE = 0x00000004;
+	const uint32_t DDS_CUBEMAP_FACES = 6;
+
+	// グレースケールとみなすチャンネルの差
+	const int GRAY_TOLERANCE = 2;
+
+	// １つの仕事で圧縮するブロックの行数
+	const uint32_t ROWS_PER_JOB = 8;
+
+	// 圧縮形式
+	enum class TargetFormat
+	{
+		Auto,
+		BC1,
+		BC3,
+		BC4,
+	};
+
+	// 設定
+	struct Options
+	{
+		TargetFormat format = TargetFormat::Auto;
+		BcQuality quality = BcQuality::Normal;
+		uint32_t threads = ThreadPool::GetDefaultThreadCount();
+		SimdLevel simd = GetSimdLevel();
+		std::string output;
+	};
+
+	// RGBA8に変換したサーフェス
+	struct Image
+	{
+		uint32_t width;
+		uint32_t height;
+		std::vector<uint8_t> rgba;
+	};
+
+	// 結果の合計
+	struct Totals
+	{
+		size_t files = 0;
+		uint64_t pixels = 0;
+		uint64_t inputBytes = 0;
+		uint64_t outputBytes = 0;
+		double seconds = 0.0;
+	};
+
+	const char* GetFormatName(TargetFormat format)
+	{
+		switch (format)
+		{
+		case TargetFormat::BC1: return "BC1";
+		case TargetFormat::BC3: return "BC3";
+		case TargetFormat::BC4: return "BC4";
+		default: return "auto";
+		}
+	}
+
+	// sRGBのフォーマットか
+	bool IsSrgb(uint32_t format)
+	{
+		return format == FORMAT_R8G8B8A8_UNORM_SRGB || format == FORMAT_B8G8R8A8_UNORM_SRGB || format == FORMAT_B8G8R8X8_UNORM_SRGB;
+	}
+
+	// サーフェスをRGBA8に変換する（対応していないフォーマットは例外を投げる）
+	Image ConvertSurface(const DdsSurface& surface, uint32_t format)
+	{
+		Image image;
+		image.width = surface.width;
+		image.height = surface.height;
+		image.rgba.resize(static_cast<size_t>(surface.width) * surface.height * 4);
+
+		for (uint32_t y = 0; y < surface.height; y++)
+		{
+			const uint8_t* row = surface.data + y * surface.rowPitch;
+			uint8_t* output = image.rgba.data() + static_cast<size_t>(y) * surface.width * 4;
+			for (uint32_t x = 0; x < surface.width; x++, output += 4)
+			{
+				switch (format)
+				{
+				case FORMAT_R8G8B8A8_UNORM:
+				case FORMAT_R8G8B8A8_UNORM_SRGB:
+					std::memcpy(output, row + x * 4, 4);
+					break;
+				case FORMAT_B8G8R8A8_UNORM:
+				case FORMAT_B8G8R8A8_UNORM_SRGB:
+				case FORMAT_B8G8R8X8_UNORM:
+				case FORMAT_B8G8R8X8_UNORM_SRGB:
+					output[0] = row[x * 4 + 2];
+					output[1] = row[x * 4 + 1];
+					output[2] = row[x * 4 + 0];
+					output[3] = (format == FORMAT_B8G8R8X8_UNORM || format == FORMAT_B8G8R8X8_UNORM_SRGB) ? 255 : row[x * 4 + 3];
+					break;
+				case FORMAT_R8_UNORM:
+					output[0] = output[1] = output[2] = row[x];
+					output[3] = 255;
+					break;
+				case FORMAT_A8_UNORM:
+					output[0] = output[1] = output[2] = row[x];
+					output[3] = row[x];
+					break;
+				default:
+					throw std::runtime_error("Unsupported source format (RGBA8, BGRA8, BGRX8, R8 and A8 only).");
+				}
+			}
+		}
+		return image;
+	}
+
+	// 圧縮形式を選ぶ
+	TargetFormat ChooseFormat(const std::vector<Image>& images, uint32_t sourceFormat)
+	{
+		if (sourceFormat == FORMAT_R8_UNORM || sourceFormat == FORMAT_A8_UNORM) return TargetFormat::BC4;
+
+		bool gray = true;
+		bool opaque = true;
+		bool binaryAlpha = true;
+		for (const Image& image : images)
+		{
+			for (size_t i = 0; i < image.rgba.size(); i += 4)
+			{
+				const uint8_t* p = image.rgba.data() + i;
+				if (std::abs(p[0] - p[1]) > GRAY_TOLERANCE || std::abs(p[1] - p[2]) > GRAY_TOLERANCE) gray = false;
+				if (p[3] != 255) opaque = false;
+				if (p[3] != 0 && p[3] != 255) binaryAlpha = false;
+			}
+		}
+
+		if (gray && opaque) return TargetFormat::BC4;
+		if (binaryAlpha) return TargetFormat::BC1;
+		return TargetFormat::BC3;
+	}
+
+	// ブロックのバイト数
+	size_t GetBlockSize(TargetFormat format)
+	{
+		return format == TargetFormat::BC3 ? BC3_BLOCK_SIZE : BC1_BLOCK_SIZE;
+	}
+
+	// ブロックの数
+	uint32_t GetBlockCount(uint32_t size)
+	{
+		return std::max(1u, (size + 3) / 4);
+	}
+
+	// ブロックのピクセルを取り出す（端は最後のピクセルを繰り返す）
+	void LoadBlock(const Image& image, uint32_t blockX, uint32_t blockY, uint8_t* rgba)
+	{
+		for (uint32_t y = 0; y < 4; y++)
+		{
+			uint32_t sourceY = std::min(blockY * 4 + y, image.height - 1);
+			for (uint32_t x = 0; x < 4; x++)
+			{
+				uint32_t sourceX = std::min(blockX * 4 + x, image.width - 1);
+				std::memcpy(rgba + (y * 4 + x) * 4, image.rgba.data() + (static_cast<size_t>(sourceY) * image.width + sourceX) * 4, 4);
+			}
+		}
+	}
+
+	// ブロックの行を圧縮する
+	void CompressRows(const Image& image, TargetFormat format, const Options& options,
+		uint32_t firstRow, uint32_t lastRow, uint8_t* output)
+	{
+		uint32_t blocksWide = GetBlockCount(image.width);
+		size_t blockSize = GetBlockSize(format);
+
+		uint8_t rgba[16 * 4];
+		uint8_t values[16];
+		for (uint32_t blockY = firstRow; blockY < lastRow; blockY++)
+		{
+			for (uint32_t blockX = 0; blockX < blocksWide; blockX++)
+			{
+				LoadBlock(image, blockX, blockY, rgba);
+				uint8_t* block = output + (static_cast<size_t>(blockY) * blocksWide + blockX) * blockSize;
+				switch (format)
+				{
+				case TargetFormat::BC1:
+					EncodeBC1Block(rgba, block, options.quality, options.simd);
+					break;
+				case TargetFormat::BC3:
+					EncodeBC3Block(rgba, block, options.quality, options.simd);
+					break;
+				default:
+					// グレースケールは３チャンネルの平均
+					for (int i = 0; i < 16; i++)
+					{
+						values[i] = static_cast<uint8_t>((rgba[i * 4] + rgba[i * 4 + 1] + rgba[i * 4 + 2] + 1) / 3);
+					}
+					EncodeBC4Block(values, block, options.quality, options.simd);
+					break;
+				}
+			}
+		}
+	}
+
+	// 圧縮したサーフェスを展開して元の画像とのPSNRを求める（rgbとalphaにdBを返す。誤差がなければ無限大）
+	void MeasurePsnr(const Image& image, const uint8_t* compressed, TargetFormat format, double& rgb, double& alpha)
+	{
+		uint32_t blocksWide = GetBlockCount(image.width);
+		uint32_t blocksHigh = GetBlockCount(image.height);
+		size_t blockSize = GetBlockSize(format);
+
+		double colorError = 0.0;
+		double alphaError = 0.0;
+		uint8_t decoded[16 * 4];
+		uint8_t values[16];
+		for (uint32_t blockY = 0; blockY < blocksHigh; blockY++)
+		{
+			for (uint32_t blockX = 0; blockX < blocksWide; blockX++)
+			{
+				const uint8_t* block = compressed + (static_cast<size_t>(blockY) * blocksWide + blockX) * blockSize;
+				if (format == TargetFormat::BC1) DecodeBC1Block(block, decoded);
+				else if (format == TargetFormat::BC3) DecodeBC3Block(block, decoded);
+				else DecodeBC4Block(block, values);
+
+				for (uint32_t y = 0; y < 4 && blockY * 4 + y < image.height; y++)
+				{
+					for (uint32_t x = 0; x < 4 && blockX * 4 + x < image.width; x++)
+					{
+						const uint8_t* source = image.rgba.data() + ((static_cast<size_t>(blockY) * 4 + y) * image.width + blockX * 4 + x) * 4;
+						int i = y * 4 + x;
+						if (format == TargetFormat::BC4)
+						{
+							// BC4は赤のチャンネルに入れた値を３チャンネル分と比べる
+							for (int c = 0; c < 3; c++)
+							{
+								double d = static_cast<double>(source[c]) - values[i];
+								colorError += d * d;
+							}
+							continue;
+						}
+
+						// BC1の透明なピクセルは色を比べない
+						bool transparent = format == TargetFormat::BC1 && decoded[i * 4 + 3] == 0;
+						for (int c = 0; c < 3 && !transparent; c++)
+						{
+							double d = static_cast<double>(source[c]) - decoded[i * 4 + c];
+							colorError += d * d;
+						}
+						double d = static_cast<double>(source[3]) - decoded[i * 4 + 3];
+						alphaError += d * d;
+					}
+				}
+			}
+		}
+
+		double pixels = static_cast<double>(image.width) * image.height;
+		rgb = colorError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 * pixels * 3.0 / colorError) : INFINITY;
+		alpha = alphaError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 * pixels / alphaError) : INFINITY;
+	}
+
+	// ファイルを書き出す
+	void WriteFile(const std::string& fileName, const std::vector<uint8_t>& data)
+	{
+		std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!file) throw std::runtime_error("Failed to write file.");
+	}
+
+	// 圧縮したDDSファイルを作る（DX10拡張ヘッダーで書き出す）
+	std::vector<uint8_t> BuildDds(const DdsFile& source, uint32_t format, const std::vector<std::vector<uint8_t>>& surfaces)
+	{
+		DdsHeader header = {};
+		header.size = sizeof(DdsHeader);
+		header.flags = DDS_HEADER_FLAGS | DDS_HEADER_FLAGS_LINEARSIZE | (source.GetMipLevels() > 1 ? DDS_HEADER_FLAGS_MIPMAP : 0);
+		header.width = source.GetWidth();
+		header.height = source.GetHeight();
+		header.depth = 1;
+		header.pitchOrLinearSize = static_cast<uint32_t>(surfaces[0].size());
+		header.mipMapCount = source.GetMipLevels();
+		header.pixelFormat.size = sizeof(DdsPixelFormat);
+		header.pixelFormat.flags = DDS_PF_FOURCC;
+		header.pixelFormat.fourCC = DDS_FOURCC_DX10;
+		header.caps = DDS_CAPS_TEXTURE | (source.GetMipLevels() > 1 ? DDS_CAPS_COMPLEX | DDS_CAPS_MIPMAP : 0);
+		if (source.IsCubemap())
+		{
+			header.caps |= DDS_CAPS_COMPLEX;
+			header.caps2 = DDS_CAPS2_CUBEMAP_ALLFACES;
+		}
+
+		DdsHeaderDxt10 headerDxt10 = {};
+		headerDxt10.dxgiFormat = format;
+		headerDxt10.resourceDimension = source.GetDimension();
+		headerDxt10.miscFlag = source.IsCubemap() ? DDS_MISC_TEXTURECUBE : 0;
+		headerDxt10.arraySize = source.IsCubemap() ? source.GetArraySize() / DDS_CUBEMAP_FACES : source.GetArraySize();
+
+		std::vector<uint8_t> output(sizeof(uint32_t) + sizeof(DdsHeader) + sizeof(DdsHeaderDxt10));
+		std::memcpy(output.data(), &DDS_MAGIC, sizeof(uint32_t));
+		std::memcpy(output.data() + sizeof(uint32_t), &header, sizeof(header));
+		std::memcpy(output.data() + sizeof(uint32_t) + sizeof(header), &headerDxt10, sizeof(headerDxt10));
+
+		// サーフェスは配列の要素ごとにミップマップの順
+		for (const std::vector<uint8_t>& surface : surfaces) output.insert(output.end(), surface.begin(), surface.end());
+		return output;
+	}
+
+	// ファイル名の部分
+	std::string GetFileName(const std::string& path)
+	{
+		size_t separator = path.find_last_of("/\\");
+		return separator == std::string::npos ? path : path.substr(separator + 1);
+	}
+
+	// 拡張子が.ddsか
+	bool HasDdsExtension(const std::string& path)
+	{
+		if (path.size() < 4) return false;
+		std::string extension = path.substr(path.size() - 4);
+		for (char& c : extension) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		return extension == ".dds";
+	}
+
+	// フォルダーの中の.ddsファイルを追加する（フォルダーでなければfalse）
+	bool ListDirectory(const std::string& path, std::vector<std::string>& files)
+	{
+		std::vector<std::string> found;
+#ifdef _WIN32
+		DWORD attributes = GetFileAttributesA(path.c_str());
+		if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY)) return false;
+
+		WIN32_FIND_DATAA data;
+		HANDLE find = FindFirstFileA((path + "\\*").c_str(), &data);
+		if (find != INVALID_HANDLE_VALUE)
+		{
+			do
+			{
+				if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && HasDdsExtension(data.cFileName))
+				{
+					found.push_back(path + "\\" + data.cFileName);
+				}
+			} while (FindNextFileA(find, &data));
+			FindClose(find);
+		}
+#else
+		struct stat status = {};
+		if (stat(path.c_str(), &status) != 0 || !S_ISDIR(status.st_mode)) return false;
+
+		DIR* directory = opendir(path.c_str());
+		if (!directory) throw std::runtime_error("Failed to open directory: " + path);
+		while (dirent* entry = readdir(directory))
+		{
+			std::string file = path + "/" + entry->d_name;
+			if (HasDdsExtension(file) && stat(file.c_str(), &status) == 0 && S_ISREG(status.st_mode)) found.push_back(file);
+		}
+		closedir(directory);
+#endif
+		std::sort(found.begin(), found.end());
+		files.insert(files.end(), found.begin(), found.end());
+		return true;
+	}
+
+	// ファイルを圧縮する
+	void ProcessFile(const std::string& path, const Options& options, ThreadPool& pool, Totals& totals)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		DdsFile source(std::wstring(path.begin(), path.end()).c_str());
+
+		DdsFormatInfo info;
+		if (GetDdsFormatInfo(source.GetFormat(), info) && info.blockCompressed)
+		{
+			std::printf("%s: already block compressed, skipped\n", path.c_str());
+			return;
+		}
+		if (source.GetDimension() == DDS_DIMENSION_TEXTURE3D) throw std::runtime_error("Volume textures are not supported.");
+
+		// 全てのサーフェスをRGBA8にする
+		std::vector<Image> images;
+		for (size_t i = 0; i < source.GetSurfaceCount(); i++)
+		{
+			images.push_back(ConvertSurface(source.GetSurfaces()[i], source.GetFormat()));
+		}
+
+		TargetFormat format = options.format == TargetFormat::Auto ? ChooseFormat(images, source.GetFormat()) : options.format;
+		bool srgb = IsSrgb(source.GetFormat());
+		uint32_t dxgiFormat = format == TargetFormat::BC1 ? (srgb ? FORMAT_BC1_UNORM_SRGB : FORMAT_BC1_UNORM)
+			: format == TargetFormat::BC3 ? (srgb ? FORMAT_BC3_UNORM_SRGB : FORMAT_BC3_UNORM)
+			: FORMAT_BC4_UNORM;
+
+		// ブロックの行をまとめてスレッドプールで圧縮する
+		std::vector<std::vector<uint8_t>> surfaces(images.size());
+		std::vector<std::future<void>> jobs;
+		uint64_t pixels = 0;
+		for (size_t i = 0; i < images.size(); i++)
+		{
+			const Image& image = images[i];
+			uint32_t blocksHigh = GetBlockCount(image.height);
+			surfaces[i].resize(static_cast<size_t>(GetBlockCount(image.width)) * blocksHigh * GetBlockSize(format));
+			pixels += static_cast<uint64_t>(image.width) * image.height;
+
+			for (uint32_t row = 0; row < blocksHigh; row += ROWS_PER_JOB)
+			{
+				uint8_t* output = surfaces[i].data();
+				uint32_t lastRow = std::min(row + ROWS_PER_JOB, blocksHigh);
+				jobs.push_back(pool.Submit([&image, format, &options, row, lastRow, output]()
+					{
+						CompressRows(image, format, options, row, lastRow, output);
+					}));
+			}
+		}
+		for (std::future<void>& job : jobs) job.get();
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		// 最も詳細なミップマップの誤差
+		double rgb, alpha;
+		MeasurePsnr(images[0], surfaces[0].data(), format, rgb, alpha);
+
+		std::vector<uint8_t> output = BuildDds(source, dxgiFormat, surfaces);
+
+		// 書き出す前に読み直して確認する
+		DdsFile check(output.data(), output.size());
+		if (check.GetFormat() != dxgiFormat || check.GetSurfaceCount() != surfaces.size())
+		{
+			throw std::runtime_error("Verification failed.");
+		}
+
+		if (!options.output.empty()) WriteFile(options.output + "/" + GetFileName(path), output);
+
+		std::printf("%s: %s, %zu -> %zu bytes (%.1fx), PSNR rgb %.2f dB", path.c_str(), GetFormatName(format),
+			source.GetSize(), output.size(), static_cast<double>(source.GetSize()) / output.size(), rgb);
+		if (format != TargetFormat::BC4) std::printf(" alpha %.2f dB", alpha);
+		std::printf(", %.1f ms\n", seconds * 1000.0);
+
+		totals.files++;
+		totals.pixels += pixels;
+		totals.inputBytes += source.GetSize();
+		totals.outputBytes += output.size();
+		totals.seconds += seconds;
+	}
+
+	// オプションの値を読む
+	bool ParseOption(const char* name, const char* value, Options& options)
+	{
+		std::string v(value);
+		if (std::strcmp(name, "--format") == 0)
+		{
+			if (v == "auto") options.format = TargetFormat::Auto;
+			else if (v == "bc1") options.format = TargetFormat::BC1;
+			else if (v == "bc3") options.format = TargetFormat::BC3;
+			else if (v == "bc4") options.format = TargetFormat::BC4;
+			else return false;
+		}
+		else if (std::strcmp(name, "--quality") == 0)
+		{
+			if (v == "fast") options.quality = BcQuality::Fast;
+			else if (v == "normal") options.quality = BcQuality::Normal;
+			else if (v == "high") options.quality = BcQuality::High;
+			else return false;
+		}
+		else if (std::strcmp(name, "--threads") == 0)
+		{
+			int threads = std::atoi(value);
+			if (threads <= 0) return false;
+			options.threads = static_cast<uint32_t>(threads);
+		}
+		else if (std::strcmp(name, "--simd") == 0)
+		{
+			if (v == "scalar") options.simd = SimdLevel::Scalar;
+			else if (v == "sse2") options.simd = SimdLevel::SSE2;
+			else if (v == "avx2") options.simd = SimdLevel::AVX2;
+			else return false;
+			if (options.simd > GetSimdLevel()) options.simd = GetSimdLevel();
+		}
+		else if (std::strcmp(name, "--output") == 0)
+		{
+			options.output = v;
+		}
+		else
+		{
+			return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	std::vector<std::string> inputs;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strncmp(argv[i], "--", 2) == 0)
+		{
+			if (i + 1 >= argc || !ParseOption(argv[i], argv[i + 1], options))
+			{
+				std::fprintf(stderr, "Invalid option: %s\n", argv[i]);
+				return 1;
+			}
+			i++;
+		}
+		else
+		{
+			inputs.push_back(argv[i]);
+		}
+	}
+
+	if (inputs.empty())
+	{
+		std::fprintf(stderr,
+			"Usage: TextureCompressor [--format auto|bc1|bc3|bc4] [--quality fast|normal|high] [--threads <n>]\n"
+			"                         [--simd scalar|sse2|avx2] [--output <directory>] <file.dds | directory>...\n");
+		return 1;
+	}
+
+	std::vector<std::string> files;
+	try
+	{
+		for (const std::string& input : inputs)
+		{
+			if (!ListDirectory(input, files)) files.push_back(input);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+
+	ThreadPool pool(options.threads);
+	Totals totals;
+	int result = 0;
+	for (const std::string& file : files)
+	{
+		try
+		{
+			ProcessFile(file, options, pool, totals);
+		}
+		catch (const std::exception& e)
+		{
+			std::fprintf(stderr, "%s: %s\n", file.c_str(), e.what());
+			result = 1;
+		}
+	}
+
+	std::printf("%zu files, %llu -> %llu bytes, %.1f Mpixel/s (%zu threads, %s)\n", totals.files,
+		static_cast<unsigned long long>(totals.inputBytes), static_cast<unsigned long long>(totals.outputBytes),
+		totals.seconds > 0.0 ? totals.pixels / totals.seconds / 1e6 : 0.0, pool.GetThreadCount(), GetSimdLevelName(options.simd));
+
+	return result;
+}
@@ -0,0 +1,327 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// TextureStreamerが転送先に渡す呼び出しの順番と、転送の予算・描画に使うミップマップを確認するテスト
+//
+// Usage: TextureStreamerTest
+//        呼び出しを記録するITextureUploadSinkを転送先にして、メモリ上に作ったDDS（2D、配列）と
+//        同梱のDDSファイルをストリーミングし、次のことを確認します。
+//          ・Add関数では64ピクセル以下のミップマップだけを転送する
+//          ・Update関数で予算を超えてよいのは、そのフレームの最初のサーフェスだけ
+//          ・SetResidentMipは詳細な方にだけ進み、要素が１つでも未転送のミップマップは使わない
+//          ・RequestSize関数で指定した大きさより大きいミップマップは転送しない
+//          ・ワーカースレッドが0個でも2個でも、転送するサーフェスと描画に使うミップマップの順番は同じ
+//        失敗した項目を表示して1を返します。
+//        D3Dを使わないのでLinuxでビルド・実行できます（ThreadSanitizerでも確認できます）。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:TextureStreamerTest.exe Tools\TextureStreamerTest\Main.cpp ImaseLib\TextureStreamer.cpp ImaseLib\DdsFile.cpp ImaseLib\MappedFile.cpp ImaseLib\Utf8.cpp
+//          g++ -std=c++14 -O2 -pthread -o TextureStreamerTest Tools/TextureStreamerTest/Main.cpp ImaseLib/TextureStreamer.cpp ImaseLib/DdsFile.cpp ImaseLib/MappedFile.cpp ImaseLib/Utf8.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/TextureStreamer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 失敗した数
+	int g_failures = 0;
+
+	void Check(bool condition, const char* message, int line)
+	{
+		if (condition) return;
+		if (g_failures < 20) std::printf("FAILED: %s (line %d)\n", message, line);
+		g_failures++;
+	}
+
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+	// 登録時に転送する大きさと、１フレームの転送の予算（256x256のRGBA8の１枚より小さい）
+	const uint32_t INITIAL_SIZE = TextureStreamer::DEFAULT_INITIAL_SIZE;
+	const size_t UPLOAD_BUDGET = 200 * 1024;
+
+	// RequestSize関数で指定する大きさ
+	const uint32_t REQUESTED_SIZE = 128;
+
+	// 転送が終わるまで待つフレーム数の上限
+	const int MAX_FRAMES = 1000000;
+
+	// 同梱のDDSファイル
+	const wchar_t* const BUNDLED_TEXTURES[] =
+	{
+		L"Resources\\Models\\ball.dds",
+		L"Resources\\Models\\floor.dds",
+		L"Resources\\Models\\image1.dds",
+		L"Resources\\Models\\image2.dds",
+		L"Resources\\Models\\image3.dds",
+		L"Resources\\Models\\shadow.dds",
+	};
+
+	// DDSのヘッダーの値
+	const uint32_t DDS_MAGIC = 0x20534444;
+	const uint32_t DDS_PF_FOURCC = 0x4;
+	const uint32_t DDS_FOURCC_DX10 = 0x30315844;
+	const uint32_t DXGI_FORMAT_R8G8B8A8_UNORM = 28;
+
+	// RGBA8の2Dテクスチャ（配列）のDDSをメモリ上に作る（中身は要素とミップマップの番号）
+	std::shared_ptr<const DdsFile> MakeDds(uint32_t width, uint32_t height, uint32_t arraySize)
+	{
+		uint32_t mipLevels = 1;
+		while ((std::max(width, height) >> mipLevels) > 0) mipLevels++;
+
+		size_t dataSize = 0;
+		for (uint32_t mip = 0; mip < mipLevels; mip++)
+		{
+			dataSize += static_cast<size_t>(std::max(width >> mip, 1u)) * std::max(height >> mip, 1u) * 4;
+		}
+		dataSize *= arraySize;
+
+		const size_t headerSize = sizeof(uint32_t) + sizeof(DdsHeader) + sizeof(DdsHeaderDxt10);
+		auto buffer = std::make_shared<std::vector<uint32_t>>((headerSize + dataSize) / sizeof(uint32_t));
+		uint8_t* bytes = reinterpret_cast<uint8_t*>(buffer->data());
+
+		DdsHeader header = {};
+		header.size = sizeof(DdsHeader);
+		header.width = width;
+		header.height = height;
+		header.mipMapCount = mipLevels;
+		header.pixelFormat.size = sizeof(DdsPixelFormat);
+		header.pixelFormat.flags = DDS_PF_FOURCC;
+		header.pixelFormat.fourCC = DDS_FOURCC_DX10;
+
+		DdsHeaderDxt10 extension = {};
+		extension.dxgiFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+		extension.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+		extension.arraySize = arraySize;
+
+		std::memcpy(bytes, &DDS_MAGIC, sizeof(uint32_t));
+		std::memcpy(bytes + sizeof(uint32_t), &header, sizeof(header));
+		std::memcpy(bytes + sizeof(uint32_t) + sizeof(header), &extension, sizeof(extension));
+
+		std::shared_ptr<const DdsFile> file = std::make_shared<DdsFile>(bytes, buffer->size() * sizeof(uint32_t));
+		for (uint32_t item = 0; item < arraySize; item++)
+		{
+			for (uint32_t mip = 0; mip < mipLevels; mip++)
+			{
+				const DdsSurface& surface = file->GetSurface(item, mip);
+				std::memset(const_cast<uint8_t*>(surface.data), static_cast<int>(item * 16 + mip), surface.slicePitch);
+			}
+		}
+
+		// ファイルが参照している間はバッファを残す
+		return std::shared_ptr<const DdsFile>(file.get(), [file, buffer](const DdsFile*) {});
+	}
+
+	// 転送先に渡されたサーフェス（要素、ミップマップ）
+	typedef std::pair<uint32_t, uint32_t> SurfaceKey;
+
+	// テクスチャごとに記録した呼び出し
+	struct TextureRecord
+	{
+		const DdsFile* file = nullptr;
+
+		// 転送したサーフェス（転送した順）と、Add関数で転送したサーフェス
+		std::vector<SurfaceKey> uploads;
+		std::vector<SurfaceKey> initialUploads;
+
+		// SetResidentMipに渡されたミップマップ（渡された順）
+		std::vector<uint32_t> residentMips;
+	};
+
+	// 呼び出しを記録し、呼び出しの順番の決まりを確認する転送先
+	class RecordingSink : public ITextureUploadSink
+	{
+	public:
+
+		std::vector<TextureRecord> textures;
+
+		// Add関数の中か
+		bool adding = true;
+
+		// 今のフレームで転送したサーフェスの数とバイト数
+		uint32_t frameSurfaces = 0;
+		size_t frameBytes = 0;
+
+		// 予算を超えたのがフレームの最初のサーフェス以外だった数
+		int budgetViolations = 0;
+
+		void BeginFrame()
+		{
+			adding = false;
+			frameSurfaces = 0;
+			frameBytes = 0;
+		}
+
+		void CreateTexture(TextureHandle handle, const DdsFile& file) override
+		{
+			CHECK(handle == textures.size());
+			textures.emplace_back();
+			textures.back().file = &file;
+		}
+
+		void UploadSurface(TextureHandle handle, uint32_t item, uint32_t mip, const DdsSurface& surface) override
+		{
+			TextureRecord& texture = textures[handle];
+			CHECK(&surface == &texture.file->GetSurface(item, mip));
+			texture.uploads.emplace_back(item, mip);
+
+			if (adding)
+			{
+				texture.initialUploads.emplace_back(item, mip);
+				return;
+			}
+
+			const size_t bytes = surface.slicePitch * surface.depth;
+			if (frameSurfaces > 0 && frameBytes + bytes > UPLOAD_BUDGET) budgetViolations++;
+			frameSurfaces++;
+			frameBytes += bytes;
+		}
+
+		void SetResidentMip(TextureHandle handle, uint32_t mip) override
+		{
+			TextureRecord& texture = textures[handle];
+
+			// 詳細な方にだけ進む
+			CHECK(texture.residentMips.empty() || mip < texture.residentMips.back());
+			texture.residentMips.push_back(mip);
+
+			// このミップマップより小さいものは全ての要素が転送済み
+			std::set<SurfaceKey> uploaded(texture.uploads.begin(), texture.uploads.end());
+			for (uint32_t item = 0; item < texture.file->GetArraySize(); item++)
+			{
+				for (uint32_t level = mip; level < texture.file->GetMipLevels(); level++)
+				{
+					CHECK(uploaded.count(SurfaceKey(item, level)) == 1);
+				}
+			}
+		}
+	};
+
+	// 転送が終わるまでUpdate関数を呼び、結果を返す
+	std::vector<TextureRecord> Stream(uint32_t workerCount)
+	{
+		RecordingSink sink;
+		std::vector<std::shared_ptr<const DdsFile>> files =
+		{
+			MakeDds(512, 512, 1),
+			MakeDds(256, 256, 3),
+			MakeDds(1024, 256, 1),
+			MakeDds(32, 32, 2),
+		};
+		for (const wchar_t* fileName : BUNDLED_TEXTURES)
+		{
+			files.push_back(std::make_shared<DdsFile>(fileName));
+		}
+
+		std::vector<TextureHandle> handles;
+		{
+			TextureStreamer streamer(&sink, workerCount);
+			for (const std::shared_ptr<const DdsFile>& file : files)
+			{
+				handles.push_back(streamer.Add(file, INITIAL_SIZE));
+			}
+
+			// 1024x256は128ピクセルまでにする
+			const TextureHandle capped = handles[2];
+			streamer.RequestSize(capped, REQUESTED_SIZE);
+
+			// Add関数では64ピクセル以下のミップマップだけを転送する
+			for (size_t i = 0; i < files.size(); i++)
+			{
+				const DdsFile& file = *files[i];
+				const TextureRecord& texture = sink.textures[handles[i]];
+				const uint32_t initialMip = file.FindMipForSize(INITIAL_SIZE);
+
+				CHECK(texture.initialUploads.size() == static_cast<size_t>(file.GetArraySize()) * (file.GetMipLevels() - initialMip));
+				for (const SurfaceKey& key : texture.initialUploads)
+				{
+					const DdsSurface& surface = file.GetSurface(key.first, key.second);
+					CHECK(key.second >= initialMip);
+					CHECK((surface.width <= INITIAL_SIZE && surface.height <= INITIAL_SIZE) || key.second + 1 == file.GetMipLevels());
+				}
+				CHECK(texture.residentMips.size() == 1 && texture.residentMips[0] == initialMip);
+				CHECK(streamer.GetResidentMip(handles[i]) == initialMip);
+			}
+
+			// 全て転送が済むまで毎フレーム予算の範囲で転送する
+			int frame = 0;
+			for (; frame < MAX_FRAMES; frame++)
+			{
+				sink.BeginFrame();
+				streamer.Update(UPLOAD_BUDGET);
+
+				const TextureStreamer::Statistics& statistics = streamer.GetStatistics();
+				CHECK(statistics.uploadedSurfaces == sink.frameSurfaces && statistics.uploadedBytes == sink.frameBytes);
+				if (streamer.IsIdle() && statistics.pendingLevels == 0) break;
+				if (workerCount > 0 && sink.frameSurfaces == 0) std::this_thread::yield();
+			}
+			CHECK(frame < MAX_FRAMES);
+			CHECK(sink.budgetViolations == 0);
+
+			// 必要な大きさまで転送が済み、指定した大きさより大きいミップマップは転送しない
+			for (size_t i = 0; i < files.size(); i++)
+			{
+				const uint32_t wantedMip = handles[i] == capped ? files[i]->FindMipForSize(REQUESTED_SIZE) : 0;
+				CHECK(streamer.IsComplete(handles[i]));
+				CHECK(streamer.GetResidentMip(handles[i]) == wantedMip);
+				CHECK(sink.textures[handles[i]].residentMips.back() == wantedMip);
+				for (const SurfaceKey& key : sink.textures[handles[i]].uploads)
+				{
+					CHECK(key.second >= wantedMip);
+				}
+			}
+		}
+
+		// ストリーマーが参照していたファイルはここで破棄する（記録はファイルのアドレスを使わない）
+		for (TextureRecord& texture : sink.textures) texture.file = nullptr;
+		return sink.textures;
+	}
+
+	// 同じサーフェスを転送したか（フレームへの分け方はワーカースレッドのタイミングで変わる）
+	std::vector<SurfaceKey> Sorted(std::vector<SurfaceKey> keys)
+	{
+		std::sort(keys.begin(), keys.end());
+		return keys;
+	}
+}
+
+int main()
+{
+	const std::vector<TextureRecord> serial = Stream(0);
+	const std::vector<TextureRecord> threaded = Stream(2);
+
+	// ワーカースレッドの数に関係なく同じ結果になる
+	CHECK(serial.size() == threaded.size());
+	for (size_t i = 0; i < std::min(serial.size(), threaded.size()); i++)
+	{
+		CHECK(serial[i].initialUploads == threaded[i].initialUploads);
+		CHECK(Sorted(serial[i].uploads) == Sorted(threaded[i].uploads));
+		std::vector<SurfaceKey> keys = Sorted(serial[i].uploads);
+		CHECK(std::adjacent_find(keys.begin(), keys.end()) == keys.end());
+		CHECK(serial[i].residentMips == threaded[i].residentMips);
+	}
+
+	size_t uploads = 0;
+	for (const TextureRecord& texture : serial) uploads += texture.uploads.size();
+	std::printf("%zu textures, %zu surfaces uploaded with 0 and 2 workers\n", serial.size(), uploads);
+
+	if (g_failures > 0)
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}
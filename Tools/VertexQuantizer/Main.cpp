@@ -0,0 +1,392 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// SDKMESHファイルの頂点を量子化した形式に変換するコマンドラインツール
+//
+// Usage: VertexQuantizer <input.sdkmesh> <output.sdkmesh>
+//        位置(float3)・法線(float3)・UV(float2)の頂点を、位置はSHORT4N、法線は八面体に展開した
+//        SHORT2N、UVはFLOAT16_2に変換して書き出します（QuantizedVertex.h）。
+//        メッシュのバウンディングボックスは頂点の範囲にぴったり合わせて書き換え、
+//        位置の復元（MakeQuantizationBounds関数）にも使います。
+//        書き出したファイルを読み直して復元し、元の頂点との誤差とサイズを表示します。
+//        位置と法線を復元するシェーダーが必要なので、BasicEffectなどではそのまま描画できません。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:VertexQuantizer.exe Tools\VertexQuantizer\Main.cpp ImaseLib\QuantizedVertex.cpp ImaseLib\SdkMeshFile.cpp ImaseLib\MappedFile.cpp
+//          g++ -std=c++14 -O2 -o VertexQuantizer Tools/VertexQuantizer/Main.cpp ImaseLib/QuantizedVertex.cpp ImaseLib/SdkMeshFile.cpp ImaseLib/MappedFile.cpp ImaseLib/Utf8.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/QuantizedVertex.h"
+#include "../../ImaseLib/SdkMeshFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 書き出すバッファの境界
+	const size_t BUFFER_ALIGNMENT = 16;
+
+	// 要素がないことを表す位置
+	const int NO_ELEMENT = -1;
+
+	// 変換元の頂点の要素の位置
+	struct SourceLayout
+	{
+		int position = NO_ELEMENT;
+		int normal = NO_ELEMENT;
+		int textureCoordinate = NO_ELEMENT;
+	};
+
+	// 変換の誤差
+	struct QuantizationError
+	{
+		// 位置の最大誤差（絶対値と、メッシュの大きさに対する割合）
+		float position = 0.0f;
+		float relativePosition = 0.0f;
+
+		// 法線の最大誤差（度）
+		float normalDegrees = 0.0f;
+
+		// UVの最大誤差
+		float textureCoordinate = 0.0f;
+	};
+
+	// ファイルを読み込む
+	std::vector<uint8_t> ReadFile(const char* fileName)
+	{
+		std::ifstream file(fileName, std::ios::binary);
+		if (!file) throw std::runtime_error("Failed to open file.");
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	// ファイルを書き出す
+	void WriteFile(const char* fileName, const std::vector<uint8_t>& data)
+	{
+		std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!file) throw std::runtime_error("Failed to write file.");
+	}
+
+	// 構造体をバイト列の指定位置に書き込む
+	template <class T>
+	void WriteAt(std::vector<uint8_t>& data, uint64_t offset, const T& value)
+	{
+		std::memcpy(data.data() + offset, &value, sizeof(T));
+	}
+
+	// バッファのデータを末尾に追加して位置を返す
+	uint64_t AppendBuffer(std::vector<uint8_t>& output, const uint8_t* data, size_t size)
+	{
+		while (output.size() % BUFFER_ALIGNMENT) output.push_back(0);
+
+		uint64_t offset = output.size();
+		output.insert(output.end(), data, data + size);
+		return offset;
+	}
+
+	// 変換元の頂点の要素を調べる（変換できない要素があれば例外を投げる）
+	SourceLayout GetSourceLayout(const SdkMeshVertexBufferHeader& header)
+	{
+		SourceLayout layout;
+		for (const SdkMeshVertexElement& element : header.decl)
+		{
+			if (element.stream == SDKMESH_DECL_END_STREAM) break;
+
+			if (element.stream == 0 && element.usageIndex == 0)
+			{
+				if (element.usage == SDKMESH_DECLUSAGE_POSITION && element.type == SDKMESH_DECLTYPE_FLOAT3)
+				{
+					layout.position = element.offset;
+					continue;
+				}
+				if (element.usage == SDKMESH_DECLUSAGE_NORMAL && element.type == SDKMESH_DECLTYPE_FLOAT3)
+				{
+					layout.normal = element.offset;
+					continue;
+				}
+				if (element.usage == SDKMESH_DECLUSAGE_TEXCOORD && element.type == SDKMESH_DECLTYPE_FLOAT2)
+				{
+					layout.textureCoordinate = element.offset;
+					continue;
+				}
+			}
+
+			throw std::runtime_error("Unsupported vertex element (only float3 position, float3 normal and float2 texcoord).");
+		}
+
+		if (layout.position == NO_ELEMENT) throw std::runtime_error("Vertex buffer has no float3 position.");
+
+		return layout;
+	}
+
+	// 頂点の要素を作る
+	SdkMeshVertexElement MakeElement(uint16_t offset, uint8_t type, uint8_t usage)
+	{
+		SdkMeshVertexElement element = {};
+		element.offset = offset;
+		element.type = type;
+		element.usage = usage;
+		return element;
+	}
+
+	// 頂点バッファを量子化する（headerの要素とサイズも書き換える）
+	std::vector<uint8_t> QuantizeVertices(const SdkMeshBufferData& source, SdkMeshVertexBufferHeader& header, const QuantizationBounds& bounds)
+	{
+		const SourceLayout layout = GetSourceLayout(header);
+		const size_t sourceStride = static_cast<size_t>(header.strideBytes);
+		const size_t count = static_cast<size_t>(header.numVertices);
+
+		// 新しい要素の並び（位置、法線、UVの順に詰める）
+		SdkMeshVertexElement end = header.decl[SDKMESH_MAX_VERTEX_ELEMENTS - 1];
+		std::fill(std::begin(header.decl), std::end(header.decl), end);
+
+		size_t element = 0;
+		uint16_t stride = 0;
+		header.decl[element++] = MakeElement(stride, SDKMESH_DECLTYPE_SHORT4N, SDKMESH_DECLUSAGE_POSITION);
+		stride += sizeof(QuantizedVertex::position);
+		const uint16_t normalOffset = stride;
+		if (layout.normal != NO_ELEMENT)
+		{
+			header.decl[element++] = MakeElement(stride, SDKMESH_DECLTYPE_SHORT2N, SDKMESH_DECLUSAGE_NORMAL);
+			stride += sizeof(QuantizedVertex::normal);
+		}
+		const uint16_t textureCoordinateOffset = stride;
+		if (layout.textureCoordinate != NO_ELEMENT)
+		{
+			header.decl[element++] = MakeElement(stride, SDKMESH_DECLTYPE_FLOAT16_2, SDKMESH_DECLUSAGE_TEXCOORD);
+			stride += sizeof(QuantizedVertex::textureCoordinate);
+		}
+
+		std::vector<uint8_t> result(count * stride);
+		for (size_t i = 0; i < count; i++)
+		{
+			const uint8_t* src = source.data + i * sourceStride;
+			uint8_t* dst = result.data() + i * stride;
+
+			float position[3];
+			int16_t quantizedPosition[4];
+			std::memcpy(position, src + layout.position, sizeof(position));
+			QuantizePosition(position, bounds, quantizedPosition);
+			std::memcpy(dst, quantizedPosition, sizeof(quantizedPosition));
+
+			if (layout.normal != NO_ELEMENT)
+			{
+				float normal[3];
+				int16_t encoded[2];
+				std::memcpy(normal, src + layout.normal, sizeof(normal));
+				EncodeOctahedralNormal(normal, encoded);
+				std::memcpy(dst + normalOffset, encoded, sizeof(encoded));
+			}
+
+			if (layout.textureCoordinate != NO_ELEMENT)
+			{
+				float uv[2];
+				uint16_t half[2];
+				std::memcpy(uv, src + layout.textureCoordinate, sizeof(uv));
+				for (int k = 0; k < 2; k++)
+				{
+					half[k] = FloatToHalf(uv[k]);
+					if ((half[k] & 0x7c00) == 0x7c00) throw std::runtime_error("Texture coordinate is out of half float range.");
+				}
+				std::memcpy(dst + textureCoordinateOffset, half, sizeof(half));
+			}
+		}
+
+		header.strideBytes = stride;
+		header.sizeBytes = result.size();
+		return result;
+	}
+
+	// 量子化した頂点を復元して元の頂点との誤差を求める
+	void MeasureError(const SdkMeshBufferData& source, const SdkMeshVertexBufferHeader& sourceHeader,
+		const SdkMeshBufferData& quantized, const SdkMeshVertexBufferHeader& quantizedHeader,
+		const QuantizationBounds& bounds, QuantizationError& error)
+	{
+		const SourceLayout layout = GetSourceLayout(sourceHeader);
+		const size_t sourceStride = static_cast<size_t>(sourceHeader.strideBytes);
+		const size_t stride = static_cast<size_t>(quantizedHeader.strideBytes);
+
+		// 書き出した要素の並びから位置を探す
+		int normalOffset = NO_ELEMENT, textureCoordinateOffset = NO_ELEMENT;
+		for (const SdkMeshVertexElement& element : quantizedHeader.decl)
+		{
+			if (element.stream == SDKMESH_DECL_END_STREAM) break;
+			if (element.usage == SDKMESH_DECLUSAGE_NORMAL) normalOffset = element.offset;
+			if (element.usage == SDKMESH_DECLUSAGE_TEXCOORD) textureCoordinateOffset = element.offset;
+		}
+
+		for (size_t i = 0; i < static_cast<size_t>(sourceHeader.numVertices); i++)
+		{
+			const uint8_t* src = source.data + i * sourceStride;
+			const uint8_t* dst = quantized.data + i * stride;
+
+			float position[3], decodedPosition[3];
+			int16_t quantizedPosition[4];
+			std::memcpy(position, src + layout.position, sizeof(position));
+			std::memcpy(quantizedPosition, dst, sizeof(quantizedPosition));
+			DequantizePosition(quantizedPosition, bounds, decodedPosition);
+			for (int k = 0; k < 3; k++)
+			{
+				error.position = std::max(error.position, std::fabs(decodedPosition[k] - position[k]));
+				error.relativePosition = std::max(error.relativePosition, std::fabs(decodedPosition[k] - position[k]) / bounds.scale);
+			}
+
+			if (layout.normal != NO_ELEMENT)
+			{
+				float normal[3], decoded[3];
+				int16_t encoded[2];
+				std::memcpy(normal, src + layout.normal, sizeof(normal));
+				std::memcpy(encoded, dst + normalOffset, sizeof(encoded));
+				DecodeOctahedralNormal(encoded, decoded);
+
+				// 1.0に近い内積のacosはfloatでは精度が出ないので、外積の長さとの atan2 で求める
+				double cross[3] =
+				{
+					static_cast<double>(normal[1]) * decoded[2] - static_cast<double>(normal[2]) * decoded[1],
+					static_cast<double>(normal[2]) * decoded[0] - static_cast<double>(normal[0]) * decoded[2],
+					static_cast<double>(normal[0]) * decoded[1] - static_cast<double>(normal[1]) * decoded[0],
+				};
+				double dot = static_cast<double>(normal[0]) * decoded[0] + static_cast<double>(normal[1]) * decoded[1] + static_cast<double>(normal[2]) * decoded[2];
+				if (dot != 0.0 || cross[0] != 0.0 || cross[1] != 0.0 || cross[2] != 0.0)
+				{
+					double sine = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+					float degrees = static_cast<float>(std::atan2(sine, dot) * 57.29577951308232);
+					error.normalDegrees = std::max(error.normalDegrees, degrees);
+				}
+			}
+
+			if (layout.textureCoordinate != NO_ELEMENT)
+			{
+				float uv[2];
+				uint16_t half[2];
+				std::memcpy(uv, src + layout.textureCoordinate, sizeof(uv));
+				std::memcpy(half, dst + textureCoordinateOffset, sizeof(half));
+				for (int k = 0; k < 2; k++)
+				{
+					error.textureCoordinate = std::max(error.textureCoordinate, std::fabs(HalfToFloat(half[k]) - uv[k]));
+				}
+			}
+		}
+	}
+
+	// ファイルを変換する
+	void ProcessFile(const char* inputName, const char* outputName)
+	{
+		std::vector<uint8_t> source = ReadFile(inputName);
+		SdkMeshFile file(source.data(), source.size());
+		const SdkMeshHeader& header = file.GetHeader();
+
+		// 頂点バッファごとに１つのメッシュだけが使っていること（バウンディングボックスを復元に使うため）
+		std::vector<int> vertexBufferMesh(file.GetVertexBufferCount(), -1);
+		for (size_t i = 0; i < file.GetMeshCount(); i++)
+		{
+			const SdkMeshMesh& mesh = file.GetMeshes()[i];
+			for (uint32_t j = 0; j < mesh.numVertexBuffers; j++)
+			{
+				if (vertexBufferMesh[mesh.vertexBuffers[j]] >= 0) throw std::runtime_error("Vertex buffer is shared by multiple meshes.");
+				vertexBufferMesh[mesh.vertexBuffers[j]] = static_cast<int>(i);
+			}
+			if (mesh.numVertexBuffers != 1) throw std::runtime_error("Multiple vertex streams are not supported.");
+		}
+
+		// バッファ以外はそのまま使い、ヘッダーとメッシュの値だけ書き換える
+		const uint64_t bufferDataOffset = header.headerSize + header.nonBufferDataSize;
+		std::vector<uint8_t> output(source.begin(), source.begin() + static_cast<size_t>(bufferDataOffset));
+
+		size_t vertexBytesBefore = 0, vertexBytesAfter = 0;
+		for (uint32_t i = 0; i < file.GetVertexBufferCount(); i++)
+		{
+			SdkMeshVertexBufferHeader vertexHeader = file.GetVertexBuffers()[i];
+			SdkMeshBufferData data = file.GetVertexData(i);
+			vertexBytesBefore += data.size;
+
+			if (vertexBufferMesh[i] < 0)
+			{
+				// どのメッシュからも使われていないバッファはそのまま
+				vertexHeader.dataOffset = AppendBuffer(output, data.data, data.size);
+				vertexBytesAfter += data.size;
+			}
+			else
+			{
+				// バウンディングボックスを頂点の範囲に合わせ、位置の量子化の範囲にする
+				const SourceLayout layout = GetSourceLayout(vertexHeader);
+				SdkMeshMesh mesh = file.GetMeshes()[vertexBufferMesh[i]];
+				ComputeBoundingBox(data.data + layout.position, static_cast<size_t>(vertexHeader.numVertices),
+					static_cast<size_t>(vertexHeader.strideBytes), mesh.boundingBoxCenter, mesh.boundingBoxExtents);
+				QuantizationBounds bounds = MakeQuantizationBounds(mesh.boundingBoxCenter, mesh.boundingBoxExtents);
+
+				std::vector<uint8_t> quantized = QuantizeVertices(data, vertexHeader, bounds);
+				vertexHeader.dataOffset = AppendBuffer(output, quantized.data(), quantized.size());
+				vertexBytesAfter += quantized.size();
+
+				WriteAt(output, header.meshDataOffset + vertexBufferMesh[i] * sizeof(SdkMeshMesh), mesh);
+			}
+			WriteAt(output, header.vertexStreamHeadersOffset + i * sizeof(SdkMeshVertexBufferHeader), vertexHeader);
+		}
+
+		for (uint32_t i = 0; i < file.GetIndexBufferCount(); i++)
+		{
+			SdkMeshIndexBufferHeader indexHeader = file.GetIndexBuffers()[i];
+			SdkMeshBufferData data = file.GetIndexData(i);
+			indexHeader.dataOffset = AppendBuffer(output, data.data, data.size);
+			WriteAt(output, header.indexStreamHeadersOffset + i * sizeof(SdkMeshIndexBufferHeader), indexHeader);
+		}
+
+		SdkMeshHeader newHeader = header;
+		newHeader.bufferDataSize = output.size() - bufferDataOffset;
+		WriteAt(output, 0, newHeader);
+
+		// 読み直し、メッシュのバウンディングボックスから復元して誤差を求める
+		SdkMeshFile check(output.data(), output.size());
+		QuantizationError error;
+		for (uint32_t i = 0; i < check.GetVertexBufferCount(); i++)
+		{
+			if (vertexBufferMesh[i] < 0) continue;
+
+			const SdkMeshMesh& mesh = check.GetMeshes()[vertexBufferMesh[i]];
+			QuantizationBounds decodeBounds = MakeQuantizationBounds(mesh.boundingBoxCenter, mesh.boundingBoxExtents);
+			MeasureError(file.GetVertexData(i), file.GetVertexBuffers()[i],
+				check.GetVertexData(i), check.GetVertexBuffers()[i], decodeBounds, error);
+		}
+
+		std::printf("%s: vertices %zu -> %zu bytes (%.2fx), file %zu -> %zu bytes\n",
+			inputName, vertexBytesBefore, vertexBytesAfter,
+			vertexBytesAfter ? static_cast<double>(vertexBytesBefore) / static_cast<double>(vertexBytesAfter) : 0.0,
+			source.size(), output.size());
+		std::printf("%s: max error position %g (%g of size), normal %.4f deg, texcoord %g\n",
+			inputName, error.position, error.relativePosition, error.normalDegrees, error.textureCoordinate);
+
+		WriteFile(outputName, output);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		std::fprintf(stderr, "Usage: VertexQuantizer <input.sdkmesh> <output.sdkmesh>\n");
+		return 1;
+	}
+
+	try
+	{
+		ProcessFile(argv[1], argv[2]);
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "%s: %s\n", argv[1], e.what());
+		return 1;
+	}
+
+	return 0;
+}
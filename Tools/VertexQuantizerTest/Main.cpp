@@ -0,0 +1,296 @@
+﻿//--------------------------------------------------------------------------------------
+// File: Main.cpp
+//
+// QuantizedVertexの変換の精度と、同梱のモデルを量子化した時の誤差とサイズのテスト
+//
+// Usage: VertexQuantizerTest [<file>...]
+//        ファイルを指定しなければ Resources/Models の７つの.sdkmeshファイルを使います。
+//        1. 半精度浮動小数点数の65,536個の値が全て同じ値に戻ること（NaNはNaNのまま）と、
+//           乱数で作ったfloatが一番近い半精度浮動小数点数に丸められること
+//        2. 乱数で作った1,000,000個の法線を八面体に展開して復元した時の誤差が
+//           NORMAL_ERROR_DEGREES以下で、軸の向きは正確に戻ること
+//        3. モデルごとに、VertexQuantizerと同じ方法で量子化した位置の誤差が範囲の大きさの
+//           0.5 / 32767（とfloatの丸め）以下、法線・UVの誤差が１・２と同じ範囲に収まり、
+//           頂点のサイズが半分以下になること
+//        を確かめ、失敗した項目を表示して1を返します。
+//
+//        ビルド例（リポジトリのルートで実行）
+//          cl /EHsc /O2 /Fe:VertexQuantizerTest.exe Tools\VertexQuantizerTest\Main.cpp ImaseLib\QuantizedVertex.cpp ImaseLib\SdkMeshFile.cpp ImaseLib\MappedFile.cpp ImaseLib\Utf8.cpp
+//          g++ -std=c++14 -O2 -o VertexQuantizerTest Tools/VertexQuantizerTest/Main.cpp ImaseLib/QuantizedVertex.cpp ImaseLib/SdkMeshFile.cpp ImaseLib/MappedFile.cpp ImaseLib/Utf8.cpp
+//
+// Date: 2026.10.17
+//--------------------------------------------------------------------------------------
+#include "../../ImaseLib/QuantizedVertex.h"
+#include "../../ImaseLib/SdkMeshFile.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Imase;
+
+namespace
+{
+	// 同梱のモデル
+	const char* const BUNDLED_MODELS[] =
+	{
+		"Resources/Models/Dice.sdkmesh",
+		"Resources/Models/RingX.sdkmesh",
+		"Resources/Models/RingY.sdkmesh",
+		"Resources/Models/RingZ.sdkmesh",
+		"Resources/Models/ball.sdkmesh",
+		"Resources/Models/floor.sdkmesh",
+		"Resources/Models/player.sdkmesh",
+	};
+
+	// 八面体に展開した法線の誤差の上限（度）
+	const double NORMAL_ERROR_DEGREES = 0.003;
+
+	// 位置の誤差の上限（範囲の大きさに対する割合、丸めの半分）
+	const double POSITION_ERROR = 0.5 / 32767.0;
+
+	// 乱数で確かめる数
+	const int RANDOM_HALF_COUNT = 1000000;
+	const int RANDOM_NORMAL_COUNT = 1000000;
+
+	// 失敗した数
+	int g_failures = 0;
+
+	void Check(bool condition, const char* message, const std::string& detail = std::string())
+	{
+		if (condition) return;
+		if (g_failures < 20) std::printf("FAILED: %s %s\n", message, detail.c_str());
+		g_failures++;
+	}
+
+	std::wstring Widen(const std::string& text)
+	{
+		return std::wstring(text.begin(), text.end());
+	}
+
+	// ２つの向きの間の角度（度、1.0に近い内積のacosは精度が出ないのでatan2で求める）
+	double AngleDegrees(const float a[3], const float b[3])
+	{
+		double cx = static_cast<double>(a[1]) * b[2] - static_cast<double>(a[2]) * b[1];
+		double cy = static_cast<double>(a[2]) * b[0] - static_cast<double>(a[0]) * b[2];
+		double cz = static_cast<double>(a[0]) * b[1] - static_cast<double>(a[1]) * b[0];
+		double dot = static_cast<double>(a[0]) * b[0] + static_cast<double>(a[1]) * b[1] + static_cast<double>(a[2]) * b[2];
+		return std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), dot) * 57.29577951308232;
+	}
+
+	// 半精度浮動小数点数の丸めの誤差の上限（一番近い値との差は隣の値との間隔の半分以下）
+	double HalfErrorBound(float value)
+	{
+		return std::max(std::fabs(static_cast<double>(value)) * std::ldexp(1.0, -11), std::ldexp(1.0, -25));
+	}
+
+	// 1. 半精度浮動小数点数
+	void TestHalf()
+	{
+		int mismatches = 0;
+		for (uint32_t i = 0; i < 65536; i++)
+		{
+			uint16_t half = static_cast<uint16_t>(i);
+			uint16_t result = FloatToHalf(HalfToFloat(half));
+			bool isNan = (half & 0x7c00) == 0x7c00 && (half & 0x3ff);
+			if (isNan ? !((result & 0x7c00) == 0x7c00 && (result & 0x3ff)) : result != half) mismatches++;
+		}
+		Check(mismatches == 0, "half round trip", std::to_string(mismatches) + " of 65536 values changed");
+
+		// 両隣の値の方が近ければ丸めが間違っている
+		std::mt19937 random(1);
+		int notNearest = 0;
+		for (int i = 0; i < RANDOM_HALF_COUNT; i++)
+		{
+			uint32_t bits = static_cast<uint32_t>(random());
+			float value;
+			std::memcpy(&value, &bits, sizeof(value));
+			if (std::isnan(value)) continue;
+
+			uint16_t half = FloatToHalf(value);
+			float result = HalfToFloat(half);
+			if (std::fabs(value) >= 65520.0f)
+			{
+				if (!std::isinf(result)) notNearest++;
+				continue;
+			}
+
+			double error = std::fabs(static_cast<double>(result) - value);
+			const uint16_t neighbors[2] = { static_cast<uint16_t>(half + 1), static_cast<uint16_t>(half - 1) };
+			for (uint16_t neighbor : neighbors)
+			{
+				float other = HalfToFloat(neighbor);
+				if (std::isnan(other) || std::isinf(other) || ((neighbor ^ half) & 0x8000)) continue;
+				if (std::fabs(static_cast<double>(other) - value) < error) notNearest++;
+			}
+		}
+		Check(notNearest == 0, "half rounds to nearest", std::to_string(notNearest) + " values");
+
+		std::printf("half: 65536 round trips, %d random floats rounded\n", RANDOM_HALF_COUNT);
+	}
+
+	// 2. 八面体に展開した法線
+	void TestOctahedral()
+	{
+		std::mt19937 random(2);
+		std::normal_distribution<float> distribution;
+		double maxError = 0.0;
+		for (int i = 0; i < RANDOM_NORMAL_COUNT; i++)
+		{
+			float normal[3] = { distribution(random), distribution(random), distribution(random) };
+			float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			if (length <= 0.0f) continue;
+			for (float& value : normal) value /= length;
+
+			int16_t encoded[2];
+			float decoded[3];
+			EncodeOctahedralNormal(normal, encoded);
+			DecodeOctahedralNormal(encoded, decoded);
+			maxError = std::max(maxError, AngleDegrees(normal, decoded));
+		}
+		Check(maxError <= NORMAL_ERROR_DEGREES, "octahedral error bound", std::to_string(maxError) + " deg");
+
+		const float axes[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+		for (const float* axis : axes)
+		{
+			int16_t encoded[2];
+			float decoded[3];
+			EncodeOctahedralNormal(axis, encoded);
+			DecodeOctahedralNormal(encoded, decoded);
+			Check(decoded[0] == axis[0] && decoded[1] == axis[1] && decoded[2] == axis[2], "octahedral axis is exact");
+		}
+
+		std::printf("octahedral: %d random normals, max error %.5f deg (limit %.4f)\n", RANDOM_NORMAL_COUNT, maxError, NORMAL_ERROR_DEGREES);
+	}
+
+	// 頂点の要素の位置を探す（なければ-1）
+	int FindElement(const SdkMeshVertexBufferHeader& header, uint8_t usage, uint8_t type)
+	{
+		for (const SdkMeshVertexElement& element : header.decl)
+		{
+			if (element.stream == SDKMESH_DECL_END_STREAM) break;
+			if (element.stream == 0 && element.usageIndex == 0 && element.usage == usage && element.type == type) return element.offset;
+		}
+		return -1;
+	}
+
+	// 3. モデルごとの誤差とサイズ
+	void TestModel(const std::string& path)
+	{
+		SdkMeshFile file(Widen(path).c_str());
+
+		for (size_t i = 0; i < file.GetVertexBufferCount(); i++)
+		{
+			const SdkMeshVertexBufferHeader& header = file.GetVertexBuffers()[i];
+			SdkMeshBufferData data = file.GetVertexData(i);
+			const size_t count = static_cast<size_t>(header.numVertices);
+			const size_t stride = static_cast<size_t>(header.strideBytes);
+
+			const int positionOffset = FindElement(header, SDKMESH_DECLUSAGE_POSITION, SDKMESH_DECLTYPE_FLOAT3);
+			const int normalOffset = FindElement(header, SDKMESH_DECLUSAGE_NORMAL, SDKMESH_DECLTYPE_FLOAT3);
+			const int textureCoordinateOffset = FindElement(header, SDKMESH_DECLUSAGE_TEXCOORD, SDKMESH_DECLTYPE_FLOAT2);
+			Check(positionOffset >= 0, "model has float3 position", path);
+			if (positionOffset < 0) continue;
+
+			// VertexQuantizerと同じく、ない要素は詰める
+			size_t quantizedStride = sizeof(QuantizedVertex::position);
+			if (normalOffset >= 0) quantizedStride += sizeof(QuantizedVertex::normal);
+			if (textureCoordinateOffset >= 0) quantizedStride += sizeof(QuantizedVertex::textureCoordinate);
+
+			// VertexQuantizerと同じく頂点の範囲から量子化の範囲を作る
+			float center[3], extents[3];
+			ComputeBoundingBox(data.data + positionOffset, count, stride, center, extents);
+			const QuantizationBounds bounds = MakeQuantizationBounds(center, extents);
+
+			// 範囲の中心と大きさの桁で起きるfloatの丸めを許す
+			const double magnitude = std::max(std::fabs(center[0]), std::max(std::fabs(center[1]), std::fabs(center[2]))) + bounds.scale;
+			const double positionLimit = POSITION_ERROR * bounds.scale + 4.0 * FLT_EPSILON * magnitude;
+
+			std::vector<QuantizedVertex> quantized(count);
+			double positionError = 0.0, normalError = 0.0;
+			int textureCoordinateFailures = 0;
+			for (size_t j = 0; j < count; j++)
+			{
+				const uint8_t* vertex = data.data + j * stride;
+				QuantizedVertex& result = quantized[j];
+
+				float position[3], decodedPosition[3];
+				std::memcpy(position, vertex + positionOffset, sizeof(position));
+				QuantizePosition(position, bounds, result.position);
+				DequantizePosition(result.position, bounds, decodedPosition);
+				for (int k = 0; k < 3; k++)
+				{
+					positionError = std::max(positionError, static_cast<double>(std::fabs(decodedPosition[k] - position[k])));
+				}
+
+				if (normalOffset >= 0)
+				{
+					float normal[3], decodedNormal[3];
+					std::memcpy(normal, vertex + normalOffset, sizeof(normal));
+					EncodeOctahedralNormal(normal, result.normal);
+					DecodeOctahedralNormal(result.normal, decodedNormal);
+					normalError = std::max(normalError, AngleDegrees(normal, decodedNormal));
+				}
+
+				if (textureCoordinateOffset >= 0)
+				{
+					float uv[2];
+					std::memcpy(uv, vertex + textureCoordinateOffset, sizeof(uv));
+					for (int k = 0; k < 2; k++)
+					{
+						result.textureCoordinate[k] = FloatToHalf(uv[k]);
+						if (std::fabs(static_cast<double>(HalfToFloat(result.textureCoordinate[k])) - uv[k]) > HalfErrorBound(uv[k])) textureCoordinateFailures++;
+					}
+				}
+			}
+
+			const size_t bytesBefore = data.size;
+			const size_t bytesAfter = count * quantizedStride;
+			std::printf("%-32s %zu vertices, %zu -> %zu bytes, position error %.3g (limit %.3g), normal %.5f deg\n",
+				path.c_str(), count, bytesBefore, bytesAfter, positionError, positionLimit, normalError);
+
+			Check(positionError <= positionLimit, "position error bound", path);
+			Check(normalError <= NORMAL_ERROR_DEGREES, "normal error bound", path);
+			Check(textureCoordinateFailures == 0, "texcoord error bound", path);
+			Check(bytesAfter * 2 <= bytesBefore, "vertices are at most half the size", path);
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> paths(argv + 1, argv + argc);
+	if (paths.empty())
+	{
+		paths.assign(std::begin(BUNDLED_MODELS), std::end(BUNDLED_MODELS));
+	}
+
+	TestHalf();
+	TestOctahedral();
+	for (const std::string& path : paths)
+	{
+		try
+		{
+			TestModel(path);
+		}
+		catch (const std::exception& e)
+		{
+			Check(false, e.what(), path);
+		}
+	}
+
+	if (g_failures > 0)
+	{
+		std::printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}